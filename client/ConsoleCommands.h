@@ -35,6 +35,8 @@
 #include "ConsoleCommands/QuitCommand.h"
 #include "ConsoleCommands/PingCommand.h"
 #include "ConsoleCommands/ScriptCommand.h"
+#include "ConsoleCommands/ConvertChunksCommand.h"
+#include "ConsoleCommands/PackMapCommand.h"
 #include "EngineLoop.h"
 
 class ConsoleCommandHandler
@@ -45,6 +47,8 @@ public:
         RegisterCommand("quit"_h, &QuitCommand);
         RegisterCommand("ping"_h, &PingCommand);
         RegisterCommand("reload"_h, &ReloadCommand);
+        RegisterCommand("convertchunks"_h, &ConvertChunksCommand);
+        RegisterCommand("packmap"_h, &PackMapCommand);
     }
 
     void HandleCommand(EngineLoop& engineLoop, std::string& command)
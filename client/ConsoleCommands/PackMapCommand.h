@@ -0,0 +1,51 @@
+/*
+    MIT License
+
+    Copyright (c) 2018-2019 NovusCore
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#pragma once
+#include <vector>
+#include <Utils/DebugHandler.h>
+#include "../EngineLoop.h"
+#include "../Gameplay/Map/MapArchive.h"
+#include "../ECS/Components/Singletons/MapSingleton.h"
+#include "../Utils/ServiceLocator.h"
+
+// Usage: packmap <map internal name>, packs the extracted map and its chunks into a single .nmapk archive
+void PackMapCommand(EngineLoop& engineLoop, std::vector<std::string> subCommands)
+{
+    if (subCommands.size() == 0)
+    {
+        DebugHandler::PrintWarning("Usage: packmap <map internal name>");
+        return;
+    }
+
+    // The archive gets replaced by renaming over it, which fails while the current map and its chunks still have it mapped
+    MapSingleton& mapSingleton = ServiceLocator::GetGameRegistry()->ctx<MapSingleton>();
+    Terrain::Map& currentMap = mapSingleton.GetCurrentMap();
+    if (currentMap.archive && currentMap.name == subCommands[0])
+    {
+        DebugHandler::PrintWarning("Can't pack %s while it is loaded from its archive, load another map first", subCommands[0].c_str());
+        return;
+    }
+
+    Terrain::MapArchive::Pack(subCommands[0]);
+}
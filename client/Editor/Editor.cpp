@@ -361,6 +361,14 @@ namespace Editor
         const std::vector<MapObjectRenderer::InstanceLookupData>& instanceLookupDatas = mapObjectRenderer->GetInstanceLookupData();
         const std::vector<MapObjectRenderer::LoadedMapObject>& loadedMapObjects = mapObjectRenderer->GetLoadedMapObjects();
 
+        // The selected placement goes away when its chunk gets streamed out
+        if (_selectedMapObjectData.instanceLookupDataID >= instanceLookupDatas.size())
+        {
+            ImGui::Text("Map Object");
+            ImGui::Text("The selected placement is no longer loaded");
+            return;
+        }
+
         const MapObjectRenderer::InstanceLookupData& instanceLookupData = instanceLookupDatas[_selectedMapObjectData.instanceLookupDataID];
         const MapObjectRenderer::LoadedMapObject& loadedMapObject = loadedMapObjects[instanceLookupData.loadedObjectID];
         const mat4x4& instanceMatrix = mapObjectRenderer->GetInstances()[instanceLookupData.instanceID].instanceMatrix;
@@ -388,6 +396,15 @@ namespace Editor
         CModelRenderer* cModelRenderer = clientRenderer->GetCModelRenderer();
 
         u32 loadedObjectIndex = cModelRenderer->GetModelIndexByDrawCallDataIndex(_selectedComplexModelData.drawCallDataID, _selectedComplexModelData.isOpaque);
+
+        // The selected placement goes away when its chunk gets streamed out
+        if (loadedObjectIndex >= cModelRenderer->GetNumLoadedCModels() || _selectedComplexModelData.instanceID >= cModelRenderer->GetNumCModelPlacements())
+        {
+            ImGui::Text("Complex Model");
+            ImGui::Text("The selected placement is no longer loaded");
+            return;
+        }
+
         const CModelRenderer::LoadedComplexModel& loadedComplexModel = cModelRenderer->GetLoadedComplexModels()[loadedObjectIndex];
         CModelRenderer::Instance& instance = cModelRenderer->GetInstance(_selectedComplexModelData.instanceID);
         const mat4x4& instanceMatrix = instance.instanceMatrix;
@@ -6,6 +6,7 @@
 
 #include <SceneManager.h>
 #include <Renderer/Renderer.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
 #include "Rendering/ClientRenderer.h"
 #include "Rendering/TerrainRenderer.h"
 #include "Rendering/MapObjectRenderer.h"
@@ -31,6 +32,7 @@
 
 #include "UI/ECS/Components/Transform.h"
 #include "UI/ECS/Components/NotCulled.h"
+#include "UI/ECS/Components/Singletons/UITextLayoutCacheSingleton.h"
 
 // Systems
 #include "ECS/Systems/Network/ConnectionSystems.h"
@@ -41,6 +43,7 @@
 #include "ECS/Systems/DayNightSystem.h"
 
 #include "UI/ECS/Systems/DeleteElementsSystem.h"
+#include "UI/ECS/Systems/UpdateTransformSystem.h"
 #include "UI/ECS/Systems/UpdateRenderingSystem.h"
 #include "UI/ECS/Systems/UpdateBoundsSystem.h"
 #include "UI/ECS/Systems/UpdateCullingSystem.h"
@@ -421,6 +424,7 @@ void EngineLoop::SetupUpdateFramework()
 
     ServiceLocator::SetGameRegistry(&gameRegistry);
     ServiceLocator::SetUIRegistry(&uiRegistry);
+    ServiceLocator::SetTaskExecutor(_updateFramework.taskflow.share_executor());
     SetupMessageHandler();
 
     // ConnectionUpdateSystem
@@ -440,6 +444,15 @@ void EngineLoop::SetupUpdateFramework()
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
 
+    // UpdateTransformSystem
+    tf::Task uiUpdateTransformSystemTask = framework.emplace([&uiRegistry, &gameRegistry]()
+    {
+        ZoneScopedNC("UpdateTransformSystem::Update", tracy::Color::Gainsboro);
+        UISystem::UpdateTransformSystem::Update(uiRegistry);
+        gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
+    });
+    uiUpdateTransformSystemTask.gather(uiDeleteElementSystem);
+
     // UpdateRenderingSystem
     tf::Task uiUpdateRenderingSystem = framework.emplace([&uiRegistry, &gameRegistry]()
     {
@@ -447,7 +460,7 @@ void EngineLoop::SetupUpdateFramework()
         UISystem::UpdateRenderingSystem::Update(uiRegistry);
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
-    uiUpdateRenderingSystem.gather(uiDeleteElementSystem);
+    uiUpdateRenderingSystem.gather(uiUpdateTransformSystemTask);
 
     // UpdateBoundsSystem
     tf::Task uiUpdateBoundsSystemTask = framework.emplace([&uiRegistry, &gameRegistry]()
@@ -456,7 +469,7 @@ void EngineLoop::SetupUpdateFramework()
         UISystem::UpdateBoundsSystem::Update(uiRegistry);
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
-    uiUpdateRenderingSystem.gather(uiDeleteElementSystem);
+    uiUpdateBoundsSystemTask.gather(uiUpdateTransformSystemTask);
 
     // UpdateCullingSystem
     tf::Task uiUpdateCullingSystemTask = framework.emplace([&uiRegistry, &gameRegistry]()
@@ -465,7 +478,7 @@ void EngineLoop::SetupUpdateFramework()
         UISystem::UpdateCullingSystem::Update(uiRegistry);
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
-    uiUpdateRenderingSystem.gather(uiDeleteElementSystem);
+    uiUpdateCullingSystemTask.gather(uiUpdateTransformSystemTask);
     
     // BuildSortKeySystem
     tf::Task uiBuildSortKeySystemTask = framework.emplace([&uiRegistry, &gameRegistry]()
@@ -474,7 +487,7 @@ void EngineLoop::SetupUpdateFramework()
         UISystem::BuildSortKeySystem::Update(uiRegistry);
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
-    uiUpdateRenderingSystem.gather(uiDeleteElementSystem);
+    uiBuildSortKeySystemTask.gather(uiDeleteElementSystem);
 
     // FinalCleanUpSystem
     tf::Task uiFinalCleanUpSystemTask = framework.emplace([&uiRegistry, &gameRegistry]()
@@ -484,6 +497,7 @@ void EngineLoop::SetupUpdateFramework()
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
     uiFinalCleanUpSystemTask.gather(uiUpdateRenderingSystem);
+    uiFinalCleanUpSystemTask.gather(uiUpdateBoundsSystemTask);
     uiFinalCleanUpSystemTask.gather(uiUpdateCullingSystemTask);
     uiFinalCleanUpSystemTask.gather(uiBuildSortKeySystemTask);
     /* END UI SYSTEMS */
@@ -787,6 +801,12 @@ void EngineLoop::DrawMapStats()
                 else
                 {
                     ImGui::Text("Loaded Chunks:                 %u", currentMap.chunks.size());
+
+                    TerrainRenderer* terrainRenderer = _clientRenderer->GetTerrainRenderer();
+                    if (terrainRenderer->IsStreaming())
+                    {
+                        ImGui::Text("Streamed Chunk Slots:          %u / %u", terrainRenderer->GetNumLoadedChunks(), terrainRenderer->GetNumChunkSlots());
+                    }
                 }
 
                 TerrainRenderer* terrainRenderer = _clientRenderer->GetTerrainRenderer();
@@ -850,6 +870,9 @@ void EngineLoop::DrawUIStats()
 
     ImGui::Text("Total Elements : %d", count);
     ImGui::Text("Culled elements : %d", (count-notCulled));
+
+    const UISingleton::UITextLayoutCacheSingleton& layoutCache = registry->ctx<UISingleton::UITextLayoutCacheSingleton>();
+    ImGui::Text("Text Layouts : %u (%u cached)", layoutCache.layoutsThisFrame, layoutCache.cachedLayoutsThisFrame);
     
     ImGui::Spacing();
     ImGui::Spacing();
@@ -1108,6 +1131,29 @@ void EngineLoop::DrawPerformance(EngineStatsSingleton* stats)
         DrawCullingStatsEntry("Total", totalTriangles, totalTrianglesSurvived, !showTriangles);
     }
 
+    // Null renderer counters, this is the only place the headless backend reports what the frame would have submitted
+    if (Renderer::RendererNull* rendererNull = dynamic_cast<Renderer::RendererNull*>(ServiceLocator::GetRenderer()))
+    {
+        ImGui::Spacing();
+        if (ImGui::CollapsingHeader("Null Renderer"))
+        {
+            const Renderer::RendererNull::Counters& frame = rendererNull->GetFrameCounters();
+            const Renderer::RendererNull::Counters& total = rendererNull->GetTotalCounters();
+
+            ImGui::Text("Frame / Total");
+            ImGui::Separator();
+            ImGui::Text("Command Lists : %u / %u", frame.numCommandLists, total.numCommandLists);
+            ImGui::Text("Draws : %u / %u", frame.numDraws, total.numDraws);
+            ImGui::Text("Indirect Draws : %u / %u", frame.numIndirectDraws, total.numIndirectDraws);
+            ImGui::Text("Dispatches : %u / %u", frame.numDispatches, total.numDispatches);
+            ImGui::Text("Pipeline Binds : %u / %u", frame.numPipelineBinds, total.numPipelineBinds);
+            ImGui::Text("Descriptor Set Binds : %u / %u", frame.numDescriptorSetBinds, total.numDescriptorSetBinds);
+            ImGui::Text("Descriptor Set Writes : %u / %u", frame.numDescriptorSetWrites, total.numDescriptorSetWrites);
+            ImGui::Text("Barriers : %u / %u (%u / %u batches)", frame.numBarriers, total.numBarriers, frame.numBarrierBatches, total.numBarrierBatches);
+            ImGui::Text("Uploaded : %.2fMB / %.2fMB", static_cast<f64>(frame.numUploadedBytes) / 1000000.0, static_cast<f64>(total.numUploadedBytes) / 1000000.0);
+        }
+    }
+
     ImGui::Spacing();
     ImGui::Spacing();
     ImGui::Text("Frametimes");
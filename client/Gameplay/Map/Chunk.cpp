@@ -1,96 +1,52 @@
 #include "Chunk.h"
+#include "ChunkView.h"
+#include "../../Utils/MappedFile.h"
 
 #include <Utils/ByteBuffer.h>
-#include <Utils/FileReader.h>
 
-bool Terrain::Chunk::Read(FileReader& reader, Terrain::Chunk& chunk, StringTable& stringTable)
+bool Terrain::Chunk::Read(const std::string& path, Terrain::Chunk& chunk, StringTable& stringTable)
 {
-    Bytebuffer buffer(nullptr, reader.Length());
-    reader.Read(&buffer, buffer.size);
+    // Copy-on-write so border alignment can patch heights and normals without touching the file
+    std::shared_ptr<MappedFile> mappedFile = std::make_shared<MappedFile>();
+    if (!mappedFile->Open(path, MappedFile::Access::CopyOnWrite))
+        return false;
 
-    buffer.Get<Terrain::ChunkHeader>(chunk.chunkHeader);
-
-    if (chunk.chunkHeader.token != Terrain::MAP_CHUNK_TOKEN)
-    {
-        DebugHandler::PrintFatal("Tried to load a map chunk file with the wrong token");
-    }
-
-    if (chunk.chunkHeader.version != Terrain::MAP_CHUNK_VERSION)
-    {
-        if (chunk.chunkHeader.version < Terrain::MAP_CHUNK_VERSION)
-        {
-            DebugHandler::PrintFatal("Loaded map chunk with too old version %u instead of expected version of %u, rerun dataextractor", chunk.chunkHeader.version, Terrain::MAP_CHUNK_VERSION);
-        }
-        else
-        {
-            DebugHandler::PrintFatal("Loaded map chunk with too new version %u instead of expected version of %u, update your client", chunk.chunkHeader.version, Terrain::MAP_CHUNK_VERSION);
-        }
-    }
-
-    buffer.Get<Terrain::HeightHeader>(chunk.heightHeader);
-    buffer.Get<Terrain::HeightBox>(chunk.heightBox);
-
-    buffer.GetBytes(reinterpret_cast<u8*>(&chunk.cells[0]), sizeof(Terrain::Cell) * Terrain::MAP_CELLS_PER_CHUNK);
-
-    buffer.Get<u32>(chunk.alphaMapStringID);
-
-    u32 numMapObjectPlacements;
-    buffer.Get<u32>(numMapObjectPlacements);
-
-    if (numMapObjectPlacements > 0)
-    {
-        chunk.mapObjectPlacements.resize(numMapObjectPlacements);
-        buffer.GetBytes(reinterpret_cast<u8*>(&chunk.mapObjectPlacements[0]), sizeof(Terrain::Placement) * numMapObjectPlacements);
-    }
-
-    u32 numComplexModelPlacements;
-    buffer.Get<u32>(numComplexModelPlacements);
+    const size_t size = mappedFile->GetSize();
+    return Read(std::move(mappedFile), 0, size, chunk, stringTable);
+}
 
-    if (numComplexModelPlacements > 0)
-    {
-        chunk.complexModelPlacements.resize(numComplexModelPlacements);
-        buffer.GetBytes(reinterpret_cast<u8*>(&chunk.complexModelPlacements[0]), sizeof(Terrain::Placement) * numComplexModelPlacements);
-    }
+bool Terrain::Chunk::Read(std::shared_ptr<MappedFile> mappedFile, size_t offset, size_t size, Terrain::Chunk& chunk, StringTable& stringTable)
+{
+    if (offset + size > mappedFile->GetSize())
+        return false;
 
-    // Read Liquid Bytes
-    {
-        u32 numLiquidBytes;
-        buffer.Get<u32>(numLiquidBytes);
+    Terrain::ChunkView view;
+    if (!Terrain::ChunkView::Read(mappedFile->GetData() + offset, size, view))
+        return false;
 
-        if (numLiquidBytes > 0)
-        {
-            chunk.liquidBytes.resize(numLiquidBytes);
-            buffer.GetBytes(chunk.liquidBytes.data(), sizeof(u8) * numLiquidBytes);
+    chunk.chunkHeader.token = Terrain::MAP_CHUNK_TOKEN;
+    chunk.chunkHeader.version = view.version;
 
-            chunk.liquidHeaders.resize(Terrain::MAP_CELLS_PER_CHUNK);
-            std::memcpy(chunk.liquidHeaders.data(), chunk.liquidBytes.data(), Terrain::MAP_CELLS_PER_CHUNK * sizeof(Terrain::CellLiquidHeader));
+    chunk.heightHeader = *view.heightHeader;
+    chunk.heightBox = *view.heightBox;
 
-            u32 numInstances = 0;
-            u32 firstInstanceOffset = std::numeric_limits<u32>().max();
+    chunk.cells = view.cells;
+    chunk.alphaMapStringID = view.alphaMapStringID;
 
-            // We reserver memory for at least 1 layer for each liquid header
-            for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i++)
-            {
-                const Terrain::CellLiquidHeader& header = chunk.liquidHeaders[i];
+    chunk.mapObjectPlacements = view.mapObjectPlacements;
+    chunk.complexModelPlacements = view.complexModelPlacements;
 
-                if (header.layerCount > 0)
-                {
-                    if (header.instancesOffset < firstInstanceOffset)
-                        firstInstanceOffset = header.instancesOffset;
+    chunk.liquidBytes = view.liquidBytes;
+    chunk.liquidHeaders = view.liquidHeaders;
+    chunk.liquidInstances = view.liquidInstances;
 
-                    numInstances += header.layerCount;
-                }
-            }
+    chunk.mappedFile = std::move(mappedFile);
 
-            if (numInstances > 0)
-            {
-                chunk.liquidInstances.resize(numInstances);
-                std::memcpy(chunk.liquidInstances.data(), &chunk.liquidBytes.data()[firstInstanceOffset], sizeof(Terrain::CellLiquidInstance) * numInstances);
-            }
-        }
-    }
+    // The string table is tiny, this is the only part that gets copied out of the mapping
+    Bytebuffer stringTableBuffer(view.stringTableBytes.data, view.stringTableBytes.size());
+    stringTableBuffer.writtenData = view.stringTableBytes.size();
 
-    stringTable.Deserialize(&buffer);
+    stringTable.Deserialize(&stringTableBuffer);
     assert(stringTable.GetNumStrings() > 0); // We always expect to have at least 1 string in our stringtable, a path for the base texture
     return true;
 }
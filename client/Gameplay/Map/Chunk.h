@@ -25,6 +25,7 @@
 #include <NovusTypes.h>
 #include <robin_hood.h>
 #include <limits>
+#include <memory>
 
 #include "Cell.h"
 #include <Containers/StringTable.h>
@@ -34,7 +35,7 @@
 // A Chunk consists of 16x16 Cells which are all being used.
 // A Cell consists of two interlapping grids. There is the 9*9 OUTER grid and the 8*8 INNER grid.
 
-class FileReader;
+class MappedFile;
 namespace Terrain
 {
     constexpr i32 MAP_CHUNK_TOKEN = 1128812107; // UTF8 -> Binary -> Decimal for "chnk"
@@ -176,6 +177,23 @@ namespace Terrain
         u16 x;
         u16 y;
     };
+#pragma pack(pop)
+
+    // A non owning array living inside a mapped chunk file
+    template <typename T>
+    struct ChunkSpan
+    {
+        T* data = nullptr;
+        u32 count = 0;
+
+        u32 size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        T& operator[](size_t index) const { return data[index]; }
+
+        T* begin() const { return data; }
+        T* end() const { return data + count; }
+    };
 
     struct Chunk
     {
@@ -184,21 +202,22 @@ namespace Terrain
         HeightHeader heightHeader;
         HeightBox heightBox;
 
-        Cell cells[MAP_CELLS_PER_CHUNK];
+        // These point straight into mappedFile, the mapping is copy-on-write so aligning borders only copies the pages it touches
+        Cell* cells = nullptr;
         u32 alphaMapStringID;
 
-        std::vector<Placement> mapObjectPlacements;
-        std::vector<Placement> complexModelPlacements;
+        ChunkSpan<Placement> mapObjectPlacements;
+        ChunkSpan<Placement> complexModelPlacements;
 
-        std::vector<u8> liquidBytes;
+        ChunkSpan<u8> liquidBytes;
 
-        std::vector<CellLiquidHeader> liquidHeaders;
-        std::vector<CellLiquidInstance> liquidInstances;
-        std::vector<CellLiquidAttributes> liquidAttributes;
-        std::vector<u8> liquidBitMaskForPatchesData;
-        std::vector<u8> liquidvertexData;
+        ChunkSpan<CellLiquidHeader> liquidHeaders;
+        ChunkSpan<CellLiquidInstance> liquidInstances;
 
-        static bool Read(FileReader& reader, Terrain::Chunk& chunk, StringTable& stringTable);
+        std::shared_ptr<MappedFile> mappedFile;
+
+        static bool Read(const std::string& path, Terrain::Chunk& chunk, StringTable& stringTable);
+        // Reads a chunk stored at offset inside an already mapped file, the mapping needs to be copy-on-write
+        static bool Read(std::shared_ptr<MappedFile> mappedFile, size_t offset, size_t size, Terrain::Chunk& chunk, StringTable& stringTable);
     };
-#pragma pack(pop)
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "ChunkConverter.h"
+#include "ChunkView.h"
+#include "../../Utils/MappedFile.h"
+
+#include <Utils/DebugHandler.h>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace Terrain
+{
+    bool ChunkConverter::ConvertChunk(const std::string& path)
+    {
+        std::vector<u8> output;
+
+        {
+            MappedFile mappedFile;
+            if (!mappedFile.Open(path, MappedFile::Access::ReadOnly))
+                return false;
+
+            ChunkView view;
+            if (!ChunkView::Read(mappedFile.GetData(), mappedFile.GetSize(), view))
+            {
+                DebugHandler::PrintError("Failed to read map chunk for conversion (%s)", path.c_str());
+                return false;
+            }
+
+            if (view.version == static_cast<u32>(MAP_CHUNK_MAPPED_VERSION))
+                return true;
+
+            if (!ChunkView::Write(view, output))
+                return false;
+        }
+
+        // Write next to the original and swap it in afterwards so a failed write never leaves a broken chunk behind
+        fs::path tempPath = path + ".tmp";
+        {
+            std::ofstream outputFile(tempPath, std::ios::out | std::ios::binary);
+            if (!outputFile)
+            {
+                DebugHandler::PrintError("Failed to create file (%s)", tempPath.string().c_str());
+                return false;
+            }
+
+            outputFile.write(reinterpret_cast<const char*>(output.data()), output.size());
+            if (!outputFile)
+            {
+                DebugHandler::PrintError("Failed to write file (%s)", tempPath.string().c_str());
+                return false;
+            }
+        }
+
+        std::error_code errorCode;
+        fs::rename(tempPath, path, errorCode);
+        if (errorCode)
+        {
+            DebugHandler::PrintError("Failed to replace map chunk (%s): %s", path.c_str(), errorCode.message().c_str());
+            fs::remove(tempPath, errorCode);
+            return false;
+        }
+
+        return true;
+    }
+
+    u32 ChunkConverter::ConvertDirectory(const std::string& directory)
+    {
+        if (!fs::is_directory(directory))
+        {
+            DebugHandler::PrintError("Failed to find chunk folder (%s)", directory.c_str());
+            return 0;
+        }
+
+        u32 numConverted = 0;
+        u32 numFailed = 0;
+
+        for (const auto& entry : fs::recursive_directory_iterator(directory))
+        {
+            if (entry.path().extension() != ".nchunk")
+                continue;
+
+            if (ConvertChunk(entry.path().string()))
+            {
+                numConverted++;
+            }
+            else
+            {
+                numFailed++;
+            }
+        }
+
+        if (numFailed > 0)
+        {
+            DebugHandler::PrintWarning("Failed to convert %u map chunks in (%s)", numFailed, directory.c_str());
+        }
+
+        DebugHandler::PrintSuccess("Converted %u map chunks in (%s)", numConverted, directory.c_str());
+        return numConverted;
+    }
+}
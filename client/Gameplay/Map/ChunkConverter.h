@@ -0,0 +1,17 @@
+#pragma once
+#include <NovusTypes.h>
+#include <string>
+
+namespace Terrain
+{
+    // Rewrites MAP_CHUNK_VERSION chunks into the aligned MAP_CHUNK_MAPPED_VERSION layout
+    class ChunkConverter
+    {
+    public:
+        // Chunks that are already converted are left alone, returns false if the chunk could not be read or written
+        static bool ConvertChunk(const std::string& path);
+
+        // Converts every .nchunk under directory, returns the number of chunks that got converted
+        static u32 ConvertDirectory(const std::string& directory);
+    };
+}
@@ -0,0 +1,149 @@
+#include "ChunkLoader.h"
+#include "Map.h"
+#include "MapArchive.h"
+#include "../../Utils/MapUtils.h"
+#include "../../Utils/ServiceLocator.h"
+
+#include <Utils/DebugHandler.h>
+#include <tracy/Tracy.hpp>
+#include <chrono>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace Terrain
+{
+    ChunkLoader::ChunkLoader()
+        : _taskflow(ServiceLocator::GetTaskExecutor())
+    {
+    }
+
+    void ChunkLoader::LoadAsync(const std::vector<Request>& requests)
+    {
+        ZoneScoped;
+
+        const size_t numRequests = requests.size();
+        if (numRequests == 0)
+            return;
+
+        Batch& batch = _batches.emplace_back();
+        batch.requests = requests;
+        batch.decodedChunks.resize(numRequests);
+
+        for (size_t i = 0; i < numRequests; i++)
+        {
+            DecodedChunk* decodedChunk = new DecodedChunk();
+            decodedChunk->batch = &batch;
+            decodedChunk->requestIndex = i;
+
+            batch.decodedChunks[i].reset(decodedChunk);
+            _loadingChunks.set(requests[i].chunkID);
+
+            // Reading only maps the file and points the chunk into it, the pages get faulted in by the decode task
+            tf::Task readTask = batch.framework.emplace([&request = batch.requests[i], decodedChunk]()
+            {
+                ZoneScopedNC("ChunkLoader::Read", tracy::Color::Orange);
+
+                if (request.archive)
+                {
+                    decodedChunk->succeeded = request.archive->ReadChunk(request.chunkID, decodedChunk->chunk, decodedChunk->stringTable);
+                }
+                else
+                {
+                    decodedChunk->succeeded = Terrain::Chunk::Read(request.path, decodedChunk->chunk, decodedChunk->stringTable);
+                }
+            });
+
+            tf::Task decodeTask = batch.framework.emplace([this, decodedChunk]()
+            {
+                ZoneScopedNC("ChunkLoader::Decode", tracy::Color::Orange2);
+
+                if (decodedChunk->succeeded)
+                {
+                    Terrain::MapUtils::AlignCellBorders(decodedChunk->chunk);
+                }
+
+                _decodedChunks.enqueue(decodedChunk);
+            });
+
+            decodeTask.gather(readTask);
+        }
+
+        batch.finished = _taskflow.run(batch.framework);
+    }
+
+    u32 ChunkLoader::Poll(Terrain::Map& map, std::vector<u16>* outLoadedChunkIDs, std::vector<u16>* outFailedChunkIDs, std::vector<u16>* outChangedNeighbours)
+    {
+        ZoneScoped;
+
+        u32 numLoadedChunks = 0;
+
+        DecodedChunk* decodedChunk;
+        while (_decodedChunks.try_dequeue(decodedChunk))
+        {
+            const Request& request = decodedChunk->batch->requests[decodedChunk->requestIndex];
+            const u16 chunkID = request.chunkID;
+
+            decodedChunk->batch->numReceived++;
+            _loadingChunks.reset(chunkID);
+
+            if (!decodedChunk->succeeded)
+            {
+                const std::string& path = request.archive ? request.archive->GetPath() : request.path;
+                DebugHandler::PrintError("Failed to load map chunk %u from (%s)", chunkID, fs::path(path).filename().string().c_str());
+
+                if (outFailedChunkIDs)
+                    outFailedChunkIDs->push_back(chunkID);
+
+                continue;
+            }
+
+            map.chunks[chunkID] = std::move(decodedChunk->chunk);
+            map.stringTables[chunkID] = std::move(decodedChunk->stringTable);
+
+            // Neighbours that haven't arrived yet aren't in the map, they fix up the shared borders once they arrive
+            Terrain::MapUtils::AlignChunkBorders(map, chunkID, outChangedNeighbours);
+            numLoadedChunks++;
+
+            if (outLoadedChunkIDs)
+                outLoadedChunkIDs->push_back(chunkID);
+        }
+
+        // Batches can only go once the workers are done with their framework, not just once their last chunk was queued
+        for (auto itr = _batches.begin(); itr != _batches.end();)
+        {
+            const bool isReceived = itr->numReceived == itr->requests.size();
+            if (isReceived && itr->finished.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                itr = _batches.erase(itr);
+            }
+            else
+            {
+                itr++;
+            }
+        }
+
+        return numLoadedChunks;
+    }
+
+    u32 ChunkLoader::Load(Terrain::Map& map, const std::vector<Request>& requests, std::vector<u16>* outChangedNeighbours)
+    {
+        ZoneScoped;
+
+        LoadAsync(requests);
+        _taskflow.wait_for_all();
+
+        return Poll(map, nullptr, nullptr, outChangedNeighbours);
+    }
+
+    void ChunkLoader::Clear()
+    {
+        _taskflow.wait_for_all();
+
+        DecodedChunk* decodedChunk;
+        while (_decodedChunks.try_dequeue(decodedChunk)) {}
+
+        _batches.clear();
+        _loadingChunks.reset();
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <NovusTypes.h>
+#include <Utils/ConcurrentQueue.h>
+#include <taskflow/taskflow.hpp>
+#include <bitset>
+#include <list>
+#include <memory>
+
+#include "Chunk.h"
+
+namespace Terrain
+{
+    struct Map;
+    class MapArchive;
+
+    // Loads chunks into a Map using the shared taskflow workers
+    // Every chunk gets a read task (which maps the file) and a decode task (which aligns the cells within the chunk), decoded chunks are handed back through a lock-free queue
+    // The workers decode into storage owned by the loader, chunks only enter the Map in Poll, on the calling thread, where they get their borders aligned against their neighbours
+    class ChunkLoader
+    {
+    public:
+        struct Request
+        {
+            u16 chunkID;
+            std::string path;
+            std::shared_ptr<const MapArchive> archive = nullptr; // When set the chunk is read from the archive and path is ignored
+        };
+
+        ChunkLoader();
+
+        // Starts loading the requests on the workers and returns right away, the chunks show up in Poll once they are decoded
+        void LoadAsync(const std::vector<Request>& requests);
+        // Moves every chunk that finished decoding since the last call into the map without waiting for the rest
+        // Returns the number of chunks that got loaded, chunks that failed to load are added to outFailedChunkIDs
+        u32 Poll(Terrain::Map& map, std::vector<u16>* outLoadedChunkIDs = nullptr, std::vector<u16>* outFailedChunkIDs = nullptr, std::vector<u16>* outChangedNeighbours = nullptr);
+
+        // Blocks until every request has been loaded or has failed, returns the number of chunks that got loaded
+        u32 Load(Terrain::Map& map, const std::vector<Request>& requests, std::vector<u16>* outChangedNeighbours = nullptr);
+
+        // Waits for the chunks still on the workers and drops them, used before the map they were requested for goes away
+        void Clear();
+
+        bool IsLoading(u16 chunkID) const { return _loadingChunks.test(chunkID); }
+        bool IsLoading() const { return _loadingChunks.any(); }
+
+    private:
+        struct Batch;
+        struct DecodedChunk
+        {
+            Batch* batch = nullptr;
+            size_t requestIndex = 0;
+            bool succeeded = false;
+
+            Terrain::Chunk chunk;
+            StringTable stringTable;
+        };
+
+        // A batch of requests, kept alive until every chunk in it has been received and the workers are done with its framework
+        struct Batch
+        {
+            std::vector<Request> requests;
+            std::vector<std::unique_ptr<DecodedChunk>> decodedChunks;
+
+            tf::Framework framework;
+            std::shared_future<void> finished;
+
+            size_t numReceived = 0;
+        };
+
+        tf::Taskflow _taskflow;
+        std::list<Batch> _batches;
+        moodycamel::ConcurrentQueue<DecodedChunk*> _decodedChunks;
+        std::bitset<Terrain::MAP_CHUNKS_PER_MAP> _loadingChunks;
+    };
+}
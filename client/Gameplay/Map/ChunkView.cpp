@@ -0,0 +1,257 @@
+#include "ChunkView.h"
+
+#include <Utils/DebugHandler.h>
+#include <cstring>
+
+namespace Terrain
+{
+    template <typename T>
+    static bool GetSection(u8* data, size_t size, size_t offset, u32 count, T*& outSection)
+    {
+        const u64 sectionEnd = static_cast<u64>(offset) + static_cast<u64>(count) * sizeof(T);
+        if (sectionEnd > size)
+            return false;
+
+        outSection = reinterpret_cast<T*>(data + offset);
+        return true;
+    }
+
+    template <typename T>
+    static bool GetSpan(u8* data, size_t size, size_t offset, u32 count, ChunkSpan<T>& outSpan)
+    {
+        if (count == 0)
+        {
+            outSpan = ChunkSpan<T>();
+            return true;
+        }
+
+        outSpan.count = count;
+        return GetSection(data, size, offset, count, outSpan.data);
+    }
+
+    static bool ReadU32(u8* data, size_t size, size_t& offset, u32& outValue)
+    {
+        if (offset + sizeof(u32) > size)
+            return false;
+
+        std::memcpy(&outValue, data + offset, sizeof(u32));
+        offset += sizeof(u32);
+        return true;
+    }
+
+    static bool SetupLiquid(ChunkView& view)
+    {
+        view.liquidHeaders = ChunkSpan<CellLiquidHeader>();
+        view.liquidInstances = ChunkSpan<CellLiquidInstance>();
+
+        if (view.liquidBytes.empty())
+            return true;
+
+        u8* liquidData = view.liquidBytes.data;
+        size_t liquidSize = view.liquidBytes.size();
+
+        if (!GetSpan(liquidData, liquidSize, 0, MAP_CELLS_PER_CHUNK, view.liquidHeaders))
+            return false;
+
+        u32 numInstances = 0;
+        u32 firstInstanceOffset = std::numeric_limits<u32>().max();
+
+        for (const CellLiquidHeader& header : view.liquidHeaders)
+        {
+            if (header.layerCount > 0)
+            {
+                if (header.instancesOffset < firstInstanceOffset)
+                    firstInstanceOffset = header.instancesOffset;
+
+                numInstances += header.layerCount;
+            }
+        }
+
+        if (numInstances == 0)
+            return true;
+
+        return GetSpan(liquidData, liquidSize, firstInstanceOffset, numInstances, view.liquidInstances);
+    }
+
+    static bool ReadPacked(u8* data, size_t size, ChunkView& view)
+    {
+        size_t offset = sizeof(ChunkHeader);
+
+        if (!GetSection(data, size, offset, 1, view.heightHeader))
+            return false;
+        offset += sizeof(HeightHeader);
+
+        if (!GetSection(data, size, offset, 1, view.heightBox))
+            return false;
+        offset += sizeof(HeightBox);
+
+        if (!GetSection(data, size, offset, MAP_CELLS_PER_CHUNK, view.cells))
+            return false;
+        offset += sizeof(Cell) * MAP_CELLS_PER_CHUNK;
+
+        if (!ReadU32(data, size, offset, view.alphaMapStringID))
+            return false;
+
+        u32 numMapObjectPlacements;
+        if (!ReadU32(data, size, offset, numMapObjectPlacements) || !GetSpan(data, size, offset, numMapObjectPlacements, view.mapObjectPlacements))
+            return false;
+        offset += sizeof(Placement) * numMapObjectPlacements;
+
+        u32 numComplexModelPlacements;
+        if (!ReadU32(data, size, offset, numComplexModelPlacements) || !GetSpan(data, size, offset, numComplexModelPlacements, view.complexModelPlacements))
+            return false;
+        offset += sizeof(Placement) * numComplexModelPlacements;
+
+        u32 numLiquidBytes;
+        if (!ReadU32(data, size, offset, numLiquidBytes) || !GetSpan(data, size, offset, numLiquidBytes, view.liquidBytes))
+            return false;
+        offset += numLiquidBytes;
+
+        // The string table takes up the rest of the file
+        return GetSpan(data, size, offset, static_cast<u32>(size - offset), view.stringTableBytes);
+    }
+
+    static bool ReadMapped(u8* data, size_t size, ChunkView& view)
+    {
+        ChunkLayout* layout;
+        if (!GetSection(data, size, 0, 1, layout))
+            return false;
+
+        view.alphaMapStringID = layout->alphaMapStringID;
+
+        if (!GetSection(data, size, layout->heightHeaderOffset, 1, view.heightHeader))
+            return false;
+
+        if (!GetSection(data, size, layout->heightHeaderOffset + sizeof(HeightHeader), 1, view.heightBox))
+            return false;
+
+        if (!GetSection(data, size, layout->cellsOffset, MAP_CELLS_PER_CHUNK, view.cells))
+            return false;
+
+        if (!GetSpan(data, size, layout->mapObjectPlacementsOffset, layout->numMapObjectPlacements, view.mapObjectPlacements))
+            return false;
+
+        if (!GetSpan(data, size, layout->complexModelPlacementsOffset, layout->numComplexModelPlacements, view.complexModelPlacements))
+            return false;
+
+        if (!GetSpan(data, size, layout->liquidBytesOffset, layout->numLiquidBytes, view.liquidBytes))
+            return false;
+
+        return GetSpan(data, size, layout->stringTableOffset, layout->stringTableSize, view.stringTableBytes);
+    }
+
+    bool ChunkView::Read(u8* data, size_t size, ChunkView& view)
+    {
+        if (data == nullptr || size < sizeof(ChunkHeader))
+        {
+            DebugHandler::PrintError("Tried to read a map chunk that is too small to contain a header");
+            return false;
+        }
+
+        ChunkHeader header;
+        std::memcpy(&header, data, sizeof(ChunkHeader));
+
+        if (header.token != MAP_CHUNK_TOKEN)
+        {
+            DebugHandler::PrintError("Tried to load a map chunk file with the wrong token");
+            return false;
+        }
+
+        view.version = header.version;
+
+        bool result = false;
+        if (header.version == static_cast<u32>(MAP_CHUNK_VERSION))
+        {
+            result = ReadPacked(data, size, view);
+        }
+        else if (header.version == static_cast<u32>(MAP_CHUNK_MAPPED_VERSION))
+        {
+            result = ReadMapped(data, size, view);
+        }
+        else if (header.version < static_cast<u32>(MAP_CHUNK_VERSION))
+        {
+            DebugHandler::PrintError("Loaded map chunk with too old version %u instead of expected version of %u, rerun dataextractor", header.version, MAP_CHUNK_VERSION);
+            return false;
+        }
+        else
+        {
+            DebugHandler::PrintError("Loaded map chunk with too new version %u instead of expected version of %u, update your client", header.version, MAP_CHUNK_MAPPED_VERSION);
+            return false;
+        }
+
+        if (!result || !SetupLiquid(view))
+        {
+            DebugHandler::PrintError("Map chunk (version %u) is truncated or has a section pointing outside of the file", header.version);
+            return false;
+        }
+
+        return true;
+    }
+
+    static size_t AlignSection(size_t offset)
+    {
+        return (offset + MAP_CHUNK_SECTION_ALIGNMENT - 1) & ~static_cast<size_t>(MAP_CHUNK_SECTION_ALIGNMENT - 1);
+    }
+
+    bool ChunkView::Write(const ChunkView& view, std::vector<u8>& output)
+    {
+        if (view.heightHeader == nullptr || view.heightBox == nullptr || view.cells == nullptr)
+        {
+            DebugHandler::PrintError("Tried to write an incomplete map chunk");
+            return false;
+        }
+
+        ChunkLayout layout;
+        layout.chunkHeader.token = MAP_CHUNK_TOKEN;
+        layout.chunkHeader.version = MAP_CHUNK_MAPPED_VERSION;
+        layout.alphaMapStringID = view.alphaMapStringID;
+
+        // Lay out every section at an aligned offset
+        size_t offset = AlignSection(sizeof(ChunkLayout));
+
+        layout.heightHeaderOffset = static_cast<u32>(offset);
+        offset = AlignSection(offset + sizeof(HeightHeader) + sizeof(HeightBox));
+
+        layout.cellsOffset = static_cast<u32>(offset);
+        offset = AlignSection(offset + sizeof(Cell) * MAP_CELLS_PER_CHUNK);
+
+        layout.mapObjectPlacementsOffset = static_cast<u32>(offset);
+        layout.numMapObjectPlacements = view.mapObjectPlacements.size();
+        offset = AlignSection(offset + sizeof(Placement) * view.mapObjectPlacements.size());
+
+        layout.complexModelPlacementsOffset = static_cast<u32>(offset);
+        layout.numComplexModelPlacements = view.complexModelPlacements.size();
+        offset = AlignSection(offset + sizeof(Placement) * view.complexModelPlacements.size());
+
+        layout.liquidBytesOffset = static_cast<u32>(offset);
+        layout.numLiquidBytes = view.liquidBytes.size();
+        offset = AlignSection(offset + view.liquidBytes.size());
+
+        layout.stringTableOffset = static_cast<u32>(offset);
+        layout.stringTableSize = view.stringTableBytes.size();
+        offset += view.stringTableBytes.size();
+
+        output.clear();
+        output.resize(offset, 0);
+
+        u8* data = output.data();
+        std::memcpy(data, &layout, sizeof(ChunkLayout));
+        std::memcpy(data + layout.heightHeaderOffset, view.heightHeader, sizeof(HeightHeader));
+        std::memcpy(data + layout.heightHeaderOffset + sizeof(HeightHeader), view.heightBox, sizeof(HeightBox));
+        std::memcpy(data + layout.cellsOffset, view.cells, sizeof(Cell) * MAP_CELLS_PER_CHUNK);
+
+        if (!view.mapObjectPlacements.empty())
+            std::memcpy(data + layout.mapObjectPlacementsOffset, view.mapObjectPlacements.data, sizeof(Placement) * view.mapObjectPlacements.size());
+
+        if (!view.complexModelPlacements.empty())
+            std::memcpy(data + layout.complexModelPlacementsOffset, view.complexModelPlacements.data, sizeof(Placement) * view.complexModelPlacements.size());
+
+        if (!view.liquidBytes.empty())
+            std::memcpy(data + layout.liquidBytesOffset, view.liquidBytes.data, view.liquidBytes.size());
+
+        if (!view.stringTableBytes.empty())
+            std::memcpy(data + layout.stringTableOffset, view.stringTableBytes.data, view.stringTableBytes.size());
+
+        return true;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <NovusTypes.h>
+#include <vector>
+
+#include "Chunk.h"
+
+namespace Terrain
+{
+    // Version 8 chunks store every section at an aligned offset described by ChunkLayout, so the file can be mapped and used in place
+    // Version 7 chunks are still readable in place, their sections are just tightly packed one after another
+    constexpr i32 MAP_CHUNK_MAPPED_VERSION = 8;
+    constexpr u32 MAP_CHUNK_SECTION_ALIGNMENT = 64;
+
+    struct ChunkLayout
+    {
+        ChunkHeader chunkHeader;
+
+        u32 alphaMapStringID = 0;
+
+        u32 heightHeaderOffset = 0; // HeightHeader directly followed by a HeightBox
+        u32 cellsOffset = 0; // MAP_CELLS_PER_CHUNK Cells
+
+        u32 mapObjectPlacementsOffset = 0;
+        u32 numMapObjectPlacements = 0;
+
+        u32 complexModelPlacementsOffset = 0;
+        u32 numComplexModelPlacements = 0;
+
+        u32 liquidBytesOffset = 0; // Starts with MAP_CELLS_PER_CHUNK CellLiquidHeaders, all offsets inside are relative to this
+        u32 numLiquidBytes = 0;
+
+        u32 stringTableOffset = 0;
+        u32 stringTableSize = 0;
+    };
+
+    // Points into a serialized chunk, it never owns or copies the data so whoever provided the memory has to keep it alive
+    struct ChunkView
+    {
+        u32 version = 0;
+
+        HeightHeader* heightHeader = nullptr;
+        HeightBox* heightBox = nullptr;
+
+        Cell* cells = nullptr;
+        u32 alphaMapStringID = 0;
+
+        ChunkSpan<Placement> mapObjectPlacements;
+        ChunkSpan<Placement> complexModelPlacements;
+
+        ChunkSpan<u8> liquidBytes;
+        ChunkSpan<CellLiquidHeader> liquidHeaders;
+        ChunkSpan<CellLiquidInstance> liquidInstances;
+
+        ChunkSpan<u8> stringTableBytes;
+
+        // Accepts both MAP_CHUNK_VERSION and MAP_CHUNK_MAPPED_VERSION, every section gets bounds checked against size
+        static bool Read(u8* data, size_t size, ChunkView& view);
+
+        // Writes the view out using the version 8 layout
+        static bool Write(const ChunkView& view, std::vector<u8>& output);
+    };
+}
@@ -1,4 +1,5 @@
 #include "Map.h"
+#include "MapArchive.h"
 
 #include <Utils/ByteBuffer.h>
 #include <Utils/FileReader.h>
@@ -18,11 +19,32 @@ namespace Terrain
         return chunks.find(chunkId) != chunks.end();
     }
 
+    bool Map::HasChunkOnDisk(u16 chunkID) const
+    {
+        if (archive)
+            return archive->HasChunk(chunkID);
+
+        return chunkPaths.find(chunkID) != chunkPaths.end();
+    }
+
+    void Map::RemoveChunkFromDisk(u16 chunkID)
+    {
+        if (archive)
+            archive->RemoveChunk(chunkID);
+
+        chunkPaths.erase(chunkID);
+    }
+
     bool MapHeader::Read(FileReader& reader, Terrain::MapHeader& header)
     {
         Bytebuffer buffer(nullptr, reader.Length());
         reader.Read(&buffer, buffer.size);
 
+        return Read(buffer, header);
+    }
+
+    bool MapHeader::Read(Bytebuffer& buffer, Terrain::MapHeader& header)
+    {
         if (!buffer.GetU32(header.token))
             return false;
 
@@ -25,6 +25,7 @@
 #include <NovusTypes.h>
 #include <robin_hood.h>
 #include <limits>
+#include <memory>
 #include <Containers/StringTable.h>
 #include "Chunk.h"
 
@@ -34,8 +35,11 @@
 // A Cell consists of two interlapping grids. There is the 9*9 OUTER grid and the 8*8 INNER grid.
 
 class FileReader;
+class Bytebuffer;
 namespace Terrain
 {
+    class MapArchive;
+
     constexpr f32 MAP_SIZE = MAP_CHUNK_SIZE * MAP_CHUNKS_PER_MAP_STRIDE; // yards
     constexpr f32 MAP_HALF_SIZE = MAP_SIZE / 2.0f; // yards
 
@@ -55,12 +59,14 @@ namespace Terrain
         Placement mapObjectPlacement;
 
         static bool Read(FileReader& reader, Terrain::MapHeader& header);
+        static bool Read(Bytebuffer& buffer, Terrain::MapHeader& header);
     };
 
     struct PlacementDetails
     {
         u32 loadedIndex = 0;
         u32 instanceIndex = 0;
+        u32 uniqueID = 0; // The placement this instance came from, used to find the instances of a chunk when it gets unloaded
     };
 
     struct Map
@@ -73,6 +79,8 @@ namespace Terrain
         std::string_view name;
         robin_hood::unordered_map<u16, Chunk> chunks;
         robin_hood::unordered_map<u16, StringTable> stringTables;
+        robin_hood::unordered_map<u16, std::string> chunkPaths; // Only filled when chunks are streamed from loose files, maps every chunk on disk to its file
+        std::shared_ptr<MapArchive> archive; // Set when the map was loaded from a .nmapk, streamed chunks are read from it instead of chunkPaths
 
         bool IsLoadedMap() { return id != std::numeric_limits<u16>().max(); }
         bool IsMapLoaded(u16 newId) { return id == newId; }
@@ -88,6 +96,10 @@ namespace Terrain
         void GetChunkPositionFromChunkId(u16 chunkId, u16& x, u16& y) const;
         bool GetChunkIdFromChunkPosition(u16 x, u16 y, u16& chunkId) const;
 
+        // Whether a chunk that isn't loaded yet can be streamed in, either from the archive or from a loose file
+        bool HasChunkOnDisk(u16 chunkID) const;
+        void RemoveChunkFromDisk(u16 chunkID);
+
         void Clear()
         {
             id = std::numeric_limits<u16>().max();
@@ -106,6 +118,8 @@ namespace Terrain
                 itr.second.Clear();
             }
             stringTables.clear();
+            chunkPaths.clear();
+            archive.reset();
         }
     };
 }
\ No newline at end of file
@@ -0,0 +1,342 @@
+#include "MapArchive.h"
+#include "Map.h"
+#include "ChunkView.h"
+#include "../../Utils/MappedFile.h"
+
+#include <Utils/ByteBuffer.h>
+#include <Utils/DebugHandler.h>
+#include <Utils/StringUtils.h>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+namespace Terrain
+{
+    std::string MapArchive::GetArchivePath(const std::string& mapInternalName)
+    {
+        return "Data/extracted/maps/" + mapInternalName + ".nmapk";
+    }
+
+    std::string MapArchive::GetMapHeaderPath(const std::string& mapInternalName)
+    {
+        return "Data/extracted/maps/" + mapInternalName + "/" + mapInternalName + ".nmap";
+    }
+
+    bool MapArchive::Open(const std::string& path)
+    {
+        // Copy-on-write so the chunk views can be patched by border alignment, same as loose chunk files
+        std::shared_ptr<MappedFile> mappedFile = std::make_shared<MappedFile>();
+        if (!mappedFile->Open(path, MappedFile::Access::CopyOnWrite))
+            return false;
+
+        const u8* data = mappedFile->GetData();
+        const size_t size = mappedFile->GetSize();
+
+        const size_t tableOffset = sizeof(MapArchiveHeader);
+        const size_t tableSize = sizeof(MapArchiveChunkEntry) * MAP_CHUNKS_PER_MAP;
+        if (size < tableOffset + tableSize)
+        {
+            DebugHandler::PrintError("Map archive is too small to contain a chunk table (%s)", path.c_str());
+            return false;
+        }
+
+        std::memcpy(&_header, data, sizeof(MapArchiveHeader));
+        if (_header.token != MAP_ARCHIVE_TOKEN)
+        {
+            DebugHandler::PrintError("Tried to load a map archive with the wrong token (%s)", path.c_str());
+            return false;
+        }
+
+        if (_header.version != MAP_ARCHIVE_VERSION)
+        {
+            DebugHandler::PrintError("Loaded map archive with version %u instead of expected version of %u, repack the map (%s)", _header.version, MAP_ARCHIVE_VERSION, path.c_str());
+            return false;
+        }
+
+        if (static_cast<u64>(_header.mapHeaderOffset) + _header.mapHeaderSize > size)
+        {
+            DebugHandler::PrintError("Map archive header points outside of the file (%s)", path.c_str());
+            return false;
+        }
+
+        _chunkEntries.resize(MAP_CHUNKS_PER_MAP);
+        std::memcpy(_chunkEntries.data(), data + tableOffset, tableSize);
+
+        for (MapArchiveChunkEntry& entry : _chunkEntries)
+        {
+            if (entry.offset != 0 && entry.offset + entry.size > size)
+            {
+                DebugHandler::PrintError("Map archive has a chunk pointing outside of the file (%s)", path.c_str());
+                return false;
+            }
+        }
+
+        _mappedFile = std::move(mappedFile);
+        return true;
+    }
+
+    bool MapArchive::ReadMapHeader(MapHeader& header) const
+    {
+        Bytebuffer buffer(_mappedFile->GetData() + _header.mapHeaderOffset, _header.mapHeaderSize);
+        buffer.writtenData = _header.mapHeaderSize;
+
+        return MapHeader::Read(buffer, header);
+    }
+
+    bool MapArchive::ReadChunk(u16 chunkID, Terrain::Chunk& chunk, StringTable& stringTable) const
+    {
+        if (!HasChunk(chunkID))
+            return false;
+
+        // Every chunk gets its own view so the pages border alignment copied are released with the chunk instead of living as long as the archive
+        const MapArchiveChunkEntry& entry = _chunkEntries[chunkID];
+
+        size_t viewOffset = 0;
+        std::shared_ptr<MappedFile> chunkView = MappedFile::OpenView(_mappedFile, static_cast<size_t>(entry.offset), static_cast<size_t>(entry.size), MappedFile::Access::CopyOnWrite, viewOffset);
+        if (chunkView == nullptr)
+            return false;
+
+        return Chunk::Read(std::move(chunkView), viewOffset, static_cast<size_t>(entry.size), chunk, stringTable);
+    }
+
+    bool MapArchive::HasChunk(u16 chunkID) const
+    {
+        return chunkID < _chunkEntries.size() && _chunkEntries[chunkID].offset != 0;
+    }
+
+    void MapArchive::RemoveChunk(u16 chunkID)
+    {
+        if (chunkID < _chunkEntries.size())
+        {
+            _chunkEntries[chunkID] = MapArchiveChunkEntry();
+        }
+    }
+
+    void MapArchive::GetChunkIDs(std::vector<u16>& outChunkIDs) const
+    {
+        outChunkIDs.reserve(outChunkIDs.size() + _header.numChunks);
+
+        for (u32 i = 0; i < _chunkEntries.size(); i++)
+        {
+            if (_chunkEntries[i].offset != 0)
+                outChunkIDs.push_back(static_cast<u16>(i));
+        }
+    }
+
+    const std::string& MapArchive::GetPath() const
+    {
+        return _mappedFile->GetPath();
+    }
+
+    static u64 AlignChunkOffset(u64 offset)
+    {
+        return (offset + MAP_ARCHIVE_CHUNK_ALIGNMENT - 1) & ~static_cast<u64>(MAP_ARCHIVE_CHUNK_ALIGNMENT - 1);
+    }
+
+    static bool ReadFileBytes(const fs::path& path, std::vector<u8>& output)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+
+        output.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(output.data()), output.size());
+
+        return static_cast<bool>(file);
+    }
+
+    static void FindMapFiles(const fs::path& mapDirectory, const std::string& mapInternalName, fs::path& outMapHeaderPath, std::vector<fs::path>& outChunkPaths)
+    {
+        outChunkPaths.resize(MAP_CHUNKS_PER_MAP);
+
+        for (const auto& entry : fs::recursive_directory_iterator(mapDirectory))
+        {
+            const fs::path& file = entry.path();
+
+            if (file.extension() == ".nmap")
+            {
+                if (file.stem().string() == mapInternalName)
+                    outMapHeaderPath = file;
+
+                continue;
+            }
+
+            if (file.extension() != ".nchunk")
+                continue;
+
+            // Make sure filename is the same, multiple maps can have chunks in the same folder
+            std::string fileName = file.stem().string();
+            if (strncmp(fileName.c_str(), mapInternalName.c_str(), mapInternalName.length()) != 0)
+                continue;
+
+            std::vector<std::string> splitName = StringUtils::SplitString(fileName, '_');
+            size_t numberOfSplits = splitName.size();
+            if (numberOfSplits < 3)
+                continue;
+
+            u16 x = std::stoi(splitName[numberOfSplits - 2]);
+            u16 y = std::stoi(splitName[numberOfSplits - 1]);
+            u32 chunkID = x + (y * MAP_CHUNKS_PER_MAP_STRIDE);
+
+            if (chunkID < MAP_CHUNKS_PER_MAP)
+                outChunkPaths[chunkID] = file;
+        }
+    }
+
+    static bool GetSourceStat(const fs::path& mapHeaderPath, u64& outSize, i64& outWriteTime)
+    {
+        std::error_code errorCode;
+        const uintmax_t size = fs::file_size(mapHeaderPath, errorCode);
+        if (errorCode)
+            return false;
+
+        const fs::file_time_type writeTime = fs::last_write_time(mapHeaderPath, errorCode);
+        if (errorCode)
+            return false;
+
+        outSize = static_cast<u64>(size);
+        outWriteTime = static_cast<i64>(writeTime.time_since_epoch().count());
+        return true;
+    }
+
+    bool MapArchive::IsOutOfDate(const std::string& mapInternalName) const
+    {
+        u64 sourceSize = 0;
+        i64 sourceWriteTime = 0;
+        if (!GetSourceStat(fs::absolute(GetMapHeaderPath(mapInternalName)), sourceSize, sourceWriteTime))
+            return false; // Nothing to compare against, the archive is all we have
+
+        return sourceSize != _header.sourceSize || sourceWriteTime != _header.sourceWriteTime;
+    }
+
+    static bool WriteArchive(const fs::path& path, MapArchiveHeader& header, std::vector<MapArchiveChunkEntry>& chunkEntries, const std::vector<u8>& mapHeaderBytes, const std::vector<fs::path>& chunkPaths)
+    {
+        std::ofstream outputFile(path, std::ios::out | std::ios::binary);
+        if (!outputFile)
+        {
+            DebugHandler::PrintError("Failed to create file (%s)", path.string().c_str());
+            return false;
+        }
+
+        outputFile.write(reinterpret_cast<const char*>(&header), sizeof(MapArchiveHeader));
+        outputFile.write(reinterpret_cast<const char*>(chunkEntries.data()), sizeof(MapArchiveChunkEntry) * chunkEntries.size());
+        outputFile.write(reinterpret_cast<const char*>(mapHeaderBytes.data()), mapHeaderBytes.size());
+
+        const char padding[MAP_ARCHIVE_CHUNK_ALIGNMENT] = {};
+        std::vector<u8> convertedBytes;
+
+        for (u32 i = 0; i < MAP_CHUNKS_PER_MAP; i++)
+        {
+            if (chunkPaths[i].empty())
+                continue;
+
+            MappedFile mappedFile;
+            if (!mappedFile.Open(chunkPaths[i].string(), MappedFile::Access::ReadOnly))
+                return false;
+
+            ChunkView view;
+            if (!ChunkView::Read(mappedFile.GetData(), mappedFile.GetSize(), view))
+            {
+                DebugHandler::PrintError("Failed to read map chunk for packing (%s)", chunkPaths[i].string().c_str());
+                return false;
+            }
+
+            // Store every chunk in the mapped layout so reading it from the archive never needs a copy
+            const u8* chunkData = mappedFile.GetData();
+            size_t chunkSize = mappedFile.GetSize();
+
+            if (view.version != static_cast<u32>(MAP_CHUNK_MAPPED_VERSION))
+            {
+                if (!ChunkView::Write(view, convertedBytes))
+                {
+                    DebugHandler::PrintError("Failed to convert map chunk for packing (%s)", chunkPaths[i].string().c_str());
+                    return false;
+                }
+
+                chunkData = convertedBytes.data();
+                chunkSize = convertedBytes.size();
+            }
+
+            const u64 position = static_cast<u64>(outputFile.tellp());
+            const u64 offset = AlignChunkOffset(position);
+            outputFile.write(padding, offset - position);
+            outputFile.write(reinterpret_cast<const char*>(chunkData), chunkSize);
+
+            chunkEntries[i].offset = offset;
+            chunkEntries[i].size = chunkSize;
+            header.numChunks++;
+        }
+
+        outputFile.seekp(0);
+        outputFile.write(reinterpret_cast<const char*>(&header), sizeof(MapArchiveHeader));
+        outputFile.write(reinterpret_cast<const char*>(chunkEntries.data()), sizeof(MapArchiveChunkEntry) * chunkEntries.size());
+
+        if (!outputFile)
+        {
+            DebugHandler::PrintError("Failed to write file (%s)", path.string().c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool MapArchive::Pack(const std::string& mapInternalName)
+    {
+        fs::path mapDirectory = fs::absolute("Data/extracted/maps/" + mapInternalName);
+        if (!fs::is_directory(mapDirectory))
+        {
+            DebugHandler::PrintError("Failed to find map folder for %s", mapInternalName.c_str());
+            return false;
+        }
+
+        fs::path mapHeaderPath;
+        std::vector<fs::path> chunkPaths;
+        FindMapFiles(mapDirectory, mapInternalName, mapHeaderPath, chunkPaths);
+
+        std::vector<u8> mapHeaderBytes;
+        if (mapHeaderPath.empty() || !ReadFileBytes(mapHeaderPath, mapHeaderBytes))
+        {
+            DebugHandler::PrintError("Failed to find nmap file for map (%s)", mapInternalName.c_str());
+            return false;
+        }
+
+        // Header, chunk table and map header go first, every chunk after that starts on its own aligned offset
+        // The table is only known once every chunk is written, so it gets written twice
+        MapArchiveHeader header;
+        std::vector<MapArchiveChunkEntry> chunkEntries(MAP_CHUNKS_PER_MAP);
+
+        header.mapHeaderOffset = static_cast<u32>(sizeof(MapArchiveHeader) + sizeof(MapArchiveChunkEntry) * MAP_CHUNKS_PER_MAP);
+        header.mapHeaderSize = static_cast<u32>(mapHeaderBytes.size());
+        GetSourceStat(fs::absolute(GetMapHeaderPath(mapInternalName)), header.sourceSize, header.sourceWriteTime);
+
+        // Write next to the final archive and swap it in afterwards so a failed write never leaves a broken archive behind
+        fs::path archivePath = fs::absolute(GetArchivePath(mapInternalName));
+        fs::path tempPath = archivePath.string() + ".tmp";
+
+        std::error_code errorCode;
+        if (!WriteArchive(tempPath, header, chunkEntries, mapHeaderBytes, chunkPaths))
+        {
+            fs::remove(tempPath, errorCode);
+            return false;
+        }
+
+        if (header.numChunks == 0)
+        {
+            DebugHandler::PrintWarning("Packed map (%s) has no chunks", mapInternalName.c_str());
+        }
+
+        fs::rename(tempPath, archivePath, errorCode);
+        if (errorCode)
+        {
+            DebugHandler::PrintError("Failed to replace map archive (%s): %s", archivePath.string().c_str(), errorCode.message().c_str());
+            fs::remove(tempPath, errorCode);
+            return false;
+        }
+
+        DebugHandler::PrintSuccess("Packed %u map chunks into (%s)", header.numChunks, archivePath.string().c_str());
+        return true;
+    }
+}
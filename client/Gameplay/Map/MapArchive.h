@@ -0,0 +1,72 @@
+#pragma once
+#include <NovusTypes.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Chunk.h"
+
+class MappedFile;
+namespace Terrain
+{
+    struct MapHeader;
+
+    // A .nmapk packs the .nmap header and every .nchunk of a map into a single file
+    // The chunk table is indexed by chunk ID so finding a chunk is a single lookup, chunk data starts on MAP_ARCHIVE_CHUNK_ALIGNMENT boundaries
+    constexpr u32 MAP_ARCHIVE_TOKEN = 1313685835; // UTF8 -> Binary -> Decimal for "nmpk"
+    constexpr u32 MAP_ARCHIVE_VERSION = 2;
+    constexpr u32 MAP_ARCHIVE_CHUNK_ALIGNMENT = 4096;
+
+    struct MapArchiveHeader
+    {
+        u32 token = MAP_ARCHIVE_TOKEN;
+        u32 version = MAP_ARCHIVE_VERSION;
+
+        u32 numChunks = 0;
+
+        u32 mapHeaderOffset = 0;
+        u32 mapHeaderSize = 0;
+
+        // Size and write time of the .nmap the archive was packed from, a single stat of it tells whether the map was extracted again
+        u64 sourceSize = 0;
+        i64 sourceWriteTime = 0;
+    };
+
+    struct MapArchiveChunkEntry
+    {
+        u64 offset = 0; // 0 means the chunk does not exist
+        u64 size = 0;
+    };
+
+    // The archive is mapped once and every chunk read from it gets a view of that mapping, so loading a chunk never opens a file
+    class MapArchive
+    {
+    public:
+        static std::string GetArchivePath(const std::string& mapInternalName);
+        static std::string GetMapHeaderPath(const std::string& mapInternalName);
+
+        bool Open(const std::string& path);
+
+        bool ReadMapHeader(MapHeader& header) const;
+        bool ReadChunk(u16 chunkID, Terrain::Chunk& chunk, StringTable& stringTable) const;
+
+        bool HasChunk(u16 chunkID) const;
+        // Stops the chunk from being handed out again, used when a chunk in the archive turns out to be broken
+        void RemoveChunk(u16 chunkID);
+
+        void GetChunkIDs(std::vector<u16>& outChunkIDs) const;
+        u32 GetNumChunks() const { return _header.numChunks; }
+        const std::string& GetPath() const;
+
+        // Packs Data/extracted/maps/<mapInternalName> into GetArchivePath(mapInternalName), chunks get converted to the mapped layout on the way
+        static bool Pack(const std::string& mapInternalName);
+        // Whether the .nmap on disk differs from the one this archive was packed from, false when there are no loose files to compare against
+        bool IsOutOfDate(const std::string& mapInternalName) const;
+
+    private:
+        std::shared_ptr<MappedFile> _mappedFile;
+
+        MapArchiveHeader _header;
+        std::vector<MapArchiveChunkEntry> _chunkEntries;
+    };
+}
@@ -45,6 +45,7 @@ constexpr u32 MATRIX_WIDTH = BITONIC_BLOCK_SIZE;
 
 CModelRenderer::CModelRenderer(Renderer::Renderer* renderer, DebugRenderer* debugRenderer)
     : _renderer(renderer)
+    , _loadTaskflow(ServiceLocator::GetTaskExecutor())
     , _debugRenderer(debugRenderer)
 {
     CreatePermanentResources();
@@ -167,6 +168,11 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
         data.mainObject = builder.Write(objectTarget, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
         data.mainDepth = builder.Write(depthTarget, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
 
+        if (cullingEnabled)
+        {
+            builder.Read(occlusionPyramid, Renderer::RenderGraphBuilder::ShaderStage::COMPUTE);
+        }
+
         return true; // Return true from setup to enable this pass, return false to disable it
     },
         [=](CModelPassData& data, Renderer::RenderGraphResources& resources, Renderer::CommandList& commandList)
@@ -180,6 +186,10 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
             AnimationRequest animationRequest;
             while (_animationRequests.try_dequeue(animationRequest))
             {
+                // Compaction remaps queued requests, this only catches requests for instances that never existed
+                if (animationRequest.instanceId >= _instances.size())
+                    continue;
+
                 Instance& instance = _instances[animationRequest.instanceId];
 
                 LoadedComplexModel& complexModel = _loadedComplexModels[instance.modelId];
@@ -273,8 +283,8 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
         {
             commandList.PushMarker("Clear instance visibility", Color::Grey);
             commandList.FillBuffer(_visibleInstanceCountBuffer, 0, sizeof(u32), 0);
-            commandList.FillBuffer(_visibleInstanceMaskBuffer, 0, sizeof(u32) * ((numInstances + 31) / 32), 0);
-            commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToComputeShaderRW, _visibleInstanceMaskBuffer);
+            commandList.FillBuffer(_visibleInstanceMaskBuffer.buffer, 0, sizeof(u32) * ((numInstances + 31) / 32), 0);
+            commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToComputeShaderRW, _visibleInstanceMaskBuffer.buffer);
             commandList.PopMarker();
         }
 
@@ -302,14 +312,14 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
             cullConstants->occlusionCull = CVAR_ComplexModelOcclusionCullEnabled.Get();
             commandList.PushConstant(cullConstants, 0, sizeof(CullConstants));
 
-            _cullingDescriptorSet.Bind("_packedDrawCallDatas", _opaqueDrawCallDataBuffer);
-            _cullingDescriptorSet.Bind("_drawCalls", _opaqueDrawCallBuffer);
-            _cullingDescriptorSet.Bind("_culledDrawCalls", _opaqueCulledDrawCallBuffer);
+            _cullingDescriptorSet.Bind("_packedDrawCallDatas", _opaqueDrawCallDataBuffer.buffer);
+            _cullingDescriptorSet.Bind("_drawCalls", _opaqueDrawCallBuffer.buffer);
+            _cullingDescriptorSet.Bind("_culledDrawCalls", _opaqueCulledDrawCallBuffer.buffer);
             _cullingDescriptorSet.Bind("_drawCount", _opaqueDrawCountBuffer);
             _cullingDescriptorSet.Bind("_triangleCount", _opaqueTriangleCountBuffer);
-            _cullingDescriptorSet.Bind("_instances", _instanceBuffer);
-            _cullingDescriptorSet.Bind("_cullingDatas", _cullingDataBuffer);
-            _cullingDescriptorSet.Bind("_visibleInstanceMask", _visibleInstanceMaskBuffer);
+            _cullingDescriptorSet.Bind("_instances", _instanceBuffer.buffer);
+            _cullingDescriptorSet.Bind("_cullingDatas", _cullingDataBuffer.buffer);
+            _cullingDescriptorSet.Bind("_visibleInstanceMask", _visibleInstanceMaskBuffer.buffer);
 
             Renderer::SamplerDesc samplerDesc;
             samplerDesc.filter = Renderer::SamplerFilter::MINIMUM_MIN_MAG_MIP_LINEAR;
@@ -327,8 +337,8 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
             _cullingDescriptorSet.Bind("_depthPyramid", occlusionPyramid);
 
             // These two are not actually used by the culling shader unless shouldPrepareSort is enabled, but they need to be bound to avoid validation errors...
-            _cullingDescriptorSet.Bind("_sortKeys", _transparentSortKeys);
-            _cullingDescriptorSet.Bind("_sortValues", _transparentSortValues);
+            _cullingDescriptorSet.Bind("_sortKeys", _transparentSortKeys.buffer);
+            _cullingDescriptorSet.Bind("_sortValues", _transparentSortValues.buffer);
 
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_cullingDescriptorSet, frameIndex);
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, globalDescriptorSet, frameIndex);
@@ -337,7 +347,7 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
 
             commandList.EndPipeline(pipeline);
 
-            commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToIndirectArguments, _opaqueCulledDrawCallBuffer);
+            commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToIndirectArguments, _opaqueCulledDrawCallBuffer.buffer);
             commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToIndirectArguments, _opaqueDrawCountBuffer);
 
             commandList.PopMarker();
@@ -383,17 +393,17 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
             cullConstants->occlusionCull = CVAR_ComplexModelOcclusionCullEnabled.Get();
             commandList.PushConstant(cullConstants, 0, sizeof(CullConstants));
 
-            _cullingDescriptorSet.Bind("_packedDrawCallDatas", _transparentDrawCallDataBuffer);
-            _cullingDescriptorSet.Bind("_drawCalls", _transparentDrawCallBuffer);
-            _cullingDescriptorSet.Bind("_culledDrawCalls", _transparentCulledDrawCallBuffer);
+            _cullingDescriptorSet.Bind("_packedDrawCallDatas", _transparentDrawCallDataBuffer.buffer);
+            _cullingDescriptorSet.Bind("_drawCalls", _transparentDrawCallBuffer.buffer);
+            _cullingDescriptorSet.Bind("_culledDrawCalls", _transparentCulledDrawCallBuffer.buffer);
             _cullingDescriptorSet.Bind("_drawCount", _transparentDrawCountBuffer);
             _cullingDescriptorSet.Bind("_triangleCount", _transparentTriangleCountBuffer);
-            _cullingDescriptorSet.Bind("_instances", _instanceBuffer);
-            _cullingDescriptorSet.Bind("_cullingDatas", _cullingDataBuffer);
-            _cullingDescriptorSet.Bind("_visibleInstanceMask", _visibleInstanceMaskBuffer);
+            _cullingDescriptorSet.Bind("_instances", _instanceBuffer.buffer);
+            _cullingDescriptorSet.Bind("_cullingDatas", _cullingDataBuffer.buffer);
+            _cullingDescriptorSet.Bind("_visibleInstanceMask", _visibleInstanceMaskBuffer.buffer);
 
-            _cullingDescriptorSet.Bind("_sortKeys", _transparentSortKeys);
-            _cullingDescriptorSet.Bind("_sortValues", _transparentSortValues);
+            _cullingDescriptorSet.Bind("_sortKeys", _transparentSortKeys.buffer);
+            _cullingDescriptorSet.Bind("_sortValues", _transparentSortValues.buffer);
 
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_cullingDescriptorSet, frameIndex);
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, globalDescriptorSet, frameIndex);
@@ -414,7 +424,7 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
         // Compact visible instance IDs
         {
             commandList.PushMarker("Visible Instance Compaction", Color::Grey);
-            commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _visibleInstanceMaskBuffer);
+            commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _visibleInstanceMaskBuffer.buffer);
 
             Renderer::ComputePipelineDesc compactPipelineDesc;
             resources.InitializePipelineDesc(compactPipelineDesc);
@@ -426,9 +436,9 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
             Renderer::ComputePipelineID pipeline = _renderer->CreatePipeline(compactPipelineDesc);
 
             Renderer::DescriptorSet descriptorSet;
-            descriptorSet.Bind("_visibleInstanceMask", _visibleInstanceMaskBuffer);
+            descriptorSet.Bind("_visibleInstanceMask", _visibleInstanceMaskBuffer.buffer);
             descriptorSet.Bind("_visibleInstanceCount", _visibleInstanceCountBuffer);
-            descriptorSet.Bind("_visibleInstanceIDs", _visibleInstanceIndexBuffer);
+            descriptorSet.Bind("_visibleInstanceIDs", _visibleInstanceIndexBuffer.buffer);
 
             commandList.BeginPipeline(pipeline);
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_DRAW, &descriptorSet, frameIndex);
@@ -483,7 +493,7 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
         {
             commandList.PushMarker("Animation Prepass", Color::Cyan);
 
-            commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _visibleInstanceIndexBuffer);
+            commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _visibleInstanceIndexBuffer.buffer);
 
             Renderer::ComputePipelineDesc animationprepassPipelineDesc;
             resources.InitializePipelineDesc(animationprepassPipelineDesc);
@@ -515,16 +525,16 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
             }
 
             _animationPrepassDescriptorSet.Bind("_visibleInstanceCount", _visibleInstanceCountBuffer);
-            _animationPrepassDescriptorSet.Bind("_visibleInstanceIndices", _visibleInstanceIndexBuffer);
-            _animationPrepassDescriptorSet.Bind("_instances", _instanceBuffer);
-            _animationPrepassDescriptorSet.Bind("_animationSequence", _animationSequenceBuffer);
-            _animationPrepassDescriptorSet.Bind("_animationModelInfo", _animationModelInfoBuffer);
-            _animationPrepassDescriptorSet.Bind("_animationBoneInfo", _animationBoneInfoBuffer);
+            _animationPrepassDescriptorSet.Bind("_visibleInstanceIndices", _visibleInstanceIndexBuffer.buffer);
+            _animationPrepassDescriptorSet.Bind("_instances", _instanceBuffer.buffer);
+            _animationPrepassDescriptorSet.Bind("_animationSequence", _animationSequenceBuffer.buffer);
+            _animationPrepassDescriptorSet.Bind("_animationModelInfo", _animationModelInfoBuffer.buffer);
+            _animationPrepassDescriptorSet.Bind("_animationBoneInfo", _animationBoneInfoBuffer.buffer);
             _animationPrepassDescriptorSet.Bind("_animationBoneDeformMatrix", _animationBoneDeformMatrixBuffer);
             _animationPrepassDescriptorSet.Bind("_animationBoneInstances", _animationBoneInstancesBuffer);
-            _animationPrepassDescriptorSet.Bind("_animationTrackInfo", _animationTrackInfoBuffer);
-            _animationPrepassDescriptorSet.Bind("_animationTrackTimestamp", _animationTrackTimestampBuffer);
-            _animationPrepassDescriptorSet.Bind("_animationTrackValue", _animationTrackValueBuffer);
+            _animationPrepassDescriptorSet.Bind("_animationTrackInfo", _animationTrackInfoBuffer.buffer);
+            _animationPrepassDescriptorSet.Bind("_animationTrackTimestamp", _animationTrackTimestampBuffer.buffer);
+            _animationPrepassDescriptorSet.Bind("_animationTrackValue", _animationTrackValueBuffer.buffer);
 
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::DEBUG, debugDescriptorSet, frameIndex);
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_animationPrepassDescriptorSet, frameIndex);
@@ -533,7 +543,7 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
 
             commandList.EndPipeline(pipeline);
 
-            commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _instanceBuffer);
+            commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _instanceBuffer.buffer);
             commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToVertexShaderRead, _animationBoneDeformMatrixBuffer);
 
             commandList.PopMarker();
@@ -550,11 +560,11 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
 
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, globalDescriptorSet, frameIndex);
 
-            _passDescriptorSet.Bind("_packedDrawCallDatas", _opaqueDrawCallDataBuffer);
-            _passDescriptorSet.Bind("_packedVertices", _vertexBuffer);
+            _passDescriptorSet.Bind("_packedDrawCallDatas", _opaqueDrawCallDataBuffer.buffer);
+            _passDescriptorSet.Bind("_packedVertices", _vertexBuffer.buffer);
             _passDescriptorSet.Bind("_textures", _cModelTextures);
-            _passDescriptorSet.Bind("_textureUnits", _textureUnitBuffer);
-            _passDescriptorSet.Bind("_instances", _instanceBuffer);
+            _passDescriptorSet.Bind("_textureUnits", _textureUnitBuffer.buffer);
+            _passDescriptorSet.Bind("_instances", _instanceBuffer.buffer);
             _passDescriptorSet.Bind("_animationBoneDeformMatrix", _animationBoneDeformMatrixBuffer);
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
 
@@ -562,9 +572,9 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
             constants->isTransparent = false;
             commandList.PushConstant(constants, 0, sizeof(Constants));
 
-            commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+            commandList.SetIndexBuffer(_indexBuffer.buffer, Renderer::IndexFormat::UInt16);
             
-            Renderer::BufferID argumentBuffer = (cullingEnabled) ? _opaqueCulledDrawCallBuffer : _opaqueDrawCallBuffer;
+            Renderer::BufferID argumentBuffer = (cullingEnabled) ? _opaqueCulledDrawCallBuffer.buffer : _opaqueDrawCallBuffer.buffer;
             commandList.DrawIndexedIndirectCount(argumentBuffer, 0, _opaqueDrawCountBuffer, 0, numOpaqueDrawCalls);
 
             commandList.EndPipeline(pipeline);
@@ -595,16 +605,16 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
                 {
                     // Barriers
                     commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _transparentDrawCountBuffer);
-                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToTransferSrc, _transparentSortKeys);
-                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToTransferSrc, _transparentSortValues);
+                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToTransferSrc, _transparentSortKeys.buffer);
+                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToTransferSrc, _transparentSortValues.buffer);
 
                     SortUtils::SortIndirectCountParams sortParams;
                     sortParams.maxNumKeys = numTransparentDrawCalls;
                     sortParams.maxThreadGroups = 800; // I am not sure why this is set to 800, but the sample code used this value so I'll go with it
 
                     sortParams.numKeysBuffer = _transparentDrawCountBuffer;
-                    sortParams.keysBuffer = _transparentSortKeys;
-                    sortParams.valuesBuffer = _transparentSortValues;
+                    sortParams.keysBuffer = _transparentSortKeys.buffer;
+                    sortParams.valuesBuffer = _transparentSortValues.buffer;
 
                     SortUtils::SortIndirectCount(_renderer, resources, commandList, frameIndex, sortParams);
                 }
@@ -614,9 +624,9 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
                     commandList.PushMarker("ApplySort", Color::White);
 
                     // Barriers
-                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _transparentCulledDrawCallBuffer);
-                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToComputeShaderRW, _transparentSortKeys);
-                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToComputeShaderRW, _transparentSortValues);
+                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _transparentCulledDrawCallBuffer.buffer);
+                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToComputeShaderRW, _transparentSortKeys.buffer);
+                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToComputeShaderRW, _transparentSortValues.buffer);
 
                     Renderer::ComputeShaderDesc shaderDesc;
                     shaderDesc.path = "cModelApplySort.cs.hlsl";
@@ -626,18 +636,18 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
                     Renderer::ComputePipelineID pipeline = _renderer->CreatePipeline(pipelineDesc);
                     commandList.BeginPipeline(pipeline);
 
-                    _sortingDescriptorSet.Bind("_sortKeys", _transparentSortKeys);
-                    _sortingDescriptorSet.Bind("_sortValues", _transparentSortValues);
+                    _sortingDescriptorSet.Bind("_sortKeys", _transparentSortKeys.buffer);
+                    _sortingDescriptorSet.Bind("_sortValues", _transparentSortValues.buffer);
                     _sortingDescriptorSet.Bind("_culledDrawCount", _transparentDrawCountBuffer);
-                    _sortingDescriptorSet.Bind("_culledDrawCalls", _transparentCulledDrawCallBuffer);
-                    _sortingDescriptorSet.Bind("_sortedCulledDrawCalls", _transparentSortedCulledDrawCallBuffer);
+                    _sortingDescriptorSet.Bind("_culledDrawCalls", _transparentCulledDrawCallBuffer.buffer);
+                    _sortingDescriptorSet.Bind("_sortedCulledDrawCalls", _transparentSortedCulledDrawCallBuffer.buffer);
                     commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_sortingDescriptorSet, frameIndex);
 
                     commandList.Dispatch((numTransparentDrawCalls + 31) / 32, 1, 1);
 
                     commandList.EndPipeline(pipeline);
 
-                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _transparentSortedCulledDrawCallBuffer);
+                    commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _transparentSortedCulledDrawCallBuffer.buffer);
                     commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToTransferSrc, _transparentTriangleCountReadBackBuffer);
 
                     commandList.PopMarker();
@@ -652,19 +662,19 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
             {
                 if (alphaSortEnabled)
                 {
-                    drawCallBuffer = _transparentSortedCulledDrawCallBuffer;
+                    drawCallBuffer = _transparentSortedCulledDrawCallBuffer.buffer;
                 }
                 else
                 {
-                    drawCallBuffer = _transparentCulledDrawCallBuffer;
+                    drawCallBuffer = _transparentCulledDrawCallBuffer.buffer;
                 }
                 commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToIndirectArguments, drawCallBuffer);
                 commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToIndirectArguments, _transparentDrawCountBuffer);
             }
             else
             {
-                drawCallBuffer = _transparentCulledDrawCallBuffer;
-                commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToIndirectArguments, _transparentCulledDrawCallBuffer);
+                drawCallBuffer = _transparentCulledDrawCallBuffer.buffer;
+                commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToIndirectArguments, _transparentCulledDrawCallBuffer.buffer);
                 commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToIndirectArguments, _transparentDrawCountBuffer);
             }
 
@@ -682,11 +692,11 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
 
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, globalDescriptorSet, frameIndex);
 
-            _passDescriptorSet.Bind("_packedDrawCallDatas", _transparentDrawCallDataBuffer);
-            _passDescriptorSet.Bind("_packedVertices", _vertexBuffer);
+            _passDescriptorSet.Bind("_packedDrawCallDatas", _transparentDrawCallDataBuffer.buffer);
+            _passDescriptorSet.Bind("_packedVertices", _vertexBuffer.buffer);
             _passDescriptorSet.Bind("_textures", _cModelTextures);
-            _passDescriptorSet.Bind("_textureUnits", _textureUnitBuffer);
-            _passDescriptorSet.Bind("_instances", _instanceBuffer);
+            _passDescriptorSet.Bind("_textureUnits", _textureUnitBuffer.buffer);
+            _passDescriptorSet.Bind("_instances", _instanceBuffer.buffer);
             _passDescriptorSet.Bind("_animationBoneDeformMatrix", _animationBoneDeformMatrixBuffer);
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
 
@@ -694,7 +704,7 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, con
             constants->isTransparent = true;
             commandList.PushConstant(constants, 0, sizeof(Constants));
 
-            commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+            commandList.SetIndexBuffer(_indexBuffer.buffer, Renderer::IndexFormat::UInt16);
 
             if (cullingEnabled)
             {
@@ -731,26 +741,184 @@ void CModelRenderer::RegisterLoadFromChunk(u16 chunkID, const Terrain::Chunk& ch
         if (_uniqueIdCounter[uniqueID]++ == 0)
         {
             ComplexModelToBeLoaded& modelToBeLoaded = _complexModelsToBeLoaded.emplace_back();
-            modelToBeLoaded.placement = &placement;
-            modelToBeLoaded.name = &stringTable.GetString(placement.nameID);
+            modelToBeLoaded.placement = placement;
+            modelToBeLoaded.name = stringTable.GetString(placement.nameID);
             modelToBeLoaded.nameHash = stringTable.GetStringHash(placement.nameID);
         }
     }
 }
 
+void CModelRenderer::UnloadChunk(u16 chunkID, const Terrain::Chunk& chunk)
+{
+    ZoneScoped;
+
+    _mapChunkToPlacementOffset.erase(chunkID);
+
+    // Placements that also sit in a chunk that is still loaded keep their instance
+    robin_hood::unordered_set<u32> removedUniqueIDs;
+    for (const Terrain::Placement& placement : chunk.complexModelPlacements)
+    {
+        auto it = _uniqueIdCounter.find(placement.uniqueID);
+        if (it == _uniqueIdCounter.end())
+            continue;
+
+        if (--it->second == 0)
+        {
+            _uniqueIdCounter.erase(it);
+            removedUniqueIDs.insert(placement.uniqueID);
+        }
+    }
+
+    if (removedUniqueIDs.empty())
+        return;
+
+    // Placements that haven't been loaded yet and aren't referenced by any resident chunk anymore
+    auto removedModelsToBeLoaded = std::remove_if(_complexModelsToBeLoaded.begin(), _complexModelsToBeLoaded.end(), [&removedUniqueIDs](const ComplexModelToBeLoaded& modelToBeLoaded)
+    {
+        return removedUniqueIDs.find(modelToBeLoaded.placement.uniqueID) != removedUniqueIDs.end();
+    });
+    _complexModelsToBeLoaded.erase(removedModelsToBeLoaded, _complexModelsToBeLoaded.end());
+
+    RemoveInstances(removedUniqueIDs);
+}
+
+void CModelRenderer::RemoveInstances(const robin_hood::unordered_set<u32>& removedUniqueIDs)
+{
+    _opaqueDrawCallDataIndexToLoadedModelIndex.clear();
+    _transparentDrawCallDataIndexToLoadedModelIndex.clear();
+
+    // AddInstance appended the draw calls in instance order, so they get compacted along with the instances
+    u32 numKeptInstances = 0;
+    u32 opaqueDrawCallIndex = 0;
+    u32 numKeptOpaqueDrawCalls = 0;
+    u32 transparentDrawCallIndex = 0;
+    u32 numKeptTransparentDrawCalls = 0;
+
+    std::vector<u32> oldToNewInstanceID(_instances.size(), std::numeric_limits<u32>().max());
+
+    for (u32 i = 0; i < _instances.size(); i++)
+    {
+        Terrain::PlacementDetails& placementDetails = _complexModelPlacementDetails[i];
+        LoadedComplexModel& complexModel = _loadedComplexModels[placementDetails.loadedIndex];
+
+        if (removedUniqueIDs.find(placementDetails.uniqueID) != removedUniqueIDs.end())
+        {
+            complexModel.numInstances--;
+
+            if (_instances[i].boneDeformOffset != std::numeric_limits<u32>().max())
+            {
+                _animationBoneDeformRangeAllocator.Free(_instanceBoneDeformRangeFrames[i]);
+                _animationBoneInstancesRangeAllocator.Free(_instanceBoneInstanceRangeFrames[i]);
+            }
+
+            opaqueDrawCallIndex += complexModel.numOpaqueDrawCalls;
+            transparentDrawCallIndex += complexModel.numTransparentDrawCalls;
+            continue;
+        }
+
+        auto MoveDrawCalls = [&complexModel, numKeptInstances](u32 numDrawCalls, std::vector<DrawCall>& drawCalls, std::vector<DrawCallData>& drawCallDatas,
+            robin_hood::unordered_map<u32, u32>& drawCallDataIndexToLoadedModelIndex, u32& drawCallIndex, u32& numKeptDrawCalls)
+        {
+            for (u32 j = 0; j < numDrawCalls; j++, drawCallIndex++, numKeptDrawCalls++)
+            {
+                drawCalls[numKeptDrawCalls] = drawCalls[drawCallIndex];
+                drawCalls[numKeptDrawCalls].firstInstance = numKeptDrawCalls;
+
+                drawCallDatas[numKeptDrawCalls] = drawCallDatas[drawCallIndex];
+                drawCallDatas[numKeptDrawCalls].instanceID = numKeptInstances;
+
+                drawCallDataIndexToLoadedModelIndex[numKeptDrawCalls] = complexModel.objectID;
+            }
+        };
+        MoveDrawCalls(complexModel.numOpaqueDrawCalls, _opaqueDrawCalls, _opaqueDrawCallDatas, _opaqueDrawCallDataIndexToLoadedModelIndex, opaqueDrawCallIndex, numKeptOpaqueDrawCalls);
+        MoveDrawCalls(complexModel.numTransparentDrawCalls, _transparentDrawCalls, _transparentDrawCallDatas, _transparentDrawCallDataIndexToLoadedModelIndex, transparentDrawCallIndex, numKeptTransparentDrawCalls);
+
+        _instances[numKeptInstances] = _instances[i];
+        _instanceBoneDeformRangeFrames[numKeptInstances] = _instanceBoneDeformRangeFrames[i];
+        _instanceBoneInstanceRangeFrames[numKeptInstances] = _instanceBoneInstanceRangeFrames[i];
+
+        _complexModelPlacementDetails[numKeptInstances] = placementDetails;
+        _complexModelPlacementDetails[numKeptInstances].instanceIndex = numKeptInstances;
+
+        oldToNewInstanceID[i] = numKeptInstances;
+        numKeptInstances++;
+    }
+
+    _instances.resize(numKeptInstances);
+    _instanceBoneDeformRangeFrames.resize(numKeptInstances);
+    _instanceBoneInstanceRangeFrames.resize(numKeptInstances);
+    _complexModelPlacementDetails.resize(numKeptInstances);
+
+    _opaqueDrawCalls.resize(numKeptOpaqueDrawCalls);
+    _opaqueDrawCallDatas.resize(numKeptOpaqueDrawCalls);
+    _transparentDrawCalls.resize(numKeptTransparentDrawCalls);
+    _transparentDrawCallDatas.resize(numKeptTransparentDrawCalls);
+
+    RemapAnimationRequests(oldToNewInstanceID);
+
+    InvalidateInstanceBuffers();
+    _hasRemovedInstances = true;
+}
+
+void CModelRenderer::RemapAnimationRequests(const std::vector<u32>& oldToNewInstanceID)
+{
+    if (_animationRequests.size_approx() == 0)
+        return;
+
+    std::vector<AnimationRequest> animationRequests;
+
+    AnimationRequest animationRequest;
+    while (_animationRequests.try_dequeue(animationRequest))
+    {
+        if (animationRequest.instanceId >= oldToNewInstanceID.size())
+            continue;
+
+        const u32 newInstanceID = oldToNewInstanceID[animationRequest.instanceId];
+        if (newInstanceID == std::numeric_limits<u32>().max())
+            continue;
+
+        animationRequest.instanceId = newInstanceID;
+        animationRequests.push_back(animationRequest);
+    }
+
+    _animationRequests.enqueue_bulk(animationRequests.begin(), animationRequests.size());
+}
+
 void CModelRenderer::ExecuteLoad()
 {
+    // Models no placement uses anymore get unloaded even when there is nothing new to place, so switching to a map without any frees them too
+    const bool unloadedComplexModels = UnloadUnreferencedComplexModels();
+
+    // Unloaded chunks already removed their instances, the buffers just have to catch up
     size_t numComplexModelsToLoad = _complexModelsToBeLoaded.size();
-    if (numComplexModelsToLoad == 0)
+    if (numComplexModelsToLoad == 0 && !unloadedComplexModels && !_hasRemovedInstances)
         return;
 
-    _animationBoneDeformRangeAllocator.Reset();
-    _animationBoneInstancesRangeAllocator.Reset();
+    // Placements reference a path to a ComplexModel, several placements can reference the same object
+    // Because of this we only parse every unique model once, in the order they are first referenced so the result matches loading them one by one
+    std::vector<ComplexModelToBeParsed> modelsToBeParsed;
+    robin_hood::unordered_map<u32, u32> nameHashToParseIndex;
+
+    for (const ComplexModelToBeLoaded& modelToBeLoaded : _complexModelsToBeLoaded)
+    {
+        if (_nameHashToIndexMap.find(modelToBeLoaded.nameHash) != _nameHashToIndexMap.end())
+            continue;
+
+        if (nameHashToParseIndex.find(modelToBeLoaded.nameHash) != nameHashToParseIndex.end())
+            continue;
+
+        nameHashToParseIndex[modelToBeLoaded.nameHash] = static_cast<u32>(modelsToBeParsed.size());
+
+        ComplexModelToBeParsed& modelToBeParsed = modelsToBeParsed.emplace_back();
+        modelToBeParsed.name = &modelToBeLoaded.name;
+        modelToBeParsed.nameHash = modelToBeLoaded.nameHash;
+    }
+
+    ParseComplexModels(modelsToBeParsed);
+    ReserveComplexModels(modelsToBeParsed);
 
     for (ComplexModelToBeLoaded& modelToBeLoaded : _complexModelsToBeLoaded)
     {
-        // Placements reference a path to a ComplexModel, several placements can reference the same object
-        // Because of this we want only the first load to actually load the object, subsequent loads should reuse the loaded version
         u32 modelID;
 
         auto it = _nameHashToIndexMap.find(modelToBeLoaded.nameHash);
@@ -759,7 +927,8 @@ void CModelRenderer::ExecuteLoad()
             modelID = static_cast<u32>(_loadedComplexModels.size());
             LoadedComplexModel& complexModel = _loadedComplexModels.emplace_back();
             complexModel.objectID = modelID;
-            LoadComplexModel(modelToBeLoaded, complexModel);
+            complexModel.nameHash = modelToBeLoaded.nameHash;
+            LoadComplexModel(modelsToBeParsed[nameHashToParseIndex[modelToBeLoaded.nameHash]], complexModel);
 
             _nameHashToIndexMap[modelToBeLoaded.nameHash] = modelID;
         }
@@ -772,13 +941,15 @@ void CModelRenderer::ExecuteLoad()
         Terrain::PlacementDetails& placementDetails = _complexModelPlacementDetails.emplace_back();
         placementDetails.loadedIndex = modelID;
         placementDetails.instanceIndex = static_cast<u32>(_instances.size());
+        placementDetails.uniqueID = modelToBeLoaded.placement.uniqueID;
 
         // Add placement as an instance
-        AddInstance(_loadedComplexModels[modelID], *modelToBeLoaded.placement);
+        AddInstance(_loadedComplexModels[modelID], modelToBeLoaded.placement);
     }
 
-    CreateBuffers();
+    UpdateBuffers();
     _complexModelsToBeLoaded.clear();
+    _hasRemovedInstances = false;
 
     // Calculate triangles
     _numOpaqueTriangles = 0;
@@ -794,37 +965,263 @@ void CModelRenderer::ExecuteLoad()
     }
 }
 
-void CModelRenderer::Clear()
+void CModelRenderer::ClearInstances()
 {
     _uniqueIdCounter.clear();
     _mapChunkToPlacementOffset.clear();
     _complexModelPlacementDetails.clear();
-    _loadedComplexModels.clear();
-    _nameHashToIndexMap.clear();
     _opaqueDrawCallDataIndexToLoadedModelIndex.clear();
     _transparentDrawCallDataIndexToLoadedModelIndex.clear();
 
+    _instances.clear();
+    _instanceBoneDeformRangeFrames.clear();
+    _instanceBoneInstanceRangeFrames.clear();
+    _animationBoneInstances.clear();
+
+    _opaqueDrawCalls.clear();
+    _opaqueDrawCallDatas.clear();
+
+    _transparentDrawCalls.clear();
+    _transparentDrawCallDatas.clear();
+
+    // The instances the queued requests were made for are gone
+    RemapAnimationRequests({});
+
+    _numOpaqueTriangles = 0;
+    _numTransparentTriangles = 0;
+
+    // Every instance is gone so their bone ranges can all be handed out again
+    _animationBoneDeformRangeAllocator.Reset();
+    _animationBoneInstancesRangeAllocator.Reset();
+
+    for (LoadedComplexModel& complexModel : _loadedComplexModels)
+    {
+        complexModel.numInstances = 0;
+    }
+
+    InvalidateInstanceBuffers();
+}
+
+void CModelRenderer::Clear()
+{
+    ClearInstances();
+
+    _loadedComplexModels.clear();
+    _nameHashToIndexMap.clear();
+
     _vertices.clear();
     _indices.clear();
     _textureUnits.clear();
-    _instances.clear();
     _cullingDatas.clear();
 
     _animationModelInfo.clear();
+    _animationSequence.clear();
     _animationBoneInfo.clear();
     _animationTrackInfo.clear();
     _animationTrackTimestamps.clear();
     _animationTrackValues.clear();
 
-    _opaqueDrawCalls.clear();
-    _opaqueDrawCallDatas.clear();
-
-    _transparentDrawCalls.clear();
-    _transparentDrawCallDatas.clear();
+    InvalidateModelBuffers();
 
     _renderer->UnloadTexturesInArray(_cModelTextures, 0);
 }
 
+bool CModelRenderer::UnloadUnreferencedComplexModels()
+{
+    ZoneScoped;
+
+    // Models that are about to get placed again stay resident even though nothing references them right now
+    robin_hood::unordered_set<u32> nameHashesToLoad;
+    for (const ComplexModelToBeLoaded& modelToBeLoaded : _complexModelsToBeLoaded)
+    {
+        nameHashesToLoad.insert(modelToBeLoaded.nameHash);
+    }
+
+    auto IsReferenced = [&nameHashesToLoad](const LoadedComplexModel& complexModel)
+    {
+        return complexModel.numInstances > 0 || nameHashesToLoad.find(complexModel.nameHash) != nameHashesToLoad.end();
+    };
+
+    if (std::all_of(_loadedComplexModels.begin(), _loadedComplexModels.end(), IsReferenced))
+        return false;
+
+    // Release the textures of the models we are about to drop before compacting moves their texture units away, textures shared with kept models stay loaded
+    std::vector<u32> texturesToRelease;
+    for (const LoadedComplexModel& complexModel : _loadedComplexModels)
+    {
+        if (IsReferenced(complexModel))
+            continue;
+
+        const ResidentRange& textureUnits = complexModel.residentRanges.textureUnits;
+        for (u32 i = 0; i < textureUnits.count; i++)
+        {
+            const TextureUnit& textureUnit = _textureUnits[textureUnits.offset + i];
+            for (u32 textureID : textureUnit.textureIds)
+            {
+                if (textureID != CMODEL_INVALID_TEXTURE_ID)
+                {
+                    texturesToRelease.push_back(textureID);
+                }
+            }
+        }
+    }
+    _renderer->ReleaseTexturesInArray(_cModelTextures, texturesToRelease.data(), static_cast<u32>(texturesToRelease.size()));
+
+    std::vector<u32> oldToNewModelID(_loadedComplexModels.size(), std::numeric_limits<u32>().max());
+
+    u32 vertexOffset = 0;
+    u32 indexOffset = 0;
+    u32 textureUnitOffset = 0;
+    u32 cullingDataOffset = 0;
+    u32 animationModelInfoOffset = 0;
+    u32 animationSequenceOffset = 0;
+    u32 animationBoneInfoOffset = 0;
+    u32 animationTrackInfoOffset = 0;
+    u32 animationTrackTimestampOffset = 0;
+    u32 animationTrackValueOffset = 0;
+
+    // Every model was appended in order, so moving the kept ones down in order never overwrites data we still need
+    u32 numKeptModels = 0;
+    for (u32 i = 0; i < _loadedComplexModels.size(); i++)
+    {
+        LoadedComplexModel& complexModel = _loadedComplexModels[i];
+        if (!IsReferenced(complexModel))
+            continue;
+
+        ResidentRanges& ranges = complexModel.residentRanges;
+
+        const u32 vertexDistance = ResidencyUtils::CompactRange(_vertices, ranges.vertices, vertexOffset);
+        const u32 indexDistance = ResidencyUtils::CompactRange(_indices, ranges.indices, indexOffset);
+        const u32 textureUnitDistance = ResidencyUtils::CompactRange(_textureUnits, ranges.textureUnits, textureUnitOffset);
+        ResidencyUtils::CompactRange(_cullingDatas, ranges.cullingDatas, cullingDataOffset);
+
+        ResidencyUtils::CompactRange(_animationModelInfo, ranges.animationModelInfos, animationModelInfoOffset);
+        const u32 sequenceDistance = ResidencyUtils::CompactRange(_animationSequence, ranges.animationSequences, animationSequenceOffset);
+        const u32 boneInfoDistance = ResidencyUtils::CompactRange(_animationBoneInfo, ranges.animationBoneInfos, animationBoneInfoOffset);
+        const u32 trackInfoDistance = ResidencyUtils::CompactRange(_animationTrackInfo, ranges.animationTrackInfos, animationTrackInfoOffset);
+        const u32 timestampDistance = ResidencyUtils::CompactRange(_animationTrackTimestamps, ranges.animationTrackTimestamps, animationTrackTimestampOffset);
+        const u32 valueDistance = ResidencyUtils::CompactRange(_animationTrackValues, ranges.animationTrackValues, animationTrackValueOffset);
+
+        // Patch everything that points into the arrays we just moved
+        if (ranges.cullingDatas.count > 0)
+        {
+            complexModel.cullingDataID = ranges.cullingDatas.offset;
+        }
+
+        auto PatchTemplates = [&](std::vector<DrawCall>& drawCallTemplates, std::vector<DrawCallData>& drawCallDataTemplates)
+        {
+            for (DrawCall& drawCallTemplate : drawCallTemplates)
+            {
+                drawCallTemplate.vertexOffset -= vertexDistance;
+                drawCallTemplate.firstIndex -= indexDistance;
+            }
+
+            for (DrawCallData& drawCallDataTemplate : drawCallDataTemplates)
+            {
+                drawCallDataTemplate.textureUnitOffset = static_cast<u16>(drawCallDataTemplate.textureUnitOffset - textureUnitDistance);
+                drawCallDataTemplate.cullingDataID = complexModel.cullingDataID;
+            }
+        };
+        PatchTemplates(complexModel.opaqueDrawCallTemplates, complexModel.opaqueDrawCallDataTemplates);
+        PatchTemplates(complexModel.transparentDrawCallTemplates, complexModel.transparentDrawCallDataTemplates);
+
+        for (u32 j = 0; j < ranges.animationModelInfos.count; j++)
+        {
+            AnimationModelInfo& animationModelInfo = _animationModelInfo[ranges.animationModelInfos.offset + j];
+            animationModelInfo.sequenceOffset -= sequenceDistance;
+            animationModelInfo.boneInfoOffset -= boneInfoDistance;
+        }
+
+        for (u32 j = 0; j < ranges.animationBoneInfos.count; j++)
+        {
+            AnimationBoneInfo& boneInfo = _animationBoneInfo[ranges.animationBoneInfos.offset + j];
+
+            if (boneInfo.numTranslationSequences > 0)
+                boneInfo.translationSequenceOffset -= trackInfoDistance;
+
+            if (boneInfo.numRotationSequences > 0)
+                boneInfo.rotationSequenceOffset -= trackInfoDistance;
+
+            if (boneInfo.numScaleSequences > 0)
+                boneInfo.scaleSequenceOffset -= trackInfoDistance;
+        }
+
+        for (u32 j = 0; j < ranges.animationTrackInfos.count; j++)
+        {
+            AnimationTrackInfo& trackInfo = _animationTrackInfo[ranges.animationTrackInfos.offset + j];
+            trackInfo.timestampOffset -= timestampDistance;
+            trackInfo.valueOffset -= valueDistance;
+        }
+
+        oldToNewModelID[i] = numKeptModels;
+        complexModel.objectID = numKeptModels;
+        if (i != numKeptModels)
+        {
+            _loadedComplexModels[numKeptModels] = std::move(complexModel);
+        }
+
+        numKeptModels++;
+    }
+
+    _loadedComplexModels.erase(_loadedComplexModels.begin() + numKeptModels, _loadedComplexModels.end());
+
+    // Instances only use kept models, AddInstance appended their draw calls in instance order so they can be rebuilt from the patched templates in the same order
+    u32 opaqueDrawCallIndex = 0;
+    u32 transparentDrawCallIndex = 0;
+    for (Instance& instance : _instances)
+    {
+        instance.modelId = oldToNewModelID[instance.modelId];
+        const LoadedComplexModel& complexModel = _loadedComplexModels[instance.modelId];
+
+        auto PatchDrawCalls = [&complexModel](const std::vector<DrawCall>& drawCallTemplates, const std::vector<DrawCallData>& drawCallDataTemplates, u32 numDrawCalls,
+            std::vector<DrawCall>& drawCalls, std::vector<DrawCallData>& drawCallDatas, robin_hood::unordered_map<u32, u32>& drawCallDataIndexToLoadedModelIndex, u32& drawCallIndex)
+        {
+            for (u32 i = 0; i < numDrawCalls; i++, drawCallIndex++)
+            {
+                drawCalls[drawCallIndex].firstIndex = drawCallTemplates[i].firstIndex;
+                drawCalls[drawCallIndex].vertexOffset = drawCallTemplates[i].vertexOffset;
+
+                drawCallDatas[drawCallIndex].cullingDataID = drawCallDataTemplates[i].cullingDataID;
+                drawCallDatas[drawCallIndex].textureUnitOffset = drawCallDataTemplates[i].textureUnitOffset;
+
+                drawCallDataIndexToLoadedModelIndex[drawCallIndex] = complexModel.objectID;
+            }
+        };
+        PatchDrawCalls(complexModel.opaqueDrawCallTemplates, complexModel.opaqueDrawCallDataTemplates, complexModel.numOpaqueDrawCalls,
+            _opaqueDrawCalls, _opaqueDrawCallDatas, _opaqueDrawCallDataIndexToLoadedModelIndex, opaqueDrawCallIndex);
+        PatchDrawCalls(complexModel.transparentDrawCallTemplates, complexModel.transparentDrawCallDataTemplates, complexModel.numTransparentDrawCalls,
+            _transparentDrawCalls, _transparentDrawCallDatas, _transparentDrawCallDataIndexToLoadedModelIndex, transparentDrawCallIndex);
+    }
+
+    for (Terrain::PlacementDetails& placementDetails : _complexModelPlacementDetails)
+    {
+        placementDetails.loadedIndex = oldToNewModelID[placementDetails.loadedIndex];
+    }
+
+    _vertices.resize(vertexOffset);
+    _indices.resize(indexOffset);
+    _textureUnits.resize(textureUnitOffset);
+    _cullingDatas.resize(cullingDataOffset);
+
+    _animationModelInfo.resize(animationModelInfoOffset);
+    _animationSequence.resize(animationSequenceOffset);
+    _animationBoneInfo.resize(animationBoneInfoOffset);
+    _animationTrackInfo.resize(animationTrackInfoOffset);
+    _animationTrackTimestamps.resize(animationTrackTimestampOffset);
+    _animationTrackValues.resize(animationTrackValueOffset);
+
+    _nameHashToIndexMap.clear();
+    for (const LoadedComplexModel& complexModel : _loadedComplexModels)
+    {
+        _nameHashToIndexMap[complexModel.nameHash] = complexModel.objectID;
+    }
+
+    InvalidateModelBuffers();
+    InvalidateInstanceBuffers();
+
+    return true;
+}
+
 void CModelRenderer::CreatePermanentResources()
 {
     Renderer::TextureArrayDesc textureArrayDesc;
@@ -895,6 +1292,20 @@ void CModelRenderer::CreatePermanentResources()
         _transparentTriangleCountReadBackBuffer = _renderer->CreateBuffer(desc);
     }
 
+    // Create VisibleInstanceCountBuffer and VisibleInstanceCountArgumentBuffer32
+    {
+        Renderer::BufferDesc desc;
+        desc.name = "CModelVisibleInstanceCountBuffer";
+        desc.size = sizeof(u32);
+        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
+        _visibleInstanceCountBuffer = _renderer->CreateBuffer(desc);
+
+        desc.name = "CModelVisibleInstanceCountArgumentBuffer";
+        desc.size = sizeof(VkDispatchIndirectCommand);
+        desc.usage = Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER;
+        _visibleInstanceCountArgumentBuffer32 = _renderer->CreateBuffer(desc);
+    }
+
     // Create AnimationBoneDeformMatrixBuffer
     {
         size_t boneDeformMatrixBufferSize = (sizeof(mat4x4) * 255) * 1000;
@@ -921,10 +1332,10 @@ void CModelRenderer::CreatePermanentResources()
         _animationBoneInstancesRangeAllocator.Init(0, boneInstanceBufferSize);
     }
 
-    //modelToBeLoaded.name = new std::string("Creature/Snake/Snake.cmodel");
-    //modelToBeLoaded.name = new std::string("Creature/Murloc/Murloc.cmodel");
-    //modelToBeLoaded.name = new std::string("Creature/LichKingMurloc/LichKingMurloc.cmodel");
-    //modelToBeLoaded.name = new std::string("World/SkillActivated/CONTAINERS/TreasureChest01.cmodel");
+    //modelToBeLoaded.name = "Creature/Snake/Snake.cmodel";
+    //modelToBeLoaded.name = "Creature/Murloc/Murloc.cmodel";
+    //modelToBeLoaded.name = "Creature/LichKingMurloc/LichKingMurloc.cmodel";
+    //modelToBeLoaded.name = "World/SkillActivated/CONTAINERS/TreasureChest01.cmodel";
 
     for (u32 x = 0; x < 10; x++)
     {
@@ -932,11 +1343,8 @@ void CModelRenderer::CreatePermanentResources()
         {
             ComplexModelToBeLoaded& modelToBeLoaded = _complexModelsToBeLoaded.emplace_back();
             {
-                Terrain::Placement* placement = new Terrain::Placement();
-                placement->position = vec3(x * 3.f, y * 3.f, 0.f);
-
-                modelToBeLoaded.placement = placement;
-                modelToBeLoaded.name = new std::string("Creature/DruidCat/DruidCat.cmodel");
+                modelToBeLoaded.placement.position = vec3(x * 3.f, y * 3.f, 0.f);
+                modelToBeLoaded.name = "Creature/DruidCat/DruidCat.cmodel";
                 modelToBeLoaded.nameHash = x + (y * 10);
             }
         }
@@ -945,15 +1353,124 @@ void CModelRenderer::CreatePermanentResources()
     ExecuteLoad();
 }
 
-bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, LoadedComplexModel& complexModel)
+void CModelRenderer::ParseComplexModels(std::vector<ComplexModelToBeParsed>& modelsToBeParsed)
 {
-    const std::string& modelPath = *toBeLoaded.name;
+    ZoneScoped;
+
+    if (modelsToBeParsed.size() == 0)
+        return;
+
+    // LoadFile only touches the staging model it is given, so every unique model can be parsed on its own worker
+    tf::Framework framework;
+    for (ComplexModelToBeParsed& modelToBeParsed : modelsToBeParsed)
+    {
+        framework.emplace([this, &modelToBeParsed]()
+        {
+            ZoneScopedNC("CModelRenderer::ParseComplexModel", tracy::Color::Orange);
+            modelToBeParsed.succeeded = LoadFile(*modelToBeParsed.name, modelToBeParsed.cModel, modelToBeParsed.error);
+        });
+    }
+
+    _loadTaskflow.run(framework);
+    _loadTaskflow.wait_for_all();
+
+    // Workers only record what went wrong, reporting happens here on the calling thread
+    for (const ComplexModelToBeParsed& modelToBeParsed : modelsToBeParsed)
+    {
+        if (!modelToBeParsed.error.empty())
+        {
+            DebugHandler::PrintFatal("%s", modelToBeParsed.error.c_str());
+        }
+    }
+}
+
+void CModelRenderer::ReserveComplexModels(const std::vector<ComplexModelToBeParsed>& modelsToBeParsed)
+{
+    size_t numSequences = 0;
+    size_t numBones = 0;
+    size_t numTracks = 0;
+    size_t numTimestamps = 0;
+    size_t numValues = 0;
+    size_t numVertices = 0;
+    size_t numIndices = 0;
+    size_t numTextureUnits = 0;
+    size_t numModels = 0;
+
+    for (const ComplexModelToBeParsed& modelToBeParsed : modelsToBeParsed)
+    {
+        if (!modelToBeParsed.succeeded)
+            continue;
+
+        const CModel::ComplexModel& cModel = modelToBeParsed.cModel;
+
+        numModels++;
+        numSequences += cModel.sequences.size();
+        numBones += cModel.bones.size();
+        numVertices += cModel.vertices.size();
+
+        for (const CModel::ComplexBone& bone : cModel.bones)
+        {
+            numTracks += bone.translation.tracks.size() + bone.rotation.tracks.size() + bone.scale.tracks.size();
+
+            for (const auto& track : bone.translation.tracks)
+            {
+                numTimestamps += track.timestamps.size();
+                numValues += track.values.size();
+            }
+            for (const auto& track : bone.rotation.tracks)
+            {
+                numTimestamps += track.timestamps.size();
+                numValues += track.values.size();
+            }
+            for (const auto& track : bone.scale.tracks)
+            {
+                numTimestamps += track.timestamps.size();
+                numValues += track.values.size();
+            }
+        }
+
+        for (const CModel::ComplexRenderBatch& renderBatch : cModel.modelData.renderBatches)
+        {
+            numIndices += renderBatch.indexCount;
+            numTextureUnits += renderBatch.textureUnits.size();
+        }
+    }
+
+    _loadedComplexModels.reserve(_loadedComplexModels.size() + modelsToBeParsed.size());
+    _animationModelInfo.reserve(_animationModelInfo.size() + numModels);
+    _animationSequence.reserve(_animationSequence.size() + numSequences);
+    _animationBoneInfo.reserve(_animationBoneInfo.size() + numBones);
+    _animationTrackInfo.reserve(_animationTrackInfo.size() + numTracks);
+    _animationTrackTimestamps.reserve(_animationTrackTimestamps.size() + numTimestamps);
+    _animationTrackValues.reserve(_animationTrackValues.size() + numValues);
+    _vertices.reserve(_vertices.size() + numVertices);
+    _cullingDatas.reserve(_cullingDatas.size() + numModels);
+    _indices.reserve(_indices.size() + numIndices);
+    _textureUnits.reserve(_textureUnits.size() + numTextureUnits);
+}
+
+bool CModelRenderer::LoadComplexModel(ComplexModelToBeParsed& toBeParsed, LoadedComplexModel& complexModel)
+{
+    const std::string& modelPath = *toBeParsed.name;
 
     complexModel.debugName = modelPath;
 
-    CModel::ComplexModel cModel;
+    ResidentRanges& ranges = complexModel.residentRanges;
+    ResidencyUtils::BeginRange(_vertices, ranges.vertices);
+    ResidencyUtils::BeginRange(_indices, ranges.indices);
+    ResidencyUtils::BeginRange(_textureUnits, ranges.textureUnits);
+    ResidencyUtils::BeginRange(_cullingDatas, ranges.cullingDatas);
+    ResidencyUtils::BeginRange(_animationModelInfo, ranges.animationModelInfos);
+    ResidencyUtils::BeginRange(_animationSequence, ranges.animationSequences);
+    ResidencyUtils::BeginRange(_animationBoneInfo, ranges.animationBoneInfos);
+    ResidencyUtils::BeginRange(_animationTrackInfo, ranges.animationTrackInfos);
+    ResidencyUtils::BeginRange(_animationTrackTimestamps, ranges.animationTrackTimestamps);
+    ResidencyUtils::BeginRange(_animationTrackValues, ranges.animationTrackValues);
+
+    // The file was already parsed by ParseComplexModels, this only appends it to the global arrays
+    CModel::ComplexModel& cModel = toBeParsed.cModel;
     fs::path modelTexturePath = "Data/extracted/Textures/" + modelPath;
-    if (!LoadFile(modelPath, cModel))
+    if (!toBeParsed.succeeded)
         return false;
 
     vec3 minBounding = cModel.cullingData.minBoundingBox;
@@ -1255,14 +1772,25 @@ bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, Loaded
         drawCallDataTemplate.renderPriority = renderBatch.renderPriority;
     }
 
+    ResidencyUtils::EndRange(_vertices, ranges.vertices);
+    ResidencyUtils::EndRange(_indices, ranges.indices);
+    ResidencyUtils::EndRange(_textureUnits, ranges.textureUnits);
+    ResidencyUtils::EndRange(_cullingDatas, ranges.cullingDatas);
+    ResidencyUtils::EndRange(_animationModelInfo, ranges.animationModelInfos);
+    ResidencyUtils::EndRange(_animationSequence, ranges.animationSequences);
+    ResidencyUtils::EndRange(_animationBoneInfo, ranges.animationBoneInfos);
+    ResidencyUtils::EndRange(_animationTrackInfo, ranges.animationTrackInfos);
+    ResidencyUtils::EndRange(_animationTrackTimestamps, ranges.animationTrackTimestamps);
+    ResidencyUtils::EndRange(_animationTrackValues, ranges.animationTrackValues);
+
     return true;
 }
 
-bool CModelRenderer::LoadFile(const std::string& cModelPathString, CModel::ComplexModel& cModel)
+bool CModelRenderer::LoadFile(const std::string& cModelPathString, CModel::ComplexModel& cModel, std::string& error)
 {
     if (!StringUtils::EndsWith(cModelPathString, ".cmodel"))
     {
-        DebugHandler::PrintFatal("Tried to call 'LoadCModel' with a reference to a file that didn't end with '.cmodel'");
+        error = "Tried to call 'LoadCModel' with a reference to a file that didn't end with '.cmodel' (" + cModelPathString + ")";
         return false;
     }
 
@@ -1273,7 +1801,7 @@ bool CModelRenderer::LoadFile(const std::string& cModelPathString, CModel::Compl
     FileReader cModelFile(cModelPath.string(), cModelPath.filename().string());
     if (!cModelFile.Open())
     {
-        DebugHandler::PrintFatal("Failed to open CModel file: %s", cModelPath.string().c_str());
+        error = "Failed to open CModel file: " + cModelPath.string();
         return false;
     }
 
@@ -1286,19 +1814,22 @@ bool CModelRenderer::LoadFile(const std::string& cModelPathString, CModel::Compl
 
     if (cModel.header.typeID != CModel::COMPLEX_MODEL_TOKEN)
     {
-        DebugHandler::PrintFatal("We opened ComplexModel file (%s) with invalid token %u instead of expected token %u", cModelPath.string().c_str(), cModel.header.typeID, CModel::COMPLEX_MODEL_TOKEN);
+        error = "We opened ComplexModel file (" + cModelPath.string() + ") with invalid token " + std::to_string(cModel.header.typeID) + " instead of expected token " + std::to_string(CModel::COMPLEX_MODEL_TOKEN);
+        return false;
     }
 
     if (cModel.header.typeVersion != CModel::COMPLEX_MODEL_VERSION)
     {
         if (cModel.header.typeVersion < CModel::COMPLEX_MODEL_VERSION)
         {
-            DebugHandler::PrintFatal("Loaded ComplexModel file (%s) with too old version %u instead of expected version of %u, rerun dataextractor", cModelPath.string().c_str(), cModel.header.typeVersion, CModel::COMPLEX_MODEL_VERSION);
+            error = "Loaded ComplexModel file (" + cModelPath.string() + ") with too old version " + std::to_string(cModel.header.typeVersion) + " instead of expected version of " + std::to_string(CModel::COMPLEX_MODEL_VERSION) + ", rerun dataextractor";
         }
         else
         {
-            DebugHandler::PrintFatal("Loaded ComplexModel file (%s) with too new version %u instead of expected version of %u, update your client", cModelPath.string().c_str(), cModel.header.typeVersion, CModel::COMPLEX_MODEL_VERSION);
+            error = "Loaded ComplexModel file (" + cModelPath.string() + ") with too new version " + std::to_string(cModel.header.typeVersion) + " instead of expected version of " + std::to_string(CModel::COMPLEX_MODEL_VERSION) + ", update your client";
         }
+
+        return false;
     }
 
     if (!cModelBuffer.Get(cModel.flags))
@@ -1581,6 +2112,7 @@ void CModelRenderer::AddInstance(LoadedComplexModel& complexModel, const Terrain
     mat4x4 scaleMatrix = glm::scale(mat4x4(1.0f), scale);
 
     instance.modelId = complexModel.objectID;
+    complexModel.numInstances++;
     instance.instanceMatrix = glm::translate(mat4x4(1.0f), pos) * rotationMatrix * scaleMatrix;
 
     BufferRangeFrame& boneDeformRangeFrame = _instanceBoneDeformRangeFrames.emplace_back();
@@ -1634,7 +2166,7 @@ void CModelRenderer::AddInstance(LoadedComplexModel& complexModel, const Terrain
             _animationBoneInstancesBuffer = newBoneInstanceBuffer;
             _animationBoneInstancesRangeAllocator.Grow(newBoneInstanceSize);
 
-            if (!_animationBoneInstancesRangeAllocator.Allocate(numBones * sizeof(mat4x4), boneInstanceRangeFrame))
+            if (!_animationBoneInstancesRangeAllocator.Allocate(numBones * sizeof(AnimationBoneInstance), boneInstanceRangeFrame))
             {
                 DebugHandler::PrintFatal("Failed to allocate '_animationBoneInstancesBuffer' to appropriate size");
             }
@@ -1646,7 +2178,15 @@ void CModelRenderer::AddInstance(LoadedComplexModel& complexModel, const Terrain
         assert(boneInstanceRangeFrame.offset % sizeof(AnimationBoneInstance) == 0);
         instance.boneInstanceDataOffset = static_cast<u32>(boneInstanceRangeFrame.offset) / sizeof(AnimationBoneInstance);
 
-        _animationBoneInstances.resize(instance.boneInstanceDataOffset);
+        // Ranges of removed instances get reused, so the new range is reset to zero here rather than by uploading the whole array
+        const size_t boneInstanceEnd = static_cast<size_t>(instance.boneInstanceDataOffset) + numBones;
+        if (_animationBoneInstances.size() < boneInstanceEnd)
+        {
+            _animationBoneInstances.resize(boneInstanceEnd);
+        }
+
+        std::fill(_animationBoneInstances.begin() + instance.boneInstanceDataOffset, _animationBoneInstances.begin() + boneInstanceEnd, AnimationBoneInstance());
+        _renderer->UploadToBuffer(_animationBoneInstancesBuffer, boneInstanceRangeFrame.offset, &_animationBoneInstances[instance.boneInstanceDataOffset], numBones * sizeof(AnimationBoneInstance));
     }
     else
     {
@@ -1710,659 +2250,72 @@ void CModelRenderer::AddInstance(LoadedComplexModel& complexModel, const Terrain
     }
 }
 
-void CModelRenderer::CreateBuffers()
+void CModelRenderer::UpdateBuffers()
 {
-    // Create Vertex buffer
-    if (_vertexBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_vertexBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelVertexBuffer";
-        desc.size = sizeof(CModel::ComplexVertex) * _vertices.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _vertexBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "CModelVertexStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _vertices.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_vertexBuffer, 0, stagingBuffer, 0, desc.size);
-    }
-
-    // Create Index buffer
-    if (_indexBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_indexBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelIndexBuffer";
-        desc.size = sizeof(u16) * _indices.size();
-        desc.usage = Renderer::BufferUsage::INDEX_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _indexBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "CModelIndexStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _indices.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_indexBuffer, 0, stagingBuffer, 0, desc.size);
-    }
-
-    // Create TextureUnit buffer
-    if (_textureUnitBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_textureUnitBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelTextureUnitBuffer";
-        desc.size = sizeof(TextureUnit) * _textureUnits.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _textureUnitBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "CModelTextureUnitStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _textureUnits.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_textureUnitBuffer, 0, stagingBuffer, 0, desc.size);
-    }
-
-    // Create Instance buffer
-    if (_instanceBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_instanceBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelInstanceBuffer";
-        desc.size = sizeof(Instance) * _instances.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _instanceBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "CModelInstanceStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _instances.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_instanceBuffer, 0, stagingBuffer, 0, desc.size);
-    }
-
-    // Create CullingData buffer
-    if (_cullingDataBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_cullingDataBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelCullDataBuffer";
-        desc.size = sizeof(CModel::CullingData) * _cullingDatas.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _cullingDataBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "CModelCullDataStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _cullingDatas.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_cullingDataBuffer, 0, stagingBuffer, 0, desc.size);
-    }
-
-    // Create AnimationSequence buffer
-    if (_animationSequenceBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_animationSequenceBuffer);
-    }
-    {
-        size_t numSequences = _animationSequence.size();
-        if (numSequences > 0)
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationSequenceBuffer";
-            desc.size = sizeof(AnimationSequence) * numSequences;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationSequenceBuffer = _renderer->CreateBuffer(desc);
-
-            // Create staging buffer
-            desc.name = "AnimationSequenceStaging";
-            desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-            // Upload to staging buffer
-            void* dst = _renderer->MapBuffer(stagingBuffer);
-            memcpy(dst, _animationSequence.data(), desc.size);
-            _renderer->UnmapBuffer(stagingBuffer);
-
-            // Queue destroy staging buffer
-            _renderer->QueueDestroyBuffer(stagingBuffer);
-            // Copy from staging buffer to buffer
-            _renderer->CopyBuffer(_animationSequenceBuffer, 0, stagingBuffer, 0, desc.size);
-        }
-    }    
-    
-    // Create AnimationModelInfo buffer
-    if (_animationModelInfoBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_animationModelInfoBuffer);
-    }
-    {
-        size_t numModelInfo = _animationModelInfo.size();
-        if (numModelInfo > 0)
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationModelInfoBuffer";
-            desc.size = sizeof(AnimationModelInfo) * numModelInfo;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationModelInfoBuffer = _renderer->CreateBuffer(desc);
-
-            // Create staging buffer
-            desc.name = "AnimationModelInfoStaging";
-            desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-            // Upload to staging buffer
-            void* dst = _renderer->MapBuffer(stagingBuffer);
-            memcpy(dst, _animationModelInfo.data(), desc.size);
-            _renderer->UnmapBuffer(stagingBuffer);
-
-            // Queue destroy staging buffer
-            _renderer->QueueDestroyBuffer(stagingBuffer);
-            // Copy from staging buffer to buffer
-            _renderer->CopyBuffer(_animationModelInfoBuffer, 0, stagingBuffer, 0, desc.size);
-        }
-    }    
-    
-    // Create AnimationBoneInfo buffer
-    if (_animationBoneInfoBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_animationBoneInfoBuffer);
-    }
-    {
-        size_t numBoneInfo = _animationBoneInfo.size();
-        if (numBoneInfo > 0)
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationBoneInfoBuffer";
-            desc.size = sizeof(AnimationBoneInfo) * numBoneInfo;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationBoneInfoBuffer = _renderer->CreateBuffer(desc);
-
-            // Create staging buffer
-            desc.name = "AnimationBoneInfoStaging";
-            desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-            // Upload to staging buffer
-            void* dst = _renderer->MapBuffer(stagingBuffer);
-            memcpy(dst, _animationBoneInfo.data(), desc.size);
-            _renderer->UnmapBuffer(stagingBuffer);
-
-            // Queue destroy staging buffer
-            _renderer->QueueDestroyBuffer(stagingBuffer);
-            // Copy from staging buffer to buffer
-            _renderer->CopyBuffer(_animationBoneInfoBuffer, 0, stagingBuffer, 0, desc.size);
-        }
-    }
-
-    // Zero Fill AnimationBoneInstance Buffer
-    {
-        size_t numBoneInstancesInfo = _animationBoneInstances.size();
-        if (numBoneInstancesInfo > 0)
-        {
-            Renderer::BufferDesc desc;
-
-            // Create staging buffer
-            desc.name = "AnimationBoneInstanceStaging";
-            desc.size = sizeof(AnimationBoneInstance) * numBoneInstancesInfo;
-            desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-            // Upload to staging buffer
-            void* dst = _renderer->MapBuffer(stagingBuffer);
-            memcpy(dst, _animationBoneInstances.data(), desc.size);
-            _renderer->UnmapBuffer(stagingBuffer);
-
-            // Queue destroy staging buffer
-            _renderer->QueueDestroyBuffer(stagingBuffer);
-            // Copy from staging buffer to buffer
-            _renderer->CopyBuffer(_animationBoneInstancesBuffer, 0, stagingBuffer, 0, desc.size);
-        }
-    }
-    
-    // Create AnimationSequence buffer
-    if (_animationTrackInfoBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_animationTrackInfoBuffer);
-    }
-    {
-        size_t numSequenceInfo = _animationTrackInfo.size();
-        if (numSequenceInfo > 0)
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationTrackInfoBuffer";
-            desc.size = sizeof(AnimationTrackInfo) * numSequenceInfo;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationTrackInfoBuffer = _renderer->CreateBuffer(desc);
-
-            // Create staging buffer
-            desc.name = "AnimationTrackInfoStaging";
-            desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-            // Upload to staging buffer
-            void* dst = _renderer->MapBuffer(stagingBuffer);
-            memcpy(dst, _animationTrackInfo.data(), desc.size);
-            _renderer->UnmapBuffer(stagingBuffer);
-
-            // Queue destroy staging buffer
-            _renderer->QueueDestroyBuffer(stagingBuffer);
-            // Copy from staging buffer to buffer
-            _renderer->CopyBuffer(_animationTrackInfoBuffer, 0, stagingBuffer, 0, desc.size);
-        }
-    }
-    
-    // Create AnimationTimestamp buffer
-    if (_animationTrackTimestampBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_animationTrackTimestampBuffer);
-    }
-    {
-        size_t numTrackTimestamps = _animationTrackTimestamps.size();
-        if (numTrackTimestamps > 0)
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationTrackTimestampBuffer";
-            desc.size = sizeof(u32) * numTrackTimestamps;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationTrackTimestampBuffer = _renderer->CreateBuffer(desc);
-
-            // Create staging buffer
-            desc.name = "AnimationTrackTimestampStaging";
-            desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-            // Upload to staging buffer
-            void* dst = _renderer->MapBuffer(stagingBuffer);
-            memcpy(dst, _animationTrackTimestamps.data(), desc.size);
-            _renderer->UnmapBuffer(stagingBuffer);
-
-            // Queue destroy staging buffer
-            _renderer->QueueDestroyBuffer(stagingBuffer);
-            // Copy from staging buffer to buffer
-            _renderer->CopyBuffer(_animationTrackTimestampBuffer, 0, stagingBuffer, 0, desc.size);
-        }
-    }
-
-    // Create AnimationValueVec buffer
-    if (_animationTrackValueBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_animationTrackValueBuffer);
-    }
-    {
-        size_t numTrackValues = _animationTrackValues.size();
-        if (numTrackValues > 0)
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationTrackValueBuffer";
-            desc.size = sizeof(vec4) * numTrackValues;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationTrackValueBuffer = _renderer->CreateBuffer(desc);
-
-            // Create staging buffer
-            desc.name = "AnimationTrackValueStaging";
-            desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-            // Upload to staging buffer
-            void* dst = _renderer->MapBuffer(stagingBuffer);
-            memcpy(dst, _animationTrackValues.data(), desc.size);
-            _renderer->UnmapBuffer(stagingBuffer);
-
-            // Queue destroy staging buffer
-            _renderer->QueueDestroyBuffer(stagingBuffer);
-            // Copy from staging buffer to buffer
-            _renderer->CopyBuffer(_animationTrackValueBuffer, 0, stagingBuffer, 0, desc.size);
-        }
-    }
+    // Loads only append to these, so only what got added since the last update has to be uploaded
+    const u8 storageUsage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
 
-    // Destroy OpaqueDrawCall buffer
-    if (_opaqueDrawCallBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_opaqueDrawCallBuffer);
-    }
+    ResidencyUtils::UploadAppended(_renderer, _vertexBuffer, _vertices, "CModelVertexBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _indexBuffer, _indices, "CModelIndexBuffer", Renderer::BufferUsage::INDEX_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION);
+    ResidencyUtils::UploadAppended(_renderer, _textureUnitBuffer, _textureUnits, "CModelTextureUnitBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _instanceBuffer, _instances, "CModelInstanceBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _cullingDataBuffer, _cullingDatas, "CModelCullDataBuffer", storageUsage);
 
-    // Destroy OpaqueCulledDrawCall buffer
-    if (_opaqueCulledDrawCallBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_opaqueCulledDrawCallBuffer);
-    }
+    ResidencyUtils::UploadAppended(_renderer, _animationSequenceBuffer, _animationSequence, "AnimationSequenceBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _animationModelInfoBuffer, _animationModelInfo, "AnimationModelInfoBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _animationBoneInfoBuffer, _animationBoneInfo, "AnimationBoneInfoBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _animationTrackInfoBuffer, _animationTrackInfo, "AnimationTrackInfoBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _animationTrackTimestampBuffer, _animationTrackTimestamps, "AnimationTrackTimestampBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _animationTrackValueBuffer, _animationTrackValues, "AnimationTrackValueBuffer", storageUsage);
 
-    if (_opaqueDrawCalls.size() > 0)
+    // Opaque DrawCalls, the culled ones are written by the culling pass
     {
-        // Create OpaqueDrawCall and OpaqueCulledDrawCall buffer
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "CModelOpaqueDrawCallBuffer";
-            desc.size = sizeof(DrawCall) * _opaqueDrawCalls.size();
-            desc.usage = Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _opaqueDrawCallBuffer = _renderer->CreateBuffer(desc);
-            desc.name = "CModelOpaqueCullDrawCallBuffer";
-            _opaqueCulledDrawCallBuffer = _renderer->CreateBuffer(desc);
-
-            // Create staging buffer
-            desc.name = "CModelOpaqueDrawCallStaging";
-            desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-            // Upload to staging buffer
-            void* dst = _renderer->MapBuffer(stagingBuffer);
-            memcpy(dst, _opaqueDrawCalls.data(), desc.size);
-            _renderer->UnmapBuffer(stagingBuffer);
-
-            // Queue destroy staging buffer
-            _renderer->QueueDestroyBuffer(stagingBuffer);
-            // Copy from staging buffer to buffer
-            _renderer->CopyBuffer(_opaqueDrawCallBuffer, 0, stagingBuffer, 0, desc.size);
-        }
+        const u8 drawCallUsage = Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | storageUsage;
 
-        // Destroy OpaqueDrawCallData buffer
-        if (_opaqueDrawCallDataBuffer != Renderer::BufferID::Invalid())
-        {
-            _renderer->QueueDestroyBuffer(_opaqueDrawCallDataBuffer);
-        }
-
-        // Create OpaqueDrawCallData buffer
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "CModelOpaqueDrawCallDataBuffer";
-            desc.size = sizeof(DrawCallData) * _opaqueDrawCallDatas.size();
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _opaqueDrawCallDataBuffer = _renderer->CreateBuffer(desc);
-
-            // Create staging buffer
-            desc.name = "CModelOpaqueDrawCallDataStaging";
-            desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-            // Upload to staging buffer
-            void* dst = _renderer->MapBuffer(stagingBuffer);
-            memcpy(dst, _opaqueDrawCallDatas.data(), desc.size);
-            _renderer->UnmapBuffer(stagingBuffer);
-
-            // Queue destroy staging buffer
-            _renderer->QueueDestroyBuffer(stagingBuffer);
-            // Copy from staging buffer to buffer
-            _renderer->CopyBuffer(_opaqueDrawCallDataBuffer, 0, stagingBuffer, 0, desc.size);
-        }
+        ResidencyUtils::UploadAppended(_renderer, _opaqueDrawCallBuffer, _opaqueDrawCalls, "CModelOpaqueDrawCallBuffer", drawCallUsage);
+        ResidencyUtils::Reserve(_renderer, _opaqueCulledDrawCallBuffer, sizeof(DrawCall), _opaqueDrawCalls.size(), "CModelOpaqueCullDrawCallBuffer", drawCallUsage);
+        ResidencyUtils::UploadAppended(_renderer, _opaqueDrawCallDataBuffer, _opaqueDrawCallDatas, "CModelOpaqueDrawCallDataBuffer", storageUsage);
     }
 
-    // Destroy TransparentDrawCall buffer
-    if (_transparentDrawCallBuffer != Renderer::BufferID::Invalid())
+    // Transparent DrawCalls, the culled and sorted ones are written by the culling and sorting passes
     {
-        _renderer->QueueDestroyBuffer(_transparentDrawCallBuffer);
-    }
+        const u8 drawCallUsage = Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | storageUsage;
+        const size_t numDrawCalls = _transparentDrawCalls.size();
 
-    // Destroy TransparentCulledDrawCall buffer
-    if (_transparentCulledDrawCallBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_transparentCulledDrawCallBuffer);
-    }
+        ResidencyUtils::UploadAppended(_renderer, _transparentDrawCallBuffer, _transparentDrawCalls, "CModelAlphaDrawCalls", drawCallUsage | Renderer::BufferUsage::TRANSFER_SOURCE);
+        ResidencyUtils::Reserve(_renderer, _transparentCulledDrawCallBuffer, sizeof(DrawCall), numDrawCalls, "CModelAlphaCullDrawCalls", drawCallUsage);
+        ResidencyUtils::Reserve(_renderer, _transparentSortedCulledDrawCallBuffer, sizeof(DrawCall), numDrawCalls, "CModelAlphaSortCullDrawCalls", drawCallUsage);
+        ResidencyUtils::UploadAppended(_renderer, _transparentDrawCallDataBuffer, _transparentDrawCallDatas, "CModelAlphaDrawCallDataBuffer", storageUsage);
 
-    // Destroy TransparentSortedCulledDrawCall buffer
-    if (_transparentSortedCulledDrawCallBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_transparentSortedCulledDrawCallBuffer);
+        const u8 sortUsage = storageUsage | Renderer::BufferUsage::TRANSFER_SOURCE;
+        ResidencyUtils::Reserve(_renderer, _transparentSortKeys, sizeof(u64), numDrawCalls, "CModelAlphaSortKeys", sortUsage);
+        ResidencyUtils::Reserve(_renderer, _transparentSortValues, sizeof(u32), numDrawCalls, "CModelAlphaSortValues", sortUsage);
     }
 
-    if (_transparentDrawCalls.size() > 0)
-    {
-        // Create TransparentDrawCall, TransparentCulledDrawCall and TransparentSortedCulledDrawCall buffer
-        {
-            u32 size = sizeof(DrawCall) * static_cast<u32>(_transparentDrawCalls.size());
-
-            Renderer::BufferDesc desc;
-            desc.name = "CModelAlphaCullDrawCalls";
-            desc.size = size;
-            desc.usage = Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _transparentCulledDrawCallBuffer = _renderer->CreateBuffer(desc);
-
-            desc.name = "CModelAlphaSortCullDrawCalls";
-            _transparentSortedCulledDrawCallBuffer = _renderer->CreateBuffer(desc);
-
-            desc.name = "CModelAlphaDrawCalls";
-            desc.usage |= Renderer::BufferUsage::TRANSFER_SOURCE;
-            _transparentDrawCallBuffer = _renderer->CreateBuffer(desc);
-
-            // Create staging buffer
-            desc.name = "CModelAlphaDrawCallStaging";
-            desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-            // Upload to staging buffers
-            void* dst = _renderer->MapBuffer(stagingBuffer);
-            memcpy(dst, _transparentDrawCalls.data(), size);
-            _renderer->UnmapBuffer(stagingBuffer);
-
-            // Copy from staging buffer to buffer
-            _renderer->CopyBuffer(_transparentDrawCallBuffer, 0, stagingBuffer, 0, desc.size);
-            // Queue destroy staging buffer
-            _renderer->QueueDestroyBuffer(stagingBuffer);
-        }
-
-        // Destroy TransparentDrawCallData buffer
-        if (_transparentDrawCallDataBuffer != Renderer::BufferID::Invalid())
-        {
-            _renderer->QueueDestroyBuffer(_transparentDrawCallDataBuffer);
-        }
-
-        // Create TransparentDrawCallData buffer
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "CModelAlphaDrawCallDataBuffer";
-            desc.size = sizeof(DrawCallData) * _transparentDrawCallDatas.size();
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _transparentDrawCallDataBuffer = _renderer->CreateBuffer(desc);
-
-            // Create staging buffer
-            desc.name = "CModelAlphaDrawCallDataStaging";
-            desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-            // Upload to staging buffer
-            void* dst = _renderer->MapBuffer(stagingBuffer);
-            memcpy(dst, _transparentDrawCallDatas.data(), desc.size);
-            _renderer->UnmapBuffer(stagingBuffer);
-
-            // Queue destroy staging buffer
-            _renderer->QueueDestroyBuffer(stagingBuffer);
-            // Copy from staging buffer to buffer
-            _renderer->CopyBuffer(_transparentDrawCallDataBuffer, 0, stagingBuffer, 0, desc.size);
-        }
-
-        // Destroy sort keys buffer
-        if (_transparentSortKeys != Renderer::BufferID::Invalid())
-        {
-            _renderer->QueueDestroyBuffer(_transparentSortKeys);
-        }
-
-        // Destroy sort values buffer
-        if (_transparentSortValues != Renderer::BufferID::Invalid())
-        {
-            _renderer->QueueDestroyBuffer(_transparentSortValues);
-        }
-
-        // Create transparent sort keys/values buffer
-        {
-            u32 numDrawCalls = static_cast<u32>(_transparentDrawCalls.size());
-            u32 keysSize = sizeof(u64) * numDrawCalls;
-            u32 valuesSize = sizeof(u32) * numDrawCalls;
-
-            Renderer::BufferDesc desc;
-            desc.name = "CModelAlphaSortKeys";
-            desc.size = keysSize;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_SOURCE | Renderer::BufferUsage::TRANSFER_DESTINATION;
-
-            _transparentSortKeys = _renderer->CreateBuffer(desc);
-
-            desc.name = "CModelAlphaSortValues";
-            desc.size = valuesSize;
-            _transparentSortValues = _renderer->CreateBuffer(desc);
-        }
-    }
-    else
-    {
-        // Destroy sort keys buffer
-        if (_transparentSortKeys != Renderer::BufferID::Invalid())
-        {
-            _renderer->QueueDestroyBuffer(_transparentSortKeys);
-        }
-
-        // Destroy sort values buffer
-        if (_transparentSortValues != Renderer::BufferID::Invalid())
-        {
-            _renderer->QueueDestroyBuffer(_transparentSortValues);
-        }
-
-        // Create transparent sort keys/values buffer
-        {
-            u32 keysSize = sizeof(u64) * 1;
-            u32 valuesSize = sizeof(u32) * 1;
-
-            Renderer::BufferDesc desc;
-            desc.name = "CModelAlphaSortKeys";
-            desc.size = keysSize;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_SOURCE | Renderer::BufferUsage::TRANSFER_DESTINATION;
-
-            _transparentSortKeys = _renderer->CreateBuffer(desc);
-
-            desc.name = "CModelAlphaSortValues";
-            desc.size = valuesSize;
-            _transparentSortValues = _renderer->CreateBuffer(desc);
-        }
-    }
-
-    if (_visibleInstanceMaskBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_visibleInstanceMaskBuffer);
-    }
-
-    if (_visibleInstanceCountBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_visibleInstanceCountBuffer);
-    }
-
-    if (_visibleInstanceIndexBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_visibleInstanceIndexBuffer);
-    }
+    ResidencyUtils::Reserve(_renderer, _visibleInstanceMaskBuffer, sizeof(u32), (_instances.size() + 31) / 32, "CModelVisibleInstanceMaskBuffer", storageUsage);
+    ResidencyUtils::Reserve(_renderer, _visibleInstanceIndexBuffer, sizeof(u32), _instances.size(), "CModelVisibleInstanceIndexBuffer", Renderer::BufferUsage::STORAGE_BUFFER);
+}
 
-    if (_visibleInstanceCountArgumentBuffer32 != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_visibleInstanceCountArgumentBuffer32);
-    }
+void CModelRenderer::InvalidateInstanceBuffers()
+{
+    ResidencyUtils::Invalidate(_instanceBuffer);
+    ResidencyUtils::Invalidate(_opaqueDrawCallBuffer);
+    ResidencyUtils::Invalidate(_opaqueDrawCallDataBuffer);
+    ResidencyUtils::Invalidate(_transparentDrawCallBuffer);
+    ResidencyUtils::Invalidate(_transparentDrawCallDataBuffer);
+}
 
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelVisibleInstanceMaskBuffer";
-        desc.size = sizeof(u32) * ((_instances.size() + 31) / 32);
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _visibleInstanceMaskBuffer = _renderer->CreateBuffer(desc);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelVisibleInstanceCountBuffer";
-        desc.size = sizeof(u32);
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _visibleInstanceCountBuffer = _renderer->CreateBuffer(desc);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelVisibleInstanceIndexBuffer";
-        desc.size = sizeof(u32) * _instances.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER;
-        _visibleInstanceIndexBuffer = _renderer->CreateBuffer(desc);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelVisibleInstanceIndexBuffer";
-        desc.size = sizeof(VkDispatchIndirectCommand);
-        desc.usage = Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER;
-        _visibleInstanceCountArgumentBuffer32 = _renderer->CreateBuffer(desc);
-    }
+void CModelRenderer::InvalidateModelBuffers()
+{
+    ResidencyUtils::Invalidate(_vertexBuffer);
+    ResidencyUtils::Invalidate(_indexBuffer);
+    ResidencyUtils::Invalidate(_textureUnitBuffer);
+    ResidencyUtils::Invalidate(_cullingDataBuffer);
+
+    ResidencyUtils::Invalidate(_animationSequenceBuffer);
+    ResidencyUtils::Invalidate(_animationModelInfoBuffer);
+    ResidencyUtils::Invalidate(_animationBoneInfoBuffer);
+    ResidencyUtils::Invalidate(_animationTrackInfoBuffer);
+    ResidencyUtils::Invalidate(_animationTrackTimestampBuffer);
+    ResidencyUtils::Invalidate(_animationTrackValueBuffer);
 }
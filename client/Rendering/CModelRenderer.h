@@ -3,6 +3,7 @@
 
 #include <Utils/StringUtils.h>
 #include <Utils/ConcurrentQueue.h>
+#include <taskflow/taskflow.hpp>
 #include <Memory/BufferRangeAllocator.h>
 
 #include <Renderer/Descriptors/ImageDesc.h>
@@ -17,6 +18,7 @@
 #include "../Gameplay/Map/Chunk.h"
 #include "CModel/CModel.h"
 #include "ViewConstantBuffer.h"
+#include "ResidencyUtils.h"
 
 namespace Renderer
 {
@@ -63,11 +65,31 @@ public:
         u32 renderPriority;
     };
 
+    // Where a loaded model lives in the global arrays, used to compact them when models get unloaded
+    struct ResidentRanges
+    {
+        ResidentRange vertices;
+        ResidentRange indices;
+        ResidentRange textureUnits;
+        ResidentRange cullingDatas;
+
+        ResidentRange animationModelInfos;
+        ResidentRange animationSequences;
+        ResidentRange animationBoneInfos;
+        ResidentRange animationTrackInfos;
+        ResidentRange animationTrackTimestamps;
+        ResidentRange animationTrackValues;
+    };
+
     struct LoadedComplexModel
     {
         u32 objectID;
         std::string debugName = "";
 
+        u32 nameHash = 0;
+        u32 numInstances = 0; // The number of placements using this model, models without any get unloaded along with their textures by the next ExecuteLoad that doesn't need them
+        ResidentRanges residentRanges;
+
         u32 cullingDataID = std::numeric_limits<u32>().max();
         u32 numBones = 0;
         bool isAnimated = false;
@@ -133,8 +155,12 @@ public:
     void AddComplexModelPass(Renderer::RenderGraph* renderGraph, const Renderer::DescriptorSet* globalDescriptorSet, const Renderer::DescriptorSet* debugDescriptorSet, Renderer::ImageID colorTarget, Renderer::ImageID objectTarget, Renderer::DepthImageID depthTarget, Renderer::ImageID occlusionPyramid, u8 frameIndex);
 
     void RegisterLoadFromChunk(u16 chunkID, const Terrain::Chunk& chunk, StringTable& stringTable);
+    // Removes the placements only this chunk was holding on to, the next ExecuteLoad unloads the models that lost their last instance
+    void UnloadChunk(u16 chunkID, const Terrain::Chunk& chunk);
     void ExecuteLoad();
 
+    // Removes every placement but keeps the loaded models resident, models the next load doesn't use again get unloaded by it
+    void ClearInstances();
     void Clear();
 
     const std::vector<DrawCallData>& GetOpaqueDrawCallData() { return _opaqueDrawCallDatas; }
@@ -184,9 +210,21 @@ public:
 private:
     struct ComplexModelToBeLoaded
     {
-        const Terrain::Placement* placement = nullptr;
+        // Copied out of the chunk, the chunk that registered it can be unloaded while another resident chunk keeps it waiting
+        Terrain::Placement placement;
+        std::string name;
+        u32 nameHash = 0;
+    };
+
+    // Staging data for a unique model, these get parsed on the taskflow workers and appended to the global arrays afterwards
+    struct ComplexModelToBeParsed
+    {
         const std::string* name = nullptr;
         u32 nameHash = 0;
+
+        CModel::ComplexModel cModel;
+        bool succeeded = false;
+        std::string error; // Filled by the worker, reported once parsing is done
     };
 
     struct TextureUnit
@@ -307,14 +345,25 @@ private:
 private:
     void CreatePermanentResources();
 
-    bool LoadComplexModel(ComplexModelToBeLoaded& complexModelToBeLoaded, LoadedComplexModel& complexModel);
-    bool LoadFile(const std::string& cModelPathString, CModel::ComplexModel& cModel);
+    void ParseComplexModels(std::vector<ComplexModelToBeParsed>& modelsToBeParsed);
+    void ReserveComplexModels(const std::vector<ComplexModelToBeParsed>& modelsToBeParsed);
+    bool LoadComplexModel(ComplexModelToBeParsed& complexModelToBeParsed, LoadedComplexModel& complexModel);
+    bool UnloadUnreferencedComplexModels();
+    bool LoadFile(const std::string& cModelPathString, CModel::ComplexModel& cModel, std::string& error);
 
     bool IsRenderBatchTransparent(const CModel::ComplexRenderBatch& renderBatch, const CModel::ComplexModel& cModel);
 
     void AddInstance(LoadedComplexModel& complexModel, const Terrain::Placement& placement);
 
-    void CreateBuffers();
+    // Removes the instances whose placement is in removedUniqueIDs, the instances after them move down to keep everything in load order
+    void RemoveInstances(const robin_hood::unordered_set<u32>& removedUniqueIDs);
+    // Points queued animation requests at the instances' new IDs, requests for removed instances get dropped
+    void RemapAnimationRequests(const std::vector<u32>& oldToNewInstanceID);
+
+    void UpdateBuffers();
+    // The next UpdateBuffers uploads these arrays in full, needed after they were compacted or patched in place
+    void InvalidateInstanceBuffers();
+    void InvalidateModelBuffers();
 
 private:
     Renderer::Renderer* _renderer;
@@ -328,8 +377,10 @@ private:
     robin_hood::unordered_map<u32, u8> _uniqueIdCounter;
     robin_hood::unordered_map<u16, u32> _mapChunkToPlacementOffset;
     std::vector<Terrain::PlacementDetails> _complexModelPlacementDetails;
+    bool _hasRemovedInstances = false;
 
     std::vector<ComplexModelToBeLoaded> _complexModelsToBeLoaded;
+    tf::Taskflow _loadTaskflow;
     std::vector<LoadedComplexModel> _loadedComplexModels;
     robin_hood::unordered_map<u32, u32> _nameHashToIndexMap;
     robin_hood::unordered_map<u32, u32> _opaqueDrawCallDataIndexToLoadedModelIndex;
@@ -360,44 +411,44 @@ private:
     std::vector<DrawCall> _transparentDrawCalls;
     std::vector<DrawCallData> _transparentDrawCallDatas;
 
-    Renderer::BufferID _vertexBuffer;
-    Renderer::BufferID _indexBuffer;
-    Renderer::BufferID _textureUnitBuffer;
-    Renderer::BufferID _instanceBuffer;
-    Renderer::BufferID _cullingDataBuffer;
-    Renderer::BufferID _visibleInstanceMaskBuffer;
+    ResidentBuffer _vertexBuffer;
+    ResidentBuffer _indexBuffer;
+    ResidentBuffer _textureUnitBuffer;
+    ResidentBuffer _instanceBuffer;
+    ResidentBuffer _cullingDataBuffer;
+    ResidentBuffer _visibleInstanceMaskBuffer;
     Renderer::BufferID _visibleInstanceCountBuffer;
-    Renderer::BufferID _visibleInstanceIndexBuffer;
+    ResidentBuffer _visibleInstanceIndexBuffer;
     Renderer::BufferID _visibleInstanceCountArgumentBuffer32;
 
-    Renderer::BufferID _animationSequenceBuffer;
-    Renderer::BufferID _animationModelInfoBuffer;
-    Renderer::BufferID _animationBoneInfoBuffer;
+    ResidentBuffer _animationSequenceBuffer;
+    ResidentBuffer _animationModelInfoBuffer;
+    ResidentBuffer _animationBoneInfoBuffer;
     Renderer::BufferID _animationBoneDeformMatrixBuffer;
     Renderer::BufferID _animationBoneInstancesBuffer;
-    Renderer::BufferID _animationTrackInfoBuffer;
-    Renderer::BufferID _animationTrackTimestampBuffer;
-    Renderer::BufferID _animationTrackValueBuffer;
+    ResidentBuffer _animationTrackInfoBuffer;
+    ResidentBuffer _animationTrackTimestampBuffer;
+    ResidentBuffer _animationTrackValueBuffer;
 
-    Renderer::BufferID _opaqueDrawCallBuffer;
-    Renderer::BufferID _opaqueCulledDrawCallBuffer;
-    Renderer::BufferID _opaqueDrawCallDataBuffer;
+    ResidentBuffer _opaqueDrawCallBuffer;
+    ResidentBuffer _opaqueCulledDrawCallBuffer;
+    ResidentBuffer _opaqueDrawCallDataBuffer;
     Renderer::BufferID _opaqueDrawCountBuffer;
     Renderer::BufferID _opaqueDrawCountReadBackBuffer;
     Renderer::BufferID _opaqueTriangleCountBuffer;
     Renderer::BufferID _opaqueTriangleCountReadBackBuffer;
 
-    Renderer::BufferID _transparentDrawCallBuffer;
-    Renderer::BufferID _transparentCulledDrawCallBuffer;
-    Renderer::BufferID _transparentSortedCulledDrawCallBuffer;
-    Renderer::BufferID _transparentDrawCallDataBuffer;
+    ResidentBuffer _transparentDrawCallBuffer;
+    ResidentBuffer _transparentCulledDrawCallBuffer;
+    ResidentBuffer _transparentSortedCulledDrawCallBuffer;
+    ResidentBuffer _transparentDrawCallDataBuffer;
     Renderer::BufferID _transparentDrawCountBuffer;
     Renderer::BufferID _transparentDrawCountReadBackBuffer;
     Renderer::BufferID _transparentTriangleCountBuffer;
     Renderer::BufferID _transparentTriangleCountReadBackBuffer;
 
-    Renderer::BufferID _transparentSortKeys;
-    Renderer::BufferID _transparentSortValues;
+    ResidentBuffer _transparentSortKeys;
+    ResidentBuffer _transparentSortValues;
 
     CullConstants _cullConstants;
 
@@ -14,6 +14,7 @@
 #include <Renderer/Renderer.h>
 #include <Renderer/RenderGraph.h>
 #include <Renderer/Renderers/Vulkan/RendererVK.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
 #include <Window/Window.h>
 #include <InputManager.h>
 #include <GLFW/glfw3.h>
@@ -30,6 +31,7 @@
 
 AutoCVar_Int CVAR_LightLockEnabled("lights.lock", "lock the light", 0, CVarFlags::EditCheckbox);
 AutoCVar_Int CVAR_LightUseDefaultEnabled("lights.useDefault", "Use the map's default light", 0, CVarFlags::EditCheckbox);
+AutoCVar_Int CVAR_RendererNullBackend("renderer.nullBackend", "run without a GPU, only takes effect on startup", 0, CVarFlags::EditCheckbox);
 
 const size_t FRAME_ALLOCATOR_SIZE = 8 * 1024 * 1024; // 8 MB
 u32 MAIN_RENDER_LAYER = "MainLayer"_h; // _h will compiletime hash the string into a u32
@@ -90,8 +92,16 @@ ClientRenderer::ClientRenderer()
     Renderer::TextureDesc debugTexture;
     debugTexture.path = "Data/textures/DebugTexture.bmp";
     
-    _renderer = new Renderer::RendererVK(debugTexture);
+    if (CVAR_RendererNullBackend.Get())
+    {
+        _renderer = new Renderer::RendererNull();
+    }
+    else
+    {
+        _renderer = new Renderer::RendererVK(debugTexture);
+    }
     _renderer->InitWindow(_window);
+    _renderer->SetTaskExecutor(ServiceLocator::GetTaskExecutor());
 
     InitImgui();
 
@@ -110,6 +120,12 @@ ClientRenderer::ClientRenderer()
     ServiceLocator::SetClientRenderer(this);
 }
 
+ClientRenderer::~ClientRenderer()
+{
+    // Flushes the GPU and lets the backend persist state like the pipeline cache before the process exits
+    _renderer->Deinit();
+}
+
 bool ClientRenderer::UpdateWindow(f32 deltaTime)
 {
     return _window->Update(deltaTime);
@@ -149,6 +165,9 @@ void ClientRenderer::Render()
 
     _renderer->FlipFrame(_frameIndex);
 
+    // Transient resources
+    _objectIDs = renderGraph.GetBuilder()->Create(_objectIDsDesc);
+
     // Update the view matrix to match the new camera position
     _viewConstantBuffer->resource.lastViewProjectionMatrix = _viewConstantBuffer->resource.viewProjectionMatrix;
     _viewConstantBuffer->resource.viewProjectionMatrix = camera->GetViewProjectionMatrix();
@@ -175,12 +194,16 @@ void ClientRenderer::Render()
     {
         struct ClearPassData
         {
+            Renderer::RenderPassMutableResource mainColor;
+            Renderer::RenderPassMutableResource mainObject;
             Renderer::RenderPassMutableResource mainDepth;
         };
 
         renderGraph.AddPass<ClearPassData>("ClearPass",
             [=](ClearPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
+            data.mainColor = builder.Write(_mainColor, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+            data.mainObject = builder.Write(_objectIDs, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
             data.mainDepth = builder.Write(_mainDepth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
 
             return true; // Return true from setup to enable this pass, return false to disable it
@@ -226,12 +249,14 @@ void ClientRenderer::Render()
     struct PyramidPassData
     {
         Renderer::RenderPassResource mainDepth;
+        Renderer::RenderPassMutableResource depthPyramid;
     };
 
     renderGraph.AddPass<PyramidPassData>("PyramidPass",
         [=](PyramidPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
-            data.mainDepth = builder.Read(_mainDepth, Renderer::RenderGraphBuilder::ShaderStage::PIXEL);
+            data.mainDepth = builder.Read(_mainDepth, Renderer::RenderGraphBuilder::ShaderStage::COMPUTE);
+            data.depthPyramid = builder.Write(_depthPyramid, Renderer::RenderGraphBuilder::WriteMode::UAV, Renderer::RenderGraphBuilder::LoadMode::DISCARD);
 
             return true; // Return true from setup to enable this pass, return false to disable it
         },
@@ -253,6 +278,10 @@ void ClientRenderer::Render()
 
     _uiRenderer->AddImguiPass(&renderGraph, _mainColor, _frameIndex);
 
+    // MainColor gets presented and next frame's occlusion culling reads the depth pyramid, everything else only matters if one of these depends on it
+    renderGraph.AddSideEffect(_mainColor);
+    renderGraph.AddSideEffect(_depthPyramid);
+
     renderGraph.AddSignalSemaphore(_sceneRenderedSemaphore); // Signal that we are ready to present
     renderGraph.AddSignalSemaphore(_frameSyncSemaphores.Get(_frameIndex)); // Signal that this frame has finished, for next frames sake
 
@@ -324,15 +353,12 @@ void ClientRenderer::CreatePermanentResources()
 
     _mainColor = _renderer->CreateImage(mainColorDesc);
 
-    // Object ID rendertarget
-    Renderer::ImageDesc objectIDsDesc;
-    objectIDsDesc.debugName = "ObjectIDs";
-    objectIDsDesc.dimensions = vec2(1.0f, 1.0f);
-    objectIDsDesc.dimensionType = Renderer::ImageDimensionType::DIMENSION_SCALE;
-    objectIDsDesc.format = Renderer::ImageFormat::R32_UINT;
-    objectIDsDesc.sampleCount = Renderer::SampleCount::SAMPLE_COUNT_1;
-
-    _objectIDs = _renderer->CreateImage(objectIDsDesc);
+    // Object ID rendertarget, nothing reads it after the PixelQuery pass so it gets created as a transient every frame
+    _objectIDsDesc.debugName = "ObjectIDs";
+    _objectIDsDesc.dimensions = vec2(1.0f, 1.0f);
+    _objectIDsDesc.dimensionType = Renderer::ImageDimensionType::DIMENSION_SCALE;
+    _objectIDsDesc.format = Renderer::ImageFormat::R32_UINT;
+    _objectIDsDesc.sampleCount = Renderer::SampleCount::SAMPLE_COUNT_1;
 
     // depth pyramid ID rendertarget
     Renderer::ImageDesc pyramidDesc;
@@ -38,6 +38,7 @@ class ClientRenderer
 {
 public:
     ClientRenderer();
+    ~ClientRenderer();
 
     bool UpdateWindow(f32 deltaTime);
     void Update(f32 deltaTime);
@@ -76,11 +77,13 @@ private:
 
     // Permanent resources
     Renderer::ImageID _mainColor;
-    Renderer::ImageID _objectIDs;
+    Renderer::ImageID _objectIDs; // Transient, only valid while the render graph of the current frame gets built
     Renderer::ImageID _depthPyramid;
 
     Renderer::DepthImageID _mainDepth;
 
+    Renderer::ImageDesc _objectIDsDesc;
+
     Renderer::GPUSemaphoreID _sceneRenderedSemaphore; // This semaphore tells the present function when the scene is ready to be blitted and presented
     FrameResource<Renderer::GPUSemaphoreID, 2> _frameSyncSemaphores; // This semaphore makes sure the GPU handles frames in order
 
@@ -1,10 +1,12 @@
 #include "MapObjectRenderer.h"
 #include "DebugRenderer.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <Renderer/Renderer.h>
 #include <Renderer/RenderGraph.h>
 #include <Utils/FileReader.h>
+#include <tracy/Tracy.hpp>
 #include <glm/gtx/rotate_vector.hpp>
 #include <glm/gtx/euler_angles.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
@@ -30,6 +32,7 @@ AutoCVar_Int CVAR_MapObjectDrawBoundingBoxes("mapObjects.drawBoundingBoxes", "dr
 MapObjectRenderer::MapObjectRenderer(Renderer::Renderer* renderer, DebugRenderer* debugRenderer)
     : _renderer(renderer)
     , _debugRenderer(debugRenderer)
+    , _loadTaskflow(ServiceLocator::GetTaskExecutor())
 {
     CreatePermanentResources();
 }
@@ -131,6 +134,11 @@ void MapObjectRenderer::AddMapObjectPass(Renderer::RenderGraph* renderGraph, con
             data.mainObject = builder.Write(objectTarget, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
             data.mainDepth = builder.Write(depthTarget, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
 
+            if (cullingEnabled)
+            {
+                builder.Read(depthPyramid, Renderer::RenderGraphBuilder::ShaderStage::COMPUTE);
+            }
+
             return true; // Return true from setup to enable this pass, return false to disable it
         },
             [=](MapObjectPassData& data, Renderer::RenderGraphResources& resources, Renderer::CommandList& commandList) // Execute
@@ -174,8 +182,8 @@ void MapObjectRenderer::AddMapObjectPass(Renderer::RenderGraph* renderGraph, con
                 }
 
                 _cullingDescriptorSet.Bind("_constants", _cullingConstantBuffer->GetBuffer(frameIndex));
-                _cullingDescriptorSet.Bind("_drawCommands", _argumentBuffer);
-                _cullingDescriptorSet.Bind("_culledDrawCommands", _culledArgumentBuffer);
+                _cullingDescriptorSet.Bind("_drawCommands", _argumentBuffer.buffer);
+                _cullingDescriptorSet.Bind("_culledDrawCommands", _culledArgumentBuffer.buffer);
                 _cullingDescriptorSet.Bind("_drawCount", _drawCountBuffer);
                 _cullingDescriptorSet.Bind("_triangleCount", _triangleCountBuffer);
 
@@ -201,7 +209,7 @@ void MapObjectRenderer::AddMapObjectPass(Renderer::RenderGraph* renderGraph, con
 
                 commandList.EndPipeline(pipeline);
 
-                commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToIndirectArguments, _culledArgumentBuffer);
+                commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToIndirectArguments, _culledArgumentBuffer.buffer);
                 commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToIndirectArguments, _drawCountBuffer);
             }
             else
@@ -252,9 +260,9 @@ void MapObjectRenderer::AddMapObjectPass(Renderer::RenderGraph* renderGraph, con
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, globalDescriptorSet, frameIndex);
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
 
-            commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+            commandList.SetIndexBuffer(_indexBuffer.buffer, Renderer::IndexFormat::UInt16);
 
-            Renderer::BufferID argumentBuffer = (cullingEnabled) ? _culledArgumentBuffer : _argumentBuffer;
+            Renderer::BufferID argumentBuffer = (cullingEnabled) ? _culledArgumentBuffer.buffer : _argumentBuffer.buffer;
             commandList.DrawIndexedIndirectCount(argumentBuffer, 0, _drawCountBuffer, 0, drawCount);
 
             commandList.EndPipeline(pipeline);
@@ -276,8 +284,8 @@ void MapObjectRenderer::RegisterMapObjectToBeLoaded(const std::string& mapObject
     if (_uniqueIdCounter[uniqueID]++ == 0)
     {
         MapObjectToBeLoaded& mapObjectToBeLoaded = _mapObjectsToBeLoaded.emplace_back();
-        mapObjectToBeLoaded.placement = &mapObjectPlacement;
-        mapObjectToBeLoaded.nmorName = &mapObjectName;
+        mapObjectToBeLoaded.placement = mapObjectPlacement;
+        mapObjectToBeLoaded.nmorName = mapObjectName;
         mapObjectToBeLoaded.nmorNameHash = StringUtils::fnv1a_32(mapObjectName.c_str(), mapObjectName.length());
     }
 }
@@ -294,37 +302,152 @@ void MapObjectRenderer::RegisterMapObjectsToBeLoaded(u16 chunkID, const Terrain:
         if (_uniqueIdCounter[uniqueID]++ == 0)
         {
             MapObjectToBeLoaded& mapObjectToBeLoaded = _mapObjectsToBeLoaded.emplace_back();
-            mapObjectToBeLoaded.placement = &mapObjectPlacement;
-            mapObjectToBeLoaded.nmorName = &stringTable.GetString(mapObjectPlacement.nameID);
+            mapObjectToBeLoaded.placement = mapObjectPlacement;
+            mapObjectToBeLoaded.nmorName = stringTable.GetString(mapObjectPlacement.nameID);
             mapObjectToBeLoaded.nmorNameHash = stringTable.GetStringHash(mapObjectPlacement.nameID);
         }
     }
 }
 
+void MapObjectRenderer::UnloadChunk(u16 chunkID, const Terrain::Chunk& chunk)
+{
+    ZoneScoped;
+
+    _mapChunkToPlacementOffset.erase(chunkID);
+
+    // Placements that also sit in a chunk that is still loaded keep their instance
+    robin_hood::unordered_set<u32> removedUniqueIDs;
+    for (const Terrain::Placement& placement : chunk.mapObjectPlacements)
+    {
+        auto it = _uniqueIdCounter.find(placement.uniqueID);
+        if (it == _uniqueIdCounter.end())
+            continue;
+
+        if (--it->second == 0)
+        {
+            _uniqueIdCounter.erase(it);
+            removedUniqueIDs.insert(placement.uniqueID);
+        }
+    }
+
+    if (removedUniqueIDs.empty())
+        return;
+
+    // Placements that haven't been loaded yet and aren't referenced by any resident chunk anymore
+    auto removedMapObjectsToBeLoaded = std::remove_if(_mapObjectsToBeLoaded.begin(), _mapObjectsToBeLoaded.end(), [&removedUniqueIDs](const MapObjectToBeLoaded& mapObjectToBeLoaded)
+    {
+        return removedUniqueIDs.find(mapObjectToBeLoaded.placement.uniqueID) != removedUniqueIDs.end();
+    });
+    _mapObjectsToBeLoaded.erase(removedMapObjectsToBeLoaded, _mapObjectsToBeLoaded.end());
+
+    RemoveInstances(removedUniqueIDs);
+}
+
+void MapObjectRenderer::RemoveInstances(const robin_hood::unordered_set<u32>& removedUniqueIDs)
+{
+    for (LoadedMapObject& mapObject : _loadedMapObjects)
+    {
+        mapObject.drawParameterIDs.clear();
+        mapObject.instanceIDs.clear();
+    }
+
+    // AddInstance appended one draw per render batch in instance order, so they get compacted along with the instances
+    u32 numKeptInstances = 0;
+    u32 drawParameterIndex = 0;
+    u32 numKeptDrawParameters = 0;
+
+    for (u32 i = 0; i < _instances.size(); i++)
+    {
+        Terrain::PlacementDetails& placementDetails = _mapObjectPlacementDetails[i];
+        LoadedMapObject& mapObject = _loadedMapObjects[placementDetails.loadedIndex];
+        const u32 numRenderBatches = static_cast<u32>(mapObject.renderBatches.size());
+
+        if (removedUniqueIDs.find(placementDetails.uniqueID) != removedUniqueIDs.end())
+        {
+            mapObject.instanceCount--;
+            drawParameterIndex += numRenderBatches;
+            continue;
+        }
+
+        mapObject.instanceIDs.push_back(static_cast<u16>(numKeptInstances));
+
+        for (u32 j = 0; j < numRenderBatches; j++, drawParameterIndex++, numKeptDrawParameters++)
+        {
+            _drawParameters[numKeptDrawParameters] = _drawParameters[drawParameterIndex];
+            _drawParameters[numKeptDrawParameters].firstInstance = numKeptDrawParameters;
+
+            _instanceLookupData[numKeptDrawParameters] = _instanceLookupData[drawParameterIndex];
+            _instanceLookupData[numKeptDrawParameters].instanceID = static_cast<u16>(numKeptInstances);
+
+            mapObject.drawParameterIDs.push_back(numKeptDrawParameters);
+        }
+
+        _instances[numKeptInstances] = _instances[i];
+
+        _mapObjectPlacementDetails[numKeptInstances] = placementDetails;
+        _mapObjectPlacementDetails[numKeptInstances].instanceIndex = numKeptInstances;
+
+        numKeptInstances++;
+    }
+
+    _instances.resize(numKeptInstances);
+    _mapObjectPlacementDetails.resize(numKeptInstances);
+    _drawParameters.resize(numKeptDrawParameters);
+    _instanceLookupData.resize(numKeptDrawParameters);
+
+    InvalidateInstanceBuffers();
+    _hasRemovedInstances = true;
+}
+
 void MapObjectRenderer::ExecuteLoad()
 {
-    size_t numMapObjectsToLoad = _mapObjectsToBeLoaded.size();
+    // Map objects no placement uses anymore get unloaded even when there is nothing new to place, so switching to a map without any frees them too
+    const bool unloadedMapObjects = UnloadUnreferencedMapObjects();
 
-    if (numMapObjectsToLoad == 0)
+    // Unloaded chunks already removed their instances, the buffers just have to catch up
+    size_t numMapObjectsToLoad = _mapObjectsToBeLoaded.size();
+    if (numMapObjectsToLoad == 0 && !unloadedMapObjects && !_hasRemovedInstances)
         return;
 
+    // Placements reference a path to a MapObject, several placements can reference the same object
+    // Because of this we only parse every unique object once, in the order they are first referenced so the result matches loading them one by one
+    std::vector<MapObjectToBeParsed> mapObjectsToBeParsed;
+    robin_hood::unordered_map<u32, u32> nameHashToParseIndex;
+
+    for (const MapObjectToBeLoaded& mapObjectToBeLoaded : _mapObjectsToBeLoaded)
+    {
+        if (_nameHashToIndexMap.find(mapObjectToBeLoaded.nmorNameHash) != _nameHashToIndexMap.end())
+            continue;
+
+        if (nameHashToParseIndex.find(mapObjectToBeLoaded.nmorNameHash) != nameHashToParseIndex.end())
+            continue;
+
+        nameHashToParseIndex[mapObjectToBeLoaded.nmorNameHash] = static_cast<u32>(mapObjectsToBeParsed.size());
+
+        MapObjectToBeParsed& mapObjectToBeParsed = mapObjectsToBeParsed.emplace_back();
+        mapObjectToBeParsed.nmorName = &mapObjectToBeLoaded.nmorName;
+        mapObjectToBeParsed.nmorNameHash = mapObjectToBeLoaded.nmorNameHash;
+    }
+
+    ParseMapObjects(mapObjectsToBeParsed);
+    ReserveMapObjects(mapObjectsToBeParsed);
+
     for (MapObjectToBeLoaded& mapObjectToBeLoaded : _mapObjectsToBeLoaded)
     {
-        // Placements reference a path to a MapObject, several placements can reference the same object
-        // Because of this we want only the first load to actually load the object, subsequent loads should just return the id to the already loaded version
         u32 mapObjectID;
 
         auto it = _nameHashToIndexMap.find(mapObjectToBeLoaded.nmorNameHash);
         if (it == _nameHashToIndexMap.end())
         {
+            MapObjectToBeParsed& mapObjectToBeParsed = mapObjectsToBeParsed[nameHashToParseIndex[mapObjectToBeLoaded.nmorNameHash]];
+            if (!mapObjectToBeParsed.succeeded)
+                continue;
+
             mapObjectID = static_cast<u32>(_loadedMapObjects.size());
             LoadedMapObject& mapObject = _loadedMapObjects.emplace_back();
             mapObject.objectID = mapObjectID;
-            if (!LoadMapObject(mapObjectToBeLoaded, mapObject))
-            {
-                _loadedMapObjects.pop_back();
-                continue;
-            }
+            mapObject.nameHash = mapObjectToBeLoaded.nmorNameHash;
+            LoadMapObject(mapObjectToBeParsed, mapObject);
 
             _nameHashToIndexMap[mapObjectToBeLoaded.nmorNameHash] = mapObjectID;
         }
@@ -332,18 +455,20 @@ void MapObjectRenderer::ExecuteLoad()
         {
             mapObjectID = it->second;
         }
-        
+
         // Add Placement Details (This is used to go from a placement to LoadedMapObject or InstanceData
         Terrain::PlacementDetails& placementDetails = _mapObjectPlacementDetails.emplace_back();
         placementDetails.loadedIndex = mapObjectID;
         placementDetails.instanceIndex = static_cast<u32>(_instances.size());
+        placementDetails.uniqueID = mapObjectToBeLoaded.placement.uniqueID;
 
         // Add placement as an instance here
         AddInstance(_loadedMapObjects[mapObjectID], mapObjectToBeLoaded.placement);
     }
 
-    CreateBuffers();
+    UpdateBuffers();
     _mapObjectsToBeLoaded.clear();
+    _hasRemovedInstances = false;
 
     // Calculate triangles
     _numTriangles = 0;
@@ -354,26 +479,199 @@ void MapObjectRenderer::ExecuteLoad()
     }
 }
 
-void MapObjectRenderer::Clear()
+void MapObjectRenderer::ClearInstances()
 {
     _uniqueIdCounter.clear();
     _mapChunkToPlacementOffset.clear();
     _mapObjectPlacementDetails.clear();
+    _drawParameters.clear();
+    _instances.clear();
+    _instanceLookupData.clear();
+    _numTriangles = 0;
+
+    for (LoadedMapObject& mapObject : _loadedMapObjects)
+    {
+        mapObject.drawParameterIDs.clear();
+        mapObject.instanceIDs.clear();
+        mapObject.instanceMaterialParameterIDs.clear();
+        mapObject.instanceCount = 0;
+    }
+
+    InvalidateInstanceBuffers();
+}
+
+void MapObjectRenderer::Clear()
+{
+    ClearInstances();
+
     _loadedMapObjects.clear();
     _nameHashToIndexMap.clear();
     _indices.clear();
     _vertices.clear();
-    _drawParameters.clear();
-    _instances.clear();
-    _instanceLookupData.clear();
     _materials.clear();
     _materialParameters.clear();
     _cullingData.clear();
 
+    InvalidateMapObjectBuffers();
+
     // Unload everything but the first texture in our array
     _renderer->UnloadTexturesInArray(_mapObjectTextures, 1);
 }
 
+bool MapObjectRenderer::UnloadUnreferencedMapObjects()
+{
+    ZoneScoped;
+
+    // Map objects that are about to get placed again stay resident even though nothing references them right now
+    robin_hood::unordered_set<u32> nameHashesToLoad;
+    for (const MapObjectToBeLoaded& mapObjectToBeLoaded : _mapObjectsToBeLoaded)
+    {
+        nameHashesToLoad.insert(mapObjectToBeLoaded.nmorNameHash);
+    }
+
+    auto IsReferenced = [&nameHashesToLoad](const LoadedMapObject& mapObject)
+    {
+        return mapObject.instanceCount > 0 || nameHashesToLoad.find(mapObject.nameHash) != nameHashesToLoad.end();
+    };
+
+    if (std::all_of(_loadedMapObjects.begin(), _loadedMapObjects.end(), IsReferenced))
+        return false;
+
+    // Release the textures of the map objects we are about to drop before compacting moves their materials away, textures shared with kept map objects stay loaded
+    // Index 0 is the black texture every unused material slot points at, it is never released
+    std::vector<u32> texturesToRelease;
+    for (const LoadedMapObject& mapObject : _loadedMapObjects)
+    {
+        if (IsReferenced(mapObject))
+            continue;
+
+        const ResidentRange& materials = mapObject.residentRanges.materials;
+        for (u32 i = 0; i < materials.count; i++)
+        {
+            for (u16 textureID : _materials[materials.offset + i].textureIDs)
+            {
+                if (textureID != 0)
+                {
+                    texturesToRelease.push_back(textureID);
+                }
+            }
+        }
+
+        for (u32 i = 0; i < 2; i++)
+        {
+            if (!mapObject.vertexColors[i].empty())
+            {
+                texturesToRelease.push_back(mapObject.vertexColorTextureIDs[i]);
+            }
+        }
+    }
+    _renderer->ReleaseTexturesInArray(_mapObjectTextures, texturesToRelease.data(), static_cast<u32>(texturesToRelease.size()));
+
+    std::vector<u32> oldToNewMapObjectID(_loadedMapObjects.size(), std::numeric_limits<u32>().max());
+
+    u32 materialOffset = 0;
+    u32 indexOffset = 0;
+    u32 vertexOffset = 0;
+    u32 materialParameterOffset = 0;
+    u32 cullingDataOffset = 0;
+
+    // Every map object was appended in order, so moving the kept ones down in order never overwrites data we still need
+    u32 numKeptMapObjects = 0;
+    for (u32 i = 0; i < _loadedMapObjects.size(); i++)
+    {
+        LoadedMapObject& mapObject = _loadedMapObjects[i];
+        if (!IsReferenced(mapObject))
+            continue;
+
+        ResidentRanges& ranges = mapObject.residentRanges;
+
+        const u32 materialDistance = ResidencyUtils::CompactRange(_materials, ranges.materials, materialOffset);
+        const u32 indexDistance = ResidencyUtils::CompactRange(_indices, ranges.indices, indexOffset);
+        const u32 vertexDistance = ResidencyUtils::CompactRange(_vertices, ranges.vertices, vertexOffset);
+        const u32 materialParameterDistance = ResidencyUtils::CompactRange(_materialParameters, ranges.materialParameters, materialParameterOffset);
+        ResidencyUtils::CompactRange(_cullingData, ranges.cullingData, cullingDataOffset);
+
+        // Patch everything that points into the arrays we just moved
+        mapObject.baseMaterialOffset -= materialDistance;
+        mapObject.baseVertexOffset -= vertexDistance;
+        mapObject.baseCullingDataOffset = ranges.cullingData.offset;
+
+        for (RenderBatchOffsets& renderBatchOffsets : mapObject.renderBatchOffsets)
+        {
+            renderBatchOffsets.baseVertexOffset -= vertexDistance;
+            renderBatchOffsets.baseIndexOffset -= indexDistance;
+        }
+
+        for (u16& materialParameterID : mapObject.materialParameterIDs)
+        {
+            materialParameterID = static_cast<u16>(materialParameterID - materialParameterDistance);
+        }
+
+        for (u32 j = 0; j < ranges.materialParameters.count; j++)
+        {
+            MaterialParameters& materialParameters = _materialParameters[ranges.materialParameters.offset + j];
+            materialParameters.materialID = static_cast<u16>(materialParameters.materialID - materialDistance);
+        }
+
+        oldToNewMapObjectID[i] = numKeptMapObjects;
+        mapObject.objectID = numKeptMapObjects;
+        if (i != numKeptMapObjects)
+        {
+            _loadedMapObjects[numKeptMapObjects] = std::move(mapObject);
+        }
+
+        numKeptMapObjects++;
+    }
+
+    _loadedMapObjects.erase(_loadedMapObjects.begin() + numKeptMapObjects, _loadedMapObjects.end());
+
+    // Instances only use kept map objects, AddInstance gave every instance one draw per render batch so they can be rebuilt from the patched offsets
+    for (const LoadedMapObject& mapObject : _loadedMapObjects)
+    {
+        const size_t numRenderBatches = mapObject.renderBatches.size();
+        for (size_t j = 0; j < mapObject.drawParameterIDs.size(); j++)
+        {
+            const u32 drawParameterID = mapObject.drawParameterIDs[j];
+            const size_t renderBatchIndex = j % numRenderBatches;
+
+            const Terrain::RenderBatch& renderBatch = mapObject.renderBatches[renderBatchIndex];
+            const RenderBatchOffsets& renderBatchOffsets = mapObject.renderBatchOffsets[renderBatchIndex];
+
+            DrawParameters& drawParameters = _drawParameters[drawParameterID];
+            drawParameters.vertexOffset = renderBatchOffsets.baseVertexOffset;
+            drawParameters.firstIndex = renderBatchOffsets.baseIndexOffset + renderBatch.startIndex;
+
+            InstanceLookupData& instanceLookupData = _instanceLookupData[drawParameterID];
+            instanceLookupData.loadedObjectID = mapObject.objectID;
+            instanceLookupData.materialParamID = mapObject.materialParameterIDs[renderBatchIndex];
+            instanceLookupData.cullingDataID = static_cast<u16>(mapObject.baseCullingDataOffset);
+            instanceLookupData.vertexOffset = renderBatchOffsets.baseVertexOffset;
+        }
+    }
+
+    for (Terrain::PlacementDetails& placementDetails : _mapObjectPlacementDetails)
+    {
+        placementDetails.loadedIndex = oldToNewMapObjectID[placementDetails.loadedIndex];
+    }
+
+    _materials.resize(materialOffset);
+    _indices.resize(indexOffset);
+    _vertices.resize(vertexOffset);
+    _materialParameters.resize(materialParameterOffset);
+    _cullingData.resize(cullingDataOffset);
+
+    _nameHashToIndexMap.clear();
+    for (const LoadedMapObject& mapObject : _loadedMapObjects)
+    {
+        _nameHashToIndexMap[mapObject.nameHash] = mapObject.objectID;
+    }
+
+    InvalidateMapObjectBuffers();
+    InvalidateInstanceBuffers();
+
+    return true;
+}
+
 void MapObjectRenderer::CreatePermanentResources()
 {
     Renderer::TextureArrayDesc textureArrayDesc;
@@ -408,47 +706,166 @@ void MapObjectRenderer::CreatePermanentResources()
     _cullingConstantBuffer = new Renderer::Buffer<CullingConstants>(_renderer, "CullingConstantBuffer", Renderer::BufferUsage::UNIFORM_BUFFER, Renderer::BufferCPUAccess::WriteOnly);
 }
 
-bool MapObjectRenderer::LoadMapObject(MapObjectToBeLoaded& mapObjectToBeLoaded, LoadedMapObject& mapObject)
+void MapObjectRenderer::ParseMapObjects(std::vector<MapObjectToBeParsed>& mapObjectsToBeParsed)
 {
-    // Load root
-    if (!StringUtils::EndsWith(*mapObjectToBeLoaded.nmorName, ".nmor"))
+    ZoneScoped;
+
+    if (mapObjectsToBeParsed.size() == 0)
+        return;
+
+    // Every unique map object decodes its root and meshes into its own staging data, so they can all be parsed at once
+    tf::Framework framework;
+    for (MapObjectToBeParsed& mapObjectToBeParsed : mapObjectsToBeParsed)
     {
-        DebugHandler::PrintFatal("For some reason, a Chunk had a MapObjectPlacement with a reference to a file that didn't end with .nmor");
-        return false;
+        framework.emplace([&mapObjectToBeParsed]()
+        {
+            ZoneScopedNC("MapObjectRenderer::ParseMapObject", tracy::Color::Orange);
+            mapObjectToBeParsed.succeeded = ParseMapObject(mapObjectToBeParsed);
+        });
     }
 
-    const std::string& modelPath = *mapObjectToBeLoaded.nmorName;
-    mapObject.debugName = modelPath;
+    _loadTaskflow.run(framework);
+    _loadTaskflow.wait_for_all();
 
-    fs::path nmorPath = "Data/extracted/MapObjects/" + *mapObjectToBeLoaded.nmorName;
-    nmorPath.make_preferred();
-    nmorPath = fs::absolute(nmorPath);
+    // Workers only record what went wrong, reporting happens here on the calling thread
+    for (const MapObjectToBeParsed& mapObjectToBeParsed : mapObjectsToBeParsed)
+    {
+        if (!mapObjectToBeParsed.error.empty())
+        {
+            DebugHandler::PrintFatal("%s", mapObjectToBeParsed.error.c_str());
+        }
+    }
+}
+
+void MapObjectRenderer::ReserveMapObjects(const std::vector<MapObjectToBeParsed>& mapObjectsToBeParsed)
+{
+    size_t numMapObjects = 0;
+    size_t numMaterials = 0;
+    size_t numIndices = 0;
+    size_t numVertices = 0;
+    size_t numRenderBatches = 0;
+
+    for (const MapObjectToBeParsed& mapObjectToBeParsed : mapObjectsToBeParsed)
+    {
+        if (!mapObjectToBeParsed.succeeded)
+            continue;
+
+        numMapObjects++;
+        numMaterials += mapObjectToBeParsed.materials.size();
+
+        for (const MeshToBeParsed& mesh : mapObjectToBeParsed.meshes)
+        {
+            numIndices += mesh.indices.size();
+            numVertices += mesh.vertices.size();
+            numRenderBatches += mesh.renderBatches.size();
+        }
+    }
 
-    if (!LoadRoot(nmorPath, mapObjectToBeLoaded.meshRoot, mapObject))
+    _loadedMapObjects.reserve(_loadedMapObjects.size() + numMapObjects);
+    _materials.reserve(_materials.size() + numMaterials);
+    _indices.reserve(_indices.size() + numIndices);
+    _vertices.reserve(_vertices.size() + numVertices);
+    _materialParameters.reserve(_materialParameters.size() + numRenderBatches);
+    _cullingData.reserve(_cullingData.size() + numMapObjects);
+}
+
+bool MapObjectRenderer::LoadMapObject(MapObjectToBeParsed& mapObjectToBeParsed, LoadedMapObject& mapObject)
+{
+    ResidentRanges& ranges = mapObject.residentRanges;
+    ResidencyUtils::BeginRange(_materials, ranges.materials);
+    ResidencyUtils::BeginRange(_indices, ranges.indices);
+    ResidencyUtils::BeginRange(_vertices, ranges.vertices);
+    ResidencyUtils::BeginRange(_materialParameters, ranges.materialParameters);
+    ResidencyUtils::BeginRange(_cullingData, ranges.cullingData);
+
+    if (!mapObjectToBeParsed.succeeded)
         return false;
 
-    // Load meshes
-    std::string nmorNameWithoutExtension = mapObjectToBeLoaded.nmorName->substr(0, mapObjectToBeLoaded.nmorName->length() - 5); // Remove .nmor
-    std::stringstream ss;
+    mapObject.debugName = *mapObjectToBeParsed.nmorName;
+
+    // Add materials
+    entt::registry* registry = ServiceLocator::GetGameRegistry();
+    TextureSingleton& textureSingleton = registry->ctx<TextureSingleton>();
+    mapObject.baseMaterialOffset = static_cast<u32>(_materials.size());
+
+    for (const Terrain::MapObjectMaterial& mapObjectMaterial : mapObjectToBeParsed.materials)
+    {
+        Material& material = _materials.emplace_back();
+        material.materialType = mapObjectMaterial.materialType;
+        material.unlit = mapObjectMaterial.flags.unlit;
+
+        // TransparencyMode 1 means that it checks the alpha of the texture if it should discard the pixel or not
+        if (mapObjectMaterial.transparencyMode == 1)
+        {
+            material.alphaTestVal = 128.0f / 255.0f;
+        }
+
+        constexpr u32 maxTexturesPerMaterial = 3;
+        for (u32 j = 0; j < maxTexturesPerMaterial; j++)
+        {
+            if (mapObjectMaterial.textureNameID[j] < std::numeric_limits<u32>().max())
+            {
+                Renderer::TextureDesc textureDesc;
+                textureDesc.path = textureSingleton.textureHashToPath[mapObjectMaterial.textureNameID[j]];
+
+                u32 textureID;
+                _renderer->LoadTextureIntoArray(textureDesc, _mapObjectTextures, textureID);
+
+                material.textureIDs[j] = static_cast<u16>(textureID);
+            }
+        }
+    }
 
     mapObject.baseVertexOffset = static_cast<u32>(_vertices.size());
     mapObject.baseCullingDataOffset = static_cast<u32>(_cullingData.size());
 
-    for (u32 i = 0; i < mapObjectToBeLoaded.meshRoot.numMeshes; i++)
+    // Add meshes
+    for (MeshToBeParsed& meshToBeParsed : mapObjectToBeParsed.meshes)
     {
-        ss.clear();
-        ss.str("");
+        Mesh mesh;
+        mesh.renderFlags = meshToBeParsed.renderFlags;
 
-        // Load MapObject
-        ss << nmorNameWithoutExtension << "_" << std::setw(3) << std::setfill('0') << i << ".nmo";
+        // Indices and vertices
+        mesh.baseIndexOffset = static_cast<u32>(_indices.size());
+        mesh.baseVertexOffset = static_cast<u32>(_vertices.size());
 
-        fs::path nmoPath = "Data/extracted/MapObjects/" + ss.str();
-        nmoPath.make_preferred();
-        nmoPath = fs::absolute(nmoPath);
+        _indices.insert(_indices.end(), meshToBeParsed.indices.begin(), meshToBeParsed.indices.end());
+        _vertices.insert(_vertices.end(), meshToBeParsed.vertices.begin(), meshToBeParsed.vertices.end());
 
-        Mesh& mesh = mapObjectToBeLoaded.meshes.emplace_back();
-        if (!LoadMesh(nmoPath, mesh, mapObject))
-            return false;
+        // Vertex colors
+        mesh.baseVertexColor1Offset = meshToBeParsed.numVertexColorSets > 0 ? static_cast<u32>(mapObject.vertexColors[0].size()) : std::numeric_limits<u32>().max();
+        mesh.baseVertexColor2Offset = meshToBeParsed.numVertexColorSets > 1 ? static_cast<u32>(mapObject.vertexColors[1].size()) : std::numeric_limits<u32>().max();
+
+        for (u32 i = 0; i < meshToBeParsed.numVertexColorSets; i++)
+        {
+            mapObject.vertexColors[i].insert(mapObject.vertexColors[i].end(), meshToBeParsed.vertexColors[i].begin(), meshToBeParsed.vertexColors[i].end());
+        }
+
+        // RenderBatches
+        u32 numRenderBatches = static_cast<u32>(meshToBeParsed.renderBatches.size());
+        mapObject.renderBatches.insert(mapObject.renderBatches.end(), meshToBeParsed.renderBatches.begin(), meshToBeParsed.renderBatches.end());
+
+        mapObject.renderBatchOffsets.reserve(mapObject.renderBatchOffsets.size() + numRenderBatches);
+        for (const Terrain::RenderBatch& renderBatch : meshToBeParsed.renderBatches)
+        {
+            RenderBatchOffsets& renderBatchOffsets = mapObject.renderBatchOffsets.emplace_back();
+            renderBatchOffsets.baseVertexOffset = mesh.baseVertexOffset;
+            renderBatchOffsets.baseIndexOffset = mesh.baseIndexOffset;
+            renderBatchOffsets.baseVertexColor1Offset = mesh.baseVertexColor1Offset;
+            renderBatchOffsets.baseVertexColor2Offset = mesh.baseVertexColor2Offset;
+
+            // MaterialParameters
+            u32 materialParameterID = static_cast<u32>(_materialParameters.size());
+
+            mapObject.materialParameterIDs.push_back(materialParameterID);
+
+            MaterialParameters& materialParameters = _materialParameters.emplace_back();
+            materialParameters.materialID = mapObject.baseMaterialOffset + renderBatch.materialID;
+            materialParameters.exteriorLit = static_cast<u32>(mesh.renderFlags.exteriorLit || mesh.renderFlags.exterior);
+        }
+
+        // Culling data
+        mapObject.cullingData.insert(mapObject.cullingData.end(), meshToBeParsed.cullingData.begin(), meshToBeParsed.cullingData.end());
     }
 
     static u32 vertexColorTextureCount = 0;
@@ -507,15 +924,62 @@ bool MapObjectRenderer::LoadMapObject(MapObjectToBeLoaded& mapObjectToBeLoaded,
 
     mapObjectCullingData.boundingSphereRadius = glm::distance(minPos, maxPos) / 2.0f;
 
+    ResidencyUtils::EndRange(_materials, ranges.materials);
+    ResidencyUtils::EndRange(_indices, ranges.indices);
+    ResidencyUtils::EndRange(_vertices, ranges.vertices);
+    ResidencyUtils::EndRange(_materialParameters, ranges.materialParameters);
+    ResidencyUtils::EndRange(_cullingData, ranges.cullingData);
+
+    return true;
+}
+
+bool MapObjectRenderer::ParseMapObject(MapObjectToBeParsed& mapObjectToBeParsed)
+{
+    // Load root
+    if (!StringUtils::EndsWith(*mapObjectToBeParsed.nmorName, ".nmor"))
+    {
+        mapObjectToBeParsed.error = "For some reason, a Chunk had a MapObjectPlacement with a reference to a file that didn't end with .nmor (" + *mapObjectToBeParsed.nmorName + ")";
+        return false;
+    }
+
+    fs::path nmorPath = "Data/extracted/MapObjects/" + *mapObjectToBeParsed.nmorName;
+    nmorPath.make_preferred();
+    nmorPath = fs::absolute(nmorPath);
+
+    u32 numMeshes;
+    if (!ParseRoot(nmorPath, mapObjectToBeParsed, numMeshes, mapObjectToBeParsed.error))
+        return false;
+
+    // Load meshes
+    std::string nmorNameWithoutExtension = mapObjectToBeParsed.nmorName->substr(0, mapObjectToBeParsed.nmorName->length() - 5); // Remove .nmor
+    std::stringstream ss;
+
+    mapObjectToBeParsed.meshes.resize(numMeshes);
+    for (u32 i = 0; i < numMeshes; i++)
+    {
+        ss.clear();
+        ss.str("");
+
+        // Load MapObject
+        ss << nmorNameWithoutExtension << "_" << std::setw(3) << std::setfill('0') << i << ".nmo";
+
+        fs::path nmoPath = "Data/extracted/MapObjects/" + ss.str();
+        nmoPath.make_preferred();
+        nmoPath = fs::absolute(nmoPath);
+
+        if (!ParseMesh(nmoPath, mapObjectToBeParsed.meshes[i], mapObjectToBeParsed.error))
+            return false;
+    }
+
     return true;
 }
 
-bool MapObjectRenderer::LoadRoot(const std::filesystem::path nmorPath, MeshRoot& meshRoot, LoadedMapObject& mapObject)
+bool MapObjectRenderer::ParseRoot(const std::filesystem::path nmorPath, MapObjectToBeParsed& mapObjectToBeParsed, u32& numMeshes, std::string& error)
 {
     FileReader nmorFile(nmorPath.string(), nmorPath.filename().string());
     if (!nmorFile.Open())
     {
-        DebugHandler::PrintFatal("Failed to load Map Object Root file: %s", nmorPath.string().c_str());
+        error = "Failed to load Map Object Root file: " + nmorPath.string();
         return false;
     }
 
@@ -531,7 +995,7 @@ bool MapObjectRenderer::LoadRoot(const std::filesystem::path nmorPath, MeshRoot&
 
     if (header.token != Terrain::MAP_OBJECT_ROOT_TOKEN)
     {
-        DebugHandler::PrintFatal("Found MapObjectRoot file (%s) with invalid token %u instead of expected token %u", nmorPath.string().c_str(), header.token, Terrain::MAP_OBJECT_ROOT_TOKEN);
+        error = "Found MapObjectRoot file (" + nmorPath.string() + ") with invalid token " + std::to_string(header.token) + " instead of expected token " + std::to_string(Terrain::MAP_OBJECT_ROOT_TOKEN);
         return false;
     }
 
@@ -539,70 +1003,39 @@ bool MapObjectRenderer::LoadRoot(const std::filesystem::path nmorPath, MeshRoot&
     {
         if (header.version < Terrain::MAP_OBJECT_ROOT_VERSION)
         {
-            DebugHandler::PrintFatal("Found MapObjectRoot file (%s) with older version %u instead of expected version %u, rerun dataextractor", nmorPath.string().c_str(), header.version, Terrain::MAP_OBJECT_ROOT_VERSION);
+            error = "Found MapObjectRoot file (" + nmorPath.string() + ") with older version " + std::to_string(header.version) + " instead of expected version " + std::to_string(Terrain::MAP_OBJECT_ROOT_VERSION) + ", rerun dataextractor";
             return false;
         }
         else
         {
-            DebugHandler::PrintFatal("Found MapObjectRoot file (%s) with newer version %u instead of expected version %u, update your client", nmorPath.string().c_str(), header.version, Terrain::MAP_OBJECT_ROOT_VERSION);
+            error = "Found MapObjectRoot file (" + nmorPath.string() + ") with newer version " + std::to_string(header.version) + " instead of expected version " + std::to_string(Terrain::MAP_OBJECT_ROOT_VERSION) + ", update your client";
             return false;
         }
     }
 
     // Read number of materials
-    if (!buffer.Get<u32>(meshRoot.numMaterials))
+    u32 numMaterials;
+    if (!buffer.Get<u32>(numMaterials))
         return false;
 
     // Read materials
-    entt::registry* registry = ServiceLocator::GetGameRegistry();
-    TextureSingleton& textureSingleton = registry->ctx<TextureSingleton>();
-    mapObject.baseMaterialOffset = static_cast<u32>(_materials.size());
-
-    for (u32 i = 0; i < meshRoot.numMaterials; i++)
-    {
-        Terrain::MapObjectMaterial mapObjectMaterial;
-        if (!buffer.GetBytes(reinterpret_cast<u8*>(&mapObjectMaterial), sizeof(Terrain::MapObjectMaterial)))
-            return false;
-
-        Material& material = _materials.emplace_back();
-        material.materialType = mapObjectMaterial.materialType;
-        material.unlit = mapObjectMaterial.flags.unlit;
-
-        // TransparencyMode 1 means that it checks the alpha of the texture if it should discard the pixel or not
-        if (mapObjectMaterial.transparencyMode == 1)
-        {
-            material.alphaTestVal = 128.0f / 255.0f;
-        }
-
-        constexpr u32 maxTexturesPerMaterial = 3;
-        for (u32 j = 0; j < maxTexturesPerMaterial; j++)
-        {
-            if (mapObjectMaterial.textureNameID[j] < std::numeric_limits<u32>().max())
-            {
-                Renderer::TextureDesc textureDesc;
-                textureDesc.path = textureSingleton.textureHashToPath[mapObjectMaterial.textureNameID[j]];
-
-                u32 textureID;
-                _renderer->LoadTextureIntoArray(textureDesc, _mapObjectTextures, textureID);
-
-                material.textureIDs[j] = static_cast<u16>(textureID);
-            }
-        }
-    }
+    mapObjectToBeParsed.materials.resize(numMaterials);
+    if (!buffer.GetBytes(reinterpret_cast<u8*>(mapObjectToBeParsed.materials.data()), numMaterials * sizeof(Terrain::MapObjectMaterial)))
+        return false;
 
     // Read number of meshes
-    if (!buffer.Get<u32>(meshRoot.numMeshes))
+    if (!buffer.Get<u32>(numMeshes))
         return false;
 
     return true;
 }
 
-bool MapObjectRenderer::LoadMesh(const std::filesystem::path nmoPath, Mesh& mesh, LoadedMapObject& mapObject)
+bool MapObjectRenderer::ParseMesh(const std::filesystem::path nmoPath, MeshToBeParsed& mesh, std::string& error)
 {
     FileReader nmoFile(nmoPath.string(), nmoPath.filename().string());
     if (!nmoFile.Open())
     {
-        DebugHandler::PrintFatal("Failed to load Map Object file: %s", nmoPath.string().c_str());
+        error = "Failed to load Map Object file: " + nmoPath.string();
         return false;
     }
 
@@ -616,7 +1049,7 @@ bool MapObjectRenderer::LoadMesh(const std::filesystem::path nmoPath, Mesh& mesh
 
     if (header.token != Terrain::MAP_OBJECT_TOKEN)
     {
-        DebugHandler::PrintFatal("Found MapObject file (%s) with invalid token %u instead of expected token %u", nmoPath.string().c_str(), header.token, Terrain::MAP_OBJECT_TOKEN);
+        error = "Found MapObject file (" + nmoPath.string() + ") with invalid token " + std::to_string(header.token) + " instead of expected token " + std::to_string(Terrain::MAP_OBJECT_TOKEN);
         return false;
     }
 
@@ -624,12 +1057,12 @@ bool MapObjectRenderer::LoadMesh(const std::filesystem::path nmoPath, Mesh& mesh
     {
         if (header.version < Terrain::MAP_OBJECT_VERSION)
         {
-            DebugHandler::PrintFatal("Found MapObject file (%s) with older version %u instead of expected version %u, rerun dataextractor", nmoPath.string().c_str(), header.version, Terrain::MAP_OBJECT_VERSION);
+            error = "Found MapObject file (" + nmoPath.string() + ") with older version " + std::to_string(header.version) + " instead of expected version " + std::to_string(Terrain::MAP_OBJECT_VERSION) + ", rerun dataextractor";
             return false;
         }
         else
         {
-            DebugHandler::PrintFatal("Found MapObject file (%s) with newer version %u instead of expected version %u, update your client", nmoPath.string().c_str(), header.version, Terrain::MAP_OBJECT_VERSION);
+            error = "Found MapObject file (" + nmoPath.string() + ") with newer version " + std::to_string(header.version) + " instead of expected version " + std::to_string(Terrain::MAP_OBJECT_VERSION) + ", update your client";
             return false;
         }
     }
@@ -639,55 +1072,49 @@ bool MapObjectRenderer::LoadMesh(const std::filesystem::path nmoPath, Mesh& mesh
         return false;
 
     // Read indices and vertices
-    if (!LoadIndicesAndVertices(nmoBuffer, mesh, mapObject))
+    if (!ParseIndicesAndVertices(nmoBuffer, mesh))
         return false;
 
     // Read renderbatches
-    if (!LoadRenderBatches(nmoBuffer, mesh, mapObject))
+    if (!ParseRenderBatches(nmoBuffer, mesh))
         return false;
 
     return true;
 }
 
-bool MapObjectRenderer::LoadIndicesAndVertices(Bytebuffer& buffer, Mesh& mesh, LoadedMapObject& mapObject)
+bool MapObjectRenderer::ParseIndicesAndVertices(Bytebuffer& buffer, MeshToBeParsed& mesh)
 {
-    mesh.baseIndexOffset = static_cast<u32>(_indices.size());
-    mesh.baseVertexOffset = static_cast<u32>(_vertices.size());
-
     // Read number of indices
     u32 indexCount;
     if (!buffer.Get<u32>(indexCount))
         return false;
 
-    _indices.resize(mesh.baseIndexOffset + indexCount);
+    mesh.indices.resize(indexCount);
 
     // Read indices
-    if (!buffer.GetBytes(reinterpret_cast<u8*>(_indices.data() + mesh.baseIndexOffset), indexCount * sizeof(u16)))
+    if (!buffer.GetBytes(reinterpret_cast<u8*>(mesh.indices.data()), indexCount * sizeof(u16)))
         return false;
-    
+
     // Read number of vertices
     u32 vertexCount;
     if (!buffer.Get<u32>(vertexCount))
         return false;
 
-    _vertices.resize(mesh.baseVertexOffset + vertexCount);
-    
+    mesh.vertices.resize(vertexCount);
+
     // Read vertices
-    if (!buffer.GetBytes(reinterpret_cast<u8*>(&_vertices.data()[mesh.baseVertexOffset]), vertexCount * sizeof(Terrain::MapObjectVertex)))
+    if (!buffer.GetBytes(reinterpret_cast<u8*>(mesh.vertices.data()), vertexCount * sizeof(Terrain::MapObjectVertex)))
         return false;
 
-    vec3 position = _vertices[0].position;
-
     // Read number of vertex color sets
-    u32 numVertexColorSets;
-    if (!buffer.Get<u32>(numVertexColorSets))
+    if (!buffer.Get<u32>(mesh.numVertexColorSets))
         return false;
 
-    // Vertex colors
-    mesh.baseVertexColor1Offset = numVertexColorSets > 0 ? static_cast<u32>(mapObject.vertexColors[0].size()) : std::numeric_limits<u32>().max();
-    mesh.baseVertexColor2Offset = numVertexColorSets > 1 ? static_cast<u32>(mapObject.vertexColors[1].size()) : std::numeric_limits<u32>().max();
+    // We only have room for two vertex color sets per mesh
+    if (mesh.numVertexColorSets > 2)
+        return false;
 
-    for (u32 i = 0; i < numVertexColorSets; i++)
+    for (u32 i = 0; i < mesh.numVertexColorSets; i++)
     {
         // Read number of vertex colors
         u32 numVertexColors;
@@ -697,19 +1124,16 @@ bool MapObjectRenderer::LoadIndicesAndVertices(Bytebuffer& buffer, Mesh& mesh, L
         if (numVertexColors == 0)
             continue;
 
-        u32 vertexColorSize = numVertexColors * sizeof(u32);
-        
-        u32 beforeSize = static_cast<u32>(mapObject.vertexColors[i].size());
-        mapObject.vertexColors[i].resize(beforeSize + numVertexColors);
+        mesh.vertexColors[i].resize(numVertexColors);
 
-        if (!buffer.GetBytes(reinterpret_cast<u8*>(&mapObject.vertexColors[i][beforeSize]), vertexColorSize))
+        if (!buffer.GetBytes(reinterpret_cast<u8*>(mesh.vertexColors[i].data()), numVertexColors * sizeof(u32)))
             return false;
     }
 
     return true;
 }
 
-bool MapObjectRenderer::LoadRenderBatches(Bytebuffer& buffer, Mesh& mesh, LoadedMapObject& mapObject)
+bool MapObjectRenderer::ParseRenderBatches(Bytebuffer& buffer, MeshToBeParsed& mesh)
 {
     // Read number of triangle data
     u32 numTriangleData;
@@ -725,54 +1149,30 @@ bool MapObjectRenderer::LoadRenderBatches(Bytebuffer& buffer, Mesh& mesh, Loaded
     if (!buffer.Get<u32>(numRenderBatches))
         return false;
 
-    u32 renderBatchesSize = static_cast<u32>(mapObject.renderBatches.size());
-    mapObject.renderBatches.resize(renderBatchesSize + numRenderBatches);
+    mesh.renderBatches.resize(numRenderBatches);
 
     // Read RenderBatches
-    if (!buffer.GetBytes(reinterpret_cast<u8*>(&mapObject.renderBatches.data()[renderBatchesSize]), numRenderBatches * sizeof(Terrain::RenderBatch)))
+    if (!buffer.GetBytes(reinterpret_cast<u8*>(mesh.renderBatches.data()), numRenderBatches * sizeof(Terrain::RenderBatch)))
         return false;
 
-    mapObject.renderBatchOffsets.reserve(renderBatchesSize + numRenderBatches);
-    for (u32 i = 0; i < numRenderBatches; i++)
-    {
-        RenderBatchOffsets& renderBatchOffsets = mapObject.renderBatchOffsets.emplace_back();
-        renderBatchOffsets.baseVertexOffset = mesh.baseVertexOffset;
-        renderBatchOffsets.baseIndexOffset = mesh.baseIndexOffset;
-        renderBatchOffsets.baseVertexColor1Offset = mesh.baseVertexColor1Offset;
-        renderBatchOffsets.baseVertexColor2Offset = mesh.baseVertexColor2Offset;
-
-        u32 renderBatchIndex = renderBatchesSize + i;
-        Terrain::RenderBatch& renderBatch = mapObject.renderBatches[renderBatchIndex];
-        // MaterialParameters
-        u32 materialParameterID = static_cast<u32>(_materialParameters.size());
-
-        mapObject.materialParameterIDs.push_back(materialParameterID);
-
-        MaterialParameters& materialParameters = _materialParameters.emplace_back();
-        materialParameters.materialID = mapObject.baseMaterialOffset + renderBatch.materialID;
-        materialParameters.exteriorLit = static_cast<u32>(mesh.renderFlags.exteriorLit || mesh.renderFlags.exterior);
-    }
-
     // Read culling data
-    u32 cullingDataSize = static_cast<u32>(mapObject.cullingData.size());
-
-    mapObject.cullingData.resize(cullingDataSize + numRenderBatches);
+    mesh.cullingData.resize(numRenderBatches);
 
-    if (!buffer.GetBytes(reinterpret_cast<u8*>(&mapObject.cullingData.data()[cullingDataSize]), numRenderBatches * sizeof(Terrain::CullingData)))
+    if (!buffer.GetBytes(reinterpret_cast<u8*>(mesh.cullingData.data()), numRenderBatches * sizeof(Terrain::CullingData)))
         return false;
 
     return true;
 }
 
-void MapObjectRenderer::AddInstance(LoadedMapObject& mapObject, const Terrain::Placement* placement)
+void MapObjectRenderer::AddInstance(LoadedMapObject& mapObject, const Terrain::Placement& placement)
 {
     u32 instanceID = static_cast<u32>(_instances.size());
     mapObject.instanceIDs.push_back(instanceID);
     
     InstanceData& instance = _instances.emplace_back();
     
-    vec3 pos = placement->position;
-    vec3 rot = glm::radians(placement->rotation);
+    vec3 pos = placement.position;
+    vec3 rot = glm::radians(placement.rotation);
     mat4x4 rotationMatrix = glm::eulerAngleZYX(rot.z, -rot.y, -rot.x);
 
     instance.instanceMatrix = glm::translate(mat4x4(1.0f), pos) * rotationMatrix;
@@ -809,100 +1209,16 @@ void MapObjectRenderer::AddInstance(LoadedMapObject& mapObject, const Terrain::P
     mapObject.instanceCount++;
 }
 
-void MapObjectRenderer::CreateBuffers()
+void MapObjectRenderer::UpdateBuffers()
 {
-    // Create Instance Lookup Buffer
-    if (_instanceLookupBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_instanceLookupBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "InstanceLookupDataBuffer";
-        desc.size = sizeof(InstanceLookupData) * _instanceLookupData.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _instanceLookupBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "InstanceLookupDataStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
+    // Loads only append to these, so only what got added since the last update has to be uploaded
+    const u8 storageUsage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
 
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
+    ResidencyUtils::UploadAppended(_renderer, _instanceLookupBuffer, _instanceLookupData, "InstanceLookupDataBuffer", storageUsage);
 
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _instanceLookupData.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_instanceLookupBuffer, 0, stagingBuffer, 0, desc.size);
-
-        _passDescriptorSet.Bind("_packedInstanceLookup", _instanceLookupBuffer);
-        _cullingDescriptorSet.Bind("_packedInstanceLookup", _instanceLookupBuffer);
-    }
-    
-    // Create Indirect Argument buffer
-    if (_argumentBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_argumentBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectIndirectArgs";
-        desc.size = sizeof(DrawParameters) * _drawParameters.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION | Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER;
-        _argumentBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "MapObjectIndirectStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _drawParameters.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to first buffer
-        _renderer->CopyBuffer(_argumentBuffer, 0, stagingBuffer, 0, desc.size);
-    }
-
-    // Create Culled Indirect Argument buffer
-    if (_culledArgumentBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_culledArgumentBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectCulledIndirectArgs";
-        desc.size = sizeof(DrawParameters) * _drawParameters.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION | Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER;
-        _culledArgumentBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "MapObjectIndirectStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _drawParameters.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to second buffer
-        _renderer->CopyBuffer(_culledArgumentBuffer, 0, stagingBuffer, 0, desc.size);
-    }
+    // The culled arguments are written by the culling pass
+    ResidencyUtils::UploadAppended(_renderer, _argumentBuffer, _drawParameters, "MapObjectIndirectArgs", storageUsage | Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER);
+    ResidencyUtils::Reserve(_renderer, _culledArgumentBuffer, sizeof(DrawParameters), _drawParameters.size(), "MapObjectCulledIndirectArgs", storageUsage | Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER);
 
     // Create draw count buffer
     if (_drawCountBuffer == Renderer::BufferID::Invalid())
@@ -932,194 +1248,36 @@ void MapObjectRenderer::CreateBuffers()
         _triangleCountReadBackBuffer = _renderer->CreateBuffer(desc);
     }
 
-    // Create Vertex buffer
-    if (_vertexBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_vertexBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectVertexBuffer";
-        desc.size = sizeof(Terrain::MapObjectVertex) * _vertices.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _vertexBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "MapObjectVertexStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _vertices.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_vertexBuffer, 0, stagingBuffer, 0, desc.size);
-
-        _passDescriptorSet.Bind("_packedVertices", _vertexBuffer);
-    }
-
-    // Create Index buffer
-    if (_indexBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_indexBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectIndexBuffer";
-        desc.size = sizeof(u16) * _indices.size();
-        desc.usage = Renderer::BufferUsage::INDEX_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _indexBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "MapObjectIndexStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _indices.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_indexBuffer, 0, stagingBuffer, 0, desc.size);
-    }
-
-    // Create Instance buffer
-    if (_instanceBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_instanceBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectInstanceBuffer";
-        desc.size = sizeof(InstanceData) * _instances.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _instanceBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "MapObjectInstanceStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _instances.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_instanceBuffer, 0, stagingBuffer, 0, desc.size);
-
-        _passDescriptorSet.Bind("_instanceData", _instanceBuffer);
-        _cullingDescriptorSet.Bind("_instanceData", _instanceBuffer);
-    }
-
-    // Create Material buffer
-    if (_materialBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_materialBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectMaterialBuffer";
-        desc.size = sizeof(Material) * _materials.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _materialBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "MapObjectMaterialStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _materials.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_materialBuffer, 0, stagingBuffer, 0, desc.size);
-
-        _passDescriptorSet.Bind("_packedMaterialData", _materialBuffer);
-    }
-
-    // Create MaterialParam buffer
-    if (_materialParametersBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_materialParametersBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectMaterialParamBuffer";
-        desc.size = sizeof(MaterialParameters) * _materialParameters.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _materialParametersBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "MapObjectMaterialParamStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _materialParameters.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_materialParametersBuffer, 0, stagingBuffer, 0, desc.size);
-
-        _passDescriptorSet.Bind("_packedMaterialParams", _materialParametersBuffer);
-    }
-
-    // Create CullingData buffer
-    if (_cullingDataBuffer != Renderer::BufferID::Invalid())
-    {
-        _renderer->QueueDestroyBuffer(_cullingDataBuffer);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectCullingDataBuffer";
-        desc.size = sizeof(Terrain::CullingData) * _cullingData.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _cullingDataBuffer = _renderer->CreateBuffer(desc);
-
-        // Create staging buffer
-        desc.name = "MapObjectCullingDataStaging";
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _cullingData.data(), desc.size);
-        _renderer->UnmapBuffer(stagingBuffer);
+    ResidencyUtils::UploadAppended(_renderer, _vertexBuffer, _vertices, "MapObjectVertexBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _indexBuffer, _indices, "MapObjectIndexBuffer", Renderer::BufferUsage::INDEX_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION);
+    ResidencyUtils::UploadAppended(_renderer, _instanceBuffer, _instances, "MapObjectInstanceBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _materialBuffer, _materials, "MapObjectMaterialBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _materialParametersBuffer, _materialParameters, "MapObjectMaterialParamBuffer", storageUsage);
+    ResidencyUtils::UploadAppended(_renderer, _cullingDataBuffer, _cullingData, "MapObjectCullingDataBuffer", storageUsage);
+
+    // Any of these can have been recreated to make room
+    _passDescriptorSet.Bind("_packedInstanceLookup", _instanceLookupBuffer.buffer);
+    _cullingDescriptorSet.Bind("_packedInstanceLookup", _instanceLookupBuffer.buffer);
+    _passDescriptorSet.Bind("_packedVertices", _vertexBuffer.buffer);
+    _passDescriptorSet.Bind("_instanceData", _instanceBuffer.buffer);
+    _cullingDescriptorSet.Bind("_instanceData", _instanceBuffer.buffer);
+    _passDescriptorSet.Bind("_packedMaterialData", _materialBuffer.buffer);
+    _passDescriptorSet.Bind("_packedMaterialParams", _materialParametersBuffer.buffer);
+    _cullingDescriptorSet.Bind("_packedCullingData", _cullingDataBuffer.buffer);
+}
 
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_cullingDataBuffer, 0, stagingBuffer, 0, desc.size);
+void MapObjectRenderer::InvalidateInstanceBuffers()
+{
+    ResidencyUtils::Invalidate(_instanceLookupBuffer);
+    ResidencyUtils::Invalidate(_argumentBuffer);
+    ResidencyUtils::Invalidate(_instanceBuffer);
+}
 
-        _cullingDescriptorSet.Bind("_packedCullingData", _cullingDataBuffer);
-    }
+void MapObjectRenderer::InvalidateMapObjectBuffers()
+{
+    ResidencyUtils::Invalidate(_vertexBuffer);
+    ResidencyUtils::Invalidate(_indexBuffer);
+    ResidencyUtils::Invalidate(_materialBuffer);
+    ResidencyUtils::Invalidate(_materialParametersBuffer);
+    ResidencyUtils::Invalidate(_cullingDataBuffer);
 }
@@ -3,6 +3,7 @@
 #include <robin_hood.h>
 #include <filesystem>
 #include <Utils/ByteBuffer.h>
+#include <taskflow/taskflow.hpp>
 
 #include <Renderer/Buffer.h>
 #include <Renderer/Descriptors/SamplerDesc.h>
@@ -11,7 +12,10 @@
 #include <Renderer/Descriptors/BufferDesc.h>
 
 #include "ViewConstantBuffer.h"
+#include "ResidencyUtils.h"
+#include "../Gameplay/Map/Chunk.h"
 #include "../Gameplay/Map/MapObject.h"
+#include "../Gameplay/Map/MapObjectRoot.h"
 
 namespace Renderer
 {
@@ -33,12 +37,6 @@ class DebugRenderer;
 
 class MapObjectRenderer
 {
-    struct MeshRoot
-    {
-        u32 numMaterials;
-        u32 numMeshes;
-    };
-
     struct RenderBatch
     {
         u32 firstIndex;
@@ -58,12 +56,38 @@ class MapObjectRenderer
 
     struct MapObjectToBeLoaded
     {
-        const Terrain::Placement* placement = nullptr;
+        // Copied out of the chunk, the chunk that registered it can be unloaded while another resident chunk keeps it waiting
+        Terrain::Placement placement;
+        std::string nmorName;
+        u32 nmorNameHash = 0;
+    };
+
+    // Staging data for a single .nmo file, decoded on a taskflow worker
+    struct MeshToBeParsed
+    {
+        Terrain::MapObjectFlags renderFlags;
+
+        std::vector<u16> indices;
+        std::vector<Terrain::MapObjectVertex> vertices;
+
+        u32 numVertexColorSets = 0;
+        std::vector<u32> vertexColors[2];
+
+        std::vector<Terrain::RenderBatch> renderBatches;
+        std::vector<Terrain::CullingData> cullingData;
+    };
+
+    // Staging data for a unique .nmor and all of its meshes, these get merged into the global arrays once every object is decoded
+    struct MapObjectToBeParsed
+    {
         const std::string* nmorName = nullptr;
         u32 nmorNameHash = 0;
 
-        MeshRoot meshRoot;
-        std::vector<Mesh> meshes;
+        std::vector<Terrain::MapObjectMaterial> materials;
+        std::vector<MeshToBeParsed> meshes;
+
+        bool succeeded = false;
+        std::string error; // Filled by the worker, reported once parsing is done
     };
 
     struct DrawParameters
@@ -90,11 +114,24 @@ class MapObjectRenderer
     };
 
 public:
+    // Where a loaded map object lives in the global arrays, used to compact them when map objects get unloaded
+    struct ResidentRanges
+    {
+        ResidentRange materials;
+        ResidentRange indices;
+        ResidentRange vertices;
+        ResidentRange materialParameters;
+        ResidentRange cullingData;
+    };
+
     struct LoadedMapObject
     {
         u32 objectID;
         std::string debugName = "";
 
+        u32 nameHash = 0;
+        ResidentRanges residentRanges;
+
         std::vector<u32> drawParameterIDs;
         std::vector<u16> materialParameterIDs;
 
@@ -104,7 +141,7 @@ public:
         std::vector<u32> vertexColors[2];
 
         u32 vertexColorTextureIDs[2] = { 0, 0 };
-        u32 instanceCount;
+        u32 instanceCount = 0; // The number of placements using this map object, map objects without any get unloaded along with their textures by the next ExecuteLoad that doesn't need them
 
         u32 baseVertexOffset = 0;
         u32 baseMaterialOffset = 0;
@@ -146,8 +183,12 @@ public:
 
     void RegisterMapObjectToBeLoaded(const std::string& mapObjectName, const Terrain::Placement& mapObjectPlacement);
     void RegisterMapObjectsToBeLoaded(u16 chunkID, const Terrain::Chunk& chunk, StringTable& stringTable);
+    // Removes the placements only this chunk was holding on to, the next ExecuteLoad unloads the map objects that lost their last instance
+    void UnloadChunk(u16 chunkID, const Terrain::Chunk& chunk);
     void ExecuteLoad();
 
+    // Removes every placement but keeps the loaded map objects resident, map objects the next load doesn't use again get unloaded by it
+    void ClearInstances();
     void Clear();
 
     const std::vector<LoadedMapObject>& GetLoadedMapObjects() { return _loadedMapObjects; }
@@ -169,19 +210,29 @@ public:
 
 private:
     void CreatePermanentResources();
-    bool LoadMapObject(MapObjectToBeLoaded& mapObjectToBeLoaded, LoadedMapObject& mapObject);
+    void ParseMapObjects(std::vector<MapObjectToBeParsed>& mapObjectsToBeParsed);
+    void ReserveMapObjects(const std::vector<MapObjectToBeParsed>& mapObjectsToBeParsed);
+    bool LoadMapObject(MapObjectToBeParsed& mapObjectToBeParsed, LoadedMapObject& mapObject);
+    bool UnloadUnreferencedMapObjects();
+
+    // Sub parsers, these only write to the staging data they are given so they are safe to run on any thread
+    static bool ParseMapObject(MapObjectToBeParsed& mapObjectToBeParsed);
+    static bool ParseRoot(const std::filesystem::path nmorPath, MapObjectToBeParsed& mapObjectToBeParsed, u32& numMeshes, std::string& error);
+    static bool ParseMesh(const std::filesystem::path nmoPath, MeshToBeParsed& mesh, std::string& error);
 
-    // Sub loaders
-    bool LoadRoot(const std::filesystem::path nmorPath, MeshRoot& meshRoot, LoadedMapObject& mapObject);
-    bool LoadMesh(const std::filesystem::path nmoPath, Mesh& mesh, LoadedMapObject& mapObject);
+    static bool ParseIndicesAndVertices(Bytebuffer& buffer, MeshToBeParsed& mesh);
 
-    bool LoadIndicesAndVertices(Bytebuffer& buffer, Mesh& mesh, LoadedMapObject& mapObject);
+    static bool ParseRenderBatches(Bytebuffer& buffer, MeshToBeParsed& mesh);
 
-    bool LoadRenderBatches(Bytebuffer& buffer, Mesh& mesh, LoadedMapObject& mapObject);
+    void AddInstance(LoadedMapObject& mapObject, const Terrain::Placement& placement);
 
-    void AddInstance(LoadedMapObject& mapObject, const Terrain::Placement* placement);
+    // Removes the instances whose placement is in removedUniqueIDs, the instances after them move down to keep everything in load order
+    void RemoveInstances(const robin_hood::unordered_set<u32>& removedUniqueIDs);
 
-    void CreateBuffers();
+    void UpdateBuffers();
+    // The next UpdateBuffers uploads these arrays in full, needed after they were compacted or patched in place
+    void InvalidateInstanceBuffers();
+    void InvalidateMapObjectBuffers();
 
     struct Material
     {
@@ -230,30 +281,32 @@ private:
 
     Renderer::Buffer<CullingConstants>* _cullingConstantBuffer;
 
-    Renderer::BufferID _argumentBuffer;
-    Renderer::BufferID _culledArgumentBuffer;
+    ResidentBuffer _argumentBuffer;
+    ResidentBuffer _culledArgumentBuffer;
     Renderer::BufferID _drawCountBuffer;
     Renderer::BufferID _drawCountReadBackBuffer;
     Renderer::BufferID _triangleCountBuffer;
     Renderer::BufferID _triangleCountReadBackBuffer;
 
-    Renderer::BufferID _vertexBuffer;
-    Renderer::BufferID _indexBuffer;
-    Renderer::BufferID _instanceBuffer;
-    Renderer::BufferID _instanceLookupBuffer;
-    Renderer::BufferID _materialBuffer;
-    Renderer::BufferID _materialParametersBuffer;
-    Renderer::BufferID _cullingDataBuffer;
+    ResidentBuffer _vertexBuffer;
+    ResidentBuffer _indexBuffer;
+    ResidentBuffer _instanceBuffer;
+    ResidentBuffer _instanceLookupBuffer;
+    ResidentBuffer _materialBuffer;
+    ResidentBuffer _materialParametersBuffer;
+    ResidentBuffer _cullingDataBuffer;
 
     Renderer::TextureArrayID _mapObjectTextures;
 
     robin_hood::unordered_map<u32, u8> _uniqueIdCounter;
     robin_hood::unordered_map<u16, u32> _mapChunkToPlacementOffset;
     std::vector<Terrain::PlacementDetails> _mapObjectPlacementDetails;
+    bool _hasRemovedInstances = false;
 
     u32 _numSurvivingDrawCalls;
     u32 _numTriangles;
     u32 _numSurvivingTriangles;
 
     std::vector<MapObjectToBeLoaded> _mapObjectsToBeLoaded;
+    tf::Taskflow _loadTaskflow;
 };
\ No newline at end of file
@@ -56,17 +56,20 @@ void PixelQuery::AddPixelQueryPass(Renderer::RenderGraph* renderGraph, Renderer:
     {
         struct PixelQueryPassData
         {
-            Renderer::RenderPassMutableResource mainColor;
-            Renderer::RenderPassMutableResource mainObject;
-            Renderer::RenderPassMutableResource mainDepth;
+            Renderer::RenderPassResource mainObject;
         };
 
         renderGraph->AddPass<PixelQueryPassData>("Query Pass",
             [=](PixelQueryPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
             {
-                data.mainColor = builder.Write(colorTarget, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
-                data.mainObject = builder.Write(objectTarget, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
-                data.mainDepth = builder.Write(depthTarget, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+                // Nothing to query, skip the pass but keep flipping between the request lists like Execute would
+                if (_requests[_frameIndex].empty())
+                {
+                    _frameIndex = !_frameIndex;
+                    return false;
+                }
+
+                data.mainObject = builder.Read(objectTarget, Renderer::RenderGraphBuilder::ShaderStage::COMPUTE);
 
                 return true; // Return true from setup to enable this pass, return false to disable it
             },
@@ -80,10 +83,6 @@ void PixelQuery::AddPixelQueryPass(Renderer::RenderGraph* renderGraph, Renderer:
                     std::string frameIndexStr = "FrameIndex: " + std::to_string(_frameIndex);
                     TracyMessage(frameIndexStr.c_str(), frameIndexStr.length());
 
-                    {
-                        ZoneScopedN("PixelQuery::ImageBarrier");
-                        commandList.ImageBarrier(objectTarget);
-                    }
                     commandList.PushMarker("Pixel Queries " + std::to_string(numRequests), Color::White);
                     Renderer::ComputePipelineDesc queryPipelineDesc;
                     resources.InitializePipelineDesc(queryPipelineDesc);
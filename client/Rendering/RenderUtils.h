@@ -13,6 +13,7 @@ namespace Renderer
     class CommandList;
 }
 
+// The pass calling these has to declare a pixel shader Read of the input or overlay image, the render graph places the barriers for it
 class RenderUtils
 {
 public:
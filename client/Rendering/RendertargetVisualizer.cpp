@@ -316,13 +316,52 @@ void RendertargetVisualizer::AddVisualizerPass(Renderer::RenderGraph* renderGrap
     struct RTVisualizerData
     {
         Renderer::RenderPassMutableResource target;
+
+        bool drawOverride = false;
+        bool drawOverlay = false;
     };
 
     renderGraph->AddPass<RTVisualizerData>("RTVisualizer",
         [=](RTVisualizerData& data, Renderer::RenderGraphBuilder& builder)
         {
+            // Transient images only exist in the frames whose render graph created them, so a selected one might not have any memory this frame
+            const bool hasOverride = _overridingImageID != Renderer::ImageID::Invalid() || _overridingDepthImageID != Renderer::DepthImageID::Invalid();
+            const bool hasOverlay = _overlayingImageID != Renderer::ImageID::Invalid() || _overlayingDepthImageID != Renderer::DepthImageID::Invalid();
+
+            data.drawOverride = hasOverride && (_overridingImageID != Renderer::ImageID::Invalid() ? _renderer->IsImageAvailable(_overridingImageID) : _renderer->IsImageAvailable(_overridingDepthImageID));
+            data.drawOverlay = hasOverlay && (_overlayingImageID != Renderer::ImageID::Invalid() ? _renderer->IsImageAvailable(_overlayingImageID) : _renderer->IsImageAvailable(_overlayingDepthImageID));
+
+            // Nothing to show, skip the pass so the visualizer doesn't keep anything alive
+            if (!data.drawOverride && !data.drawOverlay)
+                return false;
+
             data.target = builder.Write(colorTarget, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
 
+            // RenderUtils samples these, declaring them lets the render graph wait for whoever wrote them this frame
+            if (data.drawOverride)
+            {
+                if (_overridingImageID != Renderer::ImageID::Invalid())
+                {
+                    builder.Read(_overridingImageID, Renderer::RenderGraphBuilder::ShaderStage::PIXEL);
+                }
+                else
+                {
+                    builder.Read(_overridingDepthImageID, Renderer::RenderGraphBuilder::ShaderStage::PIXEL);
+                }
+            }
+
+            if (data.drawOverlay)
+            {
+                if (_overlayingImageID != Renderer::ImageID::Invalid())
+                {
+                    builder.Read(_overlayingImageID, Renderer::RenderGraphBuilder::ShaderStage::PIXEL);
+                }
+                else
+                {
+                    builder.Read(_overlayingDepthImageID, Renderer::RenderGraphBuilder::ShaderStage::PIXEL);
+                }
+            }
+
             return true;
         },
         [=](RTVisualizerData& data, Renderer::RenderGraphResources& resources, Renderer::CommandList& commandList)
@@ -330,7 +369,7 @@ void RendertargetVisualizer::AddVisualizerPass(Renderer::RenderGraph* renderGrap
             GPU_SCOPED_PROFILER_ZONE(commandList, CModelPass);
 
             // Override
-            if (_overridingImageID != Renderer::ImageID::Invalid())
+            if (data.drawOverride && _overridingImageID != Renderer::ImageID::Invalid())
             {
                 RenderUtils::BlitParams blitParams;
                 blitParams.input = _overridingImageID;
@@ -345,7 +384,7 @@ void RendertargetVisualizer::AddVisualizerPass(Renderer::RenderGraph* renderGrap
 
                 RenderUtils::Blit(_renderer, resources, commandList, frameIndex, blitParams);
             }
-            else if (_overridingDepthImageID != Renderer::DepthImageID::Invalid())
+            else if (data.drawOverride)
             {
                 RenderUtils::DepthBlitParams blitParams;
                 blitParams.input = _overridingDepthImageID;
@@ -361,7 +400,7 @@ void RendertargetVisualizer::AddVisualizerPass(Renderer::RenderGraph* renderGrap
             }
 
             // Overlay
-            if (_overlayingImageID != Renderer::ImageID::Invalid())
+            if (data.drawOverlay && _overlayingImageID != Renderer::ImageID::Invalid())
             {
                 RenderUtils::OverlayParams overlayParams;
                 overlayParams.overlayImage = _overlayingImageID;
@@ -377,7 +416,7 @@ void RendertargetVisualizer::AddVisualizerPass(Renderer::RenderGraph* renderGrap
 
                 RenderUtils::Overlay(_renderer, resources, commandList, frameIndex, overlayParams);
             }
-            else if (_overlayingDepthImageID != Renderer::DepthImageID::Invalid())
+            else if (data.drawOverlay)
             {
                 RenderUtils::DepthOverlayParams overlayParams;
                 overlayParams.overlayImage = _overlayingDepthImageID;
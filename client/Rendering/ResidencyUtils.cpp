@@ -0,0 +1,70 @@
+#include "ResidencyUtils.h"
+
+#include <Renderer/Renderer.h>
+
+// Growing by half again keeps streaming in a few more placements from recreating the buffer every time
+static size_t GetCapacityWithHeadroom(size_t numElements)
+{
+    return numElements + (numElements / 2);
+}
+
+void ResidencyUtils::UploadAppended(Renderer::Renderer* renderer, ResidentBuffer& residentBuffer, const void* data, size_t elementSize, size_t numElements, const std::string& name, u8 usage)
+{
+    if (numElements == 0)
+    {
+        residentBuffer.numUploaded = 0;
+        return;
+    }
+
+    if (numElements > residentBuffer.capacity)
+    {
+        if (residentBuffer.buffer != Renderer::BufferID::Invalid())
+        {
+            renderer->QueueDestroyBuffer(residentBuffer.buffer);
+        }
+
+        residentBuffer.capacity = GetCapacityWithHeadroom(numElements);
+
+        Renderer::BufferDesc desc;
+        desc.name = name;
+        desc.size = elementSize * residentBuffer.capacity;
+        desc.usage = usage;
+        residentBuffer.buffer = renderer->CreateBuffer(desc);
+        residentBuffer.numUploaded = 0;
+    }
+
+    // The array shrank without being invalidated, we can't tell what changed so upload all of it
+    if (numElements < residentBuffer.numUploaded)
+    {
+        residentBuffer.numUploaded = 0;
+    }
+
+    const size_t numNewElements = numElements - residentBuffer.numUploaded;
+    if (numNewElements > 0)
+    {
+        const u8* bytes = static_cast<const u8*>(data);
+        renderer->UploadToBuffer(residentBuffer.buffer, elementSize * residentBuffer.numUploaded, bytes + (elementSize * residentBuffer.numUploaded), elementSize * numNewElements);
+    }
+
+    residentBuffer.numUploaded = numElements;
+}
+
+void ResidencyUtils::Reserve(Renderer::Renderer* renderer, ResidentBuffer& residentBuffer, size_t elementSize, size_t numElements, const std::string& name, u8 usage)
+{
+    numElements = std::max(numElements, static_cast<size_t>(1));
+    if (numElements <= residentBuffer.capacity)
+        return;
+
+    if (residentBuffer.buffer != Renderer::BufferID::Invalid())
+    {
+        renderer->QueueDestroyBuffer(residentBuffer.buffer);
+    }
+
+    residentBuffer.capacity = GetCapacityWithHeadroom(numElements);
+
+    Renderer::BufferDesc desc;
+    desc.name = name;
+    desc.size = elementSize * residentBuffer.capacity;
+    desc.usage = usage;
+    residentBuffer.buffer = renderer->CreateBuffer(desc);
+}
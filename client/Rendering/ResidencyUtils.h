@@ -0,0 +1,78 @@
+#pragma once
+#include <NovusTypes.h>
+#include <algorithm>
+#include <vector>
+
+#include <Renderer/Descriptors/BufferDesc.h>
+
+namespace Renderer
+{
+    class Renderer;
+}
+
+// The model renderers append every loaded model to shared arrays, a ResidentRange remembers which part of one of those arrays belongs to a model
+struct ResidentRange
+{
+    u32 offset = 0;
+    u32 count = 0;
+};
+
+// The GPU copy of one of those arrays, between compactions the arrays only get appended to so only the new elements have to be uploaded
+struct ResidentBuffer
+{
+    Renderer::BufferID buffer = Renderer::BufferID::Invalid();
+    size_t capacity = 0; // In elements
+    size_t numUploaded = 0;
+};
+
+class ResidencyUtils
+{
+public:
+    template <typename T>
+    static void BeginRange(const std::vector<T>& data, ResidentRange& range)
+    {
+        range.offset = static_cast<u32>(data.size());
+        range.count = 0;
+    }
+
+    template <typename T>
+    static void EndRange(const std::vector<T>& data, ResidentRange& range)
+    {
+        range.count = static_cast<u32>(data.size()) - range.offset;
+    }
+
+    // Moves range down to writeOffset and advances writeOffset past it, returns how far the range moved
+    // Ranges have to be compacted in the order they were appended, the caller shrinks the array to the final writeOffset afterwards
+    template <typename T>
+    static u32 CompactRange(std::vector<T>& data, ResidentRange& range, u32& writeOffset)
+    {
+        const u32 distance = range.offset - writeOffset;
+        if (distance > 0 && range.count > 0)
+        {
+            std::move(data.begin() + range.offset, data.begin() + range.offset + range.count, data.begin() + writeOffset);
+        }
+
+        range.offset = writeOffset;
+        writeOffset += range.count;
+
+        return distance;
+    }
+
+    // Uploads the elements appended since the last call, when they don't fit the buffer gets recreated with some headroom and everything is uploaded again
+    // Empty arrays leave the buffer as it is, the callers don't draw anything from them
+    template <typename T>
+    static void UploadAppended(Renderer::Renderer* renderer, ResidentBuffer& residentBuffer, const std::vector<T>& data, const std::string& name, u8 usage)
+    {
+        UploadAppended(renderer, residentBuffer, data.data(), sizeof(T), data.size(), name, usage);
+    }
+    static void UploadAppended(Renderer::Renderer* renderer, ResidentBuffer& residentBuffer, const void* data, size_t elementSize, size_t numElements, const std::string& name, u8 usage);
+
+    // For buffers the GPU fills itself, recreates the buffer with some headroom if numElements don't fit
+    static void Reserve(Renderer::Renderer* renderer, ResidentBuffer& residentBuffer, size_t elementSize, size_t numElements, const std::string& name, u8 usage);
+
+    // Call after the array was compacted or changed in place, the next UploadAppended uploads all of it
+    static void Invalidate(ResidentBuffer& residentBuffer)
+    {
+        residentBuffer.numUploaded = 0;
+    }
+};
@@ -0,0 +1,89 @@
+#include "TerrainChunkResidency.h"
+#include "../Gameplay/Map/Chunk.h"
+
+#include <algorithm>
+
+u32 TerrainChunkResidency::GetNumSlotsForRadius(u16 streamingRadius)
+{
+    const u32 residentSide = (streamingRadius + 1) * 2 + 1;
+    return std::min(residentSide * residentSide, Terrain::MAP_CHUNKS_PER_MAP);
+}
+
+void TerrainChunkResidency::Reset(u32 numSlots)
+{
+    Clear();
+    _numSlots = numSlots;
+
+    // Hand out the lowest slots first
+    _freeSlots.reserve(_numSlots);
+    for (u32 i = _numSlots; i > 0; i--)
+    {
+        _freeSlots.push_back(static_cast<u16>(i - 1));
+    }
+}
+
+void TerrainChunkResidency::Clear()
+{
+    _numSlots = 0;
+    _residentChunks.clear();
+    _freeSlots.clear();
+    _chunkIDToSlot.clear();
+}
+
+bool TerrainChunkResidency::Acquire(u16 chunkID, u16& outSlot)
+{
+    if (_freeSlots.empty())
+        return false;
+
+    outSlot = _freeSlots.back();
+    _freeSlots.pop_back();
+
+    _residentChunks.push_back(chunkID);
+    _chunkIDToSlot[chunkID] = outSlot;
+
+    return true;
+}
+
+bool TerrainChunkResidency::Release(u16 chunkID, u16& outSlot)
+{
+    auto slotItr = _chunkIDToSlot.find(chunkID);
+    if (slotItr == _chunkIDToSlot.end())
+        return false;
+
+    outSlot = slotItr->second;
+    _freeSlots.push_back(outSlot);
+    _chunkIDToSlot.erase(slotItr);
+
+    auto residentItr = std::find(_residentChunks.begin(), _residentChunks.end(), chunkID);
+    if (residentItr != _residentChunks.end())
+    {
+        *residentItr = _residentChunks.back();
+        _residentChunks.pop_back();
+    }
+
+    return true;
+}
+
+bool TerrainChunkResidency::GetSlot(u16 chunkID, u16& outSlot) const
+{
+    auto slotItr = _chunkIDToSlot.find(chunkID);
+    if (slotItr == _chunkIDToSlot.end())
+        return false;
+
+    outSlot = slotItr->second;
+    return true;
+}
+
+void TerrainChunkResidency::GatherOutsideRadius(const ivec2& center, i32 radius, std::vector<u16>& outChunkIDs) const
+{
+    for (const u16 chunkID : _residentChunks)
+    {
+        const ivec2 chunkPosition = ivec2(chunkID % Terrain::MAP_CHUNKS_PER_MAP_STRIDE, chunkID / Terrain::MAP_CHUNKS_PER_MAP_STRIDE);
+        const ivec2 distance = glm::abs(chunkPosition - center);
+
+        if (glm::max(distance.x, distance.y) > radius)
+        {
+            outChunkIDs.push_back(chunkID);
+        }
+    }
+}
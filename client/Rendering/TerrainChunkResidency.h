@@ -0,0 +1,36 @@
+#pragma once
+#include <NovusTypes.h>
+#include <robin_hood.h>
+#include <vector>
+
+// Tracks which chunk occupies which slot of the terrain buffers, slots of evicted chunks get handed out again
+class TerrainChunkResidency
+{
+public:
+    // Chunks are kept loaded until they are more than one chunk outside of the streaming radius, this is enough slots for that outer ring
+    static u32 GetNumSlotsForRadius(u16 streamingRadius);
+
+    void Reset(u32 numSlots);
+    void Clear();
+
+    // Returns false when every slot is taken
+    bool Acquire(u16 chunkID, u16& outSlot);
+    // Returns false when the chunk isn't resident
+    bool Release(u16 chunkID, u16& outSlot);
+
+    bool GetSlot(u16 chunkID, u16& outSlot) const;
+    bool IsResident(u16 chunkID) const { return _chunkIDToSlot.find(chunkID) != _chunkIDToSlot.end(); }
+
+    // Resident chunks that are more than radius chunks away from center on either axis
+    void GatherOutsideRadius(const ivec2& center, i32 radius, std::vector<u16>& outChunkIDs) const;
+
+    const std::vector<u16>& GetResidentChunks() const { return _residentChunks; }
+    u32 GetNumResidentChunks() const { return static_cast<u32>(_residentChunks.size()); }
+    u32 GetNumSlots() const { return _numSlots; }
+
+private:
+    u32 _numSlots = 0;
+    std::vector<u16> _residentChunks;
+    std::vector<u16> _freeSlots;
+    robin_hood::unordered_map<u16, u16> _chunkIDToSlot;
+};
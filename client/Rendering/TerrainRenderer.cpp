@@ -40,6 +40,10 @@ AutoCVar_Int CVAR_HeightBoxLockPosition("terrain.heightBox.LockPosition", "lock
 
 AutoCVar_Int CVAR_DrawCellGrid("terrain.cellGrid.Enable", "draw debug grid for displaying cells", 1, CVarFlags::EditCheckbox);
 
+AutoCVar_Int CVAR_StreamingEnabled("terrain.streaming.Enable", "stream chunks in and out around the camera instead of loading the whole map, applied on map load", 0, CVarFlags::EditCheckbox);
+AutoCVar_Int CVAR_StreamingRadius("terrain.streaming.Radius", "radius in chunks around the camera to keep loaded, applied on map load", 6);
+AutoCVar_Int CVAR_StreamingMaxLoadsPerFrame("terrain.streaming.MaxLoadsPerFrame", "max number of chunks to stream in per frame", 2);
+
 struct TerrainChunkData
 {
     u32 alphaMapID = 0;
@@ -110,6 +114,8 @@ void TerrainRenderer::Update(f32 deltaTime)
         _debugRenderer->DrawAABB3D(min, max, 0xff00ff00);
     }
     
+    UpdateStreaming(camera);
+
     if (CVAR_DrawCellGrid.Get())
     {
         DebugRenderCellTriangles(camera);
@@ -124,7 +130,7 @@ void TerrainRenderer::Update(f32 deltaTime)
     }
 
     // Read back from culling counters
-    u32 numDrawCalls = Terrain::MAP_CELLS_PER_CHUNK * static_cast<u32>(_loadedChunks.size());
+    u32 numDrawCalls = Terrain::MAP_CELLS_PER_CHUNK * _chunkResidency.GetNumResidentChunks();
     _numSurvivingDrawCalls = numDrawCalls;
 
     if (cullingEnabled)
@@ -211,21 +217,20 @@ void TerrainRenderer::CPUCulling(const Camera* camera)
     }
 
     _culledInstances.clear();
-    _culledInstances.reserve(_loadedChunks.size() * Terrain::MAP_CELLS_PER_CHUNK);
+    _culledInstances.reserve(_chunkResidency.GetNumResidentChunks() * Terrain::MAP_CELLS_PER_CHUNK);
 
-    const size_t chunkCount = _loadedChunks.size();
-    size_t boundingBoxIndex = 0;
-    for (size_t i = 0; i < chunkCount; ++i)
+    for (const u16 chunkId : _chunkResidency.GetResidentChunks())
     {
+        u16 chunkSlot = 0;
+        _chunkResidency.GetSlot(chunkId, chunkSlot);
+
         for (u16 cellId = 0; cellId < Terrain::MAP_CELLS_PER_CHUNK; ++cellId)
         {
-            u32 index = static_cast<u32>(boundingBoxIndex++);
+            u32 index = (chunkSlot * Terrain::MAP_CELLS_PER_CHUNK) + cellId;
 
             const Geometry::AABoundingBox& boundingBox = _cellBoundingBoxes[index];
             if (IsInsideFrustum(frustumPlanes, boundingBox))
             {
-                const u16 chunkId = _loadedChunks[i];
-
                 CellInstance& cellInstance = _culledInstances.emplace_back();
                 cellInstance.packedChunkCellID = (chunkId << 16) | cellId;
                 cellInstance.instanceID = index;
@@ -278,6 +283,11 @@ void TerrainRenderer::AddTerrainPass(Renderer::RenderGraph* renderGraph, const R
             data.mainObject = builder.Write(objectTarget, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
             data.mainDepth = builder.Write(depthTarget, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
 
+            if (cullingEnabled && gpuCullEnabled)
+            {
+                builder.Read(depthPyramid, Renderer::RenderGraphBuilder::ShaderStage::COMPUTE);
+            }
+
             return true; // Return true from setup to enable this pass, return false to disable it
         },
             [=](TerrainPassData& data, Renderer::RenderGraphResources& resources, Renderer::CommandList& commandList) // Execute
@@ -368,7 +378,7 @@ void TerrainRenderer::AddTerrainPass(Renderer::RenderGraph* renderGraph, const R
                 commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, globalDescriptorSet, frameIndex);
                 commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_cullingPassDescriptorSet, frameIndex);
 
-                const u32 cellCount = (u32)_loadedChunks.size() * Terrain::MAP_CELLS_PER_CHUNK;
+                const u32 cellCount = _chunkResidency.GetNumResidentChunks() * Terrain::MAP_CELLS_PER_CHUNK;
                 commandList.Dispatch((cellCount + 31) / 32, 1, 1);
 
                 commandList.EndPipeline(pipeline);
@@ -449,7 +459,7 @@ void TerrainRenderer::AddTerrainPass(Renderer::RenderGraph* renderGraph, const R
             }
             else
             {
-                const u32 cellCount = Terrain::MAP_CELLS_PER_CHUNK * (u32)_loadedChunks.size();
+                const u32 cellCount = Terrain::MAP_CELLS_PER_CHUNK * _chunkResidency.GetNumResidentChunks();
                 TracyPlot("Cell Instance Count", (i64)cellCount);
                 commandList.DrawIndexed(Terrain::NUM_INDICES_PER_CELL, cellCount, 0, 0, 0);
             }
@@ -550,16 +560,7 @@ void TerrainRenderer::CreatePermanentResources()
 
     // Upload cell index buffer
     {
-        Renderer::BufferDesc indexUploadBufferDesc;
-        indexUploadBufferDesc.name = "TerrainCellIndexUploadBuffer";
-        indexUploadBufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-        indexUploadBufferDesc.size = sizeof(u16) * Terrain::NUM_INDICES_PER_CELL;
-        indexUploadBufferDesc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-
-        Renderer::BufferID indexUploadBuffer = _renderer->CreateBuffer(indexUploadBufferDesc);
-        _renderer->QueueDestroyBuffer(indexUploadBuffer);
-
-        u16* indices = static_cast<u16*>(_renderer->MapBuffer(indexUploadBuffer));
+        u16* indices = static_cast<u16*>(_renderer->StageUpload(_cellIndexBuffer, 0, sizeof(u16) * Terrain::NUM_INDICES_PER_CELL));
 
         // Fill index buffer
         size_t indexIndex = 0;
@@ -600,9 +601,6 @@ void TerrainRenderer::CreatePermanentResources()
                 indices[indexIndex++] = topRightVertex;
             }
         }
-
-        _renderer->UnmapBuffer(indexUploadBuffer);
-        _renderer->CopyBuffer(_cellIndexBuffer, 0, indexUploadBuffer, 0, indexUploadBufferDesc.size);
     }
 
     // Check if we should load a default map specified by Config
@@ -671,9 +669,10 @@ void TerrainRenderer::RegisterChunkToBeLoaded(Terrain::Map& map, u16 chunkPosX,
     chunkToBeLoaded.chunkID = chunkID;
 }
 
-void TerrainRenderer::ExecuteLoad()
+void TerrainRenderer::CreateChunkBuffers(u32 numChunkSlots)
 {
-    size_t numChunksToLoad = _chunksToBeLoaded.size();
+    _chunkResidency.Reset(glm::max(numChunkSlots, 1u));
+    const size_t numChunksToLoad = _chunkResidency.GetNumSlots();
 
     if (_instanceBuffer != Renderer::BufferID::Invalid())
     {
@@ -748,6 +747,13 @@ void TerrainRenderer::ExecuteLoad()
         _cellHeightRangeBuffer = _renderer->CreateBuffer(desc);
     }
 
+    _chunkSlotTextures.clear();
+    _chunkSlotTextures.resize(numChunksToLoad);
+    _cellBoundingBoxes.resize(numChunksToLoad * Terrain::MAP_CELLS_PER_CHUNK);
+}
+
+void TerrainRenderer::ExecuteLoad()
+{
     for (const ChunkToBeLoaded& chunk : _chunksToBeLoaded)
     {
         LoadChunk(chunk);
@@ -761,18 +767,25 @@ bool TerrainRenderer::LoadMap(const NDBC::Map* map)
     entt::registry* registry = ServiceLocator::GetGameRegistry();
     MapSingleton& mapSingleton = registry->ctx<MapSingleton>();
 
-    if (!Terrain::MapUtils::LoadMap(registry, map))
+    const bool streamChunks = CVAR_StreamingEnabled.Get() == 1;
+    if (!Terrain::MapUtils::LoadMap(registry, map, streamChunks))
         return false;
 
     Terrain::Map& currentMap = mapSingleton.GetCurrentMap();
 
-    // Clear Terrain, WMOs and Water
-    _loadedChunks.clear();
+    // Clear Terrain and Water, WMOs and CModels only drop their placements so objects shared with the new map stay loaded
+    // The ExecuteLoads below unload the ones the new map doesn't place along with their textures
+    _chunkResidency.Clear();
     _cellBoundingBoxes.clear();
-    _mapObjectRenderer->Clear();
-    _complexModelRenderer->Clear();
+    _chunkSlotTextures.clear();
+    _mapObjectRenderer->ClearInstances();
+    _complexModelRenderer->ClearInstances();
     _waterRenderer->Clear();
 
+    _isStreaming = false;
+    _hasPendingStreamingLoads = false;
+    _streamingCenterChunk = ivec2(-1, -1);
+
     // Unload everything but the first texture in our color array
     _renderer->UnloadTexturesInArray(_terrainColorTextureArray, 1);
     // Unload everything in our alpha array
@@ -784,6 +797,15 @@ bool TerrainRenderer::LoadMap(const NDBC::Map* map)
     {
         _mapObjectRenderer->RegisterMapObjectToBeLoaded(currentMap.header.mapObjectName, currentMap.header.mapObjectPlacement);
     }
+    else if (streamChunks)
+    {
+        _isStreaming = true;
+        _streamingRadius = static_cast<u16>(glm::clamp(CVAR_StreamingRadius.Get(), 1, 32));
+
+        CreateChunkBuffers(TerrainChunkResidency::GetNumSlotsForRadius(_streamingRadius));
+
+        // Chunks get streamed in by Update once we know where the camera is
+    }
     else
     {
         RegisterChunksToBeLoaded(currentMap, ivec2(32, 32), 32); // Load everything
@@ -792,46 +814,213 @@ bool TerrainRenderer::LoadMap(const NDBC::Map* map)
         //RegisterChunksToBeLoaded(map, ivec2(40, 32), 8); // Razor Hill
         //RegisterChunksToBeLoaded(map, ivec2(22, 25), 8); // Borean Tundra
 
+        CreateChunkBuffers(static_cast<u32>(_chunksToBeLoaded.size()));
         ExecuteLoad();
-    
-        // Upload instance data
+        UploadInstances();
+    }
+
+    _mapObjectRenderer->ExecuteLoad();
+    _complexModelRenderer->ExecuteLoad();
+
+    // Load Water
+    //_waterRenderer->LoadWater(_loadedChunks);
+
+    return true;
+}
+
+void TerrainRenderer::UpdateStreaming(const Camera* camera)
+{
+    if (!_isStreaming)
+        return;
+
+    ZoneScoped;
+
+    entt::registry* registry = ServiceLocator::GetGameRegistry();
+    MapSingleton& mapSingleton = registry->ctx<MapSingleton>();
+    Terrain::Map& currentMap = mapSingleton.GetCurrentMap();
+
+    if (!currentMap.IsLoadedMap())
+        return;
+
+    vec2 adtPos = Terrain::MapUtils::WorldPositionToADTCoordinates(camera->GetPosition());
+    vec2 chunkPos = Terrain::MapUtils::GetChunkFromAdtPosition(adtPos);
+
+    const i32 maxChunkPos = Terrain::MAP_CHUNKS_PER_MAP_STRIDE - 1;
+    ivec2 centerChunk = glm::clamp(ivec2(glm::floor(chunkPos)), ivec2(0, 0), ivec2(maxChunkPos, maxChunkPos));
+
+    bool residencyChanged = false;
+
+    // Take whatever the ChunkLoader finished since last frame, chunks that are still being read and decoded show up in a later frame
+    std::vector<u16> loadedChunkIDs;
+    std::vector<u16> failedChunkIDs;
+    std::vector<u16> changedNeighbours;
+    Terrain::MapUtils::PollChunks(currentMap, loadedChunkIDs, failedChunkIDs, &changedNeighbours);
+
+    for (const u16 chunkID : failedChunkIDs)
+    {
+        // Don't try this chunk again until the map is reloaded
+        currentMap.RemoveChunkFromDisk(chunkID);
+    }
+
+    for (const u16 chunkID : loadedChunkIDs)
+    {
+        RegisterChunkToBeLoaded(currentMap, chunkID % Terrain::MAP_CHUNKS_PER_MAP_STRIDE, chunkID / Terrain::MAP_CHUNKS_PER_MAP_STRIDE);
+    }
+
+    if (!_chunksToBeLoaded.empty())
+    {
+        ExecuteLoad();
+        residencyChanged = true;
+
+        // Already uploaded neighbours had their borders aligned against the new chunks, reupload their vertices
+        for (const u16 chunkID : changedNeighbours)
         {
-            const size_t cellCount = Terrain::MAP_CELLS_PER_CHUNK * _loadedChunks.size();
+            u16 chunkSlot = 0;
+            if (!_chunkResidency.GetSlot(chunkID, chunkSlot))
+                continue;
+
+            UploadChunkVertices(*currentMap.GetChunkById(chunkID), chunkSlot);
+        }
+    }
+
+    // Chunks that arrived can already be out of range again if the camera moved while they were loading
+    if (centerChunk != _streamingCenterChunk || _hasPendingStreamingLoads || !loadedChunkIDs.empty())
+    {
+        _streamingCenterChunk = centerChunk;
+        residencyChanged |= RequestStreamingChunks(currentMap, centerChunk);
+    }
 
-            Renderer::BufferDesc uploadBufferDesc;
-            uploadBufferDesc.name = "TerrainInstanceUploadBuffer";
-            uploadBufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-            uploadBufferDesc.size = sizeof(CellInstance) * cellCount;
-            uploadBufferDesc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
+    // Evicted chunks already removed their placements, ExecuteLoad unloads the objects nothing places anymore and uploads what changed
+    if (residencyChanged)
+    {
+        UploadInstances();
 
-            Renderer::BufferID instanceUploadBuffer = _renderer->CreateBuffer(uploadBufferDesc);
-            _renderer->QueueDestroyBuffer(instanceUploadBuffer);
+        _mapObjectRenderer->ExecuteLoad();
+        _complexModelRenderer->ExecuteLoad();
+    }
+}
 
-            void* instanceBufferMemory = _renderer->MapBuffer(instanceUploadBuffer);
-            CellInstance* instanceData = static_cast<CellInstance*>(instanceBufferMemory);
-            u32 instanceDataIndex = 0;
+bool TerrainRenderer::RequestStreamingChunks(Terrain::Map& currentMap, const ivec2& centerChunk)
+{
+    const i32 maxChunkPos = Terrain::MAP_CHUNKS_PER_MAP_STRIDE - 1;
+    bool residencyChanged = false;
 
-            for (const u16 chunkID : _loadedChunks)
-            {
-                for (u32 cellID = 0; cellID < Terrain::MAP_CELLS_PER_CHUNK; ++cellID)
-                {
-                    instanceData[instanceDataIndex].packedChunkCellID = (chunkID << 16) | (cellID & 0xffff);
-                    instanceData[instanceDataIndex++].instanceID = instanceDataIndex;
-                }
-            }
-            assert(instanceDataIndex == cellCount);
-            _renderer->UnmapBuffer(instanceUploadBuffer);
-            _renderer->CopyBuffer(_instanceBuffer, 0, instanceUploadBuffer, 0, uploadBufferDesc.size);
+    // Unload chunks that fell outside of the radius, we give them one chunk of slack so moving back and forth over a border doesn't thrash
+    const i32 unloadRadius = _streamingRadius + 1;
+    std::vector<u32> colorTexturesToRelease;
+    std::vector<u32> alphaTexturesToRelease;
+
+    std::vector<u16> chunkIDsToUnload;
+    _chunkResidency.GatherOutsideRadius(centerChunk, unloadRadius, chunkIDsToUnload);
+
+    for (const u16 chunkID : chunkIDsToUnload)
+    {
+        UnloadChunk(currentMap, chunkID, colorTexturesToRelease, alphaTexturesToRelease);
+        residencyChanged = true;
+    }
+
+    // Released together so evicting a whole row of chunks waits on the GPU at most once per array, textures shared with chunks that are still loaded stay loaded
+    _renderer->ReleaseTexturesInArray(_terrainColorTextureArray, colorTexturesToRelease.data(), static_cast<u32>(colorTexturesToRelease.size()));
+    _renderer->ReleaseTexturesInArray(_terrainAlphaTextureArray, alphaTexturesToRelease.data(), static_cast<u32>(alphaTexturesToRelease.size()));
+
+    // Gather the chunks inside the radius that exist on disk but aren't loaded yet, closest first
+    struct StreamingCandidate
+    {
+        u16 chunkID;
+        i32 distanceSqr;
+    };
+    std::vector<StreamingCandidate> candidates;
+
+    const ivec2 startPos = glm::max(centerChunk - ivec2(_streamingRadius), ivec2(0, 0));
+    const ivec2 endPos = glm::min(centerChunk + ivec2(_streamingRadius), ivec2(maxChunkPos, maxChunkPos));
+
+    for (i32 y = startPos.y; y <= endPos.y; y++)
+    {
+        for (i32 x = startPos.x; x <= endPos.x; x++)
+        {
+            const u16 chunkID = static_cast<u16>(x + (y * Terrain::MAP_CHUNKS_PER_MAP_STRIDE));
+
+            if (_chunkResidency.IsResident(chunkID))
+                continue;
+
+            if (Terrain::MapUtils::IsLoadingChunk(chunkID))
+                continue;
+
+            if (!currentMap.HasChunkOnDisk(chunkID))
+                continue;
+
+            const ivec2 offset = ivec2(x, y) - centerChunk;
+            candidates.push_back({ chunkID, (offset.x * offset.x) + (offset.y * offset.y) });
         }
     }
 
-    _mapObjectRenderer->ExecuteLoad();
-    _complexModelRenderer->ExecuteLoad();
+    std::sort(candidates.begin(), candidates.end(), [](const StreamingCandidate& a, const StreamingCandidate& b) { return a.distanceSqr < b.distanceSqr; });
 
-    // Load Water
-    //_waterRenderer->LoadWater(_loadedChunks);
+    const size_t maxLoadsPerFrame = static_cast<size_t>(glm::max(CVAR_StreamingMaxLoadsPerFrame.Get(), 1));
+    const size_t numChunksToLoad = glm::min(candidates.size(), maxLoadsPerFrame);
+    _hasPendingStreamingLoads = candidates.size() > numChunksToLoad;
 
-    return true;
+    std::vector<u16> chunkIDsToLoad;
+    chunkIDsToLoad.reserve(numChunksToLoad);
+    for (size_t i = 0; i < numChunksToLoad; i++)
+    {
+        chunkIDsToLoad.push_back(candidates[i].chunkID);
+    }
+
+    // This only queues the chunks, they get read and decoded on the workers and are picked up by PollChunks in a later frame
+    Terrain::MapUtils::RequestChunks(currentMap, chunkIDsToLoad);
+
+    return residencyChanged;
+}
+
+void TerrainRenderer::UnloadChunk(Terrain::Map& map, u16 chunkID, std::vector<u32>& colorTexturesToRelease, std::vector<u32>& alphaTexturesToRelease)
+{
+    u16 chunkSlot = 0;
+    if (!_chunkResidency.Release(chunkID, chunkSlot))
+        return;
+
+    ChunkSlotTextures& slotTextures = _chunkSlotTextures[chunkSlot];
+    colorTexturesToRelease.insert(colorTexturesToRelease.end(), slotTextures.colorTextureIDs.begin(), slotTextures.colorTextureIDs.end());
+    slotTextures.colorTextureIDs.clear();
+
+    if (slotTextures.alphaTextureID != std::numeric_limits<u32>().max())
+    {
+        alphaTexturesToRelease.push_back(slotTextures.alphaTextureID);
+        slotTextures.alphaTextureID = std::numeric_limits<u32>().max();
+    }
+
+    // The placements point into the chunk, so they have to go before it does
+    if (const Terrain::Chunk* chunk = map.GetChunkById(chunkID))
+    {
+        _mapObjectRenderer->UnloadChunk(chunkID, *chunk);
+        _complexModelRenderer->UnloadChunk(chunkID, *chunk);
+    }
+
+    Terrain::MapUtils::UnloadChunk(map, chunkID);
+}
+
+void TerrainRenderer::UploadInstances()
+{
+    const size_t cellCount = Terrain::MAP_CELLS_PER_CHUNK * _chunkResidency.GetNumResidentChunks();
+    if (cellCount == 0)
+        return;
+
+    CellInstance* instanceData = static_cast<CellInstance*>(_renderer->StageUpload(_instanceBuffer, 0, sizeof(CellInstance) * cellCount));
+    u32 instanceDataIndex = 0;
+
+    for (const u16 chunkID : _chunkResidency.GetResidentChunks())
+    {
+        // instanceID points to the cell in the slot based buffers, the instances themselves are tightly packed
+        u16 chunkSlot = 0;
+        _chunkResidency.GetSlot(chunkID, chunkSlot);
+
+        for (u32 cellID = 0; cellID < Terrain::MAP_CELLS_PER_CHUNK; ++cellID)
+        {
+            instanceData[instanceDataIndex].packedChunkCellID = (chunkID << 16) | (cellID & 0xffff);
+            instanceData[instanceDataIndex++].instanceID = (chunkSlot * Terrain::MAP_CELLS_PER_CHUNK) + cellID;
+        }
+    }
+    assert(instanceDataIndex == cellCount);
 }
 
 void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
@@ -846,22 +1035,39 @@ void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
     entt::registry* registry = ServiceLocator::GetGameRegistry();     
     TextureSingleton& textureSingleton = registry->ctx<TextureSingleton>();
 
-    size_t currentChunkIndex = _loadedChunks.size();
+    u16 chunkSlot = 0;
+    if (!_chunkResidency.Acquire(chunkID, chunkSlot))
+    {
+        // Nothing got registered for it yet, dropping it keeps the map from holding a chunk we never draw or evict
+        DebugHandler::PrintError("TerrainRenderer: Ran out of chunk slots, can't load chunk %u", chunkID);
+        Terrain::MapUtils::UnloadChunk(map, chunkID);
+        return;
+    }
+
+    size_t currentChunkIndex = chunkSlot;
+    ChunkSlotTextures& slotTextures = _chunkSlotTextures[chunkSlot];
 
-    // Upload cell data.
+    // Diffuse textures load asynchronously, the ones closest to the camera get loaded first
+    f32 texturePriority = 0.0f;
     {
-        Renderer::BufferDesc cellDataUploadBufferDesc;
-        cellDataUploadBufferDesc.name = "TerrainCellUploadBuffer";
-        cellDataUploadBufferDesc.size = sizeof(TerrainCellData) * Terrain::MAP_CELLS_PER_CHUNK;
-        cellDataUploadBufferDesc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        cellDataUploadBufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
+        Camera* camera = ServiceLocator::GetCamera();
+
+        // Same flip as the bounding boxes below, chunk X runs along world Y
+        vec2 chunkCenter;
+        chunkCenter.x = Terrain::MAP_HALF_SIZE - (chunkPosY * Terrain::MAP_CHUNK_SIZE) - Terrain::MAP_CHUNK_HALF_SIZE;
+        chunkCenter.y = Terrain::MAP_HALF_SIZE - (chunkPosX * Terrain::MAP_CHUNK_SIZE) - Terrain::MAP_CHUNK_HALF_SIZE;
 
-        Renderer::BufferID cellUploadBuffer = _renderer->CreateBuffer(cellDataUploadBufferDesc);
-        _renderer->QueueDestroyBuffer(cellUploadBuffer);
+        texturePriority = glm::distance(vec2(camera->GetPosition()), chunkCenter);
+    }
+
+    // Upload cell data.
+    {
+        const u64 cellBufferOffset = (currentChunkIndex * Terrain::MAP_CELLS_PER_CHUNK) * sizeof(TerrainCellData);
+        const u64 cellDataSize = sizeof(TerrainCellData) * Terrain::MAP_CELLS_PER_CHUNK;
 
-        TerrainCellData* cellDatas = static_cast<TerrainCellData*>(_renderer->MapBuffer(cellUploadBuffer));
+        TerrainCellData* cellDatas = static_cast<TerrainCellData*>(_renderer->StageUpload(_cellBuffer, cellBufferOffset, cellDataSize));
 
-        memset(cellDatas, 0, cellDataUploadBufferDesc.size);
+        memset(cellDatas, 0, cellDataSize);
 
         u32 chunkVertexOffset = static_cast<u32>(currentChunkIndex) * Terrain::NUM_VERTICES_PER_CHUNK;
 
@@ -888,19 +1094,16 @@ void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
                 textureDesc.path = texturePath;
 
                 u32 diffuseID = 0;
-                _renderer->LoadTextureIntoArray(textureDesc, _terrainColorTextureArray, diffuseID);
+                _renderer->LoadTextureIntoArrayAsync(textureDesc, _terrainColorTextureArray, diffuseID, texturePriority);
                 if (diffuseID > 4096)
                 {
                     DebugHandler::PrintFatal("This is bad!");
                 }
 
                 cellData.diffuseIDs[layerCount++] = diffuseID;
+                slotTextures.colorTextureIDs.push_back(diffuseID);
             }
         }
-
-        _renderer->UnmapBuffer(cellUploadBuffer);
-        const u64 cellBufferOffset = (currentChunkIndex * Terrain::MAP_CELLS_PER_CHUNK) * sizeof(TerrainCellData);
-        _renderer->CopyBuffer(_cellBuffer, cellBufferOffset, cellUploadBuffer, 0, cellDataUploadBufferDesc.size);
     }
 
     u32 alphaMapStringID = chunk.alphaMapStringID;
@@ -912,70 +1115,20 @@ void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
         chunkAlphaMapDesc.path = "Data/extracted/" + stringTable.GetString(alphaMapStringID);
 
         _renderer->LoadTextureIntoArray(chunkAlphaMapDesc, _terrainAlphaTextureArray, alphaID);
+        slotTextures.alphaTextureID = alphaID;
     }
 
     // Upload chunk data.
     {
-        Renderer::BufferDesc chunkDataUploadBufferDesc;
-        chunkDataUploadBufferDesc.name = "TerrainChunkUploadBuffer";
-        chunkDataUploadBufferDesc.size = sizeof(TerrainChunkData);
-        chunkDataUploadBufferDesc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        chunkDataUploadBufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID chunkUploadBuffer = _renderer->CreateBuffer(chunkDataUploadBufferDesc);
-        _renderer->QueueDestroyBuffer(chunkUploadBuffer);
+        TerrainChunkData chunkData;
+        chunkData.alphaMapID = alphaID;
 
-        TerrainChunkData* chunkData = static_cast<TerrainChunkData*>(_renderer->MapBuffer(chunkUploadBuffer));
-        chunkData->alphaMapID = alphaID;
-
-        _renderer->UnmapBuffer(chunkUploadBuffer);
         const u64 chunkBufferOffset = currentChunkIndex * sizeof(TerrainChunkData);
-        _renderer->CopyBuffer(_chunkBuffer, chunkBufferOffset, chunkUploadBuffer, 0, chunkDataUploadBufferDesc.size);
+        _renderer->UploadToBuffer(_chunkBuffer, chunkBufferOffset, &chunkData, sizeof(TerrainChunkData));
     }
 
     // Upload height data.
-    {
-        Renderer::BufferDesc vertexUploadBufferDesc;
-        vertexUploadBufferDesc.name = "TerrainVertexUploadBuffer";
-        vertexUploadBufferDesc.size = sizeof(TerrainVertex) * Terrain::NUM_VERTICES_PER_CHUNK;
-        vertexUploadBufferDesc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        vertexUploadBufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID vertexUploadBuffer = _renderer->CreateBuffer(vertexUploadBufferDesc);
-        _renderer->QueueDestroyBuffer(vertexUploadBuffer);
-
-        TerrainVertex* vertexBufferMemory = reinterpret_cast<TerrainVertex*>(_renderer->MapBuffer(vertexUploadBuffer));
-        for (size_t i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i++)
-        {
-            size_t cellOffset = i * Terrain::MAP_CELL_TOTAL_GRID_SIZE;
-            for (size_t j = 0; j < Terrain::MAP_CELL_TOTAL_GRID_SIZE; j++)
-            {
-                size_t offset = cellOffset + j;
-
-                // Set height
-                f32 height = chunk.cells[i].heightData[j];
-                vertexBufferMemory[offset].height = height;
-
-                u8 x = chunk.cells[i].normalData[j][0];
-                u8 y = chunk.cells[i].normalData[j][1];
-                u8 z = chunk.cells[i].normalData[j][2];
-
-                // Set normal
-                vertexBufferMemory[offset].normal[0] = x;
-                vertexBufferMemory[offset].normal[1] = y;
-                vertexBufferMemory[offset].normal[2] = z;
-
-                // Set color
-                vertexBufferMemory[offset].color[0] = chunk.cells[i].colorData[j][0];
-                vertexBufferMemory[offset].color[1] = chunk.cells[i].colorData[j][1];
-                vertexBufferMemory[offset].color[2] = chunk.cells[i].colorData[j][2];
-            }
-        }
-
-        _renderer->UnmapBuffer(vertexUploadBuffer);
-        const u64 chunkVertexBufferOffset = currentChunkIndex * sizeof(TerrainVertex) * Terrain::NUM_VERTICES_PER_CHUNK;
-        _renderer->CopyBuffer(_vertexBuffer, chunkVertexBufferOffset, vertexUploadBuffer, 0, vertexUploadBufferDesc.size);
-    }
+    UploadChunkVertices(chunk, chunkSlot);
 
     // Calculate bounding boxes and upload height ranges
     {
@@ -1013,7 +1166,7 @@ void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
             Geometry::AABoundingBox boundingBox;
             boundingBox.min = glm::max(min, max);
             boundingBox.max = glm::min(min, max);
-            _cellBoundingBoxes.push_back(boundingBox);
+            _cellBoundingBoxes[(currentChunkIndex * Terrain::MAP_CELLS_PER_CHUNK) + cellIndex] = boundingBox;
 
             TerrainCellHeightRange heightRange;
 #if USE_PACKED_HEIGHT_RANGE
@@ -1029,26 +1182,43 @@ void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
 
         // Upload height ranges
         {
-            Renderer::BufferDesc heightRangeUploadBufferDesc;
-            heightRangeUploadBufferDesc.name = "HeightRangeUploadBuffer";
-            heightRangeUploadBufferDesc.size = sizeof(TerrainCellHeightRange) * Terrain::MAP_CELLS_PER_CHUNK;
-            heightRangeUploadBufferDesc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-            heightRangeUploadBufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-            Renderer::BufferID heightRangeUploadBuffer = _renderer->CreateBuffer(heightRangeUploadBufferDesc);
-            _renderer->QueueDestroyBuffer(heightRangeUploadBuffer);
-
-            void* heightRangeBufferMemory = _renderer->MapBuffer(heightRangeUploadBuffer);
-            memcpy(heightRangeBufferMemory, heightRanges.data(), heightRangeUploadBufferDesc.size);
-            _renderer->UnmapBuffer(heightRangeUploadBuffer);
-
-            const u64 chunkVertexBufferOffset = currentChunkIndex * sizeof(TerrainCellHeightRange) * Terrain::MAP_CELLS_PER_CHUNK;
-            _renderer->CopyBuffer(_cellHeightRangeBuffer, chunkVertexBufferOffset, heightRangeUploadBuffer, 0, heightRangeUploadBufferDesc.size);
+            const u64 heightRangeBufferOffset = currentChunkIndex * sizeof(TerrainCellHeightRange) * Terrain::MAP_CELLS_PER_CHUNK;
+            _renderer->UploadToBuffer(_cellHeightRangeBuffer, heightRangeBufferOffset, heightRanges.data(), sizeof(TerrainCellHeightRange) * Terrain::MAP_CELLS_PER_CHUNK);
         }
     }
 
     _mapObjectRenderer->RegisterMapObjectsToBeLoaded(chunkID, chunk, stringTable);
     _complexModelRenderer->RegisterLoadFromChunk(chunkID, chunk, stringTable);
+}
+
+void TerrainRenderer::UploadChunkVertices(const Terrain::Chunk& chunk, u32 chunkSlot)
+{
+    const u64 chunkVertexBufferOffset = static_cast<u64>(chunkSlot) * sizeof(TerrainVertex) * Terrain::NUM_VERTICES_PER_CHUNK;
+    TerrainVertex* vertexBufferMemory = reinterpret_cast<TerrainVertex*>(_renderer->StageUpload(_vertexBuffer, chunkVertexBufferOffset, sizeof(TerrainVertex) * Terrain::NUM_VERTICES_PER_CHUNK));
+    for (size_t i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i++)
+    {
+        size_t cellOffset = i * Terrain::MAP_CELL_TOTAL_GRID_SIZE;
+        for (size_t j = 0; j < Terrain::MAP_CELL_TOTAL_GRID_SIZE; j++)
+        {
+            size_t offset = cellOffset + j;
 
-    _loadedChunks.push_back(chunkID);
+            // Set height
+            f32 height = chunk.cells[i].heightData[j];
+            vertexBufferMemory[offset].height = height;
+
+            u8 x = chunk.cells[i].normalData[j][0];
+            u8 y = chunk.cells[i].normalData[j][1];
+            u8 z = chunk.cells[i].normalData[j][2];
+
+            // Set normal
+            vertexBufferMemory[offset].normal[0] = x;
+            vertexBufferMemory[offset].normal[1] = y;
+            vertexBufferMemory[offset].normal[2] = z;
+
+            // Set color
+            vertexBufferMemory[offset].color[0] = chunk.cells[i].colorData[j][0];
+            vertexBufferMemory[offset].color[1] = chunk.cells[i].colorData[j][1];
+            vertexBufferMemory[offset].color[2] = chunk.cells[i].colorData[j][2];
+        }
+    }
 }
@@ -2,6 +2,7 @@
 #include <NovusTypes.h>
 
 #include <array>
+#include <robin_hood.h>
 
 #include <Utils/StringUtils.h>
 #include <Math/Geometry.h>
@@ -16,6 +17,7 @@
 
 #include "../Gameplay/Map/Chunk.h"
 #include "ViewConstantBuffer.h"
+#include "TerrainChunkResidency.h"
 
 namespace Terrain
 {
@@ -62,6 +64,13 @@ class TerrainRenderer
         u32 occlusionEnabled;
     };
 
+    // The texture array indices a chunk slot holds a reference to, released when its chunk gets unloaded
+    struct ChunkSlotTextures
+    {
+        std::vector<u32> colorTextureIDs;
+        u32 alphaTextureID = std::numeric_limits<u32>().max();
+    };
+
     struct CellInstance
     {
         u32 packedChunkCellID;
@@ -91,20 +100,34 @@ public:
     MapObjectRenderer* GetMapObjectRenderer() { return _mapObjectRenderer; }
 
     // Drawcall stats
-    u32 GetNumDrawCalls() { return Terrain::MAP_CELLS_PER_CHUNK * static_cast<u32>(_loadedChunks.size()); }
+    u32 GetNumDrawCalls() { return Terrain::MAP_CELLS_PER_CHUNK * _chunkResidency.GetNumResidentChunks(); }
     u32 GetNumSurvivingDrawCalls() { return _numSurvivingDrawCalls; }
 
     // Triangle stats
-    u32 GetNumTriangles() { return Terrain::MAP_CELLS_PER_CHUNK * static_cast<u32>(_loadedChunks.size()) * Terrain::NUM_TRIANGLES_PER_CELL; }
+    u32 GetNumTriangles() { return Terrain::MAP_CELLS_PER_CHUNK * _chunkResidency.GetNumResidentChunks() * Terrain::NUM_TRIANGLES_PER_CELL; }
     u32 GetNumSurvivingTriangles() { return _numSurvivingDrawCalls * Terrain::NUM_TRIANGLES_PER_CELL; }
+
+    // Streaming stats
+    bool IsStreaming() { return _isStreaming; }
+    u32 GetNumLoadedChunks() { return _chunkResidency.GetNumResidentChunks(); }
+    u32 GetNumChunkSlots() { return _chunkResidency.GetNumSlots(); }
 private:
     void CreatePermanentResources();
+    void CreateChunkBuffers(u32 numChunkSlots);
 
     void RegisterChunksToBeLoaded(Terrain::Map& map, ivec2 middleChunk, u16 drawDistance);
     void RegisterChunkToBeLoaded(Terrain::Map& map, u16 chunkPosX, u16 chunkPosY);
     void ExecuteLoad();
 
+    void UpdateStreaming(const Camera* camera);
+    // Evicts chunks that left the radius and queues the closest missing ones on the ChunkLoader, returns whether a chunk got evicted
+    bool RequestStreamingChunks(Terrain::Map& currentMap, const ivec2& centerChunk);
+
     void LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded);
+    // Adds the texture array indices the chunk was using to the given lists, the caller releases them
+    void UnloadChunk(Terrain::Map& map, u16 chunkID, std::vector<u32>& colorTexturesToRelease, std::vector<u32>& alphaTexturesToRelease);
+    void UploadChunkVertices(const Terrain::Chunk& chunk, u32 chunkSlot);
+    void UploadInstances();
     //void LoadChunksAround(Terrain::Map& map, ivec2 middleChunk, u16 drawDistance);
     void CPUCulling(const Camera* camera);
 
@@ -138,8 +161,16 @@ private:
 
     Renderer::DescriptorSet _cullingPassDescriptorSet;
 
-    std::vector<u16> _loadedChunks;
-    std::vector<Geometry::AABoundingBox> _cellBoundingBoxes;
+    std::vector<Geometry::AABoundingBox> _cellBoundingBoxes; // Indexed by (chunkSlot * MAP_CELLS_PER_CHUNK) + cellID
+
+    // Every loaded chunk occupies a slot in the chunk, cell, vertex and height range buffers, slots of unloaded chunks get reused
+    TerrainChunkResidency _chunkResidency;
+    std::vector<ChunkSlotTextures> _chunkSlotTextures; // Indexed by chunkSlot
+
+    bool _isStreaming = false;
+    u16 _streamingRadius = 0;
+    ivec2 _streamingCenterChunk = ivec2(-1, -1);
+    bool _hasPendingStreamingLoads = false;
 
     std::vector<CellInstance> _culledInstances;
 
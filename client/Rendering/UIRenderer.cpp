@@ -12,10 +12,13 @@
 #include <Window/Window.h>
 #include <tracy/Tracy.hpp>
 #include <tracy/TracyVulkan.hpp>
+#include <algorithm>
 
 #include "../Utils/ServiceLocator.h"
 
 #include "../UI/ECS/Components/Singletons/UIDataSingleton.h"
+#include "../UI/ECS/Components/Singletons/UIHitGridSingleton.h"
+#include "../UI/ECS/Components/Singletons/UITextLayoutCacheSingleton.h"
 #include "../UI/ECS/Components/ElementInfo.h"
 #include "../UI/ECS/Components/Relation.h"
 #include "../UI/ECS/Components/Root.h"
@@ -36,6 +39,7 @@
 
 #include "../UI/ECS/Components/Dirty.h"
 #include "../UI/ECS/Components/BoundsDirty.h"
+#include "../UI/ECS/Components/TransformDirty.h"
 #include "../UI/ECS/Components/SortKeyDirty.h"
 
 #include "../UI/ECS/Components/InputField.h"
@@ -43,6 +47,7 @@
 #include "../UI/ECS/Components/Slider.h"
 
 #include "../UI/UIInputHandler.h"
+#include "../UI/Utils/HitGridUtils.h"
 
 AutoCVar_Int CVAR_UICollisionBoundsEnabled("ui.drawCollisionBounds", "draw collision bounds for ui elements", 0, CVarFlags::EditCheckbox);
 
@@ -54,6 +59,7 @@ UIRenderer::UIRenderer(Renderer::Renderer* renderer, DebugRenderer* debugRendere
 
     // Register UI singletons.
     UISingleton::UIDataSingleton& dataSingleton = registry->set<UISingleton::UIDataSingleton>();
+    dataSingleton.imageTextureArray = _imageTextures;
 
     // Set up UI resolution. TODO Update when window size updates.
     i32 width, height;
@@ -61,6 +67,10 @@ UIRenderer::UIRenderer(Renderer::Renderer* renderer, DebugRenderer* debugRendere
     f32 aspectRatio = (static_cast<f32>(width) / static_cast<f32>(height));
     dataSingleton.UIRESOLUTION = hvec2(dataSingleton.referenceHeight * aspectRatio, dataSingleton.referenceHeight);
 
+    registry->set<UISingleton::UIHitGridSingleton>();
+    UIUtils::HitGrid::Resize(registry);
+    registry->set<UISingleton::UITextLayoutCacheSingleton>();
+
     //Reserve component space
     const int ENTITIES_TO_PREALLOCATE = 10000;
     registry->reserve(ENTITIES_TO_PREALLOCATE);
@@ -86,6 +96,7 @@ UIRenderer::UIRenderer(Renderer::Renderer* renderer, DebugRenderer* debugRendere
     registry->reserve<UIComponent::Dirty>(ENTITIES_TO_PREALLOCATE);
     registry->reserve<UIComponent::BoundsDirty>(ENTITIES_TO_PREALLOCATE);
     registry->reserve<UIComponent::SortKeyDirty>(ENTITIES_TO_PREALLOCATE);
+    registry->reserve<UIComponent::TransformDirty>(ENTITIES_TO_PREALLOCATE);
 
     registry->reserve<UIComponent::InputField>(ENTITIES_TO_PREALLOCATE);
     registry->reserve<UIComponent::Checkbox>(ENTITIES_TO_PREALLOCATE);
@@ -176,93 +187,157 @@ void UIRenderer::AddUIPass(Renderer::RenderGraph* renderGraph, Renderer::ImageID
 
             Renderer::GraphicsPipelineID textPipeline = _renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
 
-            // Set pipeline
-            commandList.BeginPipeline(imagePipeline);
-            Renderer::GraphicsPipelineID activePipeline = imagePipeline;
-
-            commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
-
             entt::registry* registry = ServiceLocator::GetUIRegistry();
             auto renderGroup = registry->group<UIComponent::SortKey>(entt::get<UIComponent::Renderable, UIComponent::Visible, UIComponent::NotCulled>);
             renderGroup.sort<UIComponent::SortKey>([](UIComponent::SortKey& first, UIComponent::SortKey& second) { return first.key < second.key; });
-            renderGroup.each([this, &commandList, frameIndex, &registry, &activePipeline, &textPipeline, &imagePipeline](const auto entity, UIComponent::SortKey& sortKey, UIComponent::Renderable& renderable)
+
+            // Count everything first so the frame buffers get resized at most once
+            u32 numQuads = 0;
+            u32 numImages = 0;
+            u32 numTexts = 0;
+            renderGroup.each([&](const auto entity, UIComponent::SortKey& sortKey, UIComponent::Renderable& renderable)
             {
-                switch (renderable.renderType)
+                if (renderable.renderType == UI::RenderType::Text)
                 {
-                case UI::RenderType::Text:
-                    {
-                        UIComponent::Text& text = registry->get<UIComponent::Text>(entity);
-                        if (!text.constantBuffer || text.vertexBufferID == Renderer::BufferID::Invalid())
-                            break;
+                    const UIComponent::Text& text = registry->get<UIComponent::Text>(entity);
+                    numQuads += static_cast<u32>(text.glyphQuads.size());
+                    numTexts++;
+                }
+                else if (renderable.renderType == UI::RenderType::Image)
+                {
+                    numQuads++;
+                    numImages++;
+                }
+            });
 
-                        if (activePipeline != textPipeline)
-                        {
-                            commandList.EndPipeline(activePipeline);
-                            commandList.BeginPipeline(textPipeline);
-                            commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
-                            activePipeline = textPipeline;
-                        }
+            if (numQuads == 0)
+                return;
+
+            FrameData& frameData = _frameData.Get(frameIndex);
+            ReserveFrameBuffer(frameData.quads, numQuads, sizeof(UI::Quad), "UIQuads");
+            ReserveFrameBuffer(frameData.panelData, numImages, sizeof(UIComponent::Image::ImageConstantBuffer), "UIPanelData");
+            ReserveFrameBuffer(frameData.textData, numTexts, sizeof(UIComponent::Text::TextConstantBuffer), "UITextData");
 
-                        commandList.PushMarker("Text", Color(0.0f, 0.1f, 0.0f));
+            UI::Quad* quads = static_cast<UI::Quad*>(_renderer->MapBuffer(frameData.quads.buffer));
+            UIComponent::Image::ImageConstantBuffer* panelData = static_cast<UIComponent::Image::ImageConstantBuffer*>(_renderer->MapBuffer(frameData.panelData.buffer));
+            UIComponent::Text::TextConstantBuffer* textData = static_cast<UIComponent::Text::TextConstantBuffer*>(_renderer->MapBuffer(frameData.textData.buffer));
 
-                        // Bind descriptors
-                        _drawTextDescriptorSet.Bind("_vertexData"_h, text.vertexBufferID);
-                        _drawTextDescriptorSet.Bind("_textData"_h, text.constantBuffer->GetBuffer(frameIndex));
-                        _drawTextDescriptorSet.Bind("_textureIDs"_h, text.textureIDBufferID);
-                        _drawTextDescriptorSet.Bind("_textures"_h, text.font->GetTextureArray());
+            u32 quadIndex = 0;
+            u32 imageIndex = 0;
+            u32 textIndex = 0;
 
-                        commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_DRAW, &_drawTextDescriptorSet, frameIndex);
+            // Elements are appended in SortKey order, an element extends the previous batch if it can be drawn with the same pipeline and descriptors
+            _drawBatches.clear();
+            auto addToBatch = [&](bool isText, Renderer::TextureArrayID fontTextures, u32 quadCount)
+            {
+                if (!_drawBatches.empty())
+                {
+                    DrawBatch& previousBatch = _drawBatches.back();
+                    if (previousBatch.isText == isText && previousBatch.fontTextures == fontTextures)
+                    {
+                        previousBatch.numQuads += quadCount;
+                        return;
+                    }
+                }
 
-                        commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+                DrawBatch& batch = _drawBatches.emplace_back();
+                batch.isText = isText;
+                batch.fontTextures = fontTextures;
+                batch.firstQuad = quadIndex;
+                batch.numQuads = quadCount;
+            };
 
-                        commandList.DrawIndexed(6, static_cast<u32>(text.glyphCount), 0, 0, 0);
+            {
+                ZoneScopedNC("UIRenderer::BuildBatches", tracy::Color::Red2);
 
-                        commandList.PopMarker();
-                        break;
-                    }
-                case UI::RenderType::Image:
+                renderGroup.each([&](const auto entity, UIComponent::SortKey& sortKey, UIComponent::Renderable& renderable)
+                {
+                    switch (renderable.renderType)
                     {
-                        UIComponent::Image& image = registry->get<UIComponent::Image>(entity);
-                        if (!image.constantBuffer)
-                            return;
-
-                        if (activePipeline != imagePipeline)
+                    case UI::RenderType::Text:
                         {
-                            commandList.EndPipeline(activePipeline);
-                            commandList.BeginPipeline(imagePipeline);
-                            commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
-                            activePipeline = imagePipeline;
-                        }
+                            const UIComponent::Text& text = registry->get<UIComponent::Text>(entity);
+                            if (text.font == nullptr || text.glyphQuads.empty())
+                                break;
 
-                        commandList.PushMarker("Image", Color(0.0f, 0.1f, 0.0f));
+                            addToBatch(true, text.font->GetTextureArray(), static_cast<u32>(text.glyphQuads.size()));
 
-                        // Bind descriptors
-                        _drawImageDescriptorSet.Bind("_vertices"_h, image.vertexBufferID);
-                        _drawImageDescriptorSet.Bind("_panelData"_h, image.constantBuffer->GetBuffer(frameIndex));
-                        _drawImageDescriptorSet.Bind("_texture"_h, image.textureID);
+                            textData[textIndex] = text.constants;
+                            for (const UI::Quad& glyphQuad : text.glyphQuads)
+                            {
+                                UI::Quad& quad = quads[quadIndex++];
+                                quad = glyphQuad;
+                                quad.dataIndex = textIndex;
+                            }
 
-                        if (image.borderID != Renderer::TextureID::Invalid())
-                        {
-                            _drawImageDescriptorSet.Bind("_border"_h, image.borderID);
+                            textIndex++;
+                            break;
                         }
-                        else
+                    case UI::RenderType::Image:
                         {
-                            _drawImageDescriptorSet.Bind("_border"_h, _emptyBorder);
-                        }
+                            const UIComponent::Image& image = registry->get<UIComponent::Image>(entity);
+                            if (image.textureID == Renderer::TextureID::Invalid())
+                                break;
 
-                        commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_DRAW, &_drawImageDescriptorSet, frameIndex);
+                            addToBatch(false, Renderer::TextureArrayID::Invalid(), 1);
 
-                        commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+                            panelData[imageIndex] = image.constants;
 
-                        commandList.DrawIndexed(6, 1, 0, 0, 0);
+                            UI::Quad& quad = quads[quadIndex++];
+                            quad = image.quad;
+                            quad.dataIndex = imageIndex;
 
-                        commandList.PopMarker();
-                        break;
+                            imageIndex++;
+                            break;
+                        }
+                    default:
+                        DebugHandler::PrintFatal("Renderable widget tried to render with invalid render type.");
                     }
-                default:
-                    DebugHandler::PrintFatal("Renderable widget tried to render with invalid render type.");
+                });
+            }
+
+            _renderer->UnmapBuffer(frameData.quads.buffer);
+            _renderer->UnmapBuffer(frameData.panelData.buffer);
+            _renderer->UnmapBuffer(frameData.textData.buffer);
+
+            _passDescriptorSet.Bind("_quads"_h, frameData.quads.buffer);
+            _passDescriptorSet.Bind("_panelData"_h, frameData.panelData.buffer);
+            _passDescriptorSet.Bind("_textData"_h, frameData.textData.buffer);
+
+            Renderer::GraphicsPipelineID activePipeline = Renderer::GraphicsPipelineID::Invalid();
+            for (const DrawBatch& batch : _drawBatches)
+            {
+                Renderer::GraphicsPipelineID pipeline = batch.isText ? textPipeline : imagePipeline;
+                if (pipeline != activePipeline)
+                {
+                    if (activePipeline != Renderer::GraphicsPipelineID::Invalid())
+                    {
+                        commandList.EndPipeline(activePipeline);
+                    }
+
+                    commandList.BeginPipeline(pipeline);
+                    commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
+                    commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+                    activePipeline = pipeline;
                 }
-            });
+
+                if (batch.isText)
+                {
+                    commandList.PushMarker("Text", Color(0.0f, 0.1f, 0.0f));
+
+                    _drawTextDescriptorSet.Bind("_fontTextures"_h, batch.fontTextures);
+                    commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_DRAW, &_drawTextDescriptorSet, frameIndex);
+                }
+                else
+                {
+                    commandList.PushMarker("Image", Color(0.0f, 0.1f, 0.0f));
+                }
+
+                // The quad index is the instance index, so one draw covers the whole batch
+                commandList.DrawIndexed(6, batch.numQuads, 0, 0, batch.firstQuad);
+
+                commandList.PopMarker();
+            }
 
             commandList.EndPipeline(activePipeline);
         });
@@ -366,13 +441,31 @@ void UIRenderer::CreatePermanentResources()
     _renderer->QueueDestroyBuffer(stagingBuffer);
     _renderer->CopyBuffer(_indexBuffer, 0, stagingBuffer, 0, indexBufferSize);
 
-    // Create empty border texture
-    Renderer::DataTextureDesc emptyBorderDesc;
-    emptyBorderDesc.debugName = "EmptyBorder";
-    emptyBorderDesc.width = 1;
-    emptyBorderDesc.height = 1;
-    emptyBorderDesc.format = Renderer::ImageFormat::R8G8B8A8_UNORM;
-    emptyBorderDesc.data = new u8[4]{ 0, 0, 0, 0 };
-    
-    _emptyBorder = _renderer->CreateDataTexture(emptyBorderDesc);
+    // Every image and border the UI uses goes into this array so images with different textures can share a draw
+    Renderer::TextureArrayDesc textureArrayDesc;
+    textureArrayDesc.size = 4096;
+
+    _imageTextures = _renderer->CreateTextureArray(textureArrayDesc);
+    _passDescriptorSet.Bind("_imageTextures"_h, _imageTextures);
+}
+
+void UIRenderer::ReserveFrameBuffer(FrameBuffer& frameBuffer, u32 count, u32 elementSize, const std::string& name)
+{
+    if (frameBuffer.buffer != Renderer::BufferID::Invalid() && count <= frameBuffer.capacity)
+        return;
+
+    if (frameBuffer.buffer != Renderer::BufferID::Invalid())
+    {
+        _renderer->QueueDestroyBuffer(frameBuffer.buffer);
+    }
+
+    frameBuffer.capacity = std::max({ count, frameBuffer.capacity * 2, 256u });
+
+    Renderer::BufferDesc desc;
+    desc.name = name;
+    desc.size = static_cast<u64>(frameBuffer.capacity) * elementSize;
+    desc.usage = Renderer::BufferUsage::STORAGE_BUFFER;
+    desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
+
+    frameBuffer.buffer = _renderer->CreateBuffer(desc);
 }
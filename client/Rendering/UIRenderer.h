@@ -2,7 +2,11 @@
 #include <NovusTypes.h>
 
 #include <Renderer/Descriptors/ImageDesc.h>
+#include <Renderer/Descriptors/BufferDesc.h>
+#include <Renderer/Descriptors/TextureArrayDesc.h>
 #include <Renderer/DescriptorSet.h>
+#include <Renderer/FrameResource.h>
+#include <vector>
 
 namespace Renderer
 {
@@ -25,19 +29,45 @@ public:
     void AddImguiPass(Renderer::RenderGraph* renderGraph, Renderer::ImageID renderTarget, u8 frameIndex);
 
 private:
+    // Storage buffer the UI pass refills every frame, it only grows
+    struct FrameBuffer
+    {
+        Renderer::BufferID buffer = Renderer::BufferID::Invalid();
+        u32 capacity = 0;
+    };
+
+    struct FrameData
+    {
+        FrameBuffer quads;
+        FrameBuffer panelData;
+        FrameBuffer textData;
+    };
+
+    // Consecutive quads in SortKey order that share pipeline and descriptors, drawn with a single instanced draw
+    struct DrawBatch
+    {
+        bool isText = false;
+        Renderer::TextureArrayID fontTextures = Renderer::TextureArrayID::Invalid();
+        u32 firstQuad = 0;
+        u32 numQuads = 0;
+    };
+
     void CreatePermanentResources();
+    void ReserveFrameBuffer(FrameBuffer& frameBuffer, u32 count, u32 elementSize, const std::string& name);
 
 private:
     Renderer::Renderer* _renderer;
     DebugRenderer* _debugRenderer;
 
-    Renderer::TextureID _emptyBorder;
+    Renderer::TextureArrayID _imageTextures;
 
     Renderer::SamplerID _linearSampler;
     Renderer::BufferID _indexBuffer;
 
     Renderer::DescriptorSet _passDescriptorSet;
-    Renderer::DescriptorSet _drawImageDescriptorSet;
     Renderer::DescriptorSet _drawTextDescriptorSet;
 
+    FrameResource<FrameData, 2> _frameData;
+    std::vector<DrawBatch> _drawBatches;
+
 };
\ No newline at end of file
@@ -343,25 +343,8 @@ void WaterRenderer::ExecuteLoad()
 
         _drawCallsBuffer = _renderer->CreateBuffer(desc);
 
-        // Create staging buffer
-        desc.name = "WaterDrawCallBufferStaging";
-        desc.size = bufferSize;
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _drawCalls.data(), bufferSize);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_drawCallsBuffer, 0, stagingBuffer, 0, bufferSize);
+        // Upload to buffer
+        _renderer->UploadToBuffer(_drawCallsBuffer, 0, _drawCalls.data(), bufferSize);
     }
 
     // -- Create DrawCallDatas Buffer --
@@ -380,25 +363,8 @@ void WaterRenderer::ExecuteLoad()
 
         _drawCallDatasBuffer = _renderer->CreateBuffer(desc);
 
-        // Create staging buffer
-        desc.name = "WaterDrawCallDatasBufferStaging";
-        desc.size = bufferSize;
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _drawCallDatas.data(), bufferSize);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_drawCallDatasBuffer, 0, stagingBuffer, 0, bufferSize);
+        // Upload to buffer
+        _renderer->UploadToBuffer(_drawCallDatasBuffer, 0, _drawCallDatas.data(), bufferSize);
     }
 
     // -- Create Vertex Buffer --
@@ -417,25 +383,8 @@ void WaterRenderer::ExecuteLoad()
 
         _vertexBuffer = _renderer->CreateBuffer(desc);
 
-        // Create staging buffer
-        desc.name = "VertexBufferStaging";
-        desc.size = bufferSize;
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _vertices.data(), bufferSize);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_vertexBuffer, 0, stagingBuffer, 0, bufferSize);
+        // Upload to buffer
+        _renderer->UploadToBuffer(_vertexBuffer, 0, _vertices.data(), bufferSize);
     }
 
     // -- Create Index Buffer --
@@ -454,24 +403,7 @@ void WaterRenderer::ExecuteLoad()
 
         _indexBuffer = _renderer->CreateBuffer(desc);
 
-        // Create staging buffer
-        desc.name = "IndexBufferStaging";
-        desc.size = bufferSize;
-        desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-        desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-        Renderer::BufferID stagingBuffer = _renderer->CreateBuffer(desc);
-
-        // Upload to staging buffer
-
-        void* dst = _renderer->MapBuffer(stagingBuffer);
-        memcpy(dst, _indices.data(), bufferSize);
-        _renderer->UnmapBuffer(stagingBuffer);
-
-        // Queue destroy staging buffer
-        _renderer->QueueDestroyBuffer(stagingBuffer);
-
-        // Copy from staging buffer to buffer
-        _renderer->CopyBuffer(_indexBuffer, 0, stagingBuffer, 0, bufferSize);
+        // Upload to buffer
+        _renderer->UploadToBuffer(_indexBuffer, 0, _indices.data(), bufferSize);
     }
 }
\ No newline at end of file
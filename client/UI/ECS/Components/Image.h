@@ -1,7 +1,7 @@
 #pragma once
 #include <NovusTypes.h>
+#include "../../UITypes.h"
 #include <Renderer/Renderer.h>
-#include <Renderer/Buffer.h>
 
 namespace UI
 {
@@ -24,6 +24,8 @@ namespace UIComponent
     struct Image
     {
     public:
+        static constexpr u32 NO_BORDER = 0xFFFFFFFF;
+
         struct ImageConstantBuffer
         {
             Color color; // 16 
@@ -31,15 +33,16 @@ namespace UIComponent
             UI::Box borderInset; // 16 bytes
             UI::Box slicingOffset; // 16 bytes
             vec2 size ; // 8 bytes
+            u32 borderIndex = NO_BORDER; // 4 bytes
 
-            u8 padding[8] = {};
+            u8 padding[4] = {};
         };
         Image(){ }
 
         UI::ImageStylesheet style;
         Renderer::TextureID textureID = Renderer::TextureID::Invalid();
         Renderer::TextureID borderID = Renderer::TextureID::Invalid();
-        Renderer::BufferID vertexBufferID = Renderer::BufferID::Invalid();
-        Renderer::Buffer<ImageConstantBuffer>* constantBuffer = nullptr;
+        UI::Quad quad;
+        ImageConstantBuffer constants; // Copied into the frame wide panel data every time the image gets drawn
     };
 }
\ No newline at end of file
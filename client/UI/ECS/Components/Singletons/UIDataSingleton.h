@@ -2,6 +2,7 @@
 #include "NovusTypes.h"
 #include <entity/fwd.hpp>
 #include <robin_hood.h>
+#include <Renderer/Descriptors/TextureArrayDesc.h>
 
 namespace UIScripting
 {
@@ -22,6 +23,9 @@ namespace UISingleton
         entt::entity hoveredWidget = entt::null;
         hvec2 dragOffset = hvec2(0.f,0.f);
 
+        // Image and border textures, images index into it from the batched UI pass
+        Renderer::TextureArrayID imageTextureArray = Renderer::TextureArrayID::Invalid();
+
         //Resolution
         const f32 referenceHeight = 1080.f;
         hvec2 UIRESOLUTION = hvec2(0.0f, 0.f);
@@ -0,0 +1,35 @@
+#pragma once
+#include <NovusTypes.h>
+#include <entity/entity.hpp>
+#include <robin_hood.h>
+#include <vector>
+
+namespace UISingleton
+{
+    // Screen space grid of element collision bounds, a point query only has to look at the elements overlapping one cell
+    struct UIHitGridSingleton
+    {
+    public:
+        // Cells an element overlaps, max is exclusive
+        struct CellRange
+        {
+            u16 minX = 0;
+            u16 minY = 0;
+            u16 maxX = 0;
+            u16 maxY = 0;
+
+            bool operator==(const CellRange& other) const { return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY; }
+            bool operator!=(const CellRange& other) const { return !(*this == other); }
+        };
+
+        UIHitGridSingleton() { }
+
+        static constexpr f32 CELL_SIZE = 64.f;
+
+        u16 numCellsX = 0;
+        u16 numCellsY = 0;
+        std::vector<std::vector<entt::entity>> cells;
+
+        robin_hood::unordered_map<entt::entity, CellRange> entityToCells;
+    };
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <NovusTypes.h>
+#include <robin_hood.h>
+#include <vector>
+
+namespace UISingleton
+{
+    // Line layouts keyed by everything they depend on, texts that only changed style or moved reuse them instead of measuring every glyph again
+    struct UITextLayoutCacheSingleton
+    {
+    public:
+        struct Layout
+        {
+            std::vector<f32> lineWidths;
+            std::vector<size_t> lineBreakPoints;
+            size_t finalCharacter = 0;
+
+            u32 lastUsedFrame = 0;
+        };
+
+        UITextLayoutCacheSingleton() { }
+
+        // Once the cache grows past this, layouts that weren't used last frame get dropped
+        static constexpr size_t MAX_LAYOUTS = 4096;
+
+        robin_hood::unordered_node_map<u64, Layout> layouts; // Node map so layouts handed out stay valid while others get added
+        u32 frame = 0;
+
+        // Shown in the UI stats
+        u32 layoutsThisFrame = 0;
+        u32 cachedLayoutsThisFrame = 0;
+    };
+}
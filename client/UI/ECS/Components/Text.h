@@ -2,7 +2,6 @@
 #include <NovusTypes.h>
 #include "../../UITypes.h"
 #include <Renderer/Renderer.h>
-#include <Renderer/Buffer.h>
 #include <Renderer/Font.h>
 #include <vector>
 
@@ -17,14 +16,13 @@ namespace UIComponent
             Color outlineColor = Color(); // 16 bytes
             f32 outlineWidth = 0.f; // 4 bytes
 
-            u8 padding[220] = {};
+            u8 padding[12] = {};
         };
 
     public:
         Text() { }
 
         std::string text = "";
-        size_t glyphCount = 0;
         size_t pushback = 0;
 
         UI::TextStylesheet style;
@@ -35,9 +33,10 @@ namespace UIComponent
 
         Renderer::Font* font = nullptr;
 
-        size_t vertexBufferGlyphCount = 0;
-        Renderer::BufferID vertexBufferID = Renderer::BufferID::Invalid();
-        Renderer::BufferID textureIDBufferID = Renderer::BufferID::Invalid();
-        Renderer::Buffer<TextConstantBuffer>* constantBuffer = nullptr;
+        std::vector<UI::Quad> glyphQuads; // One per visible glyph, textureIndex is the atlas page in the texture array of the font
+        bool hasPendingGlyphs = false; // Some glyph quads draw the fallback glyph, they get rebuilt once the font has generated the glyphs
+        u64 layoutKey = 0; // Layout the glyph quads were built from, style only changes keep the quads as long as it matches
+        vec2 layoutOrigin = vec2(0.0f, 0.0f); // Where the glyph quads were built, moving the text only offsets them
+        TextConstantBuffer constants; // Copied into the frame wide text data every time the text gets drawn
     };
 }
\ No newline at end of file
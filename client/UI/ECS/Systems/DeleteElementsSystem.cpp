@@ -4,6 +4,7 @@
 #include "../Components/Singletons/UIDataSingleton.h"
 #include "../Components/Destroy.h"
 #include "../../angelscript/BaseElement.h"
+#include "../../Utils/HitGridUtils.h"
 
 namespace UISystem
 {
@@ -17,6 +18,7 @@ namespace UISystem
         {
             delete dataSingleton.entityToElement[entityId];
             dataSingleton.entityToElement.erase(entityId);
+            UIUtils::HitGrid::RemoveElement(&registry, entityId);
         });
         registry.destroy(deleteView.begin(), deleteView.end());
 
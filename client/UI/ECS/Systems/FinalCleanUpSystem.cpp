@@ -4,6 +4,7 @@
 #include "../Components/Dirty.h"
 #include "../Components/BoundsDirty.h"
 #include "../Components/SortKeyDirty.h"
+#include "../Components/TransformDirty.h"
 
 
 namespace UISystem
@@ -13,5 +14,6 @@ namespace UISystem
         registry.clear<UIComponent::Dirty>();
         registry.clear<UIComponent::BoundsDirty>();
         registry.clear<UIComponent::SortKeyDirty>();
+        registry.clear<UIComponent::TransformDirty>();
     }
 }
\ No newline at end of file
@@ -2,7 +2,6 @@
 #include <entity/registry.hpp>
 #include <tracy/Tracy.hpp>
 #include "../../render-lib/Renderer/Descriptors/ModelDesc.h"
-#include "../../render-lib/Renderer/Buffer.h"
 
 #include "../../../Utils/ServiceLocator.h"
 #include "../Components/Singletons/UIDataSingleton.h"
@@ -17,46 +16,111 @@
 
 namespace UISystem
 {
-    void CalculateVertices(const vec2& pos, const vec2& size, const UI::FBox& texCoords, std::vector<UISystem::UIVertex>& vertices)
+    void CalculateQuad(const vec2& pos, const vec2& size, const UI::FBox& texCoords, u32 textureIndex, UI::Quad& quad)
     {
         const UISingleton::UIDataSingleton& dataSingleton = ServiceLocator::GetUIRegistry()->ctx<UISingleton::UIDataSingleton>();
-        vertices.clear();
-        vertices.reserve(4);
-
-        vec2 upperLeftPos = vec2(pos.x, pos.y);
-        vec2 upperRightPos = vec2(pos.x + size.x, pos.y);
-        vec2 lowerLeftPos = vec2(pos.x, pos.y + size.y);
-        vec2 lowerRightPos = vec2(pos.x + size.x, pos.y + size.y);
 
         // UV space
         // TODO: Do scaling depending on rendertargets actual size instead of assuming 1080p (which is our reference resolution)
-        upperLeftPos /= dataSingleton.UIRESOLUTION;
-        upperRightPos /= dataSingleton.UIRESOLUTION;
-        lowerLeftPos /= dataSingleton.UIRESOLUTION;
-        lowerRightPos /= dataSingleton.UIRESOLUTION;
-
-        // UI Vertices
-        UISystem::UIVertex& upperLeft = vertices.emplace_back();
-        upperLeft.pos = vec2(upperLeftPos.x, 1.0f - upperLeftPos.y);
-        upperLeft.uv = vec2(texCoords.left, texCoords.top);
-
-        UISystem::UIVertex& upperRight = vertices.emplace_back();
-        upperRight.pos = vec2(upperRightPos.x, 1.0f - upperRightPos.y);
-        upperRight.uv = vec2(texCoords.right, texCoords.top);
-
-        UISystem::UIVertex& lowerLeft = vertices.emplace_back();
-        lowerLeft.pos = vec2(lowerLeftPos.x, 1.0f - lowerLeftPos.y);
-        lowerLeft.uv = vec2(texCoords.left, texCoords.bottom);
-
-        UISystem::UIVertex& lowerRight = vertices.emplace_back();
-        lowerRight.pos = vec2(lowerRightPos.x, 1.0f - lowerRightPos.y);
-        lowerRight.uv = vec2(texCoords.right, texCoords.bottom);
+        vec2 upperLeftPos = vec2(pos.x, pos.y) / vec2(dataSingleton.UIRESOLUTION);
+        vec2 lowerRightPos = vec2(pos.x + size.x, pos.y + size.y) / vec2(dataSingleton.UIRESOLUTION);
+
+        // The vertex shader builds the other two corners from these
+        quad.minPosition = vec2(upperLeftPos.x, 1.0f - upperLeftPos.y);
+        quad.maxPosition = vec2(lowerRightPos.x, 1.0f - lowerRightPos.y);
+        quad.minUV = vec2(texCoords.left, texCoords.top);
+        quad.maxUV = vec2(texCoords.right, texCoords.bottom);
+        quad.textureIndex = textureIndex;
+    }
+
+    void UpdateGlyphQuads(entt::registry& registry, const UIComponent::Transform& transform, UIComponent::Text& text, bool forceRebuild)
+    {
+        const vec2 alignment = UIUtils::Text::GetAlignment(&text);
+        const vec2 origin = UIUtils::Transform::GetAnchorPositionInElement(&transform, alignment);
+        const u64 layoutKey = UIUtils::Text::CalculateLayoutKey(&text, transform.size.x, transform.size.y);
+
+        // Only the style changed or the text moved, the glyphs stay where they are relative to each other
+        if (!forceRebuild && layoutKey == text.layoutKey)
+        {
+            if (origin != text.layoutOrigin)
+            {
+                const UISingleton::UIDataSingleton& dataSingleton = registry.ctx<UISingleton::UIDataSingleton>();
+                const vec2 offset = (origin - text.layoutOrigin) / vec2(dataSingleton.UIRESOLUTION) * vec2(1.0f, -1.0f);
+                for (UI::Quad& quad : text.glyphQuads)
+                {
+                    quad.minPosition += offset;
+                    quad.maxPosition += offset;
+                }
+
+                text.layoutOrigin = origin;
+            }
+
+            return;
+        }
+
+        const UISingleton::UITextLayoutCacheSingleton::Layout& layout = UIUtils::Text::GetLayout(&registry, &text, layoutKey, transform.size.x, transform.size.y);
+        const std::vector<f32>& lineWidths = layout.lineWidths;
+        const std::vector<size_t>& lineBreakPoints = layout.lineBreakPoints;
+        const size_t finalCharacter = layout.finalCharacter;
+
+        text.layoutKey = layoutKey;
+        text.layoutOrigin = origin;
+
+        size_t textLengthWithoutSpaces = std::count_if(text.text.begin() + text.pushback, text.text.end() - (text.text.length() - finalCharacter), [](char c) { return !UIUtils::Text::IsSpace(c) && !UIUtils::Text::IsContinuationByte(c); });
+
+        text.glyphQuads.clear();
+        text.glyphQuads.reserve(textLengthWithoutSpaces);
+        text.hasPendingGlyphs = false;
+
+        if (textLengthWithoutSpaces > 0)
+        {
+            vec2 currentPosition = origin;
+            f32 startX = currentPosition.x;
+            currentPosition.x -= lineWidths[0] * alignment.x;
+            currentPosition.y += text.style.fontSize * (1 - alignment.y) * lineWidths.size();
+
+            size_t currentLine = 0;
+            for (size_t i = text.pushback; i < finalCharacter; i++)
+            {
+                const char character = text.text[i];
+                if (currentLine < lineBreakPoints.size() && lineBreakPoints[currentLine] == i)
+                {
+                    currentLine++;
+                    currentPosition.y += text.style.fontSize * text.style.lineHeightMultiplier;
+                    currentPosition.x = startX - lineWidths[currentLine] * alignment.x;
+                }
+
+                if (character == '\n' || UIUtils::Text::IsContinuationByte(character))
+                {
+                    continue;
+                }
+                else if (UIUtils::Text::IsSpace(character))
+                {
+                    currentPosition.x += text.style.fontSize * 0.15f;
+                    continue;
+                }
+
+                const Renderer::FontChar& fontChar = text.font->GetChar(UIUtils::Text::DecodeCodepoint(text.text, i));
+                if (fontChar.width > 0 && fontChar.height > 0)
+                {
+                    const vec2& pos = currentPosition + vec2(fontChar.xOffset, fontChar.yOffset);
+                    const vec2& size = vec2(fontChar.width, fontChar.height);
+                    UI::FBox texCoords{ fontChar.minUV.y, fontChar.maxUV.x, fontChar.maxUV.y, fontChar.minUV.x };
+
+                    CalculateQuad(pos, size, texCoords, fontChar.textureIndex, text.glyphQuads.emplace_back());
+                    text.hasPendingGlyphs |= !fontChar.isReady;
+                }
+
+                currentPosition.x += fontChar.advance;
+            }
+        }
     }
 
     void UpdateRenderingSystem::Update(entt::registry& registry)
     {
         Renderer::Renderer* renderer = ServiceLocator::GetRenderer();
         auto& dataSingleton = registry.ctx<UISingleton::UIDataSingleton>();
+        UIUtils::Text::BeginLayoutFrame(&registry);
 
         auto inputFieldView = registry.view<UIComponent::Transform, UIComponent::InputField, UIComponent::Text, UIComponent::Dirty>();
         inputFieldView.each([&](const UIComponent::Transform& transform, const UIComponent::InputField& inputField, UIComponent::Text& text)
@@ -71,56 +135,42 @@ namespace UISystem
             if (image.style.texture.length() == 0)
                 return;
 
+            u32 textureIndex;
             {
                 ZoneScopedNC("(Re)load Texture", tracy::Color::RoyalBlue);
-                image.textureID = renderer->LoadTexture(Renderer::TextureDesc{ image.style.texture });
+                image.textureID = renderer->LoadTextureIntoArray(Renderer::TextureDesc{ image.style.texture }, dataSingleton.imageTextureArray, textureIndex);
             }
 
+            image.constants.borderIndex = UIComponent::Image::NO_BORDER;
             if (!image.style.border.empty())
             {
                 ZoneScopedNC("(Re)load Border", tracy::Color::RoyalBlue);
-                image.borderID = renderer->LoadTexture(Renderer::TextureDesc{ image.style.border });
+                image.borderID = renderer->LoadTextureIntoArray(Renderer::TextureDesc{ image.style.border }, dataSingleton.imageTextureArray, image.constants.borderIndex);
             }
 
-            // Create constant buffer if necessary
-            auto constantBuffer = image.constantBuffer;
-            if (constantBuffer == nullptr)
-            {
-                constantBuffer = new Renderer::Buffer<UIComponent::Image::ImageConstantBuffer>(renderer, "UpdateElementSystemConstantBuffer", Renderer::BufferUsage::UNIFORM_BUFFER, Renderer::BufferCPUAccess::WriteOnly);
-                image.constantBuffer = constantBuffer;
-            }
-            constantBuffer->resource.color = image.style.color;
-            constantBuffer->resource.borderSize = image.style.borderSize;
-            constantBuffer->resource.borderInset = image.style.borderInset;
-            constantBuffer->resource.slicingOffset = image.style.slicingOffset;
-            constantBuffer->resource.size = transform.size;
-            constantBuffer->ApplyAll();
+            image.constants.color = image.style.color;
+            image.constants.borderSize = image.style.borderSize;
+            image.constants.borderInset = image.style.borderInset;
+            image.constants.slicingOffset = image.style.slicingOffset;
+            image.constants.size = transform.size;
 
             // Transform Updates.
             const vec2& pos = UIUtils::Transform::GetMinBounds(&transform);
-            const vec2& size = transform.size;
-            const UI::FBox& texCoords = image.style.texCoord;
-
-            std::vector<UISystem::UIVertex> vertices;
-            CalculateVertices(pos, size, texCoords, vertices);
-
-            static const u32 bufferSize = sizeof(UISystem::UIVertex) * 4; // 4 vertices per image
+            CalculateQuad(pos, transform.size, image.style.texCoord, textureIndex, image.quad);
+        });
 
-            if (image.vertexBufferID == Renderer::BufferID::Invalid())
+        // Glyphs the font worker finished since last frame, text that drew the fallback for them gets new quads even if nothing else changed
+        if (Renderer::Font::FinishGlyphLoads())
+        {
+            auto pendingTextView = registry.view<UIComponent::Transform, UIComponent::Text>(entt::exclude<UIComponent::Dirty>);
+            pendingTextView.each([&](UIComponent::Transform& transform, UIComponent::Text& text)
             {
-                Renderer::BufferDesc desc;
-                desc.name = "ImageVertices";
-                desc.size = bufferSize;
-                desc.usage = Renderer::BufferUsage::UNIFORM_BUFFER;
-                desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-                image.vertexBufferID = renderer->CreateBuffer(desc);
-            }
-
-            void* dst = renderer->MapBuffer(image.vertexBufferID);
-            memcpy(dst, vertices.data(), bufferSize);
-            renderer->UnmapBuffer(image.vertexBufferID);
-        });
+                if (text.hasPendingGlyphs && text.font != nullptr)
+                {
+                    UpdateGlyphQuads(registry, transform, text, true);
+                }
+            });
+        }
 
         auto textView = registry.view<UIComponent::Transform, UIComponent::Text, UIComponent::Dirty>();
         textView.each([&](UIComponent::Transform& transform, UIComponent::Text& text)
@@ -134,109 +184,12 @@ namespace UISystem
                 text.font = Renderer::Font::GetFont(renderer, text.style.fontPath, text.style.fontSize);
             }
 
-            std::vector<f32> lineWidths;
-            std::vector<size_t> lineBreakPoints;
-            size_t finalCharacter = UIUtils::Text::CalculateLineWidthsAndBreaks(&text, transform.size.x, transform.size.y, lineWidths, lineBreakPoints);
-
-            size_t textLengthWithoutSpaces = std::count_if(text.text.begin() + text.pushback, text.text.end() - (text.text.length() - finalCharacter), [](char c) { return !std::isspace(c); });
-
-            // If textLengthWithoutSpaces is bigger than the amount of glyphs we allocated in our buffer we need to reallocate the buffer
-            static const u32 perGlyphVertexSize = sizeof(UISystem::UIVertex) * 4; // 4 vertices per glyph
-            if (textLengthWithoutSpaces > text.vertexBufferGlyphCount)
-            {
-                if (text.vertexBufferID != Renderer::BufferID::Invalid())
-                {
-                    renderer->QueueDestroyBuffer(text.vertexBufferID);
-                }
-                if (text.textureIDBufferID != Renderer::BufferID::Invalid())
-                {
-                    renderer->QueueDestroyBuffer(text.textureIDBufferID);
-                }
-
-                Renderer::BufferDesc vertexBufferDesc;
-                vertexBufferDesc.name = "TextView";
-                vertexBufferDesc.size = textLengthWithoutSpaces * perGlyphVertexSize;
-                vertexBufferDesc.usage = Renderer::BufferUsage::STORAGE_BUFFER;
-                vertexBufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-                text.vertexBufferID = renderer->CreateBuffer(vertexBufferDesc);
-
-                Renderer::BufferDesc textureIDBufferDesc;
-                textureIDBufferDesc.name = "TexturesIDs";
-                textureIDBufferDesc.size = textLengthWithoutSpaces * sizeof(u32); // 1 u32 per glyph
-                textureIDBufferDesc.usage = Renderer::BufferUsage::STORAGE_BUFFER;
-                textureIDBufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-                text.textureIDBufferID = renderer->CreateBuffer(textureIDBufferDesc);
-
-                text.vertexBufferGlyphCount = textLengthWithoutSpaces;
-            }
-            text.glyphCount = textLengthWithoutSpaces;
-
-            if (textLengthWithoutSpaces > 0)
-            {
-                vec2 alignment = UIUtils::Text::GetAlignment(&text);
-                vec2 currentPosition = UIUtils::Transform::GetAnchorPositionInElement(&transform, alignment);
-                f32 startX = currentPosition.x;
-                currentPosition.x -= lineWidths[0] * alignment.x;
-                currentPosition.y += text.style.fontSize * (1 - alignment.y) * lineWidths.size();
-
-                std::vector<UISystem::UIVertex> vertices;
-
-                UISystem::UIVertex* baseVertices = reinterpret_cast<UISystem::UIVertex*>(renderer->MapBuffer(text.vertexBufferID));
-                u32* baseTextureID = reinterpret_cast<u32*>(renderer->MapBuffer(text.textureIDBufferID));
-
-                size_t currentLine = 0;
-                size_t glyph = 0;
-                for (size_t i = text.pushback; i < finalCharacter; i++)
-                {
-                    const char character = text.text[i];
-                    if (currentLine < lineBreakPoints.size() && lineBreakPoints[currentLine] == i)
-                    {
-                        currentLine++;
-                        currentPosition.y += text.style.fontSize * text.style.lineHeightMultiplier;
-                        currentPosition.x = startX - lineWidths[currentLine] * alignment.x;
-                    }
-
-                    if (character == '\n')
-                    {
-                        continue;
-                    }
-                    else if (std::isspace(character))
-                    {
-                        currentPosition.x += text.style.fontSize * 0.15f;
-                        continue;
-                    }
-
-                    const Renderer::FontChar& fontChar = text.font->GetChar(character);
-                    const vec2& pos = currentPosition + vec2(fontChar.xOffset, fontChar.yOffset);
-                    const vec2& size = vec2(fontChar.width, fontChar.height);
-                    UI::FBox texCoords{ 0.f, 1.f, 1.f, 0.f };
-
-                    vertices.clear();
-                    CalculateVertices(pos, size, texCoords, vertices);
-
-                    UISystem::UIVertex* dst = &baseVertices[glyph * 4]; // 4 vertices per glyph
-                    memcpy(dst, vertices.data(), perGlyphVertexSize);
-                    baseTextureID[glyph] = fontChar.textureIndex;
-
-                    currentPosition.x += fontChar.advance;
-                    glyph++;
-                }
-
-                renderer->UnmapBuffer(text.vertexBufferID);
-                renderer->UnmapBuffer(text.textureIDBufferID);
-            }
-
-            // Create constant buffer if necessary
-            if (!text.constantBuffer)
-                text.constantBuffer = new Renderer::Buffer<UIComponent::Text::TextConstantBuffer>(renderer, "UpdateElementSystemConstantBuffer", Renderer::BufferUsage::UNIFORM_BUFFER, Renderer::BufferCPUAccess::WriteOnly);
+            // Dirty text skipped the pending pass, so glyphs that finished this frame still need their quads rebuilt here
+            UpdateGlyphQuads(registry, transform, text, text.hasPendingGlyphs);
 
-            text.constantBuffer->resource.textColor = text.style.color;
-            text.constantBuffer->resource.outlineColor = text.style.outlineColor;
-            text.constantBuffer->resource.outlineWidth = text.style.outlineWidth;
-            text.constantBuffer->Apply(0);
-            text.constantBuffer->Apply(1);
+            text.constants.textColor = text.style.color;
+            text.constants.outlineColor = text.style.outlineColor;
+            text.constants.outlineWidth = text.style.outlineWidth;
         });
     }
 }
\ No newline at end of file
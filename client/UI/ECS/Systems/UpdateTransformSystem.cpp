@@ -0,0 +1,48 @@
+#include "UpdateTransformSystem.h"
+#include <entity/registry.hpp>
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <execution>
+#include <vector>
+
+#include "../Components/Relation.h"
+#include "../Components/TransformDirty.h"
+
+#include "../../Utils/TransformUtils.h"
+
+
+namespace UISystem
+{
+    void UpdateTransformSystem::Update(entt::registry& registry)
+    {
+        auto dirtyView = registry.view<UIComponent::TransformDirty>();
+        if (dirtyView.empty())
+            return;
+
+        // Elements below another dirty element get resolved as part of that element's subtree
+        std::vector<entt::entity> dirtyRoots;
+        dirtyRoots.reserve(dirtyView.size());
+        for (entt::entity entityId : dirtyView)
+        {
+            bool hasDirtyAncestor = false;
+            for (entt::entity parent = registry.get<UIComponent::Relation>(entityId).parent; parent != entt::null; parent = registry.get<UIComponent::Relation>(parent).parent)
+            {
+                if (registry.has<UIComponent::TransformDirty>(parent))
+                {
+                    hasDirtyAncestor = true;
+                    break;
+                }
+            }
+
+            if (!hasDirtyAncestor)
+                dirtyRoots.push_back(entityId);
+        }
+
+        // The remaining subtrees don't overlap, so they only write to their own transforms
+        std::for_each(std::execution::par, dirtyRoots.begin(), dirtyRoots.end(), [&registry](entt::entity entityId)
+        {
+            ZoneScopedN("UpdateChildTransforms");
+            UIUtils::Transform::UpdateChildTransforms(&registry, entityId);
+        });
+    }
+}
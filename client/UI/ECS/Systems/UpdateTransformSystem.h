@@ -0,0 +1,11 @@
+#pragma once
+#include <entity/fwd.hpp>
+
+namespace UISystem
+{
+    class UpdateTransformSystem
+    {
+    public:
+        static void Update(entt::registry& registry);
+    };
+}
@@ -11,16 +11,12 @@
 #include "ECS/Components/ElementInfo.h"
 #include "ECS/Components/Transform.h"
 #include "ECS/Components/TransformEvents.h"
-#include "ECS/Components/SortKey.h"
-#include "ECS/Components/Collision.h"
-#include "ECS/Components/Collidable.h"
-#include "ECS/Components/Visible.h"
-#include "ECS/Components/NotCulled.h"
 
 #include "Utils/ElementUtils.h"
 #include "Utils/TransformUtils.h"
 #include "Utils/ColllisionUtils.h"
 #include "Utils/EventUtils.h"
+#include "Utils/HitGridUtils.h"
 
 #include "angelscript/Inputfield.h"
 #include "angelscript/Checkbox.h"
@@ -54,63 +50,54 @@ namespace UIInput
             return true;
         }
 
-        auto eventGroup = registry->group<>(entt::get<UIComponent::TransformEvents, UIComponent::ElementInfo, UIComponent::SortKey, UIComponent::Collision, UIComponent::Collidable, UIComponent::Visible, UIComponent::NotCulled>);
-        eventGroup.sort<UIComponent::SortKey>([](const UIComponent::SortKey& first, const UIComponent::SortKey& second) { return first.key > second.key; });
-        for (auto entity : eventGroup)
-        {
-            UIComponent::TransformEvents& events = eventGroup.get<UIComponent::TransformEvents>(entity);
-            const UIComponent::ElementInfo& elementInfo = eventGroup.get<UIComponent::ElementInfo>(entity);
-            const UIComponent::Collision& collision = eventGroup.get<UIComponent::Collision>(entity);
+        const entt::entity entity = UIUtils::HitGrid::FindTopMostElement(registry, mouse, entt::null);
+        if (entity == entt::null)
+            return false;
 
-            // Check so mouse if within widget bounds.
-            if (mouse.x < collision.minBound.x || mouse.x > collision.maxBound.x || mouse.y < collision.minBound.y || mouse.y > collision.maxBound.y)
-                continue;
+        auto [events, elementInfo] = registry->get<UIComponent::TransformEvents, UIComponent::ElementInfo>(entity);
 
-            // Don't interact with the last focused widget directly. Reserving first click for unfocusing it but still block clicking through it.
-            // Also check if we have any events we can actually call else exit out early.
-            if (lastFocusedWidget == entity || !events.flags)
-                return true;
+        // Don't interact with the last focused widget directly. Reserving first click for unfocusing it but still block clicking through it.
+        // Also check if we have any events we can actually call else exit out early.
+        if (lastFocusedWidget == entity || !events.flags)
+            return true;
 
-            if (keybind->state == GLFW_PRESS)
+        if (keybind->state == GLFW_PRESS)
+        {
+            if (events.IsDraggable())
             {
-                if (events.IsDraggable())
-                {
-                    const UIComponent::Transform& transform = registry->get<UIComponent::Transform>(entity);
-                    dataSingleton.draggedWidget = entity;
-                    dataSingleton.dragOffset = mouse - (transform.anchorPosition + transform.position);
-                    
-                    UIUtils::ExecuteEvent(elementInfo.scriptingObject, events.onDragStartedCallback);
-                }
+                const UIComponent::Transform& transform = registry->get<UIComponent::Transform>(entity);
+                dataSingleton.draggedWidget = entity;
+                dataSingleton.dragOffset = mouse - (transform.anchorPosition + transform.position);
+                
+                UIUtils::ExecuteEvent(elementInfo.scriptingObject, events.onDragStartedCallback);
             }
-            else if (keybind->state == GLFW_RELEASE)
+        }
+        else if (keybind->state == GLFW_RELEASE)
+        {
+            if (events.IsFocusable())
             {
-                if (events.IsFocusable())
-                {
-                    dataSingleton.focusedWidget = entity;
+                dataSingleton.focusedWidget = entity;
 
-                    UIUtils::ExecuteEvent(elementInfo.scriptingObject, events.onFocusGainedCallback);
-                }
+                UIUtils::ExecuteEvent(elementInfo.scriptingObject, events.onFocusGainedCallback);
+            }
 
-                if (events.IsClickable())
+            if (events.IsClickable())
+            {
+                if (elementInfo.type == UI::ElementType::UITYPE_CHECKBOX)
+                {
+                    UIScripting::Checkbox* checkBox = reinterpret_cast<UIScripting::Checkbox*>(elementInfo.scriptingObject);
+                    checkBox->ToggleChecked();
+                } 
+                else if(elementInfo.type == UI::ElementType::UITYPE_SLIDER)
                 {
-                    if (elementInfo.type == UI::ElementType::UITYPE_CHECKBOX)
-                    {
-                        UIScripting::Checkbox* checkBox = reinterpret_cast<UIScripting::Checkbox*>(elementInfo.scriptingObject);
-                        checkBox->ToggleChecked();
-                    } 
-                    else if(elementInfo.type == UI::ElementType::UITYPE_SLIDER)
-                    {
-                        UIScripting::Slider* slider = reinterpret_cast<UIScripting::Slider*>(elementInfo.scriptingObject);
-                        slider->OnClicked(mouse);
-                    }
-                    UIUtils::ExecuteEvent(elementInfo.scriptingObject, events.onClickCallback);
+                    UIScripting::Slider* slider = reinterpret_cast<UIScripting::Slider*>(elementInfo.scriptingObject);
+                    slider->OnClicked(mouse);
                 }
+                UIUtils::ExecuteEvent(elementInfo.scriptingObject, events.onClickCallback);
             }
-
-            return true;
         }
 
-        return false;
+        return true;
     }
 
     void OnMousePositionUpdate(Window* window, f32 x, f32 y)
@@ -143,31 +130,17 @@ namespace UIInput
 
             UIUtils::MarkDirty(registry, dataSingleton.draggedWidget);
             UIUtils::MarkChildrenDirty(registry, dataSingleton.draggedWidget);
-            UIUtils::Transform::UpdateChildPositions(registry, dataSingleton.draggedWidget);
+            UIUtils::Transform::MarkTransformDirty(registry, dataSingleton.draggedWidget);
             UIUtils::Collision::MarkBoundsDirty(registry, dataSingleton.draggedWidget);
         }
 
         // Handle hover.
-        auto eventGroup = registry->group<>(entt::get<UIComponent::TransformEvents, UIComponent::SortKey, UIComponent::Collision, UIComponent::Collidable, UIComponent::Visible, UIComponent::NotCulled>);
-        eventGroup.sort<UIComponent::SortKey>([](const UIComponent::SortKey& first, const UIComponent::SortKey& second) { return first.key > second.key; });
-        for (auto entity : eventGroup)
+        const entt::entity entity = UIUtils::HitGrid::FindTopMostElement(registry, mouse, dataSingleton.draggedWidget);
+        if (entity != entt::null && dataSingleton.hoveredWidget != entity)
         {
-            if (dataSingleton.draggedWidget == entity)
-                continue;
-
-            const UIComponent::Collision& collision = eventGroup.get<UIComponent::Collision>(entity);
-            // Check so mouse if within widget bounds.
-            if (mouse.x < collision.minBound.x || mouse.x > collision.maxBound.x || mouse.y < collision.minBound.y || mouse.y > collision.maxBound.y)
-                continue;
-
-            // Hovered widget hasn't changed.
-            if (dataSingleton.hoveredWidget == entity)
-                break;
             dataSingleton.hoveredWidget = entity;
 
             // TODO Update EventState.
-
-            break;
         }
     }
 
@@ -246,8 +219,5 @@ namespace UIInput
         inputManager->RegisterMousePositionCallback("UI Mouse Position Checker", std::bind(&OnMousePositionUpdate, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
         inputManager->RegisterKeyboardInputCallback("UI Keyboard Input Checker"_h, std::bind(&OnKeyboardInput, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
         inputManager->RegisterCharInputCallback("UI Char Input Checker"_h, std::bind(&OnCharInput, std::placeholders::_1, std::placeholders::_2));
-
-        // Create mouse group upfront. Reduces hitching from first mouse input.
-        auto eventGroup = ServiceLocator::GetUIRegistry()->group<>(entt::get<UIComponent::TransformEvents, UIComponent::ElementInfo, UIComponent::SortKey, UIComponent::Collision, UIComponent::Collidable, UIComponent::Visible, UIComponent::NotCulled>);
     }
 }
\ No newline at end of file
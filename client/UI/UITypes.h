@@ -70,6 +70,17 @@ namespace UI
     };
 #pragma pack(pop)
 
+    // The batched UI pass draws every image and glyph as an instanced quad, matches Quad in shaders/UI/ui.inc.hlsl
+    struct Quad
+    {
+        vec2 minPosition = vec2(0.0f, 0.0f); // Upper left corner in 0 - 1 screen space
+        vec2 maxPosition = vec2(0.0f, 0.0f); // Lower right corner
+        vec2 minUV = vec2(0.0f, 0.0f);
+        vec2 maxUV = vec2(0.0f, 0.0f);
+        u32 textureIndex = 0; // Into the UI image texture array for images, into the font texture array for glyphs
+        u32 dataIndex = 0; // Filled in by the UIRenderer when the quad gets copied into the frame
+    };
+
     struct TextStylesheet
     {
         Color color = Color(1, 1, 1, 1);
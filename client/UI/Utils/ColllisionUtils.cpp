@@ -4,6 +4,7 @@
 #include "../ECS/Components/Transform.h"
 #include "../ECS/Components/Relation.h"
 #include "TransformUtils.h"
+#include "HitGridUtils.h"
 
 namespace UIUtils::Collision
 {
@@ -35,6 +36,7 @@ namespace UIUtils::Collision
 
         collision.minBound = minBound;
         collision.maxBound = maxBound;
+        UIUtils::HitGrid::UpdateElement(registry, entityId);
 
         if (!updateParent || relation.parent == entt::null)
             return;
@@ -64,6 +66,7 @@ namespace UIUtils::Collision
                 if (childCollision->maxBound.y > collision.maxBound.y) { collision.maxBound.y = childCollision->maxBound.y; }
             }
         }
+        UIUtils::HitGrid::UpdateElement(registry, entityId);
 
         if (relation.parent == entt::null)
             return;
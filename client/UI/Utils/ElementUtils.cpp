@@ -10,6 +10,7 @@
 #include "../ECS/Components/Dirty.h"
 
 #include "TransformUtils.h"
+#include "HitGridUtils.h"
 
 namespace UIUtils
 {
@@ -30,6 +31,7 @@ namespace UIUtils
 
         // Delete entities.
         registry->destroy(entityIds.begin(), entityIds.end());
+        UIUtils::HitGrid::Resize(registry);
 
         dataSingleton->focusedWidget = entt::null;
         dataSingleton->hoveredWidget = entt::null;
@@ -67,6 +69,7 @@ namespace UIUtils
 
         childRelation.parent = entt::null;
         childTransform.anchorPosition = UIUtils::Transform::GetAnchorPositionOnScreen(childTransform.anchor);
+        UIUtils::Transform::MarkTransformDirty(registry, child);
 
         parentRelation.children.erase(std::remove_if(parentRelation.children.begin(), parentRelation.children.end(), [child](UI::UIChild& uiChild) { return uiChild.entId == child; }), parentRelation.children.end());
     }
@@ -0,0 +1,169 @@
+#include "HitGridUtils.h"
+#include <entity/registry.hpp>
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <cmath>
+#include "../ECS/Components/Singletons/UIDataSingleton.h"
+#include "../ECS/Components/Singletons/UIHitGridSingleton.h"
+#include "../ECS/Components/TransformEvents.h"
+#include "../ECS/Components/SortKey.h"
+#include "../ECS/Components/Collision.h"
+#include "../ECS/Components/Collidable.h"
+#include "../ECS/Components/Visible.h"
+#include "../ECS/Components/NotCulled.h"
+
+namespace UIUtils::HitGrid
+{
+    using CellRange = UISingleton::UIHitGridSingleton::CellRange;
+
+    // Bounds outside of the screen are clamped away, an element that is fully outside gets an empty range
+    static CellRange GetCellRange(const UISingleton::UIHitGridSingleton& grid, const hvec2& minBound, const hvec2& maxBound)
+    {
+        CellRange range;
+
+        const f32 gridWidth = grid.numCellsX * UISingleton::UIHitGridSingleton::CELL_SIZE;
+        const f32 gridHeight = grid.numCellsY * UISingleton::UIHitGridSingleton::CELL_SIZE;
+        if (maxBound.x < 0.f || maxBound.y < 0.f || minBound.x >= gridWidth || minBound.y >= gridHeight || maxBound.x < minBound.x || maxBound.y < minBound.y)
+            return range;
+
+        const auto ToCell = [](f32 position, u16 numCells)
+        {
+            const i32 cell = static_cast<i32>(position / UISingleton::UIHitGridSingleton::CELL_SIZE);
+            return static_cast<u16>(glm::clamp(cell, 0, numCells - 1));
+        };
+
+        range.minX = ToCell(minBound.x, grid.numCellsX);
+        range.minY = ToCell(minBound.y, grid.numCellsY);
+        range.maxX = ToCell(maxBound.x, grid.numCellsX) + 1;
+        range.maxY = ToCell(maxBound.y, grid.numCellsY) + 1;
+
+        return range;
+    }
+
+    static void AddToCells(UISingleton::UIHitGridSingleton& grid, entt::entity entityId, const CellRange& range)
+    {
+        for (u16 y = range.minY; y < range.maxY; y++)
+        {
+            for (u16 x = range.minX; x < range.maxX; x++)
+            {
+                grid.cells[y * grid.numCellsX + x].push_back(entityId);
+            }
+        }
+    }
+
+    static void RemoveFromCells(UISingleton::UIHitGridSingleton& grid, entt::entity entityId, const CellRange& range)
+    {
+        for (u16 y = range.minY; y < range.maxY; y++)
+        {
+            for (u16 x = range.minX; x < range.maxX; x++)
+            {
+                // Order within a cell doesn't matter, the query picks by SortKey
+                std::vector<entt::entity>& cell = grid.cells[y * grid.numCellsX + x];
+                auto itr = std::find(cell.begin(), cell.end(), entityId);
+                if (itr != cell.end())
+                {
+                    *itr = cell.back();
+                    cell.pop_back();
+                }
+            }
+        }
+    }
+
+    void Resize(entt::registry* registry)
+    {
+        ZoneScoped;
+        const UISingleton::UIDataSingleton& dataSingleton = registry->ctx<UISingleton::UIDataSingleton>();
+        UISingleton::UIHitGridSingleton& grid = registry->ctx<UISingleton::UIHitGridSingleton>();
+
+        grid.numCellsX = static_cast<u16>(glm::max(1, static_cast<i32>(std::ceil(dataSingleton.UIRESOLUTION.x / UISingleton::UIHitGridSingleton::CELL_SIZE))));
+        grid.numCellsY = static_cast<u16>(glm::max(1, static_cast<i32>(std::ceil(dataSingleton.UIRESOLUTION.y / UISingleton::UIHitGridSingleton::CELL_SIZE))));
+
+        grid.cells.clear();
+        grid.cells.resize(static_cast<size_t>(grid.numCellsX) * grid.numCellsY);
+        grid.entityToCells.clear();
+
+        auto collisionView = registry->view<UIComponent::Collision>();
+        collisionView.each([&](entt::entity entityId, UIComponent::Collision& collision)
+        {
+            CellRange range = GetCellRange(grid, collision.minBound, collision.maxBound);
+            grid.entityToCells[entityId] = range;
+            AddToCells(grid, entityId, range);
+        });
+    }
+
+    void UpdateElement(entt::registry* registry, entt::entity entityId)
+    {
+        UISingleton::UIHitGridSingleton& grid = registry->ctx<UISingleton::UIHitGridSingleton>();
+        const UIComponent::Collision& collision = registry->get<UIComponent::Collision>(entityId);
+
+        const CellRange range = GetCellRange(grid, collision.minBound, collision.maxBound);
+
+        auto itr = grid.entityToCells.find(entityId);
+        if (itr != grid.entityToCells.end())
+        {
+            // Most bounds updates stay within the same cells, the exact bounds are only checked by the query
+            if (itr->second == range)
+                return;
+
+            RemoveFromCells(grid, entityId, itr->second);
+            itr->second = range;
+        }
+        else
+        {
+            grid.entityToCells[entityId] = range;
+        }
+
+        AddToCells(grid, entityId, range);
+    }
+
+    void RemoveElement(entt::registry* registry, entt::entity entityId)
+    {
+        UISingleton::UIHitGridSingleton& grid = registry->ctx<UISingleton::UIHitGridSingleton>();
+
+        auto itr = grid.entityToCells.find(entityId);
+        if (itr == grid.entityToCells.end())
+            return;
+
+        RemoveFromCells(grid, entityId, itr->second);
+        grid.entityToCells.erase(itr);
+    }
+
+    entt::entity FindTopMostElement(entt::registry* registry, const hvec2& point, entt::entity ignoredEntity)
+    {
+        ZoneScoped;
+        const UISingleton::UIHitGridSingleton& grid = registry->ctx<UISingleton::UIHitGridSingleton>();
+
+        if (point.x < 0.f || point.y < 0.f)
+            return entt::null;
+
+        const u32 cellX = static_cast<u32>(point.x / UISingleton::UIHitGridSingleton::CELL_SIZE);
+        const u32 cellY = static_cast<u32>(point.y / UISingleton::UIHitGridSingleton::CELL_SIZE);
+        if (cellX >= grid.numCellsX || cellY >= grid.numCellsY)
+            return entt::null;
+
+        // Visibility, culling and collision toggle without touching the bounds, so they get checked here instead of keeping the grid in sync with them
+        entt::entity topMostEntity = entt::null;
+        u64 topMostKey = 0;
+        for (entt::entity entity : grid.cells[cellY * grid.numCellsX + cellX])
+        {
+            if (entity == ignoredEntity)
+                continue;
+
+            if (!registry->has<UIComponent::TransformEvents, UIComponent::Collidable, UIComponent::Visible, UIComponent::NotCulled>(entity))
+                continue;
+
+            const UIComponent::Collision& collision = registry->get<UIComponent::Collision>(entity);
+            if (point.x < collision.minBound.x || point.x > collision.maxBound.x || point.y < collision.minBound.y || point.y > collision.maxBound.y)
+                continue;
+
+            const UIComponent::SortKey& sortKey = registry->get<UIComponent::SortKey>(entity);
+            if (topMostEntity == entt::null || sortKey.key > topMostKey)
+            {
+                topMostEntity = entity;
+                topMostKey = sortKey.key;
+            }
+        }
+
+        return topMostEntity;
+    }
+}
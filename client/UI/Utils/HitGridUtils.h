@@ -0,0 +1,34 @@
+#pragma once
+#include <NovusTypes.h>
+#include <entity/fwd.hpp>
+
+namespace UIUtils::HitGrid
+{
+    /*
+    *   Sizes the grid to cover the UI resolution and inserts every element with collision bounds again.
+    *   registry: Pointer to UI Registry.
+    */
+    void Resize(entt::registry* registry);
+
+    /*
+    *   Moves the element to the cells its collision bounds overlap, call after the bounds changed.
+    *   registry: Pointer to UI Registry.
+    *   entityId: entity whose bounds changed.
+    */
+    void UpdateElement(entt::registry* registry, entt::entity entityId);
+
+    /*
+    *   Removes the element from the grid, call before it gets destroyed.
+    *   registry: Pointer to UI Registry.
+    *   entityId: entity to remove.
+    */
+    void RemoveElement(entt::registry* registry, entt::entity entityId);
+
+    /*
+    *   Returns the top-most element under point which is visible, not culled, collidable and has events, entt::null if there is none.
+    *   registry: Pointer to UI Registry.
+    *   point: Position in UI space.
+    *   ignoredEntity: entity to skip, like the one being dragged.
+    */
+    entt::entity FindTopMostElement(entt::registry* registry, const hvec2& point, entt::entity ignoredEntity);
+};
@@ -1,5 +1,7 @@
 #include "TextUtils.h"
+#include <entity/registry.hpp>
 #include <tracy/Tracy.hpp>
+#include <cstring>
 
 namespace UIUtils::Text
 {
@@ -21,8 +23,6 @@ namespace UIUtils::Text
         if (text->text.length() == 0)
             return 0;
 
-        auto GetAdvance = [&](char c) { return std::isspace(c) ? text->style.fontSize * 0.15f : text->font->GetChar(c).advance; };
-
         size_t oldPushback = Math::Min(text->pushback, text->text.length() - 1);
         size_t finalCharacter = oldPushback;
 
@@ -30,7 +30,7 @@ namespace UIUtils::Text
         bool overflowed = false;
         for (; finalCharacter < text->text.length(); finalCharacter++)
         {
-            lineLength += GetAdvance(text->text[finalCharacter]);
+            lineLength += GetAdvance(text, finalCharacter);
 
             if (lineLength >= maxWidth)
             {
@@ -48,7 +48,7 @@ namespace UIUtils::Text
 
         for (size_t i = writeHead - 1; i > 0; --i)
         {
-            lineLength += GetAdvance(text->text[i]);
+            lineLength += GetAdvance(text, i);
 
             if (lineLength > bufferSpace)
                 return i + 1;
@@ -127,14 +127,14 @@ namespace UIUtils::Text
                 continue;
             }
 
-            if (std::isspace(text->text[i]))
+            if (IsSpace(text->text[i]))
             {
                 advance = text->style.fontSize * 0.15f;
                 BreakWord(i);
             }
             else
             {
-                advance = text->font->GetChar(text->text[i]).advance;
+                advance = GetAdvance(text, i);
                 wordWidth += advance;
             }
 
@@ -190,14 +190,14 @@ namespace UIUtils::Text
                 continue;
             }
 
-            if (std::isspace(text->text[i]))
+            if (IsSpace(text->text[i]))
             {
                 advance = text->style.fontSize * 0.15f;
                 BreakWord(i);
             }
             else
             {
-                advance = text->font->GetChar(text->text[i]).advance;
+                advance = GetAdvance(text, i);
                 wordWidth += advance;
             }
 
@@ -216,4 +216,71 @@ namespace UIUtils::Text
             lineWidths.back() += advance;
         }
     }
+
+    u64 CalculateLayoutKey(const UIComponent::Text* text, f32 maxWidth, f32 maxHeight)
+    {
+        const auto FloatBits = [](f32 value)
+        {
+            u32 bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return static_cast<u64>(bits);
+        };
+
+        // Font is unique per path and size, so the pointer covers both
+        const u64 values[] =
+        {
+            robin_hood::hash_bytes(text->text.data(), text->text.length()),
+            reinterpret_cast<u64>(text->font),
+            FloatBits(maxWidth),
+            FloatBits(maxHeight),
+            FloatBits(text->style.lineHeightMultiplier),
+            static_cast<u64>(text->pushback),
+            static_cast<u64>(text->multiline),
+            static_cast<u64>(text->horizontalAlignment),
+            static_cast<u64>(text->verticalAlignment)
+        };
+
+        return robin_hood::hash_bytes(values, sizeof(values));
+    }
+
+    const UISingleton::UITextLayoutCacheSingleton::Layout& GetLayout(entt::registry* registry, const UIComponent::Text* text, u64 layoutKey, f32 maxWidth, f32 maxHeight)
+    {
+        UISingleton::UITextLayoutCacheSingleton& cache = registry->ctx<UISingleton::UITextLayoutCacheSingleton>();
+
+        auto itr = cache.layouts.find(layoutKey);
+        if (itr != cache.layouts.end())
+        {
+            itr->second.lastUsedFrame = cache.frame;
+            cache.cachedLayoutsThisFrame++;
+            return itr->second;
+        }
+
+        UISingleton::UITextLayoutCacheSingleton::Layout& layout = cache.layouts[layoutKey];
+        layout.finalCharacter = CalculateLineWidthsAndBreaks(text, maxWidth, maxHeight, layout.lineWidths, layout.lineBreakPoints);
+        layout.lastUsedFrame = cache.frame;
+        cache.layoutsThisFrame++;
+
+        return layout;
+    }
+
+    void BeginLayoutFrame(entt::registry* registry)
+    {
+        ZoneScoped;
+        UISingleton::UITextLayoutCacheSingleton& cache = registry->ctx<UISingleton::UITextLayoutCacheSingleton>();
+
+        if (cache.layouts.size() > UISingleton::UITextLayoutCacheSingleton::MAX_LAYOUTS)
+        {
+            for (auto itr = cache.layouts.begin(); itr != cache.layouts.end();)
+            {
+                if (itr->second.lastUsedFrame != cache.frame)
+                    itr = cache.layouts.erase(itr);
+                else
+                    ++itr;
+            }
+        }
+
+        cache.frame++;
+        cache.layoutsThisFrame = 0;
+        cache.cachedLayoutsThisFrame = 0;
+    }
 }
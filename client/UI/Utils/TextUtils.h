@@ -1,6 +1,9 @@
 #pragma once
 #include <NovusTypes.h>
+#include <entity/fwd.hpp>
 #include "../ECS/Components/Text.h"
+#include "../ECS/Components/Singletons/UITextLayoutCacheSingleton.h"
+#include <cctype>
 
 namespace UIUtils::Text
 {
@@ -41,6 +44,74 @@ namespace UIUtils::Text
         return vec2(GetHorizontalAlignment(text->horizontalAlignment), GetVerticalAlignment(text->verticalAlignment));
     }
 
+    // Text is UTF-8, indices stay byte indices and the trailing bytes of a multibyte character get skipped
+    inline static bool IsContinuationByte(char c)
+    {
+        return (static_cast<u8>(c) & 0xC0) == 0x80;
+    }
+
+    inline static bool IsSpace(char c)
+    {
+        return static_cast<u8>(c) < 0x80 && std::isspace(c);
+    }
+
+    // Decodes the character starting at index, malformed sequences decode to U+FFFD
+    inline static u32 DecodeCodepoint(const std::string& text, size_t index)
+    {
+        const u8 lead = static_cast<u8>(text[index]);
+        if (lead < 0x80)
+            return lead;
+
+        u32 length;
+        u32 codepoint;
+        if ((lead & 0xE0) == 0xC0)
+        {
+            length = 2;
+            codepoint = lead & 0x1F;
+        }
+        else if ((lead & 0xF0) == 0xE0)
+        {
+            length = 3;
+            codepoint = lead & 0x0F;
+        }
+        else if ((lead & 0xF8) == 0xF0)
+        {
+            length = 4;
+            codepoint = lead & 0x07;
+        }
+        else
+        {
+            return 0xFFFD;
+        }
+
+        if (index + length > text.length())
+            return 0xFFFD;
+
+        for (u32 i = 1; i < length; i++)
+        {
+            const char c = text[index + i];
+            if (!IsContinuationByte(c))
+                return 0xFFFD;
+
+            codepoint = (codepoint << 6) | (static_cast<u8>(c) & 0x3F);
+        }
+
+        return codepoint;
+    }
+
+    // Advance of the character at index, 0 for trailing bytes
+    inline static f32 GetAdvance(const UIComponent::Text* text, size_t index)
+    {
+        const char c = text->text[index];
+        if (IsContinuationByte(c))
+            return 0.f;
+
+        if (IsSpace(c))
+            return text->style.fontSize * 0.15f;
+
+        return text->font->GetChar(DecodeCodepoint(text->text, index)).advance;
+    }
+
     /*
     *   Calculate Pushback index.
     *   text: Text to calculate pushback for.
@@ -68,4 +139,28 @@ namespace UIUtils::Text
     */
     void CalculateAllLineWidthsAndBreaks(const UIComponent::Text* text, f32 maxWidth, std::vector<f32>& lineWidths, std::vector<size_t>& lineBreakPoints);
 
+    /*
+    *   Hash of everything the line layout and glyph placement depend on, apart from the position of the text.
+    *   text: Text to hash, needs a font.
+    *   maxWidth: Max width of a line.
+    *   maxHeight: Max heights of all lines summed.
+    */
+    u64 CalculateLayoutKey(const UIComponent::Text* text, f32 maxWidth, f32 maxHeight);
+
+    /*
+    *   Returns the cached line layout for layoutKey, calculating it if it isn't cached yet.
+    *   registry: Pointer to UI Registry.
+    *   text: Text to lay out.
+    *   layoutKey: Key from CalculateLayoutKey.
+    *   maxWidth: Max width of a line.
+    *   maxHeight: Max heights of all lines summed.
+    */
+    const UISingleton::UITextLayoutCacheSingleton::Layout& GetLayout(entt::registry* registry, const UIComponent::Text* text, u64 layoutKey, f32 maxWidth, f32 maxHeight);
+
+    /*
+    *   Resets the per frame stats and drops unused layouts once the cache is full, call before any GetLayout of the frame.
+    *   registry: Pointer to UI Registry.
+    */
+    void BeginLayoutFrame(entt::registry* registry);
+
 };
\ No newline at end of file
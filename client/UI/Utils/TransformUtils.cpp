@@ -49,26 +49,4 @@ namespace UIUtils::Transform
             UpdateChildTransforms(registry, child.entId);
         }
     }
-
-    void UpdateChildPositions(entt::registry* registry, entt::entity entity)
-    {
-        auto [transform, relation] = registry->get<UIComponent::Transform, UIComponent::Relation>(entity);
-
-        if (!relation.children.size())
-            return;
-
-        const hvec2 minAnchorBound = GetMinBounds(&transform) + hvec2(transform.padding.left, transform.padding.top);
-        const hvec2 adjustedSize = transform.size - hvec2(transform.padding.right, transform.padding.bottom);
-
-        for (const UI::UIChild& child : relation.children)
-        {
-            UIComponent::Transform* childTransform = &registry->get<UIComponent::Transform>(child.entId);
-            childTransform->anchorPosition = minAnchorBound + adjustedSize * childTransform->anchor;
-        }
-
-        for (const UI::UIChild& child : relation.children)
-        {
-            UpdateChildPositions(registry, child.entId);
-        }
-    }
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 #include <NovusTypes.h>
 #include <entity/fwd.hpp>
+#include <entity/registry.hpp>
 #include "../ECS/Components/Transform.h"
+#include "../ECS/Components/TransformDirty.h"
 
 namespace UIUtils::Transform
 {
@@ -44,5 +46,10 @@ namespace UIUtils::Transform
 
     void UpdateChildTransforms(entt::registry* registry, entt::entity entity);
 
-    void UpdateChildPositions(entt::registry* registry, entt::entity entity);
+    // Children get recomputed once by UpdateTransformSystem, no matter how often the element changed this frame
+    inline static void MarkTransformDirty(entt::registry* registry, entt::entity entityId)
+    {
+        if (!registry->has<UIComponent::TransformDirty>(entityId))
+            registry->emplace<UIComponent::TransformDirty>(entityId);
+    }
 };
\ No newline at end of file
@@ -69,7 +69,7 @@ namespace UIScripting
 
         transform->position = position;
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkTransformDirty(registry, _entityId);
     }
 
     vec2 BaseElement::GetSize() const
@@ -87,7 +87,7 @@ namespace UIScripting
             return;
         transform->size = size;
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkTransformDirty(registry, _entityId);
     }
     bool BaseElement::GetFillParentSize() const
     {
@@ -109,7 +109,7 @@ namespace UIScripting
         auto parentTransform = &registry->get<UIComponent::Transform>(relation.parent);
         transform.size = UIUtils::Transform::GetInnerSize(parentTransform);
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkTransformDirty(registry, _entityId);
     }
 
     void BaseElement::SetTransform(const vec2& position, const vec2& size)
@@ -121,7 +121,7 @@ namespace UIScripting
         if (!transform->HasFlag(UI::TransformFlags::FILL_PARENTSIZE))
             transform->size = size;
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkTransformDirty(registry, _entityId);
     }
 
     vec2 BaseElement::GetAnchor() const
@@ -143,7 +143,7 @@ namespace UIScripting
         else
             transform.anchorPosition = UIUtils::Transform::GetAnchorPositionInElement(&registry->get<UIComponent::Transform>(relation.parent), anchor);
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkTransformDirty(registry, _entityId);
     }
 
     vec2 BaseElement::GetLocalAnchor() const
@@ -160,7 +160,7 @@ namespace UIScripting
             return;
         transform->localAnchor = localAnchor;
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkTransformDirty(registry, _entityId);
     }
 
     void BaseElement::SetPadding(f32 top, f32 right, f32 bottom, f32 left)
@@ -169,7 +169,7 @@ namespace UIScripting
         auto transform = &registry->get<UIComponent::Transform>(_entityId);
         transform->padding = UI::HBox{ f16(top), f16(right), f16(bottom), f16(left) };
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkTransformDirty(registry, _entityId);
     }
 
     UI::DepthLayer BaseElement::GetDepthLayer() const
@@ -254,7 +254,7 @@ namespace UIScripting
         UIUtils::Sort::MarkSortTreeDirty(registry, parent->GetEntityId());
 
         if (relation->children.size())
-            UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+            UIUtils::Transform::MarkTransformDirty(registry, _entityId);
     }
     void BaseElement::UnsetParent()
     {
@@ -1,11 +1,19 @@
 #include "MapUtils.h"
 #include "../ECS/Components/Singletons/NDBCSingleton.h"
+#include "../Gameplay/Map/ChunkLoader.h"
+#include "../Gameplay/Map/MapArchive.h"
 
 #include <Utils/FileReader.h>
 #include <filesystem>
 namespace fs = std::filesystem;
 
-bool Terrain::MapUtils::LoadMap(entt::registry* registry, const NDBC::Map* map)
+static Terrain::ChunkLoader& GetChunkLoader()
+{
+    static Terrain::ChunkLoader chunkLoader;
+    return chunkLoader;
+}
+
+bool Terrain::MapUtils::LoadMap(entt::registry* registry, const NDBC::Map* map, bool streamChunks)
 {
     MapSingleton& mapSingleton = registry->ctx<MapSingleton>();
     NDBCSingleton& ndbcSingleton = registry->ctx<NDBCSingleton>();
@@ -21,114 +29,236 @@ bool Terrain::MapUtils::LoadMap(entt::registry* registry, const NDBC::Map* map)
     NDBC::File* mapFile = ndbcSingleton.GetNDBCFile("Maps"_h);
     const std::string& mapInternalName = mapFile->GetStringTable()->GetString(map->internalName);
 
+    // Prefer the packed archive, the loose files are only used for maps that haven't been packed
+    std::shared_ptr<Terrain::MapArchive> archive;
+    fs::path archivePath = fs::absolute(Terrain::MapArchive::GetArchivePath(mapInternalName));
+    if (fs::exists(archivePath))
+    {
+        archive = std::make_shared<Terrain::MapArchive>();
+        if (!archive->Open(archivePath.string()))
+        {
+            DebugHandler::PrintWarning("Failed to open map archive for %s, falling back to the map folder", mapInternalName.c_str());
+            archive.reset();
+        }
+        else if (archive->IsOutOfDate(mapInternalName))
+        {
+            // The loose files were extracted again after packing, the archive would hand out the old chunks
+            DebugHandler::PrintWarning("Map archive for %s is older than the map folder, falling back to the map folder until it gets repacked with packmap", mapInternalName.c_str());
+            archive.reset();
+        }
+    }
+
     fs::path absolutePath = std::filesystem::absolute("Data/extracted/maps/" + mapInternalName);
-    if (!fs::is_directory(absolutePath))
+    if (!archive && !fs::is_directory(absolutePath))
     {
         DebugHandler::PrintError("Failed to find map folder for %s", mapInternalName.c_str());
         return false;
     }
 
-    // Clear currently loaded map
+    // Clear currently loaded map, chunks still being streamed in for it are dropped first
+    GetChunkLoader().Clear();
     currentMap.Clear();
 
     currentMap.id = map->id;
     currentMap.name = mapInternalName;
+    currentMap.archive = archive;
 
-    bool nmapFound = false;
-    for (const auto& entry : std::filesystem::recursive_directory_iterator(absolutePath))
+    if (archive)
     {
-        auto file = std::filesystem::path(entry.path());
-
-        if (file.extension() != ".nmap")
-            continue;
-
-        std::string fileName = file.filename().replace_extension("").string();
-        if (fileName != mapInternalName)
-            continue;
-
-        FileReader mapHeaderFile(entry.path().string(), file.filename().string());
-        if (!mapHeaderFile.Open())
-        {
-            DebugHandler::PrintError("Failed to read map (%s)", mapInternalName.c_str());
-            return false;
-        }
-
-        if (!Terrain::MapHeader::Read(mapHeaderFile, currentMap.header))
+        if (!archive->ReadMapHeader(currentMap.header))
         {
             DebugHandler::PrintError("Failed to load map header for (%s)", mapInternalName.c_str());
             return false;
         }
-
-        nmapFound = true;
-        break;
     }
-
-    if (!nmapFound)
+    else
     {
-        DebugHandler::PrintError("Failed to find nmap file for map (%s)", mapInternalName.c_str());
-        return false;
-    }
-
-    // Load Chunks if map does not use Map Object as base
-    if (!currentMap.header.flags.UseMapObjectInsteadOfTerrain)
-    {
-        size_t loadedChunks = 0;
+        bool nmapFound = false;
         for (const auto& entry : std::filesystem::recursive_directory_iterator(absolutePath))
         {
             auto file = std::filesystem::path(entry.path());
-            if (file.extension() != ".nchunk")
+
+            if (file.extension() != ".nmap")
                 continue;
 
-            // Make sure filename is the same, multiple maps can have chunks in the same folder
-            std::string fileName = file.filename().string();
-            if (strncmp(fileName.c_str(), mapInternalName.c_str(), mapInternalName.length()) != 0)
+            std::string fileName = file.filename().replace_extension("").string();
+            if (fileName != mapInternalName)
                 continue;
 
-            FileReader chunkFile(entry.path().string(), file.filename().string());
-            if (!chunkFile.Open())
+            FileReader mapHeaderFile(entry.path().string(), file.filename().string());
+            if (!mapHeaderFile.Open())
             {
-                DebugHandler::PrintError("Failed to load map chunk (%s)", file.filename().string().c_str());
+                DebugHandler::PrintError("Failed to read map (%s)", mapInternalName.c_str());
                 return false;
             }
 
-            Terrain::Chunk chunk;
-            StringTable chunkStringTable;
-            if (!Terrain::Chunk::Read(chunkFile, chunk, chunkStringTable))
+            if (!Terrain::MapHeader::Read(mapHeaderFile, currentMap.header))
             {
-                DebugHandler::PrintError("Failed to load map chunk for (%s)", file.filename().string().c_str());
+                DebugHandler::PrintError("Failed to load map header for (%s)", mapInternalName.c_str());
                 return false;
             }
 
-            std::vector<std::string> splitName = StringUtils::SplitString(file.filename().string(), '_');
-            size_t numberOfSplits = splitName.size();
+            nmapFound = true;
+            break;
+        }
 
-            std::string mapInternalName = splitName[0];
-            for (size_t i = 1; i < numberOfSplits - 2; i++)
+        if (!nmapFound)
+        {
+            DebugHandler::PrintError("Failed to find nmap file for map (%s)", mapInternalName.c_str());
+            return false;
+        }
+    }
+
+    // Load Chunks if map does not use Map Object as base
+    if (!currentMap.header.flags.UseMapObjectInsteadOfTerrain)
+    {
+        size_t loadedChunks = 0;
+        std::vector<Terrain::ChunkLoader::Request> chunkRequests;
+
+        if (archive)
+        {
+            if (streamChunks)
             {
-                mapInternalName += "_" + splitName[i];
+                // The archive already indexes every chunk, RequestChunks reads them from it once they come into range
+                loadedChunks = archive->GetNumChunks();
+            }
+            else
+            {
+                std::vector<u16> chunkIDs;
+                archive->GetChunkIDs(chunkIDs);
+
+                chunkRequests.reserve(chunkIDs.size());
+                for (const u16 chunkID : chunkIDs)
+                {
+                    Terrain::ChunkLoader::Request& request = chunkRequests.emplace_back();
+                    request.chunkID = chunkID;
+                    request.archive = archive;
+                }
             }
+        }
+        else
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(absolutePath))
+            {
+                auto file = std::filesystem::path(entry.path());
+                if (file.extension() != ".nchunk")
+                    continue;
 
-            u16 x = std::stoi(splitName[numberOfSplits - 2]);
-            u16 y = std::stoi(splitName[numberOfSplits - 1]);
-            u32 chunkId = x + (y * Terrain::MAP_CHUNKS_PER_MAP_STRIDE);
+                // Make sure filename is the same, multiple maps can have chunks in the same folder
+                std::string fileName = file.filename().string();
+                if (strncmp(fileName.c_str(), mapInternalName.c_str(), mapInternalName.length()) != 0)
+                    continue;
 
-            currentMap.chunks[chunkId] = chunk;
-            currentMap.stringTables[chunkId].CopyFrom(chunkStringTable);
+                std::vector<std::string> splitName = StringUtils::SplitString(file.filename().string(), '_');
+                size_t numberOfSplits = splitName.size();
 
-            Terrain::MapUtils::AlignCellBorders(currentMap.chunks[chunkId]);
+                std::string mapInternalName = splitName[0];
+                for (size_t i = 1; i < numberOfSplits - 2; i++)
+                {
+                    mapInternalName += "_" + splitName[i];
+                }
 
-            loadedChunks++;
+                u16 x = std::stoi(splitName[numberOfSplits - 2]);
+                u16 y = std::stoi(splitName[numberOfSplits - 1]);
+                u32 chunkId = x + (y * Terrain::MAP_CHUNKS_PER_MAP_STRIDE);
+
+                if (streamChunks)
+                {
+                    // The chunk itself gets read by RequestChunks once it comes into range
+                    currentMap.chunkPaths[chunkId] = entry.path().string();
+                    loadedChunks++;
+                    continue;
+                }
+
+                Terrain::ChunkLoader::Request& request = chunkRequests.emplace_back();
+                request.chunkID = static_cast<u16>(chunkId);
+                request.path = entry.path().string();
+            }
+        }
+
+        if (!streamChunks)
+        {
+            loadedChunks = GetChunkLoader().Load(currentMap, chunkRequests);
+
+            if (loadedChunks != chunkRequests.size())
+            {
+                DebugHandler::PrintError("Failed to load %u map chunks for (%s)", static_cast<u32>(chunkRequests.size() - loadedChunks), mapInternalName.c_str());
+                return false;
+            }
         }
 
         if (loadedChunks == 0)
         {
-            DebugHandler::PrintError("0 map chunks found in (%s)", absolutePath.string().c_str());
+            DebugHandler::PrintError("0 map chunks found in (%s)", archive ? archivePath.string().c_str() : absolutePath.string().c_str());
             return false;
         }
-
-        Terrain::MapUtils::AlignChunkBorders(currentMap);
     }
 
     DebugHandler::PrintSuccess("Loaded Map (%s)", mapInternalName.c_str());
     return true;
-}
\ No newline at end of file
+}
+
+void Terrain::MapUtils::RequestChunks(Terrain::Map& map, const std::vector<u16>& chunkIDs)
+{
+    Terrain::ChunkLoader& chunkLoader = GetChunkLoader();
+
+    std::vector<Terrain::ChunkLoader::Request> chunkRequests;
+    chunkRequests.reserve(chunkIDs.size());
+
+    for (const u16 chunkID : chunkIDs)
+    {
+        if (map.chunks.find(chunkID) != map.chunks.end())
+            continue; // Already resident
+
+        if (chunkLoader.IsLoading(chunkID))
+            continue;
+
+        if (map.archive)
+        {
+            if (!map.archive->HasChunk(chunkID))
+                continue;
+
+            Terrain::ChunkLoader::Request& request = chunkRequests.emplace_back();
+            request.chunkID = chunkID;
+            request.archive = map.archive;
+            continue;
+        }
+
+        auto pathItr = map.chunkPaths.find(chunkID);
+        if (pathItr == map.chunkPaths.end())
+            continue;
+
+        Terrain::ChunkLoader::Request& request = chunkRequests.emplace_back();
+        request.chunkID = chunkID;
+        request.path = pathItr->second;
+    }
+
+    chunkLoader.LoadAsync(chunkRequests);
+}
+
+u32 Terrain::MapUtils::PollChunks(Terrain::Map& map, std::vector<u16>& outLoadedChunkIDs, std::vector<u16>& outFailedChunkIDs, std::vector<u16>* outChangedNeighbours)
+{
+    return GetChunkLoader().Poll(map, &outLoadedChunkIDs, &outFailedChunkIDs, outChangedNeighbours);
+}
+
+bool Terrain::MapUtils::IsLoadingChunk(u16 chunkID)
+{
+    return GetChunkLoader().IsLoading(chunkID);
+}
+
+bool Terrain::MapUtils::IsLoadingChunks()
+{
+    return GetChunkLoader().IsLoading();
+}
+
+void Terrain::MapUtils::UnloadChunk(Terrain::Map& map, u16 chunkID)
+{
+    map.chunks.erase(chunkID);
+
+    auto stringTableItr = map.stringTables.find(chunkID);
+    if (stringTableItr != map.stringTables.end())
+    {
+        stringTableItr->second.Clear();
+        map.stringTables.erase(stringTableItr);
+    }
+}
@@ -44,7 +44,16 @@ namespace Terrain
     {
         constexpr f32 f32MaxValue = 3.40282346638528859812e+38F;
 
-        bool LoadMap(entt::registry* registry, const NDBC::Map* map);
+        // Maps packed into a .nmapk are loaded from the archive, otherwise from the loose files in the map folder
+        // When streamChunks is set only the map header is loaded and the chunk files are indexed, chunks are then loaded on demand with RequestChunks
+        bool LoadMap(entt::registry* registry, const NDBC::Map* map, bool streamChunks = false);
+        // Starts loading the given chunks of a streamed map on the ChunkLoader, chunks that are resident or already loading are skipped
+        void RequestChunks(Terrain::Map& map, const std::vector<u16>& chunkIDs);
+        // Moves the chunks that finished loading since the last call into the map, never waits for the ones still loading
+        u32 PollChunks(Terrain::Map& map, std::vector<u16>& outLoadedChunkIDs, std::vector<u16>& outFailedChunkIDs, std::vector<u16>* outChangedNeighbours = nullptr);
+        bool IsLoadingChunk(u16 chunkID);
+        bool IsLoadingChunks();
+        void UnloadChunk(Terrain::Map& map, u16 chunkID);
 
         inline vec2 GetChunkPosition(u32 chunkID)
         {
@@ -118,6 +127,41 @@ namespace Terrain
             }
         }
 
+        inline void AlignChunkBorderAbove(Terrain::Chunk& chunk, const Terrain::Chunk& chunkAbove)
+        {
+            u32 aboveStartCellID = Terrain::MAP_CELLS_PER_CHUNK - Terrain::MAP_CELLS_PER_CHUNK_SIDE;
+
+            for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK_SIDE; i++)
+            {
+                Terrain::Cell& currentCell = chunk.cells[i];
+                const Terrain::Cell& aboveCell = chunkAbove.cells[aboveStartCellID + i];
+
+                // Avoid fixing the very first height value within the cell grid (This is handled by "hasChunkLeft"
+                for (u32 currentHeightID = 1; currentHeightID < Terrain::MAP_CELL_OUTER_GRID_STRIDE; currentHeightID++)
+                {
+                    u32 aboveHeightID = currentHeightID + (Terrain::MAP_CELL_TOTAL_GRID_SIZE - Terrain::MAP_CELL_OUTER_GRID_STRIDE);
+                    currentCell.heightData[currentHeightID] = aboveCell.heightData[aboveHeightID];
+                }
+            }
+        }
+
+        inline void AlignChunkBorderLeft(Terrain::Chunk& chunk, const Terrain::Chunk& chunkLeft)
+        {
+            u32 leftStartCellID = Terrain::MAP_CELLS_PER_CHUNK_SIDE - 1;
+
+            for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i += Terrain::MAP_CELLS_PER_CHUNK_SIDE)
+            {
+                Terrain::Cell& currentCell = chunk.cells[i];
+                const Terrain::Cell& leftCell = chunkLeft.cells[leftStartCellID + i];
+
+                for (u32 currentHeightID = 0; currentHeightID < Terrain::MAP_CELL_TOTAL_GRID_SIZE; currentHeightID += Terrain::MAP_CELL_TOTAL_GRID_STRIDE)
+                {
+                    u32 aboveHeightID = currentHeightID + (Terrain::MAP_CELL_OUTER_GRID_STRIDE - 1);
+                    currentCell.heightData[currentHeightID] = leftCell.heightData[aboveHeightID];
+                }
+            }
+        }
+
         inline void AlignChunkBorders(Terrain::Map& map)
         {
             for (auto& chunkItr : map.chunks)
@@ -125,9 +169,6 @@ namespace Terrain
                 const u16& chunkID = chunkItr.first;
                 Terrain::Chunk& chunk = chunkItr.second;
 
-                u16 chunkX = chunkID % Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
-                u16 chunkY = chunkID / Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
-
                 u16 chunkAboveID = chunkID - Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
                 u16 chunkLeftID = chunkID - 1;
 
@@ -136,39 +177,64 @@ namespace Terrain
 
                 if (hasChunkAbove)
                 {
-                    Terrain::Chunk& chunkAbove = map.chunks[chunkAboveID];
-                    u32 aboveStartCellID = Terrain::MAP_CELLS_PER_CHUNK - Terrain::MAP_CELLS_PER_CHUNK_SIDE;
+                    AlignChunkBorderAbove(chunk, map.chunks[chunkAboveID]);
+                }
 
-                    for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK_SIDE; i++)
-                    {
-                        Terrain::Cell& currentCell = chunk.cells[i];
-                        Terrain::Cell& aboveCell = chunkAbove.cells[aboveStartCellID + i];
+                if (hasChunkLeft)
+                {
+                    AlignChunkBorderLeft(chunk, map.chunks[chunkLeftID]);
+                }
+            }
+        }
 
-                        // Avoid fixing the very first height value within the cell grid (This is handled by "hasChunkLeft"
-                        for (u32 currentHeightID = 1; currentHeightID < Terrain::MAP_CELL_OUTER_GRID_STRIDE; currentHeightID++)
-                        {
-                            u32 aboveHeightID = currentHeightID + (Terrain::MAP_CELL_TOTAL_GRID_SIZE - Terrain::MAP_CELL_OUTER_GRID_STRIDE);
-                            currentCell.heightData[currentHeightID] = aboveCell.heightData[aboveHeightID];
-                        }
-                    }
+        // Aligns a single chunk against whichever of its neighbours are currently loaded, this is used when chunks are loaded one at a time
+        // The chunks below and to the right of chunkID get their top/left borders fixed up as well, outChangedNeighbours receives their IDs
+        inline void AlignChunkBorders(Terrain::Map& map, u16 chunkID, std::vector<u16>* outChangedNeighbours = nullptr)
+        {
+            Terrain::Chunk* chunk = map.GetChunkById(chunkID);
+            if (chunk == nullptr)
+                return;
+
+            u16 chunkX = chunkID % Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
+            u16 chunkY = chunkID / Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
+
+            if (chunkY > 0)
+            {
+                if (Terrain::Chunk* chunkAbove = map.GetChunkById(chunkID - Terrain::MAP_CHUNKS_PER_MAP_STRIDE))
+                {
+                    AlignChunkBorderAbove(*chunk, *chunkAbove);
                 }
+            }
 
-                if (hasChunkLeft)
+            if (chunkX > 0)
+            {
+                if (Terrain::Chunk* chunkLeft = map.GetChunkById(chunkID - 1))
                 {
-                    Terrain::Chunk& chunkLeft = map.chunks[chunkLeftID];
-                    u32 leftStartCellID = Terrain::MAP_CELLS_PER_CHUNK_SIDE - 1;
+                    AlignChunkBorderLeft(*chunk, *chunkLeft);
+                }
+            }
 
-                    for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i += Terrain::MAP_CELLS_PER_CHUNK_SIDE)
-                    {
-                        Terrain::Cell& currentCell = chunk.cells[i];
-                        Terrain::Cell& leftCell = chunkLeft.cells[leftStartCellID + i];
+            if (chunkY < Terrain::MAP_CHUNKS_PER_MAP_STRIDE - 1)
+            {
+                u16 chunkBelowID = chunkID + Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
+                if (Terrain::Chunk* chunkBelow = map.GetChunkById(chunkBelowID))
+                {
+                    AlignChunkBorderAbove(*chunkBelow, *chunk);
 
-                        for (u32 currentHeightID = 0; currentHeightID < Terrain::MAP_CELL_TOTAL_GRID_SIZE; currentHeightID += Terrain::MAP_CELL_TOTAL_GRID_STRIDE)
-                        {
-                            u32 aboveHeightID = currentHeightID + (Terrain::MAP_CELL_OUTER_GRID_STRIDE - 1);
-                            currentCell.heightData[currentHeightID] = leftCell.heightData[aboveHeightID];
-                        }
-                    }
+                    if (outChangedNeighbours)
+                        outChangedNeighbours->push_back(chunkBelowID);
+                }
+            }
+
+            if (chunkX < Terrain::MAP_CHUNKS_PER_MAP_STRIDE - 1)
+            {
+                u16 chunkRightID = chunkID + 1;
+                if (Terrain::Chunk* chunkRight = map.GetChunkById(chunkRightID))
+                {
+                    AlignChunkBorderLeft(*chunkRight, *chunk);
+
+                    if (outChangedNeighbours)
+                        outChangedNeighbours->push_back(chunkRightID);
                 }
             }
         }
@@ -0,0 +1,175 @@
+#include "MappedFile.h"
+#include <Utils/DebugHandler.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path, Access access)
+{
+    Close();
+    _path = path;
+
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        DebugHandler::PrintError("Failed to open file for mapping (%s)", path.c_str());
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+    {
+        DebugHandler::PrintError("Can't map empty file (%s)", path.c_str());
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    DWORD protection = access == Access::CopyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY;
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, protection, 0, 0, nullptr);
+    if (mappingHandle == nullptr)
+    {
+        DebugHandler::PrintError("Failed to create file mapping (%s)", path.c_str());
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    DWORD viewAccess = access == Access::CopyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ;
+    void* data = MapViewOfFile(mappingHandle, viewAccess, 0, 0, 0);
+    if (data == nullptr)
+    {
+        DebugHandler::PrintError("Failed to map view of file (%s)", path.c_str());
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    _fileHandle = fileHandle;
+    _mappingHandle = mappingHandle;
+    _data = static_cast<u8*>(data);
+    _size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        DebugHandler::PrintError("Failed to open file for mapping (%s)", path.c_str());
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        DebugHandler::PrintError("Can't map empty file (%s)", path.c_str());
+        close(fileDescriptor);
+        return false;
+    }
+
+    int protection = access == Access::CopyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), protection, MAP_PRIVATE, fileDescriptor, 0);
+    if (data == MAP_FAILED)
+    {
+        DebugHandler::PrintError("Failed to map file (%s)", path.c_str());
+        close(fileDescriptor);
+        return false;
+    }
+
+    _fileDescriptor = fileDescriptor;
+    _data = static_cast<u8*>(data);
+    _size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    return true;
+}
+
+std::shared_ptr<MappedFile> MappedFile::OpenView(const std::shared_ptr<MappedFile>& file, size_t offset, size_t size, Access access, size_t& outViewOffset)
+{
+    if (!file->IsOpen() || file->_viewSource != nullptr || offset + size > file->_size)
+        return nullptr;
+
+#ifdef _WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    const size_t granularity = static_cast<size_t>(systemInfo.dwAllocationGranularity);
+#else
+    const size_t granularity = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+
+    // Views have to start on the allocation granularity
+    const size_t viewStart = offset - (offset % granularity);
+    const size_t viewSize = (offset - viewStart) + size;
+
+#ifdef _WIN32
+    DWORD viewAccess = access == Access::CopyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ;
+    const u64 viewStart64 = static_cast<u64>(viewStart);
+    void* data = MapViewOfFile(static_cast<HANDLE>(file->_mappingHandle), viewAccess, static_cast<DWORD>(viewStart64 >> 32), static_cast<DWORD>(viewStart64 & 0xFFFFFFFF), viewSize);
+    if (data == nullptr)
+    {
+        DebugHandler::PrintError("Failed to map view of file (%s)", file->_path.c_str());
+        return nullptr;
+    }
+#else
+    int protection = access == Access::CopyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* data = mmap(nullptr, viewSize, protection, MAP_PRIVATE, file->_fileDescriptor, static_cast<off_t>(viewStart));
+    if (data == MAP_FAILED)
+    {
+        DebugHandler::PrintError("Failed to map view of file (%s)", file->_path.c_str());
+        return nullptr;
+    }
+#endif
+
+    std::shared_ptr<MappedFile> view = std::make_shared<MappedFile>();
+    view->_path = file->_path;
+    view->_data = static_cast<u8*>(data);
+    view->_size = viewSize;
+    view->_viewSource = file;
+
+    outViewOffset = offset - viewStart;
+    return view;
+}
+
+void MappedFile::Close()
+{
+    if (_data == nullptr)
+        return;
+
+    if (_viewSource != nullptr)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+#else
+        munmap(_data, _size);
+#endif
+        _viewSource.reset();
+        _data = nullptr;
+        _size = 0;
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(_data);
+    CloseHandle(static_cast<HANDLE>(_mappingHandle));
+    CloseHandle(static_cast<HANDLE>(_fileHandle));
+
+    _mappingHandle = nullptr;
+    _fileHandle = nullptr;
+#else
+    munmap(_data, _size);
+    close(_fileDescriptor);
+
+    _fileDescriptor = -1;
+#endif
+
+    _data = nullptr;
+    _size = 0;
+}
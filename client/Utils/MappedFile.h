@@ -0,0 +1,48 @@
+#pragma once
+#include <NovusTypes.h>
+#include <memory>
+#include <string>
+
+// Maps a whole file into memory, the pages get read in by the OS on first touch
+// CopyOnWrite mappings can be written to, those writes only land in private copies of the touched pages and never reach the file
+class MappedFile
+{
+public:
+    enum class Access
+    {
+        ReadOnly,
+        CopyOnWrite
+    };
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path, Access access = Access::ReadOnly);
+    // Maps [offset, offset + size) of an already open file as a view of its own, without opening the file again
+    // Copy-on-write pages of a view are released when it closes, outViewOffset is where offset landed inside the view
+    static std::shared_ptr<MappedFile> OpenView(const std::shared_ptr<MappedFile>& file, size_t offset, size_t size, Access access, size_t& outViewOffset);
+    void Close();
+
+    bool IsOpen() const { return _data != nullptr; }
+
+    u8* GetData() const { return _data; }
+    size_t GetSize() const { return _size; }
+    const std::string& GetPath() const { return _path; }
+
+private:
+    std::string _path;
+    u8* _data = nullptr;
+    size_t _size = 0;
+
+    std::shared_ptr<MappedFile> _viewSource; // Owns the file and mapping handles when this is a view
+
+#ifdef _WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#else
+    int _fileDescriptor = -1;
+#endif
+};
@@ -13,6 +13,7 @@ CameraFreeLook* ServiceLocator::_cameraFreeLook = nullptr;
 CameraOrbital* ServiceLocator::_cameraOrbital = nullptr;
 Renderer::Renderer* ServiceLocator::_renderer = nullptr;
 SceneManager* ServiceLocator::_sceneManager = nullptr;
+std::shared_ptr<tf::Taskflow::Executor> ServiceLocator::_taskExecutor = nullptr;
 
 moodycamel::ConcurrentQueue<Message>* ServiceLocator::_mainInputQueue = nullptr;
 
@@ -88,3 +89,9 @@ void ServiceLocator::SetSceneManager(SceneManager* sceneManager)
     assert(_sceneManager == nullptr);
     _sceneManager = sceneManager;
 }
+
+void ServiceLocator::SetTaskExecutor(std::shared_ptr<tf::Taskflow::Executor> taskExecutor)
+{
+    assert(_taskExecutor == nullptr);
+    _taskExecutor = std::move(taskExecutor);
+}
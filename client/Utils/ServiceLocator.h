@@ -2,7 +2,9 @@
 #include <Utils/ConcurrentQueue.h>
 #include <Utils/Message.h>
 #include <entity/registry.hpp>
+#include <taskflow/taskflow.hpp>
 #include <cassert>
+#include <memory>
 
 class MessageHandler;
 class Window;
@@ -92,6 +94,13 @@ public:
         return _sceneManager;
     }
     static void SetSceneManager(SceneManager* sceneManager);
+    // The worker pool of the update framework, everything that runs on taskflow shares it instead of spinning up its own threads
+    static const std::shared_ptr<tf::Taskflow::Executor>& GetTaskExecutor()
+    {
+        assert(_taskExecutor != nullptr);
+        return _taskExecutor;
+    }
+    static void SetTaskExecutor(std::shared_ptr<tf::Taskflow::Executor> taskExecutor);
 
 private:
     ServiceLocator() { }
@@ -107,4 +116,5 @@ private:
     static moodycamel::ConcurrentQueue<Message>* _mainInputQueue;
     static Renderer::Renderer* _renderer;
     static SceneManager* _sceneManager;
+    static std::shared_ptr<tf::Taskflow::Executor> _taskExecutor;
 };
\ No newline at end of file
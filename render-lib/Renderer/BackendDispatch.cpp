@@ -31,6 +31,7 @@
 #include "Commands/PipelineBarrier.h"
 #include "Commands/ImageBarrier.h"
 #include "Commands/DepthImageBarrier.h"
+#include "Commands/ImageBarriers.h"
 #include "Commands/DrawImgui.h"
 #include "Commands/PushConstant.h"
 
@@ -265,6 +266,13 @@ namespace Renderer
         renderer->DepthImageBarrier(commandList, actualData->image);
     }
 
+    void BackendDispatch::ImageBarriers(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        ZoneScopedC(tracy::Color::Red3);
+        const Commands::ImageBarriers* actualData = static_cast<const Commands::ImageBarriers*>(data);
+        renderer->ImageBarriers(commandList, actualData->barriers, actualData->numBarriers);
+    }
+
     void BackendDispatch::DrawImgui(Renderer* renderer, CommandListID commandList, const void* data)
     {
         ZoneScopedNC("Imgui Draw", tracy::Color::Red3);
@@ -55,6 +55,7 @@ namespace Renderer
         static void PipelineBarrier(Renderer* renderer, CommandListID commandList, const void* data);
         static void ImageBarrier(Renderer* renderer, CommandListID commandList, const void* data);
         static void DepthImageBarrier(Renderer* renderer, CommandListID commandList, const void* data);
+        static void ImageBarriers(Renderer* renderer, CommandListID commandList, const void* data);
 
         static void DrawImgui(Renderer* renderer, CommandListID commandList, const void* data);
 
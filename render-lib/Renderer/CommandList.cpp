@@ -32,6 +32,7 @@
 #include "Commands/PipelineBarrier.h"
 #include "Commands/ImageBarrier.h"
 #include "Commands/DepthImageBarrier.h"
+#include "Commands/ImageBarriers.h"
 #include "Commands/DrawImgui.h"
 #include "Commands/PushConstant.h"
 
@@ -70,20 +71,37 @@ namespace Renderer
 #if COMMANDLIST_DEBUG_IMMEDIATE_MODE
         _renderer->EndCommandList(_immediateCommandList);
 #else
+        CommandListID commandList = _renderer->BeginCommandList();
+        Record(commandList);
+        _renderer->EndCommandList(commandList);
+#endif
+    }
+
+    void CommandList::Record(CommandListID commandListID)
+    {
         assert(_markerScope == 0); // We need to pop all markers that we push
 
-        CommandListID commandList = _renderer->BeginCommandList();
+        ZoneScopedNC("Record commandlist", tracy::Color::Red2)
+        // Execute each command
+        for (int i = 0; i < _functions.Count(); i++)
+        {
+            _functions[i](_renderer, commandListID, _data[i]);
+        }
+    }
 
+    void CommandList::InheritDynamicState(const CommandList& previous)
+    {
+        if (previous._lastViewport != nullptr)
         {
-            ZoneScopedNC("Record commandlist", tracy::Color::Red2)
-            // Execute each command
-            for (int i = 0; i < _functions.Count(); i++)
-            {
-                _functions[i](_renderer, commandList, _data[i]);
-            }
+            const Viewport& viewport = previous._lastViewport->viewport;
+            SetViewport(viewport.topLeftX, viewport.topLeftY, viewport.width, viewport.height, viewport.minDepth, viewport.maxDepth);
+        }
+
+        if (previous._lastScissorRect != nullptr)
+        {
+            const ScissorRect& scissorRect = previous._lastScissorRect->scissorRect;
+            SetScissorRect(scissorRect.left, scissorRect.right, scissorRect.top, scissorRect.bottom);
         }
-        _renderer->EndCommandList(commandList);
-#endif
     }
 
     CommandList::CommandList(Renderer* renderer, Memory::Allocator* allocator)
@@ -219,6 +237,7 @@ namespace Renderer
         command->scissorRect.right = right;
         command->scissorRect.top = top;
         command->scissorRect.bottom = bottom;
+        _lastScissorRect = command;
 
 #if COMMANDLIST_DEBUG_IMMEDIATE_MODE
         Commands::SetScissorRect::DISPATCH_FUNCTION(_renderer, _immediateCommandList, command);
@@ -234,6 +253,7 @@ namespace Renderer
         command->viewport.height = height;
         command->viewport.minDepth = minDepth;
         command->viewport.maxDepth = maxDepth;
+        _lastViewport = command;
 
 #if COMMANDLIST_DEBUG_IMMEDIATE_MODE
         Commands::SetViewport::DISPATCH_FUNCTION(_renderer, _immediateCommandList, command);
@@ -453,7 +473,10 @@ namespace Renderer
         command->dstBuffer = dstBuffer;
         command->dstBufferOffset = dstBufferOffset;
         command->size = size;
-        command->data = data;
+
+        // Copy the data since the command might not get recorded until the end of the frame
+        command->data = Memory::Allocator::NewArray<u8>(_allocator, size);
+        memcpy(command->data, data, size);
 
 #if COMMANDLIST_DEBUG_IMMEDIATE_MODE
         Commands::FillBuffer::DISPATCH_FUNCTION(_renderer, _immediateCommandList, command);
@@ -508,6 +531,20 @@ namespace Renderer
 #endif
     }
 
+    void CommandList::ImageBarriers(const ImageBarrierDesc* barriers, u32 numBarriers)
+    {
+        assert(numBarriers > 0);
+        Commands::ImageBarriers* command = AddCommand<Commands::ImageBarriers>();
+
+        command->barriers = Memory::Allocator::NewArray<ImageBarrierDesc>(_allocator, numBarriers);
+        memcpy(command->barriers, barriers, sizeof(ImageBarrierDesc) * numBarriers);
+        command->numBarriers = numBarriers;
+
+#if COMMANDLIST_DEBUG_IMMEDIATE_MODE
+        Commands::ImageBarriers::DISPATCH_FUNCTION(_renderer, _immediateCommandList, command);
+#endif
+    }
+
     void CommandList::DrawImgui()
     {
         Commands::DrawImgui* command = AddCommand<Commands::DrawImgui>();
@@ -521,7 +558,10 @@ namespace Renderer
     {
         assert(data != nullptr);
         Commands::PushConstant* command = AddCommand<Commands::PushConstant>();
-        command->data = data;
+
+        // Copy the data since the command might not get recorded until the end of the frame, callers often push a local
+        command->data = Memory::Allocator::NewArray<u8>(_allocator, size);
+        memcpy(command->data, data, size);
         command->offset = offset;
         command->size = size;
 
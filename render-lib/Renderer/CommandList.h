@@ -13,8 +13,9 @@
 #include "Descriptors/GraphicsPipelineDesc.h"
 #include "Descriptors/ComputePipelineDesc.h"
 #include "Descriptors/GPUSemaphoreDesc.h"
+#include "Descriptors/ImageBarrierDesc.h"
 
-#define COMMANDLIST_DEBUG_IMMEDIATE_MODE 1 // This makes it easier to debug the renderer by providing better callstacks if it asserts or crashes inside of render-lib
+#define COMMANDLIST_DEBUG_IMMEDIATE_MODE 0 // This makes it easier to debug the renderer by providing better callstacks if it asserts or crashes inside of render-lib, RenderGraph records serially into a single command list while it's on
 
 #if TRACY_ENABLE
 #define GPU_SCOPED_PROFILER_ZONE(commandList, name) \
@@ -33,6 +34,12 @@ namespace Renderer
     class DescriptorSet;
     class CommandList;
 
+    namespace Commands
+    {
+        struct SetViewport;
+        struct SetScissorRect;
+    }
+
     struct ScopedGPUProfilerZone
     {
         ScopedGPUProfilerZone(CommandList& commandList, const tracy::SourceLocationData* sourceLocation);
@@ -94,6 +101,7 @@ namespace Renderer
         void PipelineBarrier(PipelineBarrierType type, BufferID buffer);
         void ImageBarrier(ImageID image);
         void ImageBarrier(DepthImageID image);
+        void ImageBarriers(const ImageBarrierDesc* barriers, u32 numBarriers);
 
         void DrawImgui();
 
@@ -103,6 +111,12 @@ namespace Renderer
         // Execute gets friend-called from RenderGraph
         void Execute();
 
+        // Replays the recorded commands into a command list begun by the caller, RenderGraph calls this from its workers
+        void Record(CommandListID commandListID);
+
+        // Viewport and scissor rect are state of the backend command list, RenderGraph uses this to carry them over when it moves to the CommandList of the next pass
+        void InheritDynamicState(const CommandList& previous);
+
         template<typename Command>
         Command* AddCommand()
         {
@@ -142,6 +156,9 @@ namespace Renderer
 
         bool _isTracing = false;
 
+        const Commands::SetViewport* _lastViewport = nullptr;
+        const Commands::SetScissorRect* _lastScissorRect = nullptr;
+
 #if COMMANDLIST_DEBUG_IMMEDIATE_MODE
         CommandListID _immediateCommandList = CommandListID::Invalid();
 #endif
@@ -28,6 +28,7 @@
 #include "PipelineBarrier.h"
 #include "ImageBarrier.h"
 #include "DepthImageBarrier.h"
+#include "ImageBarriers.h"
 #include "DrawImgui.h"
 #include "PushConstant.h"
 
@@ -68,6 +69,7 @@ namespace Renderer
         const BackendDispatchFunction PipelineBarrier::DISPATCH_FUNCTION = &BackendDispatch::PipelineBarrier;
         const BackendDispatchFunction ImageBarrier::DISPATCH_FUNCTION = &BackendDispatch::ImageBarrier;
         const BackendDispatchFunction DepthImageBarrier::DISPATCH_FUNCTION = &BackendDispatch::DepthImageBarrier;
+        const BackendDispatchFunction ImageBarriers::DISPATCH_FUNCTION = &BackendDispatch::ImageBarriers;
         const BackendDispatchFunction DrawImgui::DISPATCH_FUNCTION = &BackendDispatch::DrawImgui;
         const BackendDispatchFunction PushConstant::DISPATCH_FUNCTION = &BackendDispatch::PushConstant;
     }
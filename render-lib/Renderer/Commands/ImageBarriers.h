@@ -0,0 +1,18 @@
+#pragma once
+#include <NovusTypes.h>
+#include "../BackendDispatch.h"
+#include "../Descriptors/ImageBarrierDesc.h"
+
+namespace Renderer
+{
+    namespace Commands
+    {
+        struct ImageBarriers
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            ImageBarrierDesc* barriers;
+            u32 numBarriers;
+        };
+    }
+}
@@ -11,21 +11,8 @@ namespace Renderer
 
     void DescriptorSet::Bind(u32 nameHash, SamplerID samplerID)
     {
-        for (u32 i = 0; i < _boundDescriptors.size(); i++)
-        {
-            if (nameHash == _boundDescriptors[i].nameHash)
-            {
-                _boundDescriptors[i].descriptorType = DescriptorType::DESCRIPTOR_TYPE_SAMPLER;
-                _boundDescriptors[i].samplerID = samplerID;
-                return;
-            }
-        }
-
-        u32 newIndex = static_cast<u32>(_boundDescriptors.size());
-        Descriptor& boundDescriptor = _boundDescriptors.emplace_back();
-        boundDescriptor.nameHash = nameHash;
-        boundDescriptor.descriptorType = DESCRIPTOR_TYPE_SAMPLER;
-        boundDescriptor.samplerID = samplerID;
+        Descriptor& descriptor = GetDescriptor(nameHash, DESCRIPTOR_TYPE_SAMPLER);
+        descriptor.samplerID = samplerID;
     }
 
     void DescriptorSet::Bind(const std::string& name, TextureID textureID)
@@ -36,21 +23,8 @@ namespace Renderer
 
     void DescriptorSet::Bind(u32 nameHash, TextureID textureID)
     {
-        for (u32 i = 0; i < _boundDescriptors.size(); i++)
-        {
-            if (nameHash == _boundDescriptors[i].nameHash)
-            {
-                _boundDescriptors[i].descriptorType = DescriptorType::DESCRIPTOR_TYPE_TEXTURE;
-                _boundDescriptors[i].textureID = textureID;
-                return;
-            }
-        }
-
-        u32 newIndex = static_cast<u32>(_boundDescriptors.size());
-        Descriptor& boundDescriptor = _boundDescriptors.emplace_back();
-        boundDescriptor.nameHash = nameHash;
-        boundDescriptor.descriptorType = DESCRIPTOR_TYPE_TEXTURE;
-        boundDescriptor.textureID = textureID;
+        Descriptor& descriptor = GetDescriptor(nameHash, DESCRIPTOR_TYPE_TEXTURE);
+        descriptor.textureID = textureID;
     }
 
     void DescriptorSet::Bind(const std::string& name, TextureArrayID textureArrayID)
@@ -61,22 +35,8 @@ namespace Renderer
 
     void DescriptorSet::Bind(u32 nameHash, TextureArrayID textureArrayID)
     {
-        for (u32 i = 0; i < _boundDescriptors.size(); i++)
-        {
-            if (nameHash == _boundDescriptors[i].nameHash)
-            {
-                _boundDescriptors[i].descriptorType = DescriptorType::DESCRIPTOR_TYPE_TEXTURE_ARRAY;
-                _boundDescriptors[i].textureArrayID = textureArrayID;
-
-                return;
-            }
-        }
-
-        u32 newIndex = static_cast<u32>(_boundDescriptors.size());
-        Descriptor& boundDescriptor = _boundDescriptors.emplace_back();
-        boundDescriptor.nameHash = nameHash;
-        boundDescriptor.descriptorType = DESCRIPTOR_TYPE_TEXTURE_ARRAY;
-        boundDescriptor.textureArrayID = textureArrayID;
+        Descriptor& descriptor = GetDescriptor(nameHash, DESCRIPTOR_TYPE_TEXTURE_ARRAY);
+        descriptor.textureArrayID = textureArrayID;
     }
 
     void DescriptorSet::Bind(const std::string& name, ImageID imageID, u32 mipLevel)
@@ -87,23 +47,9 @@ namespace Renderer
 
     void DescriptorSet::Bind(u32 nameHash, ImageID imageID, u32 mipLevel)
     {
-        for (u32 i = 0; i < _boundDescriptors.size(); i++)
-        {
-            if (nameHash == _boundDescriptors[i].nameHash)
-            {
-                _boundDescriptors[i].descriptorType = DescriptorType::DESCRIPTOR_TYPE_IMAGE;
-                _boundDescriptors[i].imageID = imageID;
-                _boundDescriptors[i].imageMipLevel = mipLevel;
-                return;
-            }
-        }
-
-        u32 newIndex = static_cast<u32>(_boundDescriptors.size());
-        Descriptor& boundDescriptor = _boundDescriptors.emplace_back();
-        boundDescriptor.nameHash = nameHash;
-        boundDescriptor.descriptorType = DESCRIPTOR_TYPE_IMAGE;
-        boundDescriptor.imageID = imageID;
-        boundDescriptor.imageMipLevel = mipLevel;
+        Descriptor& descriptor = GetDescriptor(nameHash, DESCRIPTOR_TYPE_IMAGE);
+        descriptor.imageID = imageID;
+        descriptor.imageMipLevel = mipLevel;
     }
 
     void DescriptorSet::Bind(const std::string& name, BufferID buffer)
@@ -114,61 +60,56 @@ namespace Renderer
 
     void DescriptorSet::Bind(u32 nameHash, BufferID buffer)
     {
-        for (u32 i = 0; i < _boundDescriptors.size(); i++)
-        {
-            if (nameHash == _boundDescriptors[i].nameHash)
-            {
-                _boundDescriptors[i].descriptorType = DescriptorType::DESCRIPTOR_TYPE_BUFFER;
-                _boundDescriptors[i].bufferID = buffer;
-                return;
-            }
-        }
-
-        u32 newIndex = static_cast<u32>(_boundDescriptors.size());
-        Descriptor& boundDescriptor = _boundDescriptors.emplace_back();
-        boundDescriptor.nameHash = nameHash;
-        boundDescriptor.descriptorType = DESCRIPTOR_TYPE_BUFFER;
-        boundDescriptor.bufferID = buffer;
+        Descriptor& descriptor = GetDescriptor(nameHash, DESCRIPTOR_TYPE_BUFFER);
+        descriptor.bufferID = buffer;
+        descriptor.bufferOffset = 0;
+        descriptor.bufferRange = 0;
     }
 
-    void DescriptorSet::Bind(StringUtils::StringHash nameHash, DepthImageID imageID)
+    void DescriptorSet::Bind(const std::string& name, const FrameConstantsAllocation& constants)
     {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.size());
+        Bind(nameHash, constants);
+    }
 
-        for (u32 i = 0; i < _boundDescriptors.size(); i++)
-        {
-            if (nameHash == _boundDescriptors[i].nameHash)
-            {
-                _boundDescriptors[i].descriptorType = DescriptorType::DESCRIPTOR_TYPE_DEPTH_IMAGE;
-                _boundDescriptors[i].depthImageID = imageID;
-                return;
-            }
-        }
+    void DescriptorSet::Bind(u32 nameHash, const FrameConstantsAllocation& constants)
+    {
+        Descriptor& descriptor = GetDescriptor(nameHash, DESCRIPTOR_TYPE_BUFFER);
+        descriptor.bufferID = constants.buffer;
+        descriptor.bufferOffset = constants.offset;
+        descriptor.bufferRange = constants.size;
+    }
 
-        u32 newIndex = static_cast<u32>(_boundDescriptors.size());
-        Descriptor& boundDescriptor = _boundDescriptors.emplace_back();
-        boundDescriptor.nameHash = nameHash;
-        boundDescriptor.descriptorType = DESCRIPTOR_TYPE_DEPTH_IMAGE;
-        boundDescriptor.depthImageID = imageID;
+    void DescriptorSet::Bind(StringUtils::StringHash nameHash, DepthImageID imageID)
+    {
+        Descriptor& descriptor = GetDescriptor(nameHash, DESCRIPTOR_TYPE_DEPTH_IMAGE);
+        descriptor.depthImageID = imageID;
     }
 
     void DescriptorSet::BindStorage(StringUtils::StringHash nameHash, ImageID imageID, u32 mipLevel /*= 0*/)
     {
-        for (u32 i = 0; i < _boundDescriptors.size(); i++)
+        Descriptor& descriptor = GetDescriptor(nameHash, DESCRIPTOR_TYPE_STORAGE_IMAGE);
+        descriptor.imageID = imageID;
+        descriptor.imageMipLevel = mipLevel;
+    }
+
+    Descriptor& DescriptorSet::GetDescriptor(u32 nameHash, DescriptorType descriptorType)
+    {
+        auto itr = _nameHashToDescriptorIndex.find(nameHash);
+        if (itr != _nameHashToDescriptorIndex.end())
         {
-            if (nameHash == _boundDescriptors[i].nameHash)
-            {
-                _boundDescriptors[i].descriptorType = DescriptorType::DESCRIPTOR_TYPE_STORAGE_IMAGE;
-                _boundDescriptors[i].imageID = imageID;
-                _boundDescriptors[i].imageMipLevel = mipLevel;
-                return;
-            }
+            Descriptor& descriptor = _boundDescriptors[itr->second];
+            descriptor.descriptorType = descriptorType;
+            return descriptor;
         }
 
         u32 newIndex = static_cast<u32>(_boundDescriptors.size());
-        Descriptor& boundDescriptor = _boundDescriptors.emplace_back();
-        boundDescriptor.nameHash = nameHash;
-        boundDescriptor.descriptorType = DESCRIPTOR_TYPE_STORAGE_IMAGE;
-        boundDescriptor.imageID = imageID;
-        boundDescriptor.imageMipLevel = mipLevel;
+        _nameHashToDescriptorIndex[nameHash] = newIndex;
+
+        Descriptor& descriptor = _boundDescriptors.emplace_back();
+        descriptor.nameHash = nameHash;
+        descriptor.descriptorType = descriptorType;
+
+        return descriptor;
     }
-}
\ No newline at end of file
+}
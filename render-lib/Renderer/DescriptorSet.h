@@ -1,6 +1,7 @@
 #pragma once
 #include <NovusTypes.h>
 #include <Utils/StringUtils.h>
+#include <robin_hood.h>
 #include "Descriptors/BufferDesc.h"
 #include "Descriptors/SamplerDesc.h"
 #include "Descriptors/TextureDesc.h"
@@ -33,6 +34,8 @@ namespace Renderer
         SamplerID samplerID;
         TextureArrayID textureArrayID;
         BufferID bufferID;
+        u32 bufferOffset; // Only uniform buffers can be bound at an offset
+        u32 bufferRange; // 0 binds the whole buffer
     };
 
     enum DescriptorSetSlot
@@ -70,11 +73,17 @@ namespace Renderer
         void Bind(const std::string& name, BufferID buffer);
         void Bind(u32 nameHash, BufferID buffer);
 
+        void Bind(const std::string& name, const FrameConstantsAllocation& constants);
+        void Bind(u32 nameHash, const FrameConstantsAllocation& constants);
+
         const std::vector<Descriptor>& GetDescriptors() const { return _boundDescriptors; }
 
     private:
+        Descriptor& GetDescriptor(u32 nameHash, DescriptorType descriptorType);
 
     private:
         std::vector<Descriptor> _boundDescriptors;
+        robin_hood::unordered_map<u32, u32> _nameHashToDescriptorIndex; // Sets get rebound for every draw, so finding the slot can't be a scan
+
     };
 }
\ No newline at end of file
@@ -15,4 +15,13 @@ namespace Renderer
 
     // Lets strong-typedef an ID type with the underlying type of u16
     STRONG_TYPEDEF(BufferID, u16);
+
+    // A slice of the per frame constants ring, only valid until the frame it was allocated in has been rendered
+    struct FrameConstantsAllocation
+    {
+        BufferID buffer = BufferID::Invalid();
+        u32 offset = 0;
+        u32 size = 0;
+        void* mappedMemory = nullptr;
+    };
 }
\ No newline at end of file
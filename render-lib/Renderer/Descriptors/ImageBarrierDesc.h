@@ -0,0 +1,33 @@
+#pragma once
+#include <NovusTypes.h>
+
+#include "ImageDesc.h"
+#include "DepthImageDesc.h"
+
+namespace Renderer
+{
+    // How a render pass uses an image, the RenderGraphBuilder collects these from the Read and Write declarations
+    enum ImageAccess
+    {
+        IMAGE_ACCESS_RENDERTARGET  = (1 << 0), // Color or depth attachment
+        IMAGE_ACCESS_UAV           = (1 << 1), // Storage image written by a pixel or compute shader
+        IMAGE_ACCESS_VERTEX_READ   = (1 << 2),
+        IMAGE_ACCESS_PIXEL_READ    = (1 << 3),
+        IMAGE_ACCESS_COMPUTE_READ  = (1 << 4),
+
+        IMAGE_ACCESS_WRITE_MASK = IMAGE_ACCESS_RENDERTARGET | IMAGE_ACCESS_UAV,
+        IMAGE_ACCESS_READ_MASK = IMAGE_ACCESS_VERTEX_READ | IMAGE_ACCESS_PIXEL_READ | IMAGE_ACCESS_COMPUTE_READ
+    };
+
+    // Makes the srcAccess of earlier passes finish before the dstAccess of the next pass, exactly one of image and depthImage is valid
+    struct ImageBarrierDesc
+    {
+        ImageID image = ImageID::Invalid();
+        DepthImageID depthImage = DepthImageID::Invalid();
+
+        u8 srcAccess = 0;
+        u8 dstAccess = 0;
+
+        bool discard = false; // The memory of the image was used by another transient image, its contents don't need to survive the barrier
+    };
+}
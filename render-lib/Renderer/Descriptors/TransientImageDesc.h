@@ -0,0 +1,18 @@
+#pragma once
+#include <NovusTypes.h>
+
+#include "ImageDesc.h"
+#include "DepthImageDesc.h"
+
+namespace Renderer
+{
+    // Tells the backend which memory a transient image of this frame goes into, images with the same aliasSlot never live at the same time and share memory
+    // Exactly one of image and depthImage is valid
+    struct TransientImageDesc
+    {
+        ImageID image = ImageID::Invalid();
+        DepthImageID depthImage = DepthImageID::Invalid();
+
+        u32 aliasSlot = 0;
+    };
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <NovusTypes.h>
+#include <Utils/StrongTypedef.h>
+
+namespace Renderer
+{
+    // Identifies a batch of staged buffer uploads, poll it with Renderer::IsUploadFinished
+    STRONG_TYPEDEF(UploadBatchID, u32);
+}
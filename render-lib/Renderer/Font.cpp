@@ -4,29 +4,155 @@
 #include "Font.h"
 #include "Renderer.h"
 #include <Utils/XXHash64.h>
-#include <Utils/FileReader.h>
 #include <Utils/DebugHandler.h>
+#include <Utils/ConcurrentQueue.h>
+#include <tracy/Tracy.hpp>
 #include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <condition_variable>
 
 namespace Renderer
 {
-    robin_hood::unordered_map<u64, Font*> Font::_fonts;
+    constexpr u32 FONT_ATLAS_SIZE = 1024; // Width and height of an atlas page, R8 so 1 MB each
+    constexpr u32 FONT_ATLAS_MAX_PAGES = 128; // Has to match the size of _fontTextures in text.ps.hlsl
+    constexpr u32 FONT_ATLAS_GLYPH_SPACING = 1; // Empty texels between glyphs so linear filtering doesn't bleed into the neighbours
+
+    // Bounds the time FinishGlyphLoads spends packing when a lot of new glyphs show up at once, the rest waits for the next frame
+    constexpr u32 MAX_GLYPHS_PACKED_PER_FRAME = 256;
 
-    FontChar& Font::GetChar(char character)
+    // Generates glyph SDFs off the calling thread, shared by every font
+    struct GlyphWorker
     {
-        auto it = _chars.find(character);
-        if (it == _chars.end())
+        struct Request
         {
-            FontChar fontChar;
-            if (!InitChar(character, fontChar))
+            Font* font;
+            u32 codepoint;
+            i32 glyphIndex;
+        };
+
+        struct GeneratedGlyph
+        {
+            Font* font;
+            u32 codepoint;
+
+            i32 width;
+            i32 height;
+            u8* data; // nullptr if stbtt couldn't generate the glyph
+        };
+
+        GlyphWorker()
+        {
+            thread = std::thread(&GlyphWorker::ThreadMain, this);
+        }
+
+        ~GlyphWorker()
+        {
+            {
+                std::lock_guard<std::mutex> lock(requestMutex);
+                stop = true;
+            }
+            requestCondition.notify_all();
+            thread.join();
+
+            GeneratedGlyph glyph;
+            while (generatedGlyphs.try_dequeue(glyph))
             {
-                DebugHandler::PrintFatal("The font does not support this character");
+                stbtt_FreeSDF(glyph.data, nullptr);
             }
+        }
+
+        void Enqueue(const Request& request)
+        {
+            {
+                std::lock_guard<std::mutex> lock(requestMutex);
+                requests.push_back(request);
+            }
+            requestCondition.notify_one();
+        }
+
+        void ThreadMain()
+        {
+            while (true)
+            {
+                Request request;
+                {
+                    std::unique_lock<std::mutex> lock(requestMutex);
+                    requestCondition.wait(lock, [this]() { return stop || !requests.empty(); });
+
+                    if (stop)
+                        return;
+
+                    request = requests.front();
+                    requests.pop_front();
+                }
+
+                ZoneScopedNC("Font::GenerateGlyph", tracy::Color::Red3);
+
+                // fontInfo, scale and desc never change after GetFont, so reading them here needs no lock
+                Font* font = request.font;
+
+                GeneratedGlyph glyph;
+                glyph.font = font;
+                glyph.codepoint = request.codepoint;
+
+                i32 xOffset, yOffset;
+                glyph.data = stbtt_GetGlyphSDF(font->fontInfo, font->scale, request.glyphIndex, font->desc.padding, 128, 64.0f, &glyph.width, &glyph.height, &xOffset, &yOffset);
+
+                generatedGlyphs.enqueue(glyph);
+            }
+        }
 
-            _chars[character] = fontChar;
+        std::mutex requestMutex;
+        std::condition_variable requestCondition;
+        std::deque<Request> requests;
+        bool stop = false;
+
+        moodycamel::ConcurrentQueue<GeneratedGlyph> generatedGlyphs;
+
+        std::thread thread;
+    };
+
+    static GlyphWorker& GetGlyphWorker()
+    {
+        static GlyphWorker glyphWorker;
+        return glyphWorker;
+    }
+
+    robin_hood::unordered_map<u64, Font*> Font::_fonts;
+
+    const FontChar& Font::GetChar(u32 codepoint)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _chars.find(codepoint);
+        if (it != _chars.end())
+            return it->second;
+
+        FontChar& fontChar = _chars[codepoint];
+
+        // Codepoints the font doesn't have use the fallback glyph for good
+        i32 glyphIndex = stbtt_FindGlyphIndex(fontInfo, codepoint);
+        if (glyphIndex == 0)
+        {
+            fontChar = _fallbackChar;
+            return fontChar;
+        }
+
+        // Draws the fallback in the box of the glyph until the worker has generated it, the metrics are final already so text doesn't move
+        if (InitChar(glyphIndex, fontChar))
+        {
+            fontChar.textureIndex = _fallbackChar.textureIndex;
+            fontChar.minUV = _fallbackChar.minUV;
+            fontChar.maxUV = _fallbackChar.maxUV;
+
+            GetGlyphWorker().Enqueue({ this, codepoint, glyphIndex });
         }
 
-        return _chars[character];
+        return fontChar;
     }
 
     Font* Font::GetFont(Renderer* renderer, const std::string& fontPath, f32 fontSize)
@@ -39,71 +165,246 @@ namespace Renderer
         {
             Font* font = new Font();
             font->_renderer = renderer;
+            font->desc.path = fontPath;
+            font->desc.size = fontSize;
 
             std::filesystem::path path = std::filesystem::absolute(fontPath);
-            FileReader file(path.string(), path.filename().string());
-            if (!file.Open())
+            std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+            if (!file)
             {
                 DebugHandler::PrintFatal("Could not open Font file %s", fontPath.c_str());
             }
 
-            std::shared_ptr<Bytebuffer> buffer = Bytebuffer::Borrow<1048576>();
-            file.Read(buffer.get(), file.Length());
+            font->_fileData.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(font->_fileData.data()), font->_fileData.size());
 
             font->fontInfo = new stbtt_fontinfo();
-            stbtt_InitFont(font->fontInfo, buffer->GetDataPointer(), 0);
+            if (!file || !stbtt_InitFont(font->fontInfo, font->_fileData.data(), 0))
+            {
+                DebugHandler::PrintFatal("Could not read Font file %s", fontPath.c_str());
+            }
 
             font->scale = stbtt_ScaleForPixelHeight(font->fontInfo, fontSize);
 
-            // Create texture array
+            // Every atlas page is a texture in this array
             TextureArrayDesc desc;
-            desc.size = 128;
+            desc.size = FONT_ATLAS_MAX_PAGES;
 
             font->_textureArray = renderer->CreateTextureArray(desc);
+            font->CreateAtlasPage();
 
-            // Preload char 32 to 127 (commonly used ASCII characters)
-            for (int i = 32; i < 127; i++)
+            // The fallback is the only glyph generated on this thread since pending glyphs draw it, the font's .notdef glyph if it has one
+            i32 fallbackGlyphIndex = 0;
+            if (!font->InitChar(fallbackGlyphIndex, font->_fallbackChar))
             {
-                FontChar fontChar;
-                if (font->InitChar(i, fontChar))
-                {
-                    font->_chars[i] = fontChar;
-                }
+                fallbackGlyphIndex = stbtt_FindGlyphIndex(font->fontInfo, '?');
+                font->InitChar(fallbackGlyphIndex, font->_fallbackChar);
+            }
+
+            i32 width, height, xOffset, yOffset;
+            u8* data = stbtt_GetGlyphSDF(font->fontInfo, font->scale, fallbackGlyphIndex, font->desc.padding, 128, 64.0f, &width, &height, &xOffset, &yOffset);
+            if (data != nullptr)
+            {
+                font->AddToAtlas(data, width, height, font->_fallbackChar);
+                stbtt_FreeSDF(data, nullptr);
+            }
+            font->_fallbackChar.isReady = true;
+            font->UploadDirtyPages();
+
+            // Queue the commonly used ASCII characters, they are usually ready before the first text using them gets drawn
+            for (u32 i = 33; i < 127; i++)
+            {
+                font->GetChar(i);
             }
-            
+
             _fonts[hash] = font;
         }
 
         return _fonts[hash];
     }
 
-    bool Font::InitChar(char character, FontChar& fontChar)
+    bool Font::FinishGlyphLoads()
     {
-        fontChar.data = stbtt_GetCodepointSDF(fontInfo, scale, character, desc.padding, 128, 64.0f, &fontChar.width, &fontChar.height, &fontChar.xOffset, &fontChar.yOffset);
-
-        if (fontChar.width == 0 && fontChar.height == 0)
+        GlyphWorker& glyphWorker = GetGlyphWorker();
+        if (glyphWorker.generatedGlyphs.size_approx() == 0)
             return false;
 
-        int advance;
-        stbtt_GetCodepointHMetrics(fontInfo, character, &advance, NULL);
+        ZoneScopedNC("Font::FinishGlyphLoads", tracy::Color::Red3);
+
+        std::vector<Font*> changedFonts;
+        bool anyGlyphReady = false;
+
+        u32 numPacked = 0;
+        GlyphWorker::GeneratedGlyph glyph;
+        while (numPacked < MAX_GLYPHS_PACKED_PER_FRAME && glyphWorker.generatedGlyphs.try_dequeue(glyph))
+        {
+            Font* font = glyph.font;
+            {
+                std::lock_guard<std::mutex> lock(font->_mutex);
+                FontChar& fontChar = font->_chars[glyph.codepoint];
+
+                if (glyph.data == nullptr || !font->AddToAtlas(glyph.data, glyph.width, glyph.height, fontChar))
+                {
+                    DebugHandler::PrintWarning("Failed to add glyph %u to the atlas of font %s, it keeps using the fallback glyph", glyph.codepoint, font->desc.path.c_str());
+                }
+                fontChar.isReady = true;
+            }
+
+            stbtt_FreeSDF(glyph.data, nullptr);
+
+            if (std::find(changedFonts.begin(), changedFonts.end(), font) == changedFonts.end())
+            {
+                changedFonts.push_back(font);
+            }
+
+            anyGlyphReady = true;
+            numPacked++;
+        }
+
+        // One upload per changed page instead of one per glyph
+        for (Font* font : changedFonts)
+        {
+            std::lock_guard<std::mutex> lock(font->_mutex);
+            font->UploadDirtyPages();
+        }
+
+        return anyGlyphReady;
+    }
+
+    bool Font::InitChar(i32 glyphIndex, FontChar& fontChar)
+    {
+        i32 advance;
+        stbtt_GetGlyphHMetrics(fontInfo, glyphIndex, &advance, nullptr);
         fontChar.advance = advance * scale;
 
+        // Same box stbtt_GetGlyphSDF generates, so the quads are known before the SDF is
+        i32 x0, y0, x1, y1;
+        stbtt_GetGlyphBitmapBox(fontInfo, glyphIndex, scale, scale, &x0, &y0, &x1, &y1);
+
+        if (x0 == x1 || y0 == y1)
+        {
+            // Nothing to draw, like a space
+            fontChar.width = 0;
+            fontChar.height = 0;
+            fontChar.isReady = true;
+            return false;
+        }
+
+        fontChar.xOffset = x0 - desc.padding;
+        fontChar.yOffset = y0 - desc.padding;
+        fontChar.width = (x1 - x0) + desc.padding * 2;
+        fontChar.height = (y1 - y0) + desc.padding * 2;
+        fontChar.isReady = false;
+
+        return true;
+    }
+
+    bool Font::AddToAtlas(const u8* data, i32 width, i32 height, FontChar& fontChar)
+    {
+        const u32 paddedWidth = static_cast<u32>(width) + FONT_ATLAS_GLYPH_SPACING;
+        const u32 paddedHeight = static_cast<u32>(height) + FONT_ATLAS_GLYPH_SPACING;
+
+        if (paddedWidth > FONT_ATLAS_SIZE || paddedHeight > FONT_ATLAS_SIZE)
+            return false;
+
+        // Lowest shelf with room, glyphs of the same font size are close in height so shelves waste little space
+        AtlasPage* page = nullptr;
+        AtlasShelf* shelf = nullptr;
+        for (AtlasPage& atlasPage : _atlasPages)
+        {
+            for (AtlasShelf& atlasShelf : atlasPage.shelves)
+            {
+                if (atlasShelf.height >= paddedHeight && atlasShelf.x + paddedWidth <= FONT_ATLAS_SIZE && (shelf == nullptr || atlasShelf.height < shelf->height))
+                {
+                    page = &atlasPage;
+                    shelf = &atlasShelf;
+                }
+            }
+        }
+
+        if (shelf == nullptr)
+        {
+            page = _atlasPages.empty() ? nullptr : &_atlasPages.back();
+            if (page == nullptr || page->nextShelfY + paddedHeight > FONT_ATLAS_SIZE)
+            {
+                page = CreateAtlasPage();
+                if (page == nullptr)
+                    return false;
+            }
+
+            shelf = &page->shelves.emplace_back();
+            shelf->y = page->nextShelfY;
+            shelf->height = paddedHeight;
+            page->nextShelfY += paddedHeight;
+        }
+
+        const u32 x = shelf->x;
+        const u32 y = shelf->y;
+        shelf->x += paddedWidth;
+
+        for (i32 row = 0; row < height; row++)
+        {
+            memcpy(&page->pixels[(y + row) * FONT_ATLAS_SIZE + x], &data[row * width], width);
+        }
+
+        const uvec2 glyphMin = uvec2(x, y);
+        const uvec2 glyphMax = uvec2(x + width, y + height);
+        page->dirtyMin = page->isDirty ? glm::min(page->dirtyMin, glyphMin) : glyphMin;
+        page->dirtyMax = page->isDirty ? glm::max(page->dirtyMax, glyphMax) : glyphMax;
+        page->isDirty = true;
+
+        fontChar.textureIndex = page->arrayIndex;
+        fontChar.minUV = vec2(glyphMin) / static_cast<f32>(FONT_ATLAS_SIZE);
+        fontChar.maxUV = vec2(glyphMax) / static_cast<f32>(FONT_ATLAS_SIZE);
+
+        return true;
+    }
+
+    Font::AtlasPage* Font::CreateAtlasPage()
+    {
+        if (_atlasPages.size() >= FONT_ATLAS_MAX_PAGES)
+            return nullptr;
+
+        AtlasPage& page = _atlasPages.emplace_back();
+        page.pixels.resize(FONT_ATLAS_SIZE * FONT_ATLAS_SIZE);
+
         DataTextureDesc textureDesc;
-        textureDesc.width = fontChar.width;
-        textureDesc.height = fontChar.height;
+        textureDesc.width = FONT_ATLAS_SIZE;
+        textureDesc.height = FONT_ATLAS_SIZE;
         textureDesc.format = ImageFormat::R8_UNORM;
-        textureDesc.data = fontChar.data;
-        textureDesc.debugName = desc.path + " " + character;
+        textureDesc.data = page.pixels.data();
+        textureDesc.debugName = desc.path + " atlas " + std::to_string(_atlasPages.size() - 1);
 
-        _renderer->CreateDataTextureIntoArray(textureDesc, _textureArray, fontChar.textureIndex);
+        page.texture = _renderer->CreateDataTextureIntoArray(textureDesc, _textureArray, page.arrayIndex);
 
-        delete[] textureDesc.data;
+        return &page;
+    }
 
-        return true;
+    void Font::UploadDirtyPages()
+    {
+        std::vector<u8> region;
+
+        for (AtlasPage& page : _atlasPages)
+        {
+            if (!page.isDirty)
+                continue;
+
+            const uvec2 size = page.dirtyMax - page.dirtyMin;
+            region.resize(static_cast<size_t>(size.x) * size.y);
+
+            for (u32 row = 0; row < size.y; row++)
+            {
+                memcpy(&region[row * size.x], &page.pixels[(page.dirtyMin.y + row) * FONT_ATLAS_SIZE + page.dirtyMin.x], size.x);
+            }
+
+            _renderer->UpdateDataTexture(page.texture, page.dirtyMin.x, page.dirtyMin.y, size.x, size.y, region.data());
+            page.isDirty = false;
+        }
     }
 
     TextureArrayID Font::GetTextureArray()
     {
         return _textureArray;
     }
-}
\ No newline at end of file
+}
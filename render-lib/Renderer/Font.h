@@ -1,6 +1,9 @@
 #pragma once
 #include <NovusTypes.h>
 #include <robin_hood.h>
+#include <vector>
+#include <mutex>
+#include "Descriptors/TextureDesc.h"
 #include "Descriptors/TextureArrayDesc.h"
 #include "Descriptors/FontDesc.h"
 
@@ -12,14 +15,17 @@ namespace Renderer
 
     struct FontChar
     {
-        f32 advance;
-        i32 xOffset;
-        i32 yOffset;
+        f32 advance = 0.0f;
+        i32 xOffset = 0;
+        i32 yOffset = 0;
         i32 width = 0;
         i32 height = 0;
-        u8* data;
 
-        u32 textureIndex;
+        // Where the SDF lives in the atlas, points at the fallback glyph until the glyph has been generated
+        u32 textureIndex = 0;
+        vec2 minUV = vec2(0.0f, 0.0f);
+        vec2 maxUV = vec2(0.0f, 0.0f);
+        bool isReady = false;
     };
 
     struct Font
@@ -29,24 +35,60 @@ namespace Renderer
         stbtt_fontinfo* fontInfo;
         float scale;
 
-        FontChar& GetChar(char character);
+        // Metrics are known right away, glyphs that aren't in the atlas yet get queued for the glyph worker thread
+        const FontChar& GetChar(u32 codepoint);
         TextureArrayID GetTextureArray();
 
         static Font* GetFont(Renderer* renderer, const std::string& fontPath, f32 fontSize);
-        
+
+        // Packs the glyphs the worker has generated into the atlases and uploads them, at most one region per atlas page
+        // Returns true if any glyph became ready, text drawn with a pending glyph has to rebuild its quads
+        static bool FinishGlyphLoads();
+
     private:
+        // Glyphs get packed left to right into horizontal shelves, a glyph goes into the lowest shelf it fits in
+        struct AtlasShelf
+        {
+            u32 x = 0;
+            u32 y = 0;
+            u32 height = 0;
+        };
+
+        struct AtlasPage
+        {
+            TextureID texture = TextureID::Invalid();
+            u32 arrayIndex = 0;
+
+            std::vector<u8> pixels;
+            std::vector<AtlasShelf> shelves;
+            u32 nextShelfY = 0;
+
+            // Region that changed since the last upload
+            uvec2 dirtyMin = uvec2(0, 0);
+            uvec2 dirtyMax = uvec2(0, 0);
+            bool isDirty = false;
+        };
+
         Font() = default;
 
-        bool InitChar(char character, FontChar& fontChar);
+        bool InitChar(i32 glyphIndex, FontChar& fontChar);
+        bool AddToAtlas(const u8* data, i32 width, i32 height, FontChar& fontChar);
+        AtlasPage* CreateAtlasPage();
+        void UploadDirtyPages();
 
     private:
         static robin_hood::unordered_map<u64, Font*> _fonts;
-        robin_hood::unordered_map<char, FontChar> _chars;
+        robin_hood::unordered_node_map<u32, FontChar> _chars; // Node map so the references GetChar hands out stay valid
+
+        std::vector<u8> _fileData; // stbtt reads the font file for as long as the font lives
+        FontChar _fallbackChar;
 
+        std::vector<AtlasPage> _atlasPages;
         TextureArrayID _textureArray = TextureArrayID::Invalid();
+        std::mutex _mutex;
 
         Renderer* _renderer;
 
         friend class Renderer;
     };
-}
\ No newline at end of file
+}
@@ -4,6 +4,8 @@
 #include <tracy/Tracy.hpp>
 #include <Memory/Allocator.h>
 #include <Containers/DynamicArray.h>
+#include <taskflow/taskflow.hpp>
+#include <vector>
 
 namespace Renderer
 {
@@ -11,6 +13,7 @@ namespace Renderer
     {
         RenderGraphData(Memory::Allocator* allocator)
             : passes(allocator, 32)
+            , enabledPasses(allocator, 32)
             , executingPasses(allocator, 32)
             , signalSemaphores(allocator, 4)
             , waitSemaphores(allocator, 4)
@@ -19,6 +22,7 @@ namespace Renderer
         }
 
         DynamicArray<IRenderPass*> passes;
+        DynamicArray<IRenderPass*> enabledPasses;
         DynamicArray<IRenderPass*> executingPasses;
 
         DynamicArray<GPUSemaphoreID> signalSemaphores;
@@ -70,6 +74,16 @@ namespace Renderer
         data->waitSemaphores.Insert(semaphoreID);
     }
 
+    void RenderGraph::AddSideEffect(ImageID imageID)
+    {
+        _renderGraphBuilder->AddSideEffect(imageID);
+    }
+
+    void RenderGraph::AddSideEffect(DepthImageID imageID)
+    {
+        _renderGraphBuilder->AddSideEffect(imageID);
+    }
+
     void RenderGraph::Setup()
     {
         ZoneScopedNC("RenderGraph::Setup", tracy::Color::Red2)
@@ -80,11 +94,30 @@ namespace Renderer
             ZoneScopedC(tracy::Color::Red2)
             ZoneName(pass->_name, pass->_nameLength)
 
-            if (pass->Setup(_renderGraphBuilder))
+            _renderGraphBuilder->BeginPass();
+            bool executes = pass->Setup(_renderGraphBuilder);
+            _renderGraphBuilder->EndPass(executes);
+
+            if (executes)
+            {
+                data->enabledPasses.Insert(pass);
+            }
+        }
+
+        // Insertion order already respects every dependency the passes declared, culling only removes passes from it
+        // Moving the remaining passes around isn't safe yet since buffer accesses aren't declared
+        DynamicArray<bool> isPassCulled(_desc.allocator, static_cast<int>(data->enabledPasses.Count()) + 1);
+        _renderGraphBuilder->Cull(isPassCulled);
+
+        for (int i = 0; i < static_cast<int>(data->enabledPasses.Count()); i++)
+        {
+            if (!isPassCulled[i])
             {
-                data->executingPasses.Insert(pass);
+                data->executingPasses.Insert(data->enabledPasses[i]);
             }
         }
+
+        _renderGraphBuilder->Compile();
     }
 
     void RenderGraph::Execute()
@@ -93,7 +126,8 @@ namespace Renderer
 
         RenderGraphData* data = static_cast<RenderGraphData*>(_data);
         RenderGraphResources& resources = _renderGraphBuilder->GetResources();
-        
+
+#if COMMANDLIST_DEBUG_IMMEDIATE_MODE
         CommandList commandList(_renderer, _desc.allocator);
 
         // Add semaphores
@@ -107,13 +141,15 @@ namespace Renderer
             commandList.AddWaitSemaphore(waitSemaphore);
         }
 
-        // TODO: Parallel_for this
+        // Immediate mode records while the passes execute, so everything has to go into one command list on this thread
         commandList.PushMarker("RenderGraph", Color(0.0f, 0.0f, 0.4f));
+        u32 passIndex = 0;
         for (IRenderPass* pass : data->executingPasses)
         {
             ZoneScopedC(tracy::Color::Red2)
             ZoneName(pass->_name, pass->_nameLength)
 
+            _renderGraphBuilder->AddBarriers(passIndex++, commandList);
             pass->Execute(resources, commandList);
         }
         commandList.PopMarker();
@@ -122,5 +158,78 @@ namespace Renderer
             ZoneScopedNC("CommandList::Execute", tracy::Color::Red2)
             commandList.Execute();
         }
+#else
+        // Every pass gets its own CommandList, the passes still execute in order on this thread since they create pipelines and buffers through the Renderer
+        // Recording those into the backend is the expensive part, that happens on the workers and the command lists get submitted in pass order
+        const size_t numPasses = data->executingPasses.Count();
+        const size_t numCommandLists = numPasses > 0 ? numPasses : 1; // The semaphores still need a command list
+
+        std::vector<CommandList*> commandLists(numCommandLists);
+        for (size_t i = 0; i < numCommandLists; i++)
+        {
+            CommandList* commandList = Memory::Allocator::New<CommandList>(_desc.allocator, _renderer, _desc.allocator);
+            commandLists[i] = commandList;
+
+            if (i > 0)
+            {
+                commandList->InheritDynamicState(*commandLists[i - 1]);
+            }
+
+            if (i < numPasses)
+            {
+                IRenderPass* pass = data->executingPasses[static_cast<int>(i)];
+
+                ZoneScopedC(tracy::Color::Red2)
+                ZoneName(pass->_name, pass->_nameLength)
+
+                _renderGraphBuilder->AddBarriers(static_cast<u32>(i), *commandList);
+                pass->Execute(resources, *commandList);
+            }
+        }
+
+        // Everything gets submitted together, so waiting in the first and signaling in the last covers the whole graph
+        for (GPUSemaphoreID waitSemaphore : data->waitSemaphores)
+        {
+            commandLists.front()->AddWaitSemaphore(waitSemaphore);
+        }
+
+        for (GPUSemaphoreID signalSemaphore : data->signalSemaphores)
+        {
+            commandLists.back()->AddSignalSemaphore(signalSemaphore);
+        }
+
+        std::vector<CommandListID> commandListIDs(numCommandLists);
+        for (size_t i = 0; i < numCommandLists; i++)
+        {
+            commandListIDs[i] = _renderer->BeginDeferredCommandList();
+        }
+
+        {
+            ZoneScopedNC("RenderGraph::RecordCommandLists", tracy::Color::Red2)
+
+            tf::Framework framework;
+            for (size_t i = 0; i < numCommandLists; i++)
+            {
+                CommandList* commandList = commandLists[i];
+                CommandListID commandListID = commandListIDs[i];
+
+                framework.emplace([this, commandList, commandListID]()
+                {
+                    commandList->Record(commandListID);
+                    _renderer->EndCommandList(commandListID);
+                });
+            }
+
+            // RenderGraphs only live for a frame, their recording runs on the renderer's shared workers
+            tf::Taskflow taskflow(_renderer->GetTaskExecutor());
+            taskflow.run(framework);
+            taskflow.wait_for_all();
+        }
+
+        {
+            ZoneScopedNC("RenderGraph::SubmitCommandLists", tracy::Color::Red2)
+            _renderer->SubmitCommandLists(commandListIDs.data(), static_cast<u32>(numCommandLists));
+        }
+#endif
     }
 }
\ No newline at end of file
@@ -14,6 +14,7 @@ namespace Renderer
     struct IRenderGraphData {};
 
     // Acyclic Graph for rendering
+    // Passes execute in the order they were added, minus the ones Setup disabled or that nothing depends on
     class RenderGraph
     {
     public:
@@ -29,6 +30,10 @@ namespace Renderer
         void AddSignalSemaphore(GPUSemaphoreID semaphoreID);
         void AddWaitSemaphore(GPUSemaphoreID semaphoreID);
 
+        // Marks images that get used after the graph executed, passes that don't contribute to one of these or to a buffer get culled
+        void AddSideEffect(ImageID imageID);
+        void AddSideEffect(DepthImageID imageID);
+
         void Setup();
         void Execute();
 
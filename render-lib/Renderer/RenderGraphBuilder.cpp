@@ -2,18 +2,436 @@
 #include "Renderer.h"
 #include "RenderGraph.h"
 
+#include <robin_hood.h>
+#include <algorithm>
+#include <vector>
+
 namespace Renderer
 {
     RenderGraphBuilder::RenderGraphBuilder(Memory::Allocator* allocator, Renderer* renderer)
-        : _renderer(renderer)
+        : _allocator(allocator)
+        , _renderer(renderer)
         , _resources(allocator)
+        , _accesses(allocator, 64)
+        , _enabledSetupIndices(allocator, 32)
+        , _executingSetupIndices(allocator, 32)
+        , _sideEffects(allocator, 4)
+        , _barriers(allocator, 32)
+        , _passBarrierOffsets(allocator, 32)
+        , _transients(allocator, 8)
+    {
+
+    }
+
+    void RenderGraphBuilder::BeginPass()
+    {
+        _setupIndex++;
+    }
+
+    void RenderGraphBuilder::EndPass(bool executes)
+    {
+        if (executes)
+        {
+            _enabledSetupIndices.Insert(_setupIndex);
+        }
+    }
+
+    struct ImageAccessState
+    {
+        u8 writeAccess = 0; // The last write this frame, 0 if nothing wrote the image yet
+        u8 readAccess = 0; // Every read since the last write
+        u8 visibleAccess = 0; // The reads that already waited for the last write
+    };
+
+    static u32 GetImageKey(ImageID image, DepthImageID depthImage)
+    {
+        return depthImage != DepthImageID::Invalid() ? (1u << 16) | static_cast<DepthImageID::type>(depthImage) : static_cast<ImageID::type>(image);
+    }
+
+    constexpr u32 PASS_NOT_EXECUTED = 0xFFFFFFFF;
+
+    void RenderGraphBuilder::AddSideEffect(ImageID id)
+    {
+        _sideEffects.Insert(GetImageKey(id, DepthImageID::Invalid()));
+    }
+
+    void RenderGraphBuilder::AddSideEffect(DepthImageID id)
+    {
+        _sideEffects.Insert(GetImageKey(ImageID::Invalid(), id));
+    }
+
+    void RenderGraphBuilder::Cull(DynamicArray<bool>& isPassCulled)
+    {
+        const int numAccesses = static_cast<int>(_accesses.Count());
+        const int numPasses = static_cast<int>(_enabledSetupIndices.Count());
+
+        // Find the range of accesses every enabled pass declared, accesses are in setup order
+        std::vector<int> passAccessBegin(numPasses);
+        std::vector<int> passAccessEnd(numPasses);
+        {
+            int accessIndex = 0;
+            for (int i = 0; i < numPasses; i++)
+            {
+                const u16 setupIndex = _enabledSetupIndices[i];
+                while (accessIndex < numAccesses && _accesses[accessIndex].setupIndex < setupIndex)
+                {
+                    accessIndex++;
+                }
+                passAccessBegin[i] = accessIndex;
+
+                while (accessIndex < numAccesses && _accesses[accessIndex].setupIndex == setupIndex)
+                {
+                    accessIndex++;
+                }
+                passAccessEnd[i] = accessIndex;
+            }
+        }
+
+        // An image is live if a pass we keep, or a side effect, uses it after this point
+        robin_hood::unordered_set<u32> liveImages;
+        for (u32 sideEffect : _sideEffects)
+        {
+            liveImages.insert(sideEffect);
+        }
+
+        std::vector<bool> isCulled(numPasses, false);
+        for (int i = numPasses - 1; i >= 0; i--)
+        {
+            const int accessBegin = passAccessBegin[i];
+            const int accessEnd = passAccessEnd[i];
+
+            bool hasWrites = false;
+            bool isNeeded = false;
+
+            for (int accessIndex = accessBegin; accessIndex < accessEnd; accessIndex++)
+            {
+                const ImageAccessEntry& entry = _accesses[accessIndex];
+                if ((entry.access & IMAGE_ACCESS_WRITE_MASK) == 0)
+                    continue;
+
+                hasWrites = true;
+                if (liveImages.find(GetImageKey(entry.image, entry.depthImage)) != liveImages.end())
+                {
+                    isNeeded = true;
+                    break;
+                }
+            }
+
+            if (hasWrites && !isNeeded)
+            {
+                isCulled[i] = true;
+                continue;
+            }
+
+            // Writes don't end the liveness of an image since passes can load what the previous pass wrote
+            for (int accessIndex = accessBegin; accessIndex < accessEnd; accessIndex++)
+            {
+                const ImageAccessEntry& entry = _accesses[accessIndex];
+                liveImages.insert(GetImageKey(entry.image, entry.depthImage));
+            }
+        }
+
+        for (int i = 0; i < numPasses; i++)
+        {
+            isPassCulled.Insert(isCulled[i]);
+
+            if (!isCulled[i])
+            {
+                _executingSetupIndices.Insert(_enabledSetupIndices[i]);
+            }
+        }
+    }
+
+    struct TransientAliasState
+    {
+        u8 previousAccess = 0; // Everything the previous transient in the alias slot did to the memory, 0 for the first one this frame
+        bool isSlotShared = false;
+    };
+
+    struct TransientLifetime
+    {
+        u32 firstPass = PASS_NOT_EXECUTED;
+        u32 lastPass = 0;
+        u8 access = 0;
+        int transientIndex = 0;
+    };
+
+    struct AliasSlot
+    {
+        u32 lastPass = 0;
+        u8 lastAccess = 0;
+        bool isDepth = false;
+        u32 numMembers = 0;
+    };
+
+    // Greedy interval assignment, transients are placed in order of their first use into the first slot that is free again by then
+    // Color and depth images never share a slot since they rarely have a memory type in common
+    template <typename Accesses>
+    static void AssignAliasSlots(const Accesses& accesses, const DynamicArray<u32>& accessPassIndices, DynamicArray<TransientImageDesc>& transients, u32 numPasses, robin_hood::unordered_map<u32, TransientAliasState>& aliasStates)
+    {
+        const int numTransients = static_cast<int>(transients.Count());
+
+        std::vector<TransientLifetime> lifetimes(numTransients);
+        robin_hood::unordered_map<u32, int> transientIndices;
+
+        for (int i = 0; i < numTransients; i++)
+        {
+            lifetimes[i].transientIndex = i;
+            transientIndices[GetImageKey(transients[i].image, transients[i].depthImage)] = i;
+        }
+
+        const int numAccesses = static_cast<int>(accesses.Count());
+        for (int i = 0; i < numAccesses; i++)
+        {
+            const u32 passIndex = accessPassIndices[i];
+            if (passIndex == PASS_NOT_EXECUTED)
+                continue;
+
+            auto transient = transientIndices.find(GetImageKey(accesses[i].image, accesses[i].depthImage));
+            if (transient == transientIndices.end())
+                continue;
+
+            TransientLifetime& lifetime = lifetimes[transient->second];
+            lifetime.firstPass = std::min(lifetime.firstPass, passIndex);
+            lifetime.lastPass = std::max(lifetime.lastPass, passIndex);
+            lifetime.access |= accesses[i].access;
+        }
+
+        // Transients no executing pass touched could still be used outside of the graph, so they keep their memory for the whole frame
+        for (TransientLifetime& lifetime : lifetimes)
+        {
+            if (lifetime.firstPass == PASS_NOT_EXECUTED)
+            {
+                lifetime.firstPass = 0;
+                lifetime.lastPass = numPasses;
+                lifetime.access = IMAGE_ACCESS_WRITE_MASK | IMAGE_ACCESS_READ_MASK;
+            }
+        }
+
+        std::stable_sort(lifetimes.begin(), lifetimes.end(), [](const TransientLifetime& a, const TransientLifetime& b)
+        {
+            return a.firstPass < b.firstPass;
+        });
+
+        std::vector<AliasSlot> slots;
+        for (const TransientLifetime& lifetime : lifetimes)
+        {
+            TransientImageDesc& transient = transients[lifetime.transientIndex];
+            const bool isDepth = transient.depthImage != DepthImageID::Invalid();
+
+            u32 slotIndex = static_cast<u32>(slots.size());
+            for (u32 i = 0; i < slots.size(); i++)
+            {
+                if (slots[i].isDepth == isDepth && slots[i].lastPass < lifetime.firstPass)
+                {
+                    slotIndex = i;
+                    break;
+                }
+            }
+
+            if (slotIndex == slots.size())
+            {
+                AliasSlot& slot = slots.emplace_back();
+                slot.isDepth = isDepth;
+            }
+
+            AliasSlot& slot = slots[slotIndex];
+
+            TransientAliasState& aliasState = aliasStates[GetImageKey(transient.image, transient.depthImage)];
+            aliasState.previousAccess = slot.lastAccess;
+
+            slot.lastPass = lifetime.lastPass;
+            slot.lastAccess = lifetime.access;
+            slot.numMembers++;
+
+            transient.aliasSlot = slotIndex;
+        }
+
+        for (int i = 0; i < numTransients; i++)
+        {
+            const TransientImageDesc& transient = transients[i];
+            aliasStates[GetImageKey(transient.image, transient.depthImage)].isSlotShared = slots[transient.aliasSlot].numMembers > 1;
+        }
+    }
+
+    void RenderGraphBuilder::Compile()
+    {
+        const int numAccesses = static_cast<int>(_accesses.Count());
+        const int numTransients = static_cast<int>(_transients.Count());
+
+        // Find out which executing pass every access belongs to, accesses are in setup order so the ones of passes that didn't execute can just be skipped
+        DynamicArray<u32> accessPassIndices(_allocator, numAccesses > 0 ? numAccesses : 1);
+        {
+            int accessIndex = 0;
+            u32 passIndex = 0;
+
+            for (u16 setupIndex : _executingSetupIndices)
+            {
+                for (; accessIndex < numAccesses && _accesses[accessIndex].setupIndex < setupIndex; accessIndex++)
+                {
+                    accessPassIndices.Insert(PASS_NOT_EXECUTED);
+                }
+
+                for (; accessIndex < numAccesses && _accesses[accessIndex].setupIndex == setupIndex; accessIndex++)
+                {
+                    accessPassIndices.Insert(passIndex);
+                }
+
+                passIndex++;
+            }
+
+            for (; accessIndex < numAccesses; accessIndex++)
+            {
+                accessPassIndices.Insert(PASS_NOT_EXECUTED);
+            }
+        }
+
+        // Transients in a shared alias slot discard what the previous image in the slot left in the memory on their first access
+        robin_hood::unordered_map<u32, TransientAliasState> aliasStates;
+        if (numTransients > 0)
+        {
+            AssignAliasSlots(_accesses, accessPassIndices, _transients, static_cast<u32>(_executingSetupIndices.Count()), aliasStates);
+        }
+
+        // Images start every frame without a pending write, the semaphore between frames orders them against the last frame
+        robin_hood::unordered_map<u32, ImageAccessState> states;
+
+        int accessIndex = 0;
+        const u32 numPasses = static_cast<u32>(_executingSetupIndices.Count());
+
+        for (u32 passIndex = 0; passIndex < numPasses; passIndex++)
+        {
+            _passBarrierOffsets.Insert(static_cast<u32>(_barriers.Count()));
+
+            while (accessIndex < numAccesses && accessPassIndices[accessIndex] != passIndex)
+            {
+                accessIndex++;
+            }
+
+            for (; accessIndex < numAccesses && accessPassIndices[accessIndex] == passIndex; accessIndex++)
+            {
+                const ImageAccessEntry& entry = _accesses[accessIndex];
+
+                const u32 key = GetImageKey(entry.image, entry.depthImage);
+                const bool isFirstAccess = states.find(key) == states.end();
+                ImageAccessState& state = states[key];
+
+                if (isFirstAccess)
+                {
+                    auto aliasState = aliasStates.find(key);
+                    if (aliasState != aliasStates.end() && aliasState->second.isSlotShared)
+                    {
+                        ImageBarrierDesc barrier;
+                        barrier.image = entry.image;
+                        barrier.depthImage = entry.depthImage;
+                        barrier.srcAccess = aliasState->second.previousAccess;
+                        barrier.dstAccess = entry.access;
+                        barrier.discard = true;
+
+                        _barriers.Insert(barrier);
+
+                        state.writeAccess = entry.access & IMAGE_ACCESS_WRITE_MASK;
+                        state.readAccess = entry.access & IMAGE_ACCESS_READ_MASK;
+                        state.visibleAccess = state.readAccess;
+                        continue;
+                    }
+                }
+
+                const u8 writes = entry.access & IMAGE_ACCESS_WRITE_MASK;
+                const u8 reads = entry.access & IMAGE_ACCESS_READ_MASK;
+                u8 srcAccess = 0;
+
+                if (writes != 0)
+                {
+                    // Render passes writing the same attachment one after another are already ordered by the backend's render pass dependencies
+                    const bool renderTargetToRenderTarget = state.writeAccess == IMAGE_ACCESS_RENDERTARGET && state.readAccess == 0 && entry.access == IMAGE_ACCESS_RENDERTARGET;
+                    if (!renderTargetToRenderTarget)
+                    {
+                        srcAccess = state.writeAccess | state.readAccess;
+                    }
+
+                    state.writeAccess = writes;
+                    state.readAccess = reads;
+                    state.visibleAccess = 0;
+                }
+                else
+                {
+                    // Reads only need to wait for the last write once per stage, reads after reads need nothing
+                    if (state.writeAccess != 0 && (reads & ~state.visibleAccess) != 0)
+                    {
+                        srcAccess = state.writeAccess;
+                    }
+
+                    state.readAccess |= reads;
+                    state.visibleAccess |= reads;
+                }
+
+                if (srcAccess != 0)
+                {
+                    ImageBarrierDesc barrier;
+                    barrier.image = entry.image;
+                    barrier.depthImage = entry.depthImage;
+                    barrier.srcAccess = srcAccess;
+                    barrier.dstAccess = entry.access;
+
+                    _barriers.Insert(barrier);
+                }
+            }
+        }
+
+        _passBarrierOffsets.Insert(static_cast<u32>(_barriers.Count()));
+
+        // This has to happen every frame, even without transients, so images the graph stopped using give their memory back
+        _renderer->AllocateTransientImages(numTransients > 0 ? &_transients[0] : nullptr, static_cast<u32>(numTransients));
+    }
+
+    void RenderGraphBuilder::AddBarriers(u32 passIndex, CommandList& commandList)
+    {
+        const u32 barrierOffset = _passBarrierOffsets[static_cast<int>(passIndex)];
+        const u32 numBarriers = _passBarrierOffsets[static_cast<int>(passIndex + 1)] - barrierOffset;
+
+        if (numBarriers > 0)
+        {
+            commandList.ImageBarriers(&_barriers[static_cast<int>(barrierOffset)], numBarriers);
+        }
+    }
+
+    void RenderGraphBuilder::AddAccess(ImageID image, DepthImageID depthImage, u8 access)
     {
+        // Declaring the same image more than once in a pass merges into one access
+        for (int i = static_cast<int>(_accesses.Count()) - 1; i >= 0 && _accesses[i].setupIndex == _setupIndex; i--)
+        {
+            ImageAccessEntry& entry = _accesses[i];
+            if (entry.image == image && entry.depthImage == depthImage)
+            {
+                entry.access |= access;
+                return;
+            }
+        }
+
+        ImageAccessEntry entry;
+        entry.image = image;
+        entry.depthImage = depthImage;
+        entry.access = access;
+        entry.setupIndex = _setupIndex;
 
+        _accesses.Insert(entry);
     }
 
-    void RenderGraphBuilder::Compile(CommandList* /*commandList*/)
+    static u8 ToReadAccess(RenderGraphBuilder::ShaderStage shaderStage)
     {
+        switch (shaderStage)
+        {
+            case RenderGraphBuilder::ShaderStage::VERTEX: return IMAGE_ACCESS_VERTEX_READ;
+            case RenderGraphBuilder::ShaderStage::PIXEL: return IMAGE_ACCESS_PIXEL_READ;
+            case RenderGraphBuilder::ShaderStage::COMPUTE: return IMAGE_ACCESS_COMPUTE_READ;
+            default: return IMAGE_ACCESS_READ_MASK; // We don't know who reads it, so wait for everyone
+        }
+    }
 
+    static u8 ToWriteAccess(RenderGraphBuilder::WriteMode writeMode)
+    {
+        return writeMode == RenderGraphBuilder::WriteMode::UAV ? IMAGE_ACCESS_UAV : IMAGE_ACCESS_RENDERTARGET;
     }
 
     RenderGraphResources& RenderGraphBuilder::GetResources()
@@ -21,48 +439,61 @@ namespace Renderer
         return _resources;
     }
 
-    ImageID RenderGraphBuilder::Create(ImageDesc& /*desc*/)
+    ImageID RenderGraphBuilder::Create(ImageDesc& desc)
     {
-        return ImageID::Invalid();
+        TransientImageDesc transient;
+        transient.image = _renderer->CreateTransientImage(desc);
+
+        _transients.Insert(transient);
+        return transient.image;
     }
 
-    DepthImageID RenderGraphBuilder::Create(DepthImageDesc& /*desc*/)
+    DepthImageID RenderGraphBuilder::Create(DepthImageDesc& desc)
     {
-        return DepthImageID::Invalid();
+        TransientImageDesc transient;
+        transient.depthImage = _renderer->CreateTransientDepthImage(desc);
+
+        _transients.Insert(transient);
+        return transient.depthImage;
     }
 
-    RenderPassResource RenderGraphBuilder::Read(ImageID id, ShaderStage /*shaderStage*/)
+    RenderPassResource RenderGraphBuilder::Read(ImageID id, ShaderStage shaderStage)
     {
         RenderPassResource resource = _resources.GetResource(id);
+        AddAccess(id, DepthImageID::Invalid(), ToReadAccess(shaderStage));
 
         return resource;
     }
 
     RenderPassResource RenderGraphBuilder::Read(TextureID id, ShaderStage /*shaderStage*/)
     {
+        // Textures are never written by passes, so they never need a barrier
         RenderPassResource resource = _resources.GetResource(id);
 
         return resource;
     }
 
-    RenderPassResource RenderGraphBuilder::Read(DepthImageID id, ShaderStage /*shaderStage*/)
+    RenderPassResource RenderGraphBuilder::Read(DepthImageID id, ShaderStage shaderStage)
     {
         RenderPassResource resource = _resources.GetResource(id);
+        AddAccess(ImageID::Invalid(), id, ToReadAccess(shaderStage));
 
         return resource;
     }
 
-    RenderPassMutableResource RenderGraphBuilder::Write(ImageID id, WriteMode /*writeMode*/, LoadMode /*loadMode*/)
+    RenderPassMutableResource RenderGraphBuilder::Write(ImageID id, WriteMode writeMode, LoadMode /*loadMode*/)
     {
         RenderPassMutableResource resource = _resources.GetMutableResource(id);
+        AddAccess(id, DepthImageID::Invalid(), ToWriteAccess(writeMode));
 
         return resource;
     }
 
-    RenderPassMutableResource RenderGraphBuilder::Write(DepthImageID id, WriteMode /*writeMode*/, LoadMode /*loadMode*/)
+    RenderPassMutableResource RenderGraphBuilder::Write(DepthImageID id, WriteMode writeMode, LoadMode /*loadMode*/)
     {
         RenderPassMutableResource resource = _resources.GetMutableResource(id);
+        AddAccess(ImageID::Invalid(), id, ToWriteAccess(writeMode));
 
         return resource;
     }
-}
\ No newline at end of file
+}
@@ -9,6 +9,10 @@
 #include "Descriptors/TextureDesc.h"
 #include "Descriptors/ImageDesc.h"
 #include "Descriptors/DepthImageDesc.h"
+#include "Descriptors/ImageBarrierDesc.h"
+#include "Descriptors/TransientImageDesc.h"
+
+#include <Containers/DynamicArray.h>
 
 namespace Memory
 {
@@ -47,10 +51,12 @@ namespace Renderer
             COMPUTE
         };
 
-        // Create transient resources
+        // Create transient resources, they only have memory while this graph executes and share it with transient images the graph never uses at the same time
+        // Their contents don't survive between frames
         ImageID Create(ImageDesc& desc);
         DepthImageID Create(DepthImageDesc& desc);
 
+        // Reads and writes get recorded per pass, the RenderGraph uses them to place the barriers between passes
         // Reads
         RenderPassResource Read(ImageID id, ShaderStage shaderStage);
         RenderPassResource Read(TextureID id, ShaderStage shaderStage);
@@ -61,7 +67,33 @@ namespace Renderer
         RenderPassMutableResource Write(DepthImageID id, WriteMode writeMode, LoadMode loadMode);
 
     private:
-        void Compile(CommandList* commandList);
+        struct ImageAccessEntry
+        {
+            ImageID image = ImageID::Invalid();
+            DepthImageID depthImage = DepthImageID::Invalid();
+            u8 access = 0;
+            u16 setupIndex = 0; // Which call to RenderGraph::Setup's pass loop declared this access
+        };
+
+        // Accesses get declared between BeginPass and EndPass, they only count if EndPass gets told the pass executes
+        void BeginPass();
+        void EndPass(bool executes);
+
+        // Images that get used after the graph executed, like the image we present
+        void AddSideEffect(ImageID id);
+        void AddSideEffect(DepthImageID id);
+
+        // Walks the enabled passes backwards and culls the ones that write nothing a later pass or a side effect depends on
+        // Passes that don't declare any writes are kept, they write buffers the graph can't see
+        void Cull(DynamicArray<bool>& isPassCulled);
+
+        // Walks the accesses of every executing pass in order and computes the barriers each pass needs before it runs
+        // Transient images get their alias slots from the same walk, and their memory once it's done
+        void Compile();
+        void AddBarriers(u32 passIndex, CommandList& commandList);
+
+        void AddAccess(ImageID image, DepthImageID depthImage, u8 access);
+
         RenderGraphResources& GetResources();
 
     private:
@@ -70,6 +102,18 @@ namespace Renderer
 
         RenderGraphResources _resources;
 
+        // These live in the frame allocator together with the RenderGraph
+        DynamicArray<ImageAccessEntry> _accesses;
+        DynamicArray<u16> _enabledSetupIndices; // Passes whose Setup returned true
+        DynamicArray<u16> _executingSetupIndices; // The enabled passes that survived Cull
+        DynamicArray<u32> _sideEffects;
+        u16 _setupIndex = 0;
+
+        DynamicArray<ImageBarrierDesc> _barriers;
+        DynamicArray<u32> _passBarrierOffsets; // Where the barriers of each executing pass start in _barriers, has one extra entry at the end
+
+        DynamicArray<TransientImageDesc> _transients;
+
         friend class RenderGraph;
     };
 }
\ No newline at end of file
@@ -2,9 +2,20 @@
 
 #include "Descriptors/GraphicsPipelineDesc.h"
 #include <Containers/DynamicArray.h>
+#include <cstring>
 
 namespace Renderer
 {
+    constexpr u16 UNTRACKED_RESOURCE = 0xFFFF;
+
+    // Maps the IDs a graph uses to their index in the tracked arrays, indexed directly by ID
+    // It lives in the frame allocator, growing it just leaves the old table behind until the frame allocator gets reset
+    struct ResourceTable
+    {
+        u16* indices = nullptr;
+        u32 size = 0;
+    };
+
     struct RenderGraphResourcesData : IRenderGraphResourcesData
     {
         RenderGraphResourcesData(Memory::Allocator* allocator)
@@ -18,8 +29,50 @@ namespace Renderer
         DynamicArray<ImageID> trackedImages;
         DynamicArray<TextureID> trackedTextures;
         DynamicArray<DepthImageID> trackedDepthImages;
+
+        ResourceTable imageTable;
+        ResourceTable textureTable;
+        ResourceTable depthImageTable;
     };
 
+    template <typename ID>
+    static u16 GetResourceIndex(Memory::Allocator* allocator, ResourceTable& table, DynamicArray<ID>& trackedIDs, ID id)
+    {
+        const u32 idIndex = static_cast<u32>(static_cast<typename ID::type>(id));
+
+        if (idIndex >= table.size)
+        {
+            u32 newSize = table.size > 0 ? table.size * 2 : 64;
+            if (newSize <= idIndex)
+            {
+                newSize = idIndex + 1;
+            }
+
+            u16* newIndices = Memory::Allocator::NewArray<u16>(allocator, newSize);
+            if (table.size > 0)
+            {
+                memcpy(newIndices, table.indices, sizeof(u16) * table.size);
+            }
+
+            for (u32 i = table.size; i < newSize; i++)
+            {
+                newIndices[i] = UNTRACKED_RESOURCE;
+            }
+
+            table.indices = newIndices;
+            table.size = newSize;
+        }
+
+        u16& resourceIndex = table.indices[idIndex];
+        if (resourceIndex == UNTRACKED_RESOURCE)
+        {
+            resourceIndex = static_cast<u16>(trackedIDs.Count());
+            trackedIDs.Insert(id);
+        }
+
+        return resourceIndex;
+    }
+
 	RenderGraphResources::RenderGraphResources(Memory::Allocator* allocator)
 		: _allocator(allocator)
         , _data(Memory::Allocator::New<RenderGraphResourcesData>(allocator, allocator))
@@ -77,95 +130,30 @@ namespace Renderer
     RenderPassResource RenderGraphResources::GetResource(ImageID id)
     {
         RenderGraphResourcesData* data = static_cast<RenderGraphResourcesData*>(_data);
-
-        ImageID::type i = 0;
-        for (ImageID& trackedID : data->trackedImages)
-        {
-            if (trackedID == id)
-            {
-                return RenderPassResource(i);
-            }
-
-            i++;
-        }
-
-        data->trackedImages.Insert(id);
-        return RenderPassResource(i);
+        return RenderPassResource(GetResourceIndex(_allocator, data->imageTable, data->trackedImages, id));
     }
 
     RenderPassResource RenderGraphResources::GetResource(TextureID id)
     {
         RenderGraphResourcesData* data = static_cast<RenderGraphResourcesData*>(_data);
-
-        TextureID::type i = 0;
-        for (TextureID& trackedID : data->trackedTextures)
-        {
-            if (trackedID == id)
-            {
-                return RenderPassResource(i);
-            }
-
-            i++;
-        }
-
-        data->trackedTextures.Insert(id);
-        return RenderPassResource(i);
+        return RenderPassResource(GetResourceIndex(_allocator, data->textureTable, data->trackedTextures, id));
     }
 
     RenderPassResource RenderGraphResources::GetResource(DepthImageID id)
     {
         RenderGraphResourcesData* data = static_cast<RenderGraphResourcesData*>(_data);
-
-        DepthImageID::type i = 0;
-        for (DepthImageID& trackedID : data->trackedDepthImages)
-        {
-            if (trackedID == id)
-            {
-                return RenderPassResource(i);
-            }
-
-            i++;
-        }
-
-        data->trackedDepthImages.Insert(id);
-        return RenderPassResource(i);
+        return RenderPassResource(GetResourceIndex(_allocator, data->depthImageTable, data->trackedDepthImages, id));
     }
 
     RenderPassMutableResource RenderGraphResources::GetMutableResource(ImageID id)
     {
         RenderGraphResourcesData* data = static_cast<RenderGraphResourcesData*>(_data);
-
-        ImageID::type i = 0;
-        for (ImageID& trackedID : data->trackedImages)
-        {
-            if (trackedID == id)
-            {
-                return RenderPassMutableResource(i);
-            }
-
-            i++;
-        }
-
-        data->trackedImages.Insert(id);
-        return RenderPassMutableResource(i);
+        return RenderPassMutableResource(GetResourceIndex(_allocator, data->imageTable, data->trackedImages, id));
     }
 
     RenderPassMutableResource RenderGraphResources::GetMutableResource(DepthImageID id)
     {
         RenderGraphResourcesData* data = static_cast<RenderGraphResourcesData*>(_data);
-
-        DepthImageID::type i = 0;
-        for (DepthImageID& trackedID : data->trackedDepthImages)
-        {
-            if (trackedID == id)
-            {
-                return RenderPassMutableResource(i);
-            }
-
-            i++;
-        }
-
-        data->trackedDepthImages.Insert(id);
-        return RenderPassMutableResource(i);
+        return RenderPassMutableResource(GetResourceIndex(_allocator, data->depthImageTable, data->trackedDepthImages, id));
     }
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "RenderGraph.h"
 
 #include <Memory/Allocator.h>
+#include <cstring>
 
 namespace Renderer
 {
@@ -16,4 +17,38 @@ namespace Renderer
 
         return *renderGraph;
     }
+
+    const std::shared_ptr<tf::Taskflow::Executor>& Renderer::GetTaskExecutor()
+    {
+        if (_taskExecutor == nullptr)
+        {
+            // Nobody handed us workers, create a pool the first time one is needed
+            _taskExecutor = tf::Taskflow().share_executor();
+        }
+
+        return _taskExecutor;
+    }
+
+    void Renderer::UploadToBuffer(BufferID dstBuffer, u64 dstOffset, const void* data, u64 size)
+    {
+        if (size == 0)
+            return;
+
+        void* dst = StageUpload(dstBuffer, dstOffset, size);
+        if (dst == nullptr)
+            return;
+
+        memcpy(dst, data, size);
+    }
+
+    FrameConstantsAllocation Renderer::UploadFrameConstants(const void* data, u32 size)
+    {
+        FrameConstantsAllocation allocation = AllocateFrameConstants(size);
+        if (allocation.mappedMemory != nullptr)
+        {
+            memcpy(allocation.mappedMemory, data, size);
+        }
+
+        return allocation;
+    }
 }
\ No newline at end of file
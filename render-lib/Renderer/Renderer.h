@@ -17,6 +17,12 @@
 #include "Descriptors/TextureArrayDesc.h"
 #include "Descriptors/SamplerDesc.h"
 #include "Descriptors/GPUSemaphoreDesc.h"
+#include "Descriptors/UploadBufferDesc.h"
+#include "Descriptors/ImageBarrierDesc.h"
+#include "Descriptors/TransientImageDesc.h"
+
+#include <memory>
+#include <taskflow/taskflow.hpp>
 
 class Window;
 
@@ -55,6 +61,12 @@ namespace Renderer
         virtual ImageID CreateImage(ImageDesc& desc) = 0;
         virtual DepthImageID CreateDepthImage(DepthImageDesc& desc) = 0;
 
+        // Transient images only live within the render graph that created them through RenderGraphBuilder::Create
+        // The same desc gets the same ID every frame, memory only gets bound in AllocateTransientImages once the graph knows their lifetimes
+        virtual ImageID CreateTransientImage(ImageDesc& desc) = 0;
+        virtual DepthImageID CreateTransientDepthImage(DepthImageDesc& desc) = 0;
+        virtual void AllocateTransientImages(const TransientImageDesc* images, u32 numImages) = 0;
+
         virtual SamplerID CreateSampler(SamplerDesc& sampler) = 0;
         virtual GPUSemaphoreID CreateGPUSemaphore() = 0;
 
@@ -66,10 +78,18 @@ namespace Renderer
         virtual TextureID CreateDataTexture(DataTextureDesc& desc) = 0;
         virtual TextureID CreateDataTextureIntoArray(DataTextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex) = 0;
 
+        // Overwrites a region of a data texture with tightly packed pixels, staged so it lands before the next command list
+        virtual void UpdateDataTexture(TextureID textureID, u32 x, u32 y, u32 width, u32 height, const void* data) = 0;
+
         // Loading
         virtual TextureID LoadTexture(TextureDesc& desc) = 0;
         virtual TextureID LoadTextureIntoArray(TextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex) = 0;
 
+        // Async loading returns right away, the texture is bound to a 1x1 placeholder until it has been decoded and uploaded
+        // Requests with a lower priority load first, pass the distance to the camera to get nearby textures in first
+        virtual TextureID LoadTextureAsync(TextureDesc& desc, f32 priority) = 0;
+        virtual TextureID LoadTextureIntoArrayAsync(TextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex, f32 priority) = 0;
+
         virtual VertexShaderID LoadShader(VertexShaderDesc& desc) = 0;
         virtual PixelShaderID LoadShader(PixelShaderDesc& desc) = 0;
         virtual ComputeShaderID LoadShader(ComputeShaderDesc& desc) = 0;
@@ -77,10 +97,19 @@ namespace Renderer
         // Unloading
         virtual void UnloadTexture(TextureID textureID) = 0;
         virtual void UnloadTexturesInArray(TextureArrayID textureArrayID, u32 unloadStartIndex) = 0;
+        // Every load into an array adds a reference to its index, this drops one per given index
+        // Textures without references left get unloaded and their indices get reused by later loads into the array
+        virtual void ReleaseTexturesInArray(TextureArrayID textureArrayID, const u32* arrayIndices, u32 numArrayIndices) = 0;
 
         // Command List Functions
         virtual CommandListID BeginCommandList() = 0;
         virtual void EndCommandList(CommandListID commandListID) = 0;
+
+        // Deferred command lists have to be begun on the render thread, after that each one can be recorded and ended on its own thread
+        // EndCommandList only closes them, SubmitCommandLists submits them together in the given order
+        virtual CommandListID BeginDeferredCommandList() = 0;
+        virtual void SubmitCommandLists(const CommandListID* commandListIDs, u32 numCommandLists) = 0;
+
         virtual void Clear(CommandListID commandListID, ImageID image, Color color) = 0;
         virtual void Clear(CommandListID commandListID, DepthImageID image, DepthClearFlags clearFlags, f32 depth, u8 stencil) = 0;
         virtual void Draw(CommandListID commandListID, u32 numVertices, u32 numInstances, u32 vertexOffset, u32 instanceOffset) = 0;
@@ -112,6 +141,7 @@ namespace Renderer
         virtual void PipelineBarrier(CommandListID commandListID, PipelineBarrierType type, BufferID buffer) = 0;
         virtual void ImageBarrier(CommandListID commandListID, ImageID image) = 0;
         virtual void DepthImageBarrier(CommandListID commandListID, DepthImageID image) = 0;
+        virtual void ImageBarriers(CommandListID commandListID, const ImageBarrierDesc* barriers, u32 numBarriers) = 0;
         virtual void PushConstant(CommandListID commandListID, void* data, u32 offset, u32 size) = 0;
         virtual void FillBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, u32 data) = 0;
         virtual void UpdateBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, void* data) = 0;
@@ -128,10 +158,30 @@ namespace Renderer
         virtual void FlipFrame(u32 frameIndex) = 0;
 
         virtual void CopyBuffer(BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range) = 0;
-        
+
+        // Staged uploads, these get gathered into batches that are submitted before the next command list or on SubmitUploads
+        // The returned memory has to be written before the next upload call since that call might submit the batch
+        virtual void* StageUpload(BufferID dstBuffer, u64 dstOffset, u64 size) = 0;
+        void UploadToBuffer(BufferID dstBuffer, u64 dstOffset, const void* data, u64 size);
+        virtual UploadBatchID SubmitUploads() = 0;
+        virtual bool IsUploadFinished(UploadBatchID batchID) = 0;
+        virtual void WaitForUpload(UploadBatchID batchID) = 0;
+
+        // CPU visible buffers stay mapped, unmapping them is only needed for symmetry
         virtual void* MapBuffer(BufferID buffer) = 0;
         virtual void UnmapBuffer(BufferID buffer) = 0;
 
+        // Per frame constants get sub-allocated from a mapped uniform buffer ring and bound with Bind(nameHash, allocation)
+        // The memory gets reused once the frame has been rendered, so it has to be written again every frame it gets bound
+        virtual FrameConstantsAllocation AllocateFrameConstants(u32 size) = 0;
+        FrameConstantsAllocation UploadFrameConstants(const void* data, u32 size);
+
+        template <typename T>
+        FrameConstantsAllocation UploadFrameConstants(const T& constants)
+        {
+            return UploadFrameConstants(&constants, sizeof(T));
+        }
+
         virtual const std::string& GetGPUName() = 0;
 
         virtual size_t GetVRAMUsage() = 0;
@@ -143,7 +193,18 @@ namespace Renderer
         virtual u32 GetNumImages() = 0;
         virtual u32 GetNumDepthImages() = 0;
 
+        // False for transient images the render graph being set up hasn't created, they won't have any memory this frame
+        virtual bool IsImageAvailable(ImageID imageID) = 0;
+        virtual bool IsImageAvailable(DepthImageID imageID) = 0;
+
+        // Render graphs record their command lists on these workers, the application hands in the pool it already runs everything else on
+        void SetTaskExecutor(std::shared_ptr<tf::Taskflow::Executor> taskExecutor) { _taskExecutor = std::move(taskExecutor); }
+        const std::shared_ptr<tf::Taskflow::Executor>& GetTaskExecutor();
+
     protected:
         Renderer() {}; // Pure virtual class, disallow creation of it
+
+    private:
+        std::shared_ptr<tf::Taskflow::Executor> _taskExecutor;
     };
 }
\ No newline at end of file
@@ -0,0 +1,947 @@
+#include "RendererNull.h"
+#include "../../../Window/Window.h"
+#include <Utils/DebugHandler.h>
+#include <Utils/XXHash64.h>
+#include <GLFW/glfw3.h>
+#include <cstring>
+#include <algorithm>
+
+#include "imgui/imgui.h"
+
+namespace Renderer
+{
+    static u32 PreviousPow2(u32 v)
+    {
+        u32 r = 1;
+
+        while (r * 2 < v)
+            r *= 2;
+
+        return r;
+    }
+
+    static u32 GetImageMipLevels(u32 width, u32 height)
+    {
+        u32 result = 1;
+
+        while (width > 1 || height > 1)
+        {
+            result++;
+            width /= 2;
+            height /= 2;
+        }
+
+        return result;
+    }
+
+    static void AddCounters(RendererNull::Counters& total, const RendererNull::Counters& frame)
+    {
+        total.numCommandLists += frame.numCommandLists;
+        total.numDraws += frame.numDraws;
+        total.numIndirectDraws += frame.numIndirectDraws;
+        total.numDispatches += frame.numDispatches;
+        total.numPipelineBinds += frame.numPipelineBinds;
+        total.numDescriptorSetBinds += frame.numDescriptorSetBinds;
+        total.numDescriptorSetWrites += frame.numDescriptorSetWrites;
+        total.numBarriers += frame.numBarriers;
+        total.numBarrierBatches += frame.numBarrierBatches;
+        total.numUploadedBytes += frame.numUploadedBytes;
+    }
+
+    RendererNull::RendererNull()
+    {
+        // Mirror RendererVK which always has the debug texture in slot 0
+        CreateTexture(0);
+    }
+
+    void RendererNull::InitWindow(Window* window)
+    {
+        ivec2 size;
+        glfwGetWindowSize(window->GetWindow(), &size.x, &size.y);
+
+        _windowSize = uvec2(glm::max(size.x, 1), glm::max(size.y, 1));
+    }
+
+    void RendererNull::Deinit()
+    {
+        _buffers.clear();
+        _freeBufferIDs.clear();
+        _temporaryBuffers.clear();
+    }
+
+    void RendererNull::ReloadShaders(bool /*forceRecompileAll*/)
+    {
+    }
+
+    BufferID RendererNull::CreateBuffer(BufferDesc& desc)
+    {
+        BufferID::type id;
+
+        if (!_freeBufferIDs.empty())
+        {
+            id = static_cast<BufferID::type>(_freeBufferIDs.back());
+            _freeBufferIDs.pop_back();
+        }
+        else
+        {
+            size_t nextHandle = _buffers.size();
+
+            // Make sure we haven't exceeded the limit of the BufferID type, if this hits you need to change type of BufferID to something bigger
+            if (nextHandle >= BufferID::MaxValue())
+            {
+                DebugHandler::PrintFatal("We exceeded the limit of the BufferID type!");
+            }
+
+            _buffers.emplace_back();
+            id = static_cast<BufferID::type>(nextHandle);
+        }
+
+        Buffer& buffer = _buffers[id];
+        buffer.size = desc.size;
+        buffer.memory.clear();
+
+        return BufferID(id);
+    }
+
+    BufferID RendererNull::CreateTemporaryBuffer(BufferDesc& desc, u32 framesLifetime)
+    {
+        BufferID bufferID = CreateBuffer(desc);
+
+        TemporaryBuffer& temporaryBuffer = _temporaryBuffers.emplace_back();
+        temporaryBuffer.bufferID = bufferID;
+        temporaryBuffer.framesLifetimeLeft = framesLifetime;
+
+        return bufferID;
+    }
+
+    void RendererNull::QueueDestroyBuffer(BufferID buffer)
+    {
+        // Nothing can be using it on a GPU, so there is no need to wait
+        DestroyBuffer(buffer);
+    }
+
+    ImageID RendererNull::CreateImage(ImageDesc& desc)
+    {
+        size_t nextHandle = _images.size();
+
+        if (nextHandle >= ImageID::MaxValue())
+        {
+            DebugHandler::PrintFatal("We exceeded the limit of the ImageID type!");
+        }
+
+        _images.push_back(desc);
+        return ImageID(static_cast<ImageID::type>(nextHandle));
+    }
+
+    DepthImageID RendererNull::CreateDepthImage(DepthImageDesc& desc)
+    {
+        size_t nextHandle = _depthImages.size();
+
+        if (nextHandle >= DepthImageID::MaxValue())
+        {
+            DebugHandler::PrintFatal("We exceeded the limit of the DepthImageID type!");
+        }
+
+        _depthImages.push_back(desc);
+        return DepthImageID(static_cast<DepthImageID::type>(nextHandle));
+    }
+
+    ImageID RendererNull::CreateTransientImage(ImageDesc& desc)
+    {
+        for (TransientImage& transient : _transientImages)
+        {
+            if (transient.isAcquired || transient.image == ImageID::Invalid())
+                continue;
+
+            const ImageDesc& transientDesc = _images[static_cast<ImageID::type>(transient.image)];
+            if (transientDesc.debugName == desc.debugName && transientDesc.dimensions == desc.dimensions && transientDesc.dimensionType == desc.dimensionType &&
+                transientDesc.depth == desc.depth && transientDesc.format == desc.format && transientDesc.sampleCount == desc.sampleCount)
+            {
+                transient.isAcquired = true;
+                return transient.image;
+            }
+        }
+
+        TransientImage& transient = _transientImages.emplace_back();
+        transient.image = CreateImage(desc);
+        transient.isAcquired = true;
+
+        return transient.image;
+    }
+
+    DepthImageID RendererNull::CreateTransientDepthImage(DepthImageDesc& desc)
+    {
+        for (TransientImage& transient : _transientImages)
+        {
+            if (transient.isAcquired || transient.depthImage == DepthImageID::Invalid())
+                continue;
+
+            const DepthImageDesc& transientDesc = _depthImages[static_cast<DepthImageID::type>(transient.depthImage)];
+            if (transientDesc.debugName == desc.debugName && transientDesc.dimensions == desc.dimensions && transientDesc.dimensionType == desc.dimensionType &&
+                transientDesc.format == desc.format && transientDesc.sampleCount == desc.sampleCount)
+            {
+                transient.isAcquired = true;
+                return transient.depthImage;
+            }
+        }
+
+        TransientImage& transient = _transientImages.emplace_back();
+        transient.depthImage = CreateDepthImage(desc);
+        transient.isAcquired = true;
+
+        return transient.depthImage;
+    }
+
+    void RendererNull::AllocateTransientImages(const TransientImageDesc* /*images*/, u32 /*numImages*/)
+    {
+        // There is no memory to alias, the next render graph just has to acquire its transient images again
+        for (TransientImage& transient : _transientImages)
+        {
+            transient.isAcquired = false;
+        }
+    }
+
+    SamplerID RendererNull::CreateSampler(SamplerDesc& /*desc*/)
+    {
+        return SamplerID(_numSamplers++);
+    }
+
+    GPUSemaphoreID RendererNull::CreateGPUSemaphore()
+    {
+        return GPUSemaphoreID(_numSemaphores++);
+    }
+
+    GraphicsPipelineID RendererNull::CreatePipeline(GraphicsPipelineDesc& /*desc*/)
+    {
+        return GraphicsPipelineID(_numGraphicsPipelines++);
+    }
+
+    ComputePipelineID RendererNull::CreatePipeline(ComputePipelineDesc& /*desc*/)
+    {
+        return ComputePipelineID(_numComputePipelines++);
+    }
+
+    TextureArrayID RendererNull::CreateTextureArray(TextureArrayDesc& desc)
+    {
+        if (desc.size == 0)
+        {
+            DebugHandler::PrintFatal("Tried to create a texture array with a size of zero!");
+        }
+
+        size_t nextHandle = _textureArrays.size();
+
+        if (nextHandle >= TextureArrayID::MaxValue())
+        {
+            DebugHandler::PrintFatal("We exceeded the limit of the TextureArrayID type!");
+        }
+
+        _textureArrays.emplace_back();
+        return TextureArrayID(static_cast<TextureArrayID::type>(nextHandle));
+    }
+
+    TextureID RendererNull::CreateDataTexture(DataTextureDesc& /*desc*/)
+    {
+        return CreateTexture(0);
+    }
+
+    TextureID RendererNull::CreateDataTextureIntoArray(DataTextureDesc& /*desc*/, TextureArrayID textureArray, u32& arrayIndex)
+    {
+        TextureID textureID = CreateTexture(0);
+
+        TextureArray& array = _textureArrays[static_cast<TextureArrayID::type>(textureArray)];
+        arrayIndex = AddToTextureArray(array, textureID);
+
+        return textureID;
+    }
+
+    void RendererNull::UpdateDataTexture(TextureID /*textureID*/, u32 /*x*/, u32 /*y*/, u32 /*width*/, u32 /*height*/, const void* /*data*/)
+    {
+        // Data texture formats aren't kept around, so the upload size is unknown and doesn't get counted
+    }
+
+    TextureID RendererNull::LoadTexture(TextureDesc& desc)
+    {
+        return LoadTexture(desc.path);
+    }
+
+    TextureID RendererNull::LoadTextureIntoArray(TextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex)
+    {
+        return LoadTextureIntoArray(desc.path, textureArray, arrayIndex);
+    }
+
+    TextureID RendererNull::LoadTextureAsync(TextureDesc& desc, f32 /*priority*/)
+    {
+        return LoadTexture(desc.path);
+    }
+
+    TextureID RendererNull::LoadTextureIntoArrayAsync(TextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex, f32 /*priority*/)
+    {
+        return LoadTextureIntoArray(desc.path, textureArray, arrayIndex);
+    }
+
+    VertexShaderID RendererNull::LoadShader(VertexShaderDesc& /*desc*/)
+    {
+        return VertexShaderID(_numVertexShaders++);
+    }
+
+    PixelShaderID RendererNull::LoadShader(PixelShaderDesc& /*desc*/)
+    {
+        return PixelShaderID(_numPixelShaders++);
+    }
+
+    ComputeShaderID RendererNull::LoadShader(ComputeShaderDesc& /*desc*/)
+    {
+        return ComputeShaderID(_numComputeShaders++);
+    }
+
+    void RendererNull::UnloadTexture(TextureID textureID)
+    {
+        u64& hash = _textureHashes[static_cast<TextureID::type>(textureID)];
+        if (hash == 0)
+            return;
+
+        auto itr = _hashToTexture.find(hash);
+        if (itr != _hashToTexture.end() && itr->second == textureID)
+        {
+            _hashToTexture.erase(itr);
+        }
+
+        hash = 0;
+    }
+
+    void RendererNull::UnloadTexturesInArray(TextureArrayID textureArrayID, u32 unloadStartIndex)
+    {
+        TextureArray& array = _textureArrays[static_cast<TextureArrayID::type>(textureArrayID)];
+
+        for (u32 i = unloadStartIndex; i < array.textures.size(); i++)
+        {
+            if (array.references[i] == 0)
+                continue;
+
+            TextureID textureID = array.textures[i];
+
+            array.hashToArrayIndex.erase(_textureHashes[static_cast<TextureID::type>(textureID)]);
+            UnloadTexture(textureID);
+        }
+
+        if (unloadStartIndex < array.textures.size())
+        {
+            array.textures.resize(unloadStartIndex);
+            array.references.resize(unloadStartIndex);
+        }
+
+        auto removedIndices = std::remove_if(array.freeArrayIndices.begin(), array.freeArrayIndices.end(), [unloadStartIndex](u32 arrayIndex) { return arrayIndex >= unloadStartIndex; });
+        array.freeArrayIndices.erase(removedIndices, array.freeArrayIndices.end());
+    }
+
+    void RendererNull::ReleaseTexturesInArray(TextureArrayID textureArrayID, const u32* arrayIndices, u32 numArrayIndices)
+    {
+        TextureArray& array = _textureArrays[static_cast<TextureArrayID::type>(textureArrayID)];
+
+        for (u32 i = 0; i < numArrayIndices; i++)
+        {
+            u32 arrayIndex = arrayIndices[i];
+            if (arrayIndex >= array.textures.size() || array.references[arrayIndex] == 0)
+            {
+                DebugHandler::PrintFatal("Tried to release index %u in a texture array which isn't in use", arrayIndex);
+            }
+
+            if (--array.references[arrayIndex] > 0)
+                continue;
+
+            TextureID textureID = array.textures[arrayIndex];
+
+            array.hashToArrayIndex.erase(_textureHashes[static_cast<TextureID::type>(textureID)]);
+            UnloadTexture(textureID);
+
+            array.textures[arrayIndex] = TextureID::Invalid();
+            array.freeArrayIndices.push_back(arrayIndex);
+        }
+    }
+
+    CommandListID RendererNull::BeginCommandList()
+    {
+        _frameCounters.numCommandLists++;
+
+        CommandListID::type id = _nextCommandListID++;
+        if (id >= _commandLists.size())
+        {
+            _commandLists.resize(static_cast<size_t>(id) + 1);
+        }
+
+        _commandLists[id] = CommandList();
+        return CommandListID(id);
+    }
+
+    void RendererNull::EndCommandList(CommandListID commandListID)
+    {
+        CommandList& commandList = GetCommandList(commandListID);
+
+        // Deferred command lists might be ended on a worker, their counters get added in SubmitCommandLists
+        if (!commandList.isDeferred)
+        {
+            AddCounters(_frameCounters, commandList.counters);
+            CountDescriptorSetWrites(commandList);
+        }
+    }
+
+    CommandListID RendererNull::BeginDeferredCommandList()
+    {
+        CommandListID commandListID = BeginCommandList();
+        GetCommandList(commandListID).isDeferred = true;
+
+        return commandListID;
+    }
+
+    void RendererNull::SubmitCommandLists(const CommandListID* commandListIDs, u32 numCommandLists)
+    {
+        for (u32 i = 0; i < numCommandLists; i++)
+        {
+            CommandList& commandList = GetCommandList(commandListIDs[i]);
+
+            AddCounters(_frameCounters, commandList.counters);
+            CountDescriptorSetWrites(commandList);
+        }
+    }
+
+    void RendererNull::Clear(CommandListID /*commandListID*/, ImageID /*image*/, Color /*color*/)
+    {
+    }
+
+    void RendererNull::Clear(CommandListID /*commandListID*/, DepthImageID /*image*/, DepthClearFlags /*clearFlags*/, f32 /*depth*/, u8 /*stencil*/)
+    {
+    }
+
+    void RendererNull::Draw(CommandListID commandListID, u32 /*numVertices*/, u32 /*numInstances*/, u32 /*vertexOffset*/, u32 /*instanceOffset*/)
+    {
+        GetCommandList(commandListID).counters.numDraws++;
+    }
+
+    void RendererNull::DrawIndirect(CommandListID commandListID, BufferID /*argumentBuffer*/, u32 /*argumentBufferOffset*/, u32 /*drawCount*/)
+    {
+        GetCommandList(commandListID).counters.numIndirectDraws++;
+    }
+
+    void RendererNull::DrawIndexed(CommandListID commandListID, u32 /*numIndices*/, u32 /*numInstances*/, u32 /*indexOffset*/, u32 /*vertexOffset*/, u32 /*instanceOffset*/)
+    {
+        GetCommandList(commandListID).counters.numDraws++;
+    }
+
+    void RendererNull::DrawIndexedIndirect(CommandListID commandListID, BufferID /*argumentBuffer*/, u32 /*argumentBufferOffset*/, u32 /*drawCount*/)
+    {
+        GetCommandList(commandListID).counters.numIndirectDraws++;
+    }
+
+    void RendererNull::DrawIndexedIndirectCount(CommandListID commandListID, BufferID /*argumentBuffer*/, u32 /*argumentBufferOffset*/, BufferID /*drawCountBuffer*/, u32 /*drawCountBufferOffset*/, u32 /*maxDrawCount*/)
+    {
+        GetCommandList(commandListID).counters.numIndirectDraws++;
+    }
+
+    void RendererNull::Dispatch(CommandListID commandListID, u32 /*threadGroupCountX*/, u32 /*threadGroupCountY*/, u32 /*threadGroupCountZ*/)
+    {
+        GetCommandList(commandListID).counters.numDispatches++;
+    }
+
+    void RendererNull::DispatchIndirect(CommandListID commandListID, BufferID /*argumentBuffer*/, u32 /*argumentBufferOffset*/)
+    {
+        GetCommandList(commandListID).counters.numDispatches++;
+    }
+
+    void RendererNull::PopMarker(CommandListID /*commandListID*/)
+    {
+    }
+
+    void RendererNull::PushMarker(CommandListID /*commandListID*/, Color /*color*/, std::string /*name*/)
+    {
+    }
+
+    void RendererNull::BeginPipeline(CommandListID commandListID, GraphicsPipelineID /*pipeline*/)
+    {
+        GetCommandList(commandListID).counters.numPipelineBinds++;
+    }
+
+    void RendererNull::EndPipeline(CommandListID /*commandListID*/, GraphicsPipelineID /*pipeline*/)
+    {
+    }
+
+    void RendererNull::BeginPipeline(CommandListID commandListID, ComputePipelineID /*pipeline*/)
+    {
+        GetCommandList(commandListID).counters.numPipelineBinds++;
+    }
+
+    void RendererNull::EndPipeline(CommandListID /*commandListID*/, ComputePipelineID /*pipeline*/)
+    {
+    }
+
+    void RendererNull::SetScissorRect(CommandListID /*commandListID*/, ScissorRect /*scissorRect*/)
+    {
+    }
+
+    void RendererNull::SetViewport(CommandListID /*commandListID*/, Viewport /*viewport*/)
+    {
+    }
+
+    void RendererNull::SetVertexBuffer(CommandListID /*commandListID*/, u32 /*slot*/, BufferID /*bufferID*/)
+    {
+    }
+
+    void RendererNull::SetIndexBuffer(CommandListID /*commandListID*/, BufferID /*bufferID*/, IndexFormat /*indexFormat*/)
+    {
+    }
+
+    void RendererNull::SetBuffer(CommandListID /*commandListID*/, u32 /*slot*/, BufferID /*buffer*/)
+    {
+    }
+
+    void RendererNull::BindDescriptorSet(CommandListID commandListID, DescriptorSetSlot slot, Descriptor* descriptors, u32 numDescriptors)
+    {
+        CommandList& commandList = GetCommandList(commandListID);
+        commandList.counters.numDescriptorSetBinds++;
+
+        // Same idea as the key RendererVK caches descriptor sets by, just with IDs since there are no views or buffers to resolve
+        struct DescriptorKey
+        {
+            u32 nameHash;
+            u32 descriptorType;
+            u32 id;
+            u32 imageMipLevel;
+        };
+
+        u64 key = static_cast<u64>(slot);
+        for (u32 i = 0; i < numDescriptors; i++)
+        {
+            const Descriptor& descriptor = descriptors[i];
+
+            DescriptorKey descriptorKey;
+            descriptorKey.nameHash = descriptor.nameHash;
+            descriptorKey.descriptorType = static_cast<u32>(descriptor.descriptorType);
+            descriptorKey.imageMipLevel = 0;
+
+            switch (descriptor.descriptorType)
+            {
+                case DescriptorType::DESCRIPTOR_TYPE_SAMPLER:
+                    descriptorKey.id = static_cast<SamplerID::type>(descriptor.samplerID);
+                    break;
+                case DescriptorType::DESCRIPTOR_TYPE_TEXTURE:
+                    descriptorKey.id = static_cast<TextureID::type>(descriptor.textureID);
+                    break;
+                case DescriptorType::DESCRIPTOR_TYPE_TEXTURE_ARRAY:
+                    descriptorKey.id = static_cast<TextureArrayID::type>(descriptor.textureArrayID);
+                    break;
+                case DescriptorType::DESCRIPTOR_TYPE_IMAGE:
+                case DescriptorType::DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                    descriptorKey.id = static_cast<ImageID::type>(descriptor.imageID);
+                    descriptorKey.imageMipLevel = descriptor.imageMipLevel;
+                    break;
+                case DescriptorType::DESCRIPTOR_TYPE_DEPTH_IMAGE:
+                    descriptorKey.id = static_cast<DepthImageID::type>(descriptor.depthImageID);
+                    break;
+                case DescriptorType::DESCRIPTOR_TYPE_BUFFER:
+                    descriptorKey.id = static_cast<BufferID::type>(descriptor.bufferID);
+                    break;
+                default:
+                    descriptorKey.id = 0;
+                    break;
+            }
+
+            key = XXHash64::hash(&descriptorKey, sizeof(DescriptorKey), key);
+        }
+
+        commandList.descriptorSetKeys.insert(key);
+    }
+
+    void RendererNull::MarkFrameStart(CommandListID /*commandListID*/, u32 /*frameIndex*/)
+    {
+    }
+
+    void RendererNull::BeginTrace(CommandListID /*commandListID*/, const tracy::SourceLocationData* /*sourceLocation*/)
+    {
+    }
+
+    void RendererNull::EndTrace(CommandListID /*commandListID*/)
+    {
+    }
+
+    void RendererNull::AddSignalSemaphore(CommandListID /*commandListID*/, GPUSemaphoreID /*semaphoreID*/)
+    {
+    }
+
+    void RendererNull::AddWaitSemaphore(CommandListID /*commandListID*/, GPUSemaphoreID /*semaphoreID*/)
+    {
+    }
+
+    void RendererNull::CopyImage(CommandListID /*commandListID*/, ImageID /*dstImageID*/, uvec2 /*dstPos*/, u32 /*dstMipLevel*/, ImageID /*srcImageID*/, uvec2 /*srcPos*/, u32 /*srcMipLevel*/, uvec2 /*size*/)
+    {
+    }
+
+    void RendererNull::CopyBuffer(CommandListID /*commandListID*/, BufferID /*dstBuffer*/, u64 /*dstOffset*/, BufferID /*srcBuffer*/, u64 /*srcOffset*/, u64 /*range*/)
+    {
+    }
+
+    void RendererNull::PipelineBarrier(CommandListID commandListID, PipelineBarrierType /*type*/, BufferID /*buffer*/)
+    {
+        GetCommandList(commandListID).counters.numBarriers++;
+    }
+
+    void RendererNull::ImageBarrier(CommandListID commandListID, ImageID /*image*/)
+    {
+        GetCommandList(commandListID).counters.numBarriers++;
+    }
+
+    void RendererNull::DepthImageBarrier(CommandListID commandListID, DepthImageID /*image*/)
+    {
+        GetCommandList(commandListID).counters.numBarriers++;
+    }
+
+    void RendererNull::ImageBarriers(CommandListID commandListID, const ImageBarrierDesc* /*barriers*/, u32 numBarriers)
+    {
+        CommandList& commandList = GetCommandList(commandListID);
+        commandList.counters.numBarriers += numBarriers;
+        commandList.counters.numBarrierBatches++;
+    }
+
+    void RendererNull::PushConstant(CommandListID /*commandListID*/, void* /*data*/, u32 /*offset*/, u32 /*size*/)
+    {
+    }
+
+    void RendererNull::FillBuffer(CommandListID /*commandListID*/, BufferID /*dstBuffer*/, u64 /*dstOffset*/, u64 /*size*/, u32 /*data*/)
+    {
+    }
+
+    void RendererNull::UpdateBuffer(CommandListID commandListID, BufferID /*dstBuffer*/, u64 /*dstOffset*/, u64 size, void* /*data*/)
+    {
+        GetCommandList(commandListID).counters.numUploadedBytes += size;
+    }
+
+    void RendererNull::Present(Window* /*window*/, ImageID /*image*/, GPUSemaphoreID /*semaphoreID*/)
+    {
+    }
+
+    void RendererNull::Present(Window* /*window*/, DepthImageID /*image*/, GPUSemaphoreID /*semaphoreID*/)
+    {
+    }
+
+    void RendererNull::FlipFrame(u32 /*frameIndex*/)
+    {
+        AddCounters(_totalCounters, _frameCounters);
+        _lastFrameCounters = _frameCounters;
+        _frameCounters = Counters();
+        _frameDescriptorSetKeys.clear();
+        _frameConstantsOffset = 0;
+
+        for (size_t i = _temporaryBuffers.size(); i > 0; i--)
+        {
+            TemporaryBuffer& temporaryBuffer = _temporaryBuffers[i - 1];
+
+            if (temporaryBuffer.framesLifetimeLeft > 0)
+            {
+                temporaryBuffer.framesLifetimeLeft--;
+                continue;
+            }
+
+            DestroyBuffer(temporaryBuffer.bufferID);
+
+            temporaryBuffer = _temporaryBuffers.back();
+            _temporaryBuffers.pop_back();
+        }
+    }
+
+    ImageDesc RendererNull::GetImageDesc(ImageID ID)
+    {
+        return _images[static_cast<ImageID::type>(ID)];
+    }
+
+    DepthImageDesc RendererNull::GetDepthImageDesc(DepthImageID ID)
+    {
+        return _depthImages[static_cast<DepthImageID::type>(ID)];
+    }
+
+    uvec2 RendererNull::GetImageDimension(const ImageID id, u32 mipLevel)
+    {
+        const ImageDesc& desc = _images[static_cast<ImageID::type>(id)];
+
+        u32 width = static_cast<u32>(desc.dimensions.x);
+        u32 height = static_cast<u32>(desc.dimensions.y);
+        u32 mips = desc.mipLevels;
+
+        // Same rules as ImageHandlerVK::GetDimension
+        if (desc.dimensionType == ImageDimensionType::DIMENSION_SCALE)
+        {
+            width = static_cast<u32>(desc.dimensions.x * _windowSize.x);
+            height = static_cast<u32>(desc.dimensions.y * _windowSize.y);
+        }
+        else if (desc.dimensionType == ImageDimensionType::DIMENSION_PYRAMID)
+        {
+            width = PreviousPow2(static_cast<u32>(desc.dimensions.x * _windowSize.x));
+            height = PreviousPow2(static_cast<u32>(desc.dimensions.y * _windowSize.y));
+            mips = GetImageMipLevels(width, height);
+        }
+
+        u32 mip = glm::min(mips, mipLevel);
+
+        return { width >> mip, height >> mip };
+    }
+
+    void RendererNull::CopyBuffer(BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range)
+    {
+        Buffer& src = _buffers[static_cast<BufferID::type>(srcBuffer)];
+        if (src.memory.empty())
+            return;
+
+        u8* dst = GetBufferMemory(dstBuffer);
+        memcpy(dst + dstOffset, src.memory.data() + srcOffset, range);
+    }
+
+    void* RendererNull::StageUpload(BufferID dstBuffer, u64 dstOffset, u64 size)
+    {
+        CountUpload(size);
+
+        // Buffers the CPU has mapped keep the data so it can be read back, every other upload is thrown away
+        Buffer& buffer = _buffers[static_cast<BufferID::type>(dstBuffer)];
+        if (!buffer.memory.empty())
+        {
+            return buffer.memory.data() + dstOffset;
+        }
+
+        if (_uploadScratchMemory.size() < size)
+        {
+            _uploadScratchMemory.resize(size);
+        }
+
+        return _uploadScratchMemory.data();
+    }
+
+    UploadBatchID RendererNull::SubmitUploads()
+    {
+        return UploadBatchID(_numSubmittedUploadBatches++);
+    }
+
+    bool RendererNull::IsUploadFinished(UploadBatchID /*batchID*/)
+    {
+        return true;
+    }
+
+    void RendererNull::WaitForUpload(UploadBatchID /*batchID*/)
+    {
+    }
+
+    void* RendererNull::MapBuffer(BufferID buffer)
+    {
+        return GetBufferMemory(buffer);
+    }
+
+    void RendererNull::UnmapBuffer(BufferID /*buffer*/)
+    {
+    }
+
+    FrameConstantsAllocation RendererNull::AllocateFrameConstants(u32 size)
+    {
+        std::lock_guard<std::mutex> lock(_frameConstantsMutex);
+
+        // Same alignment the Vulkan renderer ends up with on most GPUs
+        const u32 alignedSize = (size + 255) & ~255u;
+        if (_frameConstantsOffset + alignedSize > _frameConstantsSize)
+        {
+            u32 newSize = std::max(_frameConstantsSize * 2, 1024u * 1024u);
+            while (newSize < alignedSize)
+            {
+                newSize *= 2;
+            }
+
+            // Memory handed out earlier this frame has to stay valid until the frame is over
+            if (_frameConstantsBuffer != BufferID::Invalid())
+            {
+                TemporaryBuffer& temporaryBuffer = _temporaryBuffers.emplace_back();
+                temporaryBuffer.bufferID = _frameConstantsBuffer;
+                temporaryBuffer.framesLifetimeLeft = 0;
+            }
+
+            BufferDesc desc;
+            desc.name = "FrameConstantsRing";
+            desc.size = newSize;
+            desc.usage = BufferUsage::UNIFORM_BUFFER;
+            desc.cpuAccess = BufferCPUAccess::WriteOnly;
+
+            _frameConstantsBuffer = CreateBuffer(desc);
+            _frameConstantsSize = newSize;
+            _frameConstantsOffset = 0;
+        }
+
+        FrameConstantsAllocation allocation;
+        allocation.buffer = _frameConstantsBuffer;
+        allocation.offset = _frameConstantsOffset;
+        allocation.size = size;
+        allocation.mappedMemory = GetBufferMemory(_frameConstantsBuffer) + _frameConstantsOffset;
+
+        _frameConstantsOffset += alignedSize;
+
+        return allocation;
+    }
+
+    const std::string& RendererNull::GetGPUName()
+    {
+        static const std::string gpuName = "Null Renderer";
+        return gpuName;
+    }
+
+    size_t RendererNull::GetVRAMUsage()
+    {
+        return 0;
+    }
+
+    size_t RendererNull::GetVRAMBudget()
+    {
+        return 0;
+    }
+
+    void RendererNull::InitImgui()
+    {
+        // There is no backend to build the font atlas for us, ImGui::NewFrame asserts without it
+        u8* pixels;
+        i32 width;
+        i32 height;
+        ImGui::GetIO().Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    }
+
+    void RendererNull::DrawImgui(CommandListID /*commandListID*/)
+    {
+    }
+
+    u32 RendererNull::GetNumImages()
+    {
+        return static_cast<u32>(_images.size());
+    }
+
+    u32 RendererNull::GetNumDepthImages()
+    {
+        return static_cast<u32>(_depthImages.size());
+    }
+
+    bool RendererNull::IsImageAvailable(ImageID imageID)
+    {
+        for (const TransientImage& transient : _transientImages)
+        {
+            if (transient.image == imageID)
+                return transient.isAcquired;
+        }
+
+        return true;
+    }
+
+    bool RendererNull::IsImageAvailable(DepthImageID imageID)
+    {
+        for (const TransientImage& transient : _transientImages)
+        {
+            if (transient.depthImage == imageID)
+                return transient.isAcquired;
+        }
+
+        return true;
+    }
+
+    RendererNull::CommandList& RendererNull::GetCommandList(CommandListID commandListID)
+    {
+        return _commandLists[static_cast<CommandListID::type>(commandListID)];
+    }
+
+    u8* RendererNull::GetBufferMemory(BufferID bufferID)
+    {
+        Buffer& buffer = _buffers[static_cast<BufferID::type>(bufferID)];
+        if (buffer.memory.empty())
+        {
+            buffer.memory.resize(buffer.size);
+        }
+
+        return buffer.memory.data();
+    }
+
+    void RendererNull::DestroyBuffer(BufferID bufferID)
+    {
+        Buffer& buffer = _buffers[static_cast<BufferID::type>(bufferID)];
+        buffer.size = 0;
+        buffer.memory = std::vector<u8>();
+
+        _freeBufferIDs.push_back(bufferID);
+    }
+
+    TextureID RendererNull::LoadTexture(const std::string& path)
+    {
+        u64 hash = XXHash64::hash(path.c_str(), path.size(), 0);
+
+        auto itr = _hashToTexture.find(hash);
+        if (itr != _hashToTexture.end())
+            return itr->second;
+
+        TextureID textureID = CreateTexture(hash);
+        _hashToTexture[hash] = textureID;
+
+        return textureID;
+    }
+
+    TextureID RendererNull::LoadTextureIntoArray(const std::string& path, TextureArrayID textureArrayID, u32& arrayIndex)
+    {
+        TextureArray& array = _textureArrays[static_cast<TextureArrayID::type>(textureArrayID)];
+        u64 hash = XXHash64::hash(path.c_str(), path.size(), 0);
+
+        auto itr = array.hashToArrayIndex.find(hash);
+        if (itr != array.hashToArrayIndex.end())
+        {
+            arrayIndex = itr->second;
+            array.references[arrayIndex]++;
+            return array.textures[arrayIndex];
+        }
+
+        TextureID textureID = LoadTexture(path);
+
+        arrayIndex = AddToTextureArray(array, textureID);
+        array.hashToArrayIndex[hash] = arrayIndex;
+
+        return textureID;
+    }
+
+    u32 RendererNull::AddToTextureArray(TextureArray& array, TextureID textureID)
+    {
+        if (!array.freeArrayIndices.empty())
+        {
+            u32 arrayIndex = array.freeArrayIndices.back();
+            array.freeArrayIndices.pop_back();
+
+            array.textures[arrayIndex] = textureID;
+            array.references[arrayIndex] = 1;
+            return arrayIndex;
+        }
+
+        array.textures.push_back(textureID);
+        array.references.push_back(1);
+        return static_cast<u32>(array.textures.size() - 1);
+    }
+
+    TextureID RendererNull::CreateTexture(u64 hash)
+    {
+        size_t nextHandle = _textureHashes.size();
+
+        if (nextHandle >= TextureID::MaxValue())
+        {
+            DebugHandler::PrintFatal("We exceeded the limit of the TextureID type!");
+        }
+
+        _textureHashes.push_back(hash);
+        return TextureID(static_cast<TextureID::type>(nextHandle));
+    }
+
+    void RendererNull::CountUpload(u64 size)
+    {
+        _frameCounters.numUploadedBytes += size;
+    }
+
+    void RendererNull::CountDescriptorSetWrites(const CommandList& commandList)
+    {
+        for (u64 key : commandList.descriptorSetKeys)
+        {
+            if (_frameDescriptorSetKeys.insert(key).second)
+            {
+                _frameCounters.numDescriptorSetWrites++;
+            }
+        }
+    }
+}
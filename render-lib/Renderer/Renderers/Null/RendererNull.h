@@ -0,0 +1,246 @@
+#pragma once
+#include "../../Renderer.h"
+#include <robin_hood.h>
+#include <vector>
+#include <mutex>
+
+namespace Renderer
+{
+    // Renderer without a GPU, it hands out valid IDs and counts what the executed command lists would have done
+    // Lets us profile and soak test the CPU side of the client on machines without a GPU
+    class RendererNull : public Renderer
+    {
+    public:
+        struct Counters
+        {
+            u32 numCommandLists = 0;
+            u32 numDraws = 0;
+            u32 numIndirectDraws = 0;
+            u32 numDispatches = 0;
+            u32 numPipelineBinds = 0;
+            u32 numDescriptorSetBinds = 0;
+            u32 numDescriptorSetWrites = 0; // Binds with a slot and descriptors that weren't bound before in the same frame, what a descriptor set cache has to write at most
+            u32 numBarriers = 0;
+            u32 numBarrierBatches = 0; // The barriers the render graph derives for a pass get batched together
+            u64 numUploadedBytes = 0;
+        };
+
+        RendererNull();
+
+        void InitWindow(Window* window) override;
+        void Deinit() override;
+
+        void ReloadShaders(bool forceRecompileAll) override;
+
+        // Creation
+        BufferID CreateBuffer(BufferDesc& desc) override;
+        BufferID CreateTemporaryBuffer(BufferDesc& desc, u32 framesLifetime) override;
+        void QueueDestroyBuffer(BufferID buffer) override;
+
+        ImageID CreateImage(ImageDesc& desc) override;
+        DepthImageID CreateDepthImage(DepthImageDesc& desc) override;
+
+        ImageID CreateTransientImage(ImageDesc& desc) override;
+        DepthImageID CreateTransientDepthImage(DepthImageDesc& desc) override;
+        void AllocateTransientImages(const TransientImageDesc* images, u32 numImages) override;
+
+        SamplerID CreateSampler(SamplerDesc& desc) override;
+        GPUSemaphoreID CreateGPUSemaphore() override;
+
+        GraphicsPipelineID CreatePipeline(GraphicsPipelineDesc& desc) override;
+        ComputePipelineID CreatePipeline(ComputePipelineDesc& desc) override;
+
+        TextureArrayID CreateTextureArray(TextureArrayDesc& desc) override;
+
+        TextureID CreateDataTexture(DataTextureDesc& desc) override;
+        TextureID CreateDataTextureIntoArray(DataTextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex) override;
+        void UpdateDataTexture(TextureID textureID, u32 x, u32 y, u32 width, u32 height, const void* data) override;
+
+        // Loading
+        TextureID LoadTexture(TextureDesc& desc) override;
+        TextureID LoadTextureIntoArray(TextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex) override;
+        TextureID LoadTextureAsync(TextureDesc& desc, f32 priority) override;
+        TextureID LoadTextureIntoArrayAsync(TextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex, f32 priority) override;
+
+        VertexShaderID LoadShader(VertexShaderDesc& desc) override;
+        PixelShaderID LoadShader(PixelShaderDesc& desc) override;
+        ComputeShaderID LoadShader(ComputeShaderDesc& desc) override;
+
+        // Unloading
+        void UnloadTexture(TextureID textureID) override;
+        void UnloadTexturesInArray(TextureArrayID textureArrayID, u32 unloadStartIndex) override;
+        void ReleaseTexturesInArray(TextureArrayID textureArrayID, const u32* arrayIndices, u32 numArrayIndices) override;
+
+        // Command List Functions
+        CommandListID BeginCommandList() override;
+        void EndCommandList(CommandListID commandListID) override;
+        CommandListID BeginDeferredCommandList() override;
+        void SubmitCommandLists(const CommandListID* commandListIDs, u32 numCommandLists) override;
+        void Clear(CommandListID commandListID, ImageID image, Color color) override;
+        void Clear(CommandListID commandListID, DepthImageID image, DepthClearFlags clearFlags, f32 depth, u8 stencil) override;
+        void Draw(CommandListID commandListID, u32 numVertices, u32 numInstances, u32 vertexOffset, u32 instanceOffset) override;
+        void DrawIndirect(CommandListID commandListID, BufferID argumentBuffer, u32 argumentBufferOffset, u32 drawCount) override;
+        void DrawIndexed(CommandListID commandListID, u32 numIndices, u32 numInstances, u32 indexOffset, u32 vertexOffset, u32 instanceOffset) override;
+        void DrawIndexedIndirect(CommandListID commandListID, BufferID argumentBuffer, u32 argumentBufferOffset, u32 drawCount) override;
+        void DrawIndexedIndirectCount(CommandListID commandListID, BufferID argumentBuffer, u32 argumentBufferOffset, BufferID drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount) override;
+        void Dispatch(CommandListID commandListID, u32 threadGroupCountX, u32 threadGroupCountY, u32 threadGroupCountZ) override;
+        void DispatchIndirect(CommandListID commandListID, BufferID argumentBuffer, u32 argumentBufferOffset) override;
+        void PopMarker(CommandListID commandListID) override;
+        void PushMarker(CommandListID commandListID, Color color, std::string name) override;
+        void BeginPipeline(CommandListID commandListID, GraphicsPipelineID pipeline) override;
+        void EndPipeline(CommandListID commandListID, GraphicsPipelineID pipeline) override;
+        void BeginPipeline(CommandListID commandListID, ComputePipelineID pipeline) override;
+        void EndPipeline(CommandListID commandListID, ComputePipelineID pipeline) override;
+        void SetScissorRect(CommandListID commandListID, ScissorRect scissorRect) override;
+        void SetViewport(CommandListID commandListID, Viewport viewport) override;
+        void SetVertexBuffer(CommandListID commandListID, u32 slot, BufferID bufferID) override;
+        void SetIndexBuffer(CommandListID commandListID, BufferID bufferID, IndexFormat indexFormat) override;
+        void SetBuffer(CommandListID commandListID, u32 slot, BufferID buffer) override;
+        void BindDescriptorSet(CommandListID commandListID, DescriptorSetSlot slot, Descriptor* descriptors, u32 numDescriptors) override;
+        void MarkFrameStart(CommandListID commandListID, u32 frameIndex) override;
+        void BeginTrace(CommandListID commandListID, const tracy::SourceLocationData* sourceLocation) override;
+        void EndTrace(CommandListID commandListID) override;
+        void AddSignalSemaphore(CommandListID commandListID, GPUSemaphoreID semaphoreID) override;
+        void AddWaitSemaphore(CommandListID commandListID, GPUSemaphoreID semaphoreID) override;
+        void CopyImage(CommandListID commandListID, ImageID dstImageID, uvec2 dstPos, u32 dstMipLevel, ImageID srcImageID, uvec2 srcPos, u32 srcMipLevel, uvec2 size) override;
+        void CopyBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range) override;
+        void PipelineBarrier(CommandListID commandListID, PipelineBarrierType type, BufferID buffer) override;
+        void ImageBarrier(CommandListID commandListID, ImageID image) override;
+        void DepthImageBarrier(CommandListID commandListID, DepthImageID image) override;
+        void ImageBarriers(CommandListID commandListID, const ImageBarrierDesc* barriers, u32 numBarriers) override;
+        void PushConstant(CommandListID commandListID, void* data, u32 offset, u32 size) override;
+        void FillBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, u32 data) override;
+        void UpdateBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, void* data) override;
+
+        // Non-commandlist based present functions
+        void Present(Window* window, ImageID image, GPUSemaphoreID semaphoreID = GPUSemaphoreID::Invalid()) override;
+        void Present(Window* window, DepthImageID image, GPUSemaphoreID semaphoreID = GPUSemaphoreID::Invalid()) override;
+
+        // Utils
+        void FlipFrame(u32 frameIndex) override;
+
+        ImageDesc GetImageDesc(ImageID ID) override;
+        DepthImageDesc GetDepthImageDesc(DepthImageID ID) override;
+
+        uvec2 GetImageDimension(const ImageID id, u32 mipLevel) override;
+
+        void CopyBuffer(BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range) override;
+
+        void* StageUpload(BufferID dstBuffer, u64 dstOffset, u64 size) override;
+        UploadBatchID SubmitUploads() override;
+        bool IsUploadFinished(UploadBatchID batchID) override;
+        void WaitForUpload(UploadBatchID batchID) override;
+
+        void* MapBuffer(BufferID buffer) override;
+        void UnmapBuffer(BufferID buffer) override;
+
+        FrameConstantsAllocation AllocateFrameConstants(u32 size) override;
+
+        const std::string& GetGPUName() override;
+
+        size_t GetVRAMUsage() override;
+        size_t GetVRAMBudget() override;
+
+        void InitImgui() override;
+        void DrawImgui(CommandListID commandListID) override;
+
+        u32 GetNumImages() override;
+        u32 GetNumDepthImages() override;
+
+        bool IsImageAvailable(ImageID imageID) override;
+        bool IsImageAvailable(DepthImageID imageID) override;
+
+        // Counters of the last finished frame, and of everything since the renderer was created
+        const Counters& GetFrameCounters() const { return _lastFrameCounters; }
+        const Counters& GetTotalCounters() const { return _totalCounters; }
+
+    private:
+        struct Buffer
+        {
+            u64 size = 0;
+            std::vector<u8> memory; // Only allocated once the buffer gets mapped or written to by the CPU
+        };
+
+        // Commands only count into their own command list so deferred command lists can be recorded in parallel
+        struct CommandList
+        {
+            Counters counters;
+            robin_hood::unordered_set<u64> descriptorSetKeys;
+            bool isDeferred = false;
+        };
+
+        struct TemporaryBuffer
+        {
+            BufferID bufferID;
+            u32 framesLifetimeLeft;
+        };
+
+        // Transient images keep their ID between frames, the render graph acquires them again every frame
+        struct TransientImage
+        {
+            ImageID image = ImageID::Invalid();
+            DepthImageID depthImage = DepthImageID::Invalid();
+            bool isAcquired = false;
+        };
+
+        struct TextureArray
+        {
+            std::vector<TextureID> textures;
+            std::vector<u32> references; // Released indices hold an invalid TextureID until they get reused
+            std::vector<u32> freeArrayIndices;
+            robin_hood::unordered_map<u64, u32> hashToArrayIndex;
+        };
+
+        CommandList& GetCommandList(CommandListID commandListID);
+        u8* GetBufferMemory(BufferID bufferID);
+        void DestroyBuffer(BufferID bufferID);
+
+        TextureID LoadTexture(const std::string& path);
+        TextureID LoadTextureIntoArray(const std::string& path, TextureArrayID textureArrayID, u32& arrayIndex);
+        TextureID CreateTexture(u64 hash);
+        u32 AddToTextureArray(TextureArray& array, TextureID textureID);
+
+        void CountUpload(u64 size);
+        void CountDescriptorSetWrites(const CommandList& commandList);
+
+    private:
+        uvec2 _windowSize = uvec2(1, 1);
+
+        std::vector<Buffer> _buffers;
+        std::vector<BufferID> _freeBufferIDs;
+        std::vector<TemporaryBuffer> _temporaryBuffers;
+
+        std::vector<ImageDesc> _images;
+        std::vector<DepthImageDesc> _depthImages;
+        std::vector<TransientImage> _transientImages;
+
+        u16 _numSamplers = 0;
+        u16 _numSemaphores = 0;
+        u16 _numGraphicsPipelines = 0;
+        u16 _numComputePipelines = 0;
+        u16 _numVertexShaders = 0;
+        u16 _numPixelShaders = 0;
+        u16 _numComputeShaders = 0;
+        CommandListID::type _nextCommandListID = 0;
+        std::vector<CommandList> _commandLists;
+
+        std::vector<u64> _textureHashes; // Indexed by TextureID, 0 for data textures and unloaded textures
+        robin_hood::unordered_map<u64, TextureID> _hashToTexture;
+        std::vector<TextureArray> _textureArrays;
+
+        std::vector<u8> _uploadScratchMemory; // Uploads into buffers the CPU never reads go here and get dropped
+
+        // Nothing reads the constants after the frame, so a single ring gets reused every frame
+        BufferID _frameConstantsBuffer = BufferID::Invalid();
+        u32 _frameConstantsSize = 0;
+        u32 _frameConstantsOffset = 0;
+        std::mutex _frameConstantsMutex; // Render graph passes get recorded in parallel
+        UploadBatchID::type _numSubmittedUploadBatches = 0;
+
+        robin_hood::unordered_set<u64> _frameDescriptorSetKeys;
+
+        Counters _frameCounters;
+        Counters _lastFrameCounters;
+        Counters _totalCounters;
+    };
+}
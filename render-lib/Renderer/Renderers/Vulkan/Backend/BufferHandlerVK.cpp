@@ -1,6 +1,7 @@
 #include "BufferHandlerVK.h"
 #include "RenderDeviceVK.h"
 #include "DebugMarkerUtilVK.h"
+#include "DescriptorSetBuilderVK.h"
 
 #include <vector>
 #include <queue>
@@ -15,6 +16,7 @@ namespace Renderer
             VmaAllocation allocation;
             VkBuffer buffer;
             VkDeviceSize size;
+            void* mappedMemory = nullptr; // CPU visible buffers stay mapped for their whole lifetime
         };
 
         struct TemporaryBuffer
@@ -82,6 +84,14 @@ namespace Renderer
             return data.buffers[static_cast<BufferID::type>(bufferID)].allocation;
         }
 
+        void* BufferHandlerVK::GetMappedMemory(BufferID bufferID) const
+        {
+            BufferHandlerVKData& data = static_cast<BufferHandlerVKData&>(*_data);
+
+            assert(bufferID != BufferID::Invalid());
+            return data.buffers[static_cast<BufferID::type>(bufferID)].mappedMemory;
+        }
+
         BufferID BufferHandlerVK::CreateBuffer(BufferDesc& desc)
         {
             BufferHandlerVKData& data = static_cast<BufferHandlerVKData&>(*_data);
@@ -142,15 +152,23 @@ namespace Renderer
             VmaAllocationCreateInfo allocInfo = {};
             allocInfo.usage = memoryUsage;
 
+            // Mapping is not free, so CPU visible buffers get mapped once instead of every time they get written
+            if (desc.cpuAccess != BufferCPUAccess::None)
+            {
+                allocInfo.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            }
+
             const BufferID bufferID = AcquireNewBufferID();
             Buffer& buffer = data.buffers[(BufferID::type)bufferID];
             buffer.size = desc.size;
 
-            if (vmaCreateBuffer(_device->_allocator, &bufferInfo, &allocInfo, &buffer.buffer, &buffer.allocation, nullptr) != VK_SUCCESS)
+            VmaAllocationInfo allocationInfo;
+            if (vmaCreateBuffer(_device->_allocator, &bufferInfo, &allocInfo, &buffer.buffer, &buffer.allocation, &allocationInfo) != VK_SUCCESS)
             {
                 DebugHandler::PrintFatal("Failed to create buffer!");
                 return BufferID::Invalid();
             }
+            buffer.mappedMemory = allocationInfo.pMappedData;
 
             DebugMarkerUtilVK::SetObjectName(_device->_device, (u64)buffer.buffer, VK_DEBUG_REPORT_OBJECT_TYPE_BUFFER_EXT, desc.name.c_str());
 
@@ -174,7 +192,9 @@ namespace Renderer
 
             Buffer& buffer = data.buffers[(BufferID::type)bufferID];
 
+            _device->_descriptorMegaPool->OnHandleDestroyed(DescriptorMegaPoolVK::GetHandleKey(buffer.buffer));
             vmaDestroyBuffer(_device->_allocator, buffer.buffer, buffer.allocation);
+            buffer.mappedMemory = nullptr;
 
             ReturnBufferID(bufferID);
         }
@@ -23,6 +23,7 @@ namespace Renderer
             VkBuffer GetBuffer(BufferID bufferID) const;
             VkDeviceSize GetBufferSize(BufferID bufferID) const;
             VmaAllocation GetBufferAllocation(BufferID bufferID) const;
+            void* GetMappedMemory(BufferID bufferID) const; // nullptr for buffers the CPU can't access
 
             BufferID CreateBuffer(BufferDesc& desc);
             BufferID CreateTemporaryBuffer(BufferDesc& desc, u32 framesLifetime);
@@ -25,6 +25,14 @@ namespace Renderer
 
             GraphicsPipelineID boundGraphicsPipeline = GraphicsPipelineID::Invalid();
             ComputePipelineID boundComputePipeline = ComputePipelineID::Invalid();
+            i8 renderPassOpenCount = 0;
+
+            Viewport viewport;
+            ScissorRect scissorRect;
+            bool hasViewport = false;
+            bool hasScissorRect = false;
+
+            bool isDeferred = false;
         };
 
         struct CommandListHandlerVKData : ICommandListHandlerVKData
@@ -159,13 +167,92 @@ namespace Renderer
                 vkQueueSubmit(_device->_graphicsQueue, 1, &submitInfo, fence);
             }
 
-            commandList.waitSemaphores.clear();
-            commandList.signalSemaphores.clear();
-            commandList.boundGraphicsPipeline = GraphicsPipelineID::Invalid();
-
+            ResetCommandListState(id);
             data.closedCommandLists.Get(data.frameIndex).push(id);
         }
 
+        CommandListID CommandListHandlerVK::BeginDeferredCommandList()
+        {
+            CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
+
+            CommandListID id = BeginCommandList();
+            data.commandLists[static_cast<CommandListID::type>(id)].isDeferred = true;
+
+            return id;
+        }
+
+        void CommandListHandlerVK::EndDeferredCommandList(CommandListID id)
+        {
+            CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
+
+            // Lets make sure this id exists
+            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+
+            CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
+            assert(commandList.isDeferred); // Non deferred command lists get closed and submitted by EndCommandList
+
+            // Only touches this command list so it is safe to call from the thread that recorded it
+            if (vkEndCommandBuffer(commandList.commandBuffer) != VK_SUCCESS)
+            {
+                DebugHandler::PrintFatal("Failed to record command buffer!");
+            }
+        }
+
+        void CommandListHandlerVK::SubmitCommandLists(const CommandListID* ids, u32 numIDs, VkFence fence)
+        {
+            ZoneScopedC(tracy::Color::Red3);
+
+            CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
+
+            std::vector<VkCommandBuffer> commandBuffers;
+            std::vector<VkSemaphore> waitSemaphores;
+            std::vector<VkSemaphore> signalSemaphores;
+            commandBuffers.reserve(numIDs);
+
+            // A single submit executes the command buffers in the order they are given, so the result matches recording everything into one command list
+            for (u32 i = 0; i < numIDs; i++)
+            {
+                CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(ids[i])];
+                assert(commandList.isDeferred); // Only deferred command lists can be submitted together
+
+                commandBuffers.push_back(commandList.commandBuffer);
+                waitSemaphores.insert(waitSemaphores.end(), commandList.waitSemaphores.begin(), commandList.waitSemaphores.end());
+                signalSemaphores.insert(signalSemaphores.end(), commandList.signalSemaphores.begin(), commandList.signalSemaphores.end());
+            }
+
+            std::vector<VkPipelineStageFlags> dstStageMasks(waitSemaphores.size(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = static_cast<u32>(commandBuffers.size());
+            submitInfo.pCommandBuffers = commandBuffers.data();
+
+            submitInfo.waitSemaphoreCount = static_cast<u32>(waitSemaphores.size());
+            submitInfo.pWaitSemaphores = waitSemaphores.data();
+            submitInfo.pWaitDstStageMask = dstStageMasks.data();
+
+            submitInfo.signalSemaphoreCount = static_cast<u32>(signalSemaphores.size());
+            submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+            vkQueueSubmit(_device->_graphicsQueue, 1, &submitInfo, fence);
+
+            for (u32 i = 0; i < numIDs; i++)
+            {
+                ResetCommandListState(ids[i]);
+                data.closedCommandLists.Get(data.frameIndex).push(ids[i]);
+            }
+        }
+
+        bool CommandListHandlerVK::IsDeferred(CommandListID id)
+        {
+            CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
+
+            // Lets make sure this id exists
+            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+
+            return data.commandLists[static_cast<CommandListID::type>(id)].isDeferred;
+        }
+
         VkCommandBuffer CommandListHandlerVK::GetCommandBuffer(CommandListID id)
         {
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
@@ -246,6 +333,68 @@ namespace Renderer
             return data.commandLists[static_cast<CommandListID::type>(id)].boundComputePipeline;
         }
 
+        i8& CommandListHandlerVK::GetRenderPassOpenCount(CommandListID id)
+        {
+            CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
+
+            // Lets make sure this id exists
+            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+
+            return data.commandLists[static_cast<CommandListID::type>(id)].renderPassOpenCount;
+        }
+
+        void CommandListHandlerVK::SetViewport(CommandListID id, const Viewport& viewport)
+        {
+            CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
+
+            // Lets make sure this id exists
+            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+
+            CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
+
+            commandList.viewport = viewport;
+            commandList.hasViewport = true;
+        }
+
+        void CommandListHandlerVK::SetScissorRect(CommandListID id, const ScissorRect& scissorRect)
+        {
+            CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
+
+            // Lets make sure this id exists
+            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+
+            CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
+
+            commandList.scissorRect = scissorRect;
+            commandList.hasScissorRect = true;
+        }
+
+        bool CommandListHandlerVK::GetViewport(CommandListID id, Viewport& viewport)
+        {
+            CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
+
+            // Lets make sure this id exists
+            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+
+            CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
+
+            viewport = commandList.viewport;
+            return commandList.hasViewport;
+        }
+
+        bool CommandListHandlerVK::GetScissorRect(CommandListID id, ScissorRect& scissorRect)
+        {
+            CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
+
+            // Lets make sure this id exists
+            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+
+            CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
+
+            scissorRect = commandList.scissorRect;
+            return commandList.hasScissorRect;
+        }
+
         tracy::VkCtxManualScope*& CommandListHandlerVK::GetTracyScope(CommandListID id)
         {
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
@@ -311,5 +460,21 @@ namespace Renderer
 
             return CommandListID(static_cast<CommandListID::type>(id));
         }
+
+        void CommandListHandlerVK::ResetCommandListState(CommandListID id)
+        {
+            CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
+
+            CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
+
+            commandList.waitSemaphores.clear();
+            commandList.signalSemaphores.clear();
+            commandList.boundGraphicsPipeline = GraphicsPipelineID::Invalid();
+            commandList.boundComputePipeline = ComputePipelineID::Invalid();
+            commandList.renderPassOpenCount = 0;
+            commandList.hasViewport = false;
+            commandList.hasScissorRect = false;
+            commandList.isDeferred = false;
+        }
     }
 }
\ No newline at end of file
@@ -31,6 +31,12 @@ namespace Renderer
             CommandListID BeginCommandList();
             void EndCommandList(CommandListID id, VkFence fence);
 
+            // Deferred command lists only get closed by EndDeferredCommandList, they can be recorded on any thread and are submitted together in order by SubmitCommandLists
+            CommandListID BeginDeferredCommandList();
+            void EndDeferredCommandList(CommandListID id);
+            void SubmitCommandLists(const CommandListID* ids, u32 numIDs, VkFence fence);
+            bool IsDeferred(CommandListID id);
+
             VkCommandBuffer GetCommandBuffer(CommandListID id);
 
             void AddWaitSemaphore(CommandListID id, VkSemaphore semaphore);
@@ -42,12 +48,22 @@ namespace Renderer
             GraphicsPipelineID GetBoundGraphicsPipeline(CommandListID id);
             ComputePipelineID GetBoundComputePipeline(CommandListID id);
 
+            i8& GetRenderPassOpenCount(CommandListID id);
+
+            void SetViewport(CommandListID id, const Viewport& viewport);
+            void SetScissorRect(CommandListID id, const ScissorRect& scissorRect);
+
+            // Returns false if the command list never set a viewport or scissor rect
+            bool GetViewport(CommandListID id, Viewport& viewport);
+            bool GetScissorRect(CommandListID id, ScissorRect& scissorRect);
+
             tracy::VkCtxManualScope*& GetTracyScope(CommandListID id);
 
             VkFence GetCurrentFence();
 
         private:
             CommandListID CreateCommandList();
+            void ResetCommandListState(CommandListID id);
 
         private:
 
@@ -47,9 +47,9 @@ namespace Renderer
                 { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f},
                 { VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1.0f},
                 { VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1.0f},
-                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f},
+                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0f},
                 { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f},
-                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 2.0f},
                 { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f},
                 { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1.0f}
             };
@@ -64,8 +64,9 @@ namespace Renderer
             void Flip() override final;
             DescriptorAllocatorHandleVK GetAllocator() override final;
 
+            VkDescriptorPool CreatePool(i32 count, VkDescriptorPoolCreateFlags flags) override final;
+
             void ReturnAllocator(DescriptorAllocatorHandleVK& handle, bool isFull);
-            VkDescriptorPool CreatePool(i32 count, VkDescriptorPoolCreateFlags flags);
 
             RenderDeviceVK* _device;
             PoolSizes _poolSizes;
@@ -37,6 +37,7 @@ namespace Renderer
             static DescriptorAllocatorPoolVK* Create(RenderDeviceVK* device, i32 numFrames = 3);
 
             virtual void SetPoolSizeMultiplier(VkDescriptorType type, f32 multiplier) = 0;
+            virtual VkDescriptorPool CreatePool(i32 count, VkDescriptorPoolCreateFlags flags) = 0;
             
             virtual void Flip() = 0;
             virtual DescriptorAllocatorHandleVK GetAllocator() = 0;
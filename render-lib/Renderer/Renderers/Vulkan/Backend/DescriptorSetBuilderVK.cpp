@@ -4,7 +4,9 @@
 #include "RenderDeviceVK.h"
 
 #include <Utils/StringUtils.h>
+#include <Utils/DebugHandler.h>
 #include <vulkan/vulkan.h>
+#include <algorithm>
 
 namespace Renderer
 {
@@ -89,17 +91,53 @@ namespace Renderer
                 const Backend::BindReflection& bindReflection = _shaderHandler->GetBindReflection(desc.computeShader);
                 _bindInfos.insert(_bindInfos.end(), bindReflection.dataBindings.begin(), bindReflection.dataBindings.end());
             }
+
+            // Emplace keeps the first bind info of a name, which is the one the old linear search found
+            _nameHashToBindInfoIndex.reserve(_bindInfos.size());
+            for (u32 i = 0; i < _bindInfos.size(); i++)
+            {
+                _nameHashToBindInfoIndex.emplace(_bindInfos[i].nameHash, i);
+            }
+
+            // Dynamic offsets get passed in binding order, not in the order the shaders declared them
+            std::vector<u32> dynamicBindInfoIndices;
+            for (u32 i = 0; i < _bindInfos.size(); i++)
+            {
+                if (_bindInfos[i].descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+                {
+                    dynamicBindInfoIndices.push_back(i);
+                }
+            }
+
+            std::sort(dynamicBindInfoIndices.begin(), dynamicBindInfoIndices.end(), [&](u32 a, u32 b)
+            {
+                return GetBindingKey(_bindInfos[a].set, _bindInfos[a].binding) < GetBindingKey(_bindInfos[b].set, _bindInfos[b].binding);
+            });
+
+            for (u32 bindInfoIndex : dynamicBindInfoIndices)
+            {
+                const BindInfo& bindInfo = _bindInfos[bindInfoIndex];
+                if (bindInfo.set >= _numDynamicOffsets.size())
+                {
+                    _numDynamicOffsets.resize(bindInfo.set + 1, 0);
+                }
+
+                DynamicOffsetSlot dynamicOffset;
+                dynamicOffset.set = static_cast<i32>(bindInfo.set);
+                dynamicOffset.index = _numDynamicOffsets[bindInfo.set]++;
+
+                _nameHashToDynamicOffset.emplace(bindInfo.nameHash, dynamicOffset);
+            }
         }
 
         void DescriptorSetBuilderVK::BindSampler(i32 set, i32 binding, VkDescriptorImageInfo& imageInfo)
         {
-            for (auto& imageWrite : _imageWrites)
+            auto itr = _bindingToImageWriteIndex.find(GetBindingKey(set, binding));
+            if (itr != _bindingToImageWriteIndex.end())
             {
-                if (imageWrite.dstBinding == binding && imageWrite.dstSet == set)
-                {
-                    imageWrite.imageInfo = imageInfo;
-                    return;
-                }
+                ImageWriteDescriptor& imageWrite = _imageWrites[itr->second];
+                imageWrite.imageInfo = imageInfo;
+                return;
             }
 
             ImageWriteDescriptor newWrite;
@@ -108,31 +146,29 @@ namespace Renderer
             newWrite.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
             newWrite.imageInfo = imageInfo;
             
+            _bindingToImageWriteIndex[GetBindingKey(set, binding)] = static_cast<u32>(_imageWrites.size());
             _imageWrites.push_back(newWrite);
         }
 
         void DescriptorSetBuilderVK::BindSampler(u32 nameHash, VkDescriptorImageInfo& imageInfo)
         {
-            for (auto& bindInfo : _bindInfos)
+            auto itr = _nameHashToBindInfoIndex.find(nameHash);
+            if (itr != _nameHashToBindInfoIndex.end())
             {
-                if (nameHash == bindInfo.nameHash)
-                {
-                    BindSampler(bindInfo.set, bindInfo.binding, imageInfo);
-                    return;
-                }
+                const BindInfo& bindInfo = _bindInfos[itr->second];
+                BindSampler(bindInfo.set, bindInfo.binding, imageInfo);
             }
         }
 
         void DescriptorSetBuilderVK::BindImageArray(i32 set, i32 binding, VkDescriptorImageInfo* images, i32 count)
         {
-            for (auto& imageWrite : _imageWrites)
+            auto itr = _bindingToImageWriteIndex.find(GetBindingKey(set, binding));
+            if (itr != _bindingToImageWriteIndex.end())
             {
-                if (imageWrite.dstBinding == binding && imageWrite.dstSet == set)
-                {
-                    imageWrite.imageArray = images;
-                    imageWrite.imageCount = count;
-                    return;
-                }
+                ImageWriteDescriptor& imageWrite = _imageWrites[itr->second];
+                imageWrite.imageArray = images;
+                imageWrite.imageCount = count;
+                return;
             }
 
             ImageWriteDescriptor newWrite;
@@ -142,30 +178,28 @@ namespace Renderer
             newWrite.imageArray = images;
             newWrite.imageCount = count;
 
+            _bindingToImageWriteIndex[GetBindingKey(set, binding)] = static_cast<u32>(_imageWrites.size());
             _imageWrites.push_back(newWrite);
         }
 
         void DescriptorSetBuilderVK::BindImageArray(u32 nameHash, VkDescriptorImageInfo* images, i32 count)
         {
-            for (auto& bindInfo : _bindInfos)
+            auto itr = _nameHashToBindInfoIndex.find(nameHash);
+            if (itr != _nameHashToBindInfoIndex.end())
             {
-                if (nameHash == bindInfo.nameHash)
-                {
-                    BindImageArray(bindInfo.set, bindInfo.binding, images, count);
-                    return;
-                }
+                const BindInfo& bindInfo = _bindInfos[itr->second];
+                BindImageArray(bindInfo.set, bindInfo.binding, images, count);
             }
         }
 
         void DescriptorSetBuilderVK::BindImage(i32 set, i32 binding, const VkDescriptorImageInfo& imageInfo, bool imageWrite)
         {
-            for (auto& imageWrite : _imageWrites) 
+            auto itr = _bindingToImageWriteIndex.find(GetBindingKey(set, binding));
+            if (itr != _bindingToImageWriteIndex.end())
             {
-                if (imageWrite.dstBinding == binding && imageWrite.dstSet == set)
-                {
-                    imageWrite.imageInfo = imageInfo;
-                    return;
-                }
+                ImageWriteDescriptor& imageWrite = _imageWrites[itr->second];
+                imageWrite.imageInfo = imageInfo;
+                return;
             }
 
             ImageWriteDescriptor newWrite;
@@ -178,44 +212,40 @@ namespace Renderer
                 newWrite.imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             }
 
+            _bindingToImageWriteIndex[GetBindingKey(set, binding)] = static_cast<u32>(_imageWrites.size());
             _imageWrites.push_back(newWrite);
         }
 
         void DescriptorSetBuilderVK::BindImage(u32 nameHash, const VkDescriptorImageInfo& imageInfo)
         {
-            for (auto& bindInfo : _bindInfos)
+            auto itr = _nameHashToBindInfoIndex.find(nameHash);
+            if (itr != _nameHashToBindInfoIndex.end())
             {
-                if (nameHash == bindInfo.nameHash)
-                {
-                    BindImage(bindInfo.set, bindInfo.binding, imageInfo);
-                    return;
-                }
+                const BindInfo& bindInfo = _bindInfos[itr->second];
+                BindImage(bindInfo.set, bindInfo.binding, imageInfo);
             }
         }
 
 
         void DescriptorSetBuilderVK::BindStorageImage(u32 nameHash, const VkDescriptorImageInfo& imageInfo)
         {
-            for (auto& bindInfo : _bindInfos)
+            auto itr = _nameHashToBindInfoIndex.find(nameHash);
+            if (itr != _nameHashToBindInfoIndex.end())
             {
-                if (nameHash == bindInfo.nameHash)
-                {
-                    BindStorageImage(bindInfo.set, bindInfo.binding, imageInfo);
-                    return;
-                }
+                const BindInfo& bindInfo = _bindInfos[itr->second];
+                BindStorageImage(bindInfo.set, bindInfo.binding, imageInfo);
             }
         }
 
 
         void DescriptorSetBuilderVK::BindStorageImage(i32 set, i32 binding, const VkDescriptorImageInfo& imageInfo)
         {
-            for (auto& imageWrite : _imageWrites)
+            auto itr = _bindingToImageWriteIndex.find(GetBindingKey(set, binding));
+            if (itr != _bindingToImageWriteIndex.end())
             {
-                if (imageWrite.dstBinding == binding && imageWrite.dstSet == set)
-                {
-                    imageWrite.imageInfo = imageInfo;
-                    return;
-                }
+                ImageWriteDescriptor& imageWrite = _imageWrites[itr->second];
+                imageWrite.imageInfo = imageInfo;
+                return;
             }
 
             ImageWriteDescriptor newWrite;
@@ -224,19 +254,19 @@ namespace Renderer
             newWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
             newWrite.imageInfo = imageInfo;
 
+            _bindingToImageWriteIndex[GetBindingKey(set, binding)] = static_cast<u32>(_imageWrites.size());
             _imageWrites.push_back(newWrite);
         }
 
         void DescriptorSetBuilderVK::BindBuffer(i32 set, i32 binding, const VkDescriptorBufferInfo& bufferInfo, VkDescriptorType bufferType)
         {
-            for (auto& bufferWrite : _bufferWrites) 
+            auto itr = _bindingToBufferWriteIndex.find(GetBindingKey(set, binding));
+            if (itr != _bindingToBufferWriteIndex.end())
             {
-                if (bufferWrite.dstBinding == binding && bufferWrite.dstSet == set)
-                {
-                    bufferWrite.bufferInfo = bufferInfo;
-                    bufferWrite.descriptorType = bufferType;
-                    return;
-                }
+                BufferWriteDescriptor& bufferWrite = _bufferWrites[itr->second];
+                bufferWrite.bufferInfo = bufferInfo;
+                bufferWrite.descriptorType = bufferType;
+                return;
             }
 
             BufferWriteDescriptor newWrite;
@@ -245,30 +275,28 @@ namespace Renderer
             newWrite.descriptorType = bufferType;
             newWrite.bufferInfo = bufferInfo;
 
+            _bindingToBufferWriteIndex[GetBindingKey(set, binding)] = static_cast<u32>(_bufferWrites.size());
             _bufferWrites.push_back(newWrite);
         }
 
         void DescriptorSetBuilderVK::BindBuffer(u32 nameHash, const VkDescriptorBufferInfo& bufferInfo)
         {
-            for (auto& bindInfo : _bindInfos)
+            auto itr = _nameHashToBindInfoIndex.find(nameHash);
+            if (itr != _nameHashToBindInfoIndex.end())
             {
-                if (nameHash == bindInfo.nameHash)
-                {
-                    BindBuffer(bindInfo.set, bindInfo.binding, bufferInfo, bindInfo.descriptorType);
-                    return;
-                }
+                const BindInfo& bindInfo = _bindInfos[itr->second];
+                BindBuffer(bindInfo.set, bindInfo.binding, bufferInfo, bindInfo.descriptorType);
             }
         }
 
         void DescriptorSetBuilderVK::BindRayStructure(i32 set, i32 binding, const VkWriteDescriptorSetAccelerationStructureKHR& info)
         {
-            for (auto& bufferWrite : _bufferWrites)
+            auto itr = _bindingToBufferWriteIndex.find(GetBindingKey(set, binding));
+            if (itr != _bindingToBufferWriteIndex.end())
             {
-                if (bufferWrite.dstBinding == binding && bufferWrite.dstSet == set)
-                {
-                    bufferWrite.accelinfo = info;
-                    return;
-                }
+                BufferWriteDescriptor& bufferWrite = _bufferWrites[itr->second];
+                bufferWrite.accelinfo = info;
+                return;
             }
 
             BufferWriteDescriptor newWrite;
@@ -277,18 +305,17 @@ namespace Renderer
             newWrite.descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
             newWrite.accelinfo = info;
 
+            _bindingToBufferWriteIndex[GetBindingKey(set, binding)] = static_cast<u32>(_bufferWrites.size());
             _bufferWrites.push_back(newWrite);
         }
 
         void DescriptorSetBuilderVK::BindRayStructure(u32 nameHash, const VkWriteDescriptorSetAccelerationStructureKHR& info)
         {
-            for (auto& bindInfo : _bindInfos)
+            auto itr = _nameHashToBindInfoIndex.find(nameHash);
+            if (itr != _nameHashToBindInfoIndex.end())
             {
-                if (nameHash == bindInfo.nameHash)
-                {
-                    BindRayStructure(bindInfo.set, bindInfo.binding, info);
-                    return;
-                }
+                const BindInfo& bindInfo = _bindInfos[itr->second];
+                BindRayStructure(bindInfo.set, bindInfo.binding, info);
             }
         }
 
@@ -351,38 +378,80 @@ namespace Renderer
 
         VkDescriptorSet DescriptorSetBuilderVK::BuildDescriptor(i32 set, DescriptorLifetime lifetime)
         {
-            VkDescriptorSetLayout* layout; 
+            VkDescriptorSetLayout layout = GetDescriptorSetLayout(set);
+
+            u32 count;
+            VkDescriptorSetVariableDescriptorCountAllocateInfo setCounts = {};
+            void* next = GetVariableDescriptorCount(set, count, setCounts);
+
+            VkDescriptorSet newSet = _parentPool->AllocateDescriptor(layout, lifetime, next);
+            UpdateDescriptor(set, newSet, *_parentPool->_device);
+            return newSet;
+        }
+
+        VkDescriptorSet DescriptorSetBuilderVK::BuildCachedDescriptor(i32 set, u64 key)
+        {
+            VkDescriptorSetLayout layout = GetDescriptorSetLayout(set);
+
+            u32 count;
+            VkDescriptorSetVariableDescriptorCountAllocateInfo setCounts = {};
+            void* next = GetVariableDescriptorCount(set, count, setCounts);
+
+            VkDescriptorSet newSet = _parentPool->AllocateCachedDescriptor(key, layout, next);
+            UpdateDescriptor(set, newSet, *_parentPool->_device);
+            return newSet;
+        }
+
+        u32 DescriptorSetBuilderVK::GetNumDynamicOffsets(i32 set) const
+        {
+            if (set < 0 || static_cast<size_t>(set) >= _numDynamicOffsets.size())
+                return 0;
+
+            return _numDynamicOffsets[set];
+        }
+
+        bool DescriptorSetBuilderVK::GetDynamicOffsetIndex(u32 nameHash, i32 set, u32& outIndex) const
+        {
+            auto itr = _nameHashToDynamicOffset.find(nameHash);
+            if (itr == _nameHashToDynamicOffset.end() || itr->second.set != set)
+                return false;
+
+            outIndex = itr->second.index;
+            return true;
+        }
+
+        VkDescriptorSetLayout DescriptorSetBuilderVK::GetDescriptorSetLayout(i32 set)
+        {
             if (_pipelineType == PipelineType::Graphics)
             {
-                layout = &_pipelineHandler->GetDescriptorSetLayout(_graphicsPipelineID, set);
+                return _pipelineHandler->GetDescriptorSetLayout(_graphicsPipelineID, set);
             }
             else
             {
-                layout = &_pipelineHandler->GetDescriptorSetLayout(_computePipelineID, set);
+                return _pipelineHandler->GetDescriptorSetLayout(_computePipelineID, set);
             }
+        }
 
+        void* DescriptorSetBuilderVK::GetVariableDescriptorCount(i32 set, u32& count, VkDescriptorSetVariableDescriptorCountAllocateInfo& setCounts)
+        {
             void* next = nullptr;
-            u32 counts[1];
-            counts[0] = 4096;
+            count = 4096;
 
-            VkDescriptorSetVariableDescriptorCountAllocateInfo setCounts = {};
             setCounts.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
             setCounts.pNext = nullptr;
             setCounts.descriptorSetCount = 1;
-            setCounts.pDescriptorCounts = counts;
+            setCounts.pDescriptorCounts = &count;
 
             for (const ImageWriteDescriptor& imageWrite : _imageWrites)
             {
                 if (imageWrite.imageArray != nullptr && imageWrite.dstSet == set)
                 {
-                    counts[0] = imageWrite.imageCount;
+                    count = imageWrite.imageCount;
                     next = &setCounts;
                 }
             }
 
-            VkDescriptorSet newSet = _parentPool->AllocateDescriptor(*layout, lifetime, next);
-            UpdateDescriptor(set, newSet, *_parentPool->_device);
-            return newSet;
+            return next;
         }
 
         VkDescriptorSet DescriptorMegaPoolVK::AllocateDescriptor(VkDescriptorSetLayout layout, DescriptorLifetime lifetime, void* next)
@@ -404,6 +473,7 @@ namespace Renderer
         void DescriptorMegaPoolVK::Init(i32 numFrames, RenderDeviceVK* device)
         {
             _device = device;
+            _numFrames = numFrames;
 
             _dynamicAllocatorPool = DescriptorAllocatorPoolVK::Create(device, numFrames);
             _staticAllocatorPool = DescriptorAllocatorPoolVK::Create(device, 1);
@@ -415,6 +485,132 @@ namespace Renderer
         {
             _dynamicAllocatorPool->Flip();
             _dynamicHandle = _dynamicAllocatorPool->GetAllocator();
+
+            std::lock_guard<std::mutex> lock(_cacheMutex);
+            _frameNumber++;
+
+            // Sets that haven't been bound for a while are unlikely to come back, a set is only safe to free once its last frame has passed its fence
+            for (auto itr = _cachedDescriptorSets.begin(); itr != _cachedDescriptorSets.end();)
+            {
+                if (_frameNumber - itr->second.lastUsedFrame > CACHED_DESCRIPTOR_SET_LIFETIME)
+                {
+                    _retiredDescriptorSets.push_back(itr->second);
+                    itr = _cachedDescriptorSets.erase(itr);
+                }
+                else
+                {
+                    itr++;
+                }
+            }
+
+            if (_cachedDescriptorSets.empty())
+            {
+                _cachedHandles.clear();
+            }
+
+            for (size_t i = _retiredDescriptorSets.size(); i > 0; i--)
+            {
+                CachedDescriptorSetVK& retiredSet = _retiredDescriptorSets[i - 1];
+
+                if (_frameNumber - retiredSet.lastUsedFrame < static_cast<u64>(_numFrames))
+                    continue;
+
+                vkFreeDescriptorSets(_device->_device, retiredSet.pool, 1, &retiredSet.set);
+
+                retiredSet = _retiredDescriptorSets.back();
+                _retiredDescriptorSets.pop_back();
+            }
+        }
+
+        bool DescriptorMegaPoolVK::TryGetCachedDescriptor(u64 key, VkDescriptorSet& outSet)
+        {
+            std::lock_guard<std::mutex> lock(_cacheMutex);
+
+            auto itr = _cachedDescriptorSets.find(key);
+            if (itr == _cachedDescriptorSets.end())
+                return false;
+
+            itr->second.lastUsedFrame = _frameNumber;
+            outSet = itr->second.set;
+            return true;
+        }
+
+        VkDescriptorSet DescriptorMegaPoolVK::AllocateCachedDescriptor(u64 key, VkDescriptorSetLayout layout, void* next)
+        {
+            std::lock_guard<std::mutex> lock(_cacheMutex);
+
+            VkDescriptorSetAllocateInfo allocInfo = {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocInfo.pNext = next;
+            allocInfo.descriptorSetCount = 1;
+            allocInfo.pSetLayouts = &layout;
+
+            CachedDescriptorSetVK cachedSet;
+            cachedSet.lastUsedFrame = _frameNumber;
+
+            // Cached sets get freed one by one, so every pool can have room again and the newest pools are the most likely to have it
+            for (size_t i = _cachePools.size(); i > 0; i--)
+            {
+                allocInfo.descriptorPool = _cachePools[i - 1];
+
+                VkResult result = vkAllocateDescriptorSets(_device->_device, &allocInfo, &cachedSet.set);
+                if (result == VK_SUCCESS)
+                {
+                    cachedSet.pool = allocInfo.descriptorPool;
+                    break;
+                }
+
+                if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+                {
+                    DebugHandler::PrintFatal("Could not allocate cached descriptor set");
+                }
+            }
+
+            if (cachedSet.pool == VK_NULL_HANDLE)
+            {
+                allocInfo.descriptorPool = _staticAllocatorPool->CreatePool(CACHED_DESCRIPTOR_POOL_SIZE, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+                _cachePools.push_back(allocInfo.descriptorPool);
+
+                if (vkAllocateDescriptorSets(_device->_device, &allocInfo, &cachedSet.set) != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("Could not allocate cached descriptor set");
+                }
+                cachedSet.pool = allocInfo.descriptorPool;
+            }
+
+            _cachedDescriptorSets[key] = cachedSet;
+            return cachedSet.set;
+        }
+
+        void DescriptorMegaPoolVK::AddCachedHandle(u64 handle)
+        {
+            std::lock_guard<std::mutex> lock(_cacheMutex);
+            _cachedHandles.insert(handle);
+        }
+
+        void DescriptorMegaPoolVK::OnHandleDestroyed(u64 handle)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_cacheMutex);
+                if (_cachedHandles.find(handle) == _cachedHandles.end())
+                    return;
+            }
+
+            FlushCachedDescriptors();
+        }
+
+        void DescriptorMegaPoolVK::FlushCachedDescriptors()
+        {
+            std::lock_guard<std::mutex> lock(_cacheMutex);
+
+            // Frames in flight might still use these, SetFrame frees them once they can't
+            for (auto& pair : _cachedDescriptorSets)
+            {
+                _retiredDescriptorSets.push_back(pair.second);
+            }
+
+            _cachedDescriptorSets.clear();
+            _cachedHandles.clear();
         }
     }
 }
\ No newline at end of file
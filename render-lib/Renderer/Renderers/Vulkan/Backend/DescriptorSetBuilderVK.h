@@ -1,7 +1,9 @@
 #pragma once
 #include <NovusTypes.h>
 #include <vector>
+#include <mutex>
 #include <vulkan/vulkan_core.h>
+#include <robin_hood.h>
 
 #include "DescriptorAllocatorVK.h"
 #include "ShaderHandlerVK.h"
@@ -53,6 +55,13 @@ namespace Renderer
             void UpdateDescriptor(i32 set, VkDescriptorSet& descriptor, RenderDeviceVK& device);
             VkDescriptorSet BuildDescriptor(i32 set, DescriptorLifetime lifetime);
 
+            // Builds the set into the cache of the parent pool, the next bind with the same key can take it from there without building anything
+            VkDescriptorSet BuildCachedDescriptor(i32 set, u64 key);
+
+            // Uniform buffers are dynamic, binding a set takes one offset per uniform buffer in it ordered by binding
+            u32 GetNumDynamicOffsets(i32 set) const;
+            bool GetDynamicOffsetIndex(u32 nameHash, i32 set, u32& outIndex) const;
+
         private:
             enum class PipelineType
             {
@@ -79,6 +88,17 @@ namespace Renderer
                 VkWriteDescriptorSetAccelerationStructureKHR accelinfo;
             };
 
+            struct DynamicOffsetSlot
+            {
+                i32 set;
+                u32 index;
+            };
+
+            VkDescriptorSetLayout GetDescriptorSetLayout(i32 set);
+            void* GetVariableDescriptorCount(i32 set, u32& count, VkDescriptorSetVariableDescriptorCountAllocateInfo& setCounts);
+
+            static u32 GetBindingKey(i32 set, i32 binding) { return (static_cast<u32>(set) << 16) | static_cast<u32>(binding); }
+
         private:
             PipelineHandlerVK* _pipelineHandler;
             ShaderHandlerVK* _shaderHandler;
@@ -90,9 +110,14 @@ namespace Renderer
             ComputePipelineID _computePipelineID;
 
             std::vector<Backend::BindInfo> _bindInfos;
+            robin_hood::unordered_map<u32, u32> _nameHashToBindInfoIndex; // Filled from the reflection data
+            robin_hood::unordered_map<u32, DynamicOffsetSlot> _nameHashToDynamicOffset;
+            std::vector<u32> _numDynamicOffsets; // Indexed by set
 
             std::vector<ImageWriteDescriptor> _imageWrites;
             std::vector<BufferWriteDescriptor> _bufferWrites;
+            robin_hood::unordered_map<u32, u32> _bindingToImageWriteIndex;
+            robin_hood::unordered_map<u32, u32> _bindingToBufferWriteIndex;
         };
 
         struct DescriptorAllocator
@@ -102,6 +127,18 @@ namespace Renderer
             VkDescriptorPool pool;
         };
 
+        // Descriptor sets in the cache are keyed by a hash of everything that got written into them
+        // They stay alive as long as they keep getting bound, and get freed once no frame in flight can still use them
+        constexpr u64 CACHED_DESCRIPTOR_SET_LIFETIME = 8; // In frames since the set was last bound
+        constexpr i32 CACHED_DESCRIPTOR_POOL_SIZE = 1000;
+
+        struct CachedDescriptorSetVK
+        {
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            VkDescriptorPool pool = VK_NULL_HANDLE;
+            u64 lastUsedFrame = 0;
+        };
+
         struct DescriptorMegaPoolVK
         {
             VkDescriptorSet AllocateDescriptor(VkDescriptorSetLayout layout, DescriptorLifetime lifetime, void* next = nullptr);
@@ -109,6 +146,17 @@ namespace Renderer
             void Init(i32 numFrames, RenderDeviceVK* device);
             void SetFrame(i32 frameNumber);
 
+            bool TryGetCachedDescriptor(u64 key, VkDescriptorSet& outSet);
+            VkDescriptorSet AllocateCachedDescriptor(u64 key, VkDescriptorSetLayout layout, void* next = nullptr);
+
+            // Vulkan is free to hand out the handle of a destroyed object again, so any cached set pointing at a destroyed handle has to go
+            void AddCachedHandle(u64 handle);
+            void OnHandleDestroyed(u64 handle);
+            void FlushCachedDescriptors();
+
+            template <typename T>
+            static u64 GetHandleKey(T handle) { return reinterpret_cast<u64>(handle); }
+
             DescriptorAllocatorHandleVK _dynamicHandle;
             DescriptorAllocatorHandleVK _staticHandle;
 
@@ -116,6 +164,15 @@ namespace Renderer
             DescriptorAllocatorPoolVK* _staticAllocatorPool;
 
             RenderDeviceVK* _device;
+
+            i32 _numFrames = 0;
+            u64 _frameNumber = 0;
+
+            std::mutex _cacheMutex;
+            robin_hood::unordered_map<u64, CachedDescriptorSetVK> _cachedDescriptorSets;
+            robin_hood::unordered_set<u64> _cachedHandles;
+            std::vector<CachedDescriptorSetVK> _retiredDescriptorSets;
+            std::vector<VkDescriptorPool> _cachePools;
         };
     }
 }
\ No newline at end of file
@@ -3,10 +3,12 @@
 #include <Utils/StringUtils.h>
 #include <vulkan/vulkan.h>
 #include <vector>
+#include <algorithm>
 
 #include "RenderDeviceVK.h"
 #include "FormatConverterVK.h"
 #include "DebugMarkerUtilVK.h"
+#include "DescriptorSetBuilderVK.h"
 
 namespace Renderer
 {
@@ -44,6 +46,10 @@ namespace Renderer
             VkImage image;
             VkImageView colorView;
             bool isSwapchain = false;
+
+            // Transient images don't own their allocation, it belongs to a TransientMemoryBlock
+            bool isTransient = false;
+            bool isAcquired = false; // Handed out to the render graph that is being set up
         };
 
         struct DepthImage
@@ -53,8 +59,30 @@ namespace Renderer
             VmaAllocation allocation;
             VkImage image;
             VkImageView depthView;
+
+            bool isTransient = false;
+            bool isAcquired = false;
+        };
+
+        // Transient images sharing one allocation, keys are ImageIDs or DepthImageIDs with TRANSIENT_DEPTH_KEY_BIT set
+        struct TransientMemoryBlock
+        {
+            VmaAllocation allocation = VK_NULL_HANDLE;
+            std::vector<u32> members;
         };
 
+        // Transient images and memory can still be used by frames in flight when the aliasing changes, so they get destroyed a few frames later
+        struct RetiredTransient
+        {
+            VkImage image = VK_NULL_HANDLE;
+            std::vector<VkImageView> views;
+            VmaAllocation allocation = VK_NULL_HANDLE;
+            u32 framesLifetimeLeft = 0;
+        };
+
+        constexpr u32 TRANSIENT_DEPTH_KEY_BIT = 1u << 16;
+        constexpr u32 TRANSIENT_RETIRE_FRAMES = 2;
+
         struct ExtraViews
         {
             VkImageView view;
@@ -67,6 +95,11 @@ namespace Renderer
             std::vector<DepthImage> depthImages;
 
             std::unordered_map<u16, std::vector<ExtraViews>> extraViews;
+
+            std::vector<ImageID> transientImages;
+            std::vector<DepthImageID> transientDepthImages;
+            std::vector<TransientMemoryBlock> transientBlocks;
+            std::vector<RetiredTransient> retiredTransients;
         };
 
         void ImageHandlerVK::Init(RenderDeviceVK* device)
@@ -79,10 +112,28 @@ namespace Renderer
         {
             ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
 
+            // The device is idle here, so transient images can go right away, the next AllocateTransientImages creates them in the new size
+            for (TransientMemoryBlock& block : data.transientBlocks)
+            {
+                RetireTransientBlock(block);
+            }
+            data.transientBlocks.clear();
+
+            for (RetiredTransient& retired : data.retiredTransients)
+            {
+                DestroyRetiredTransient(retired);
+            }
+            data.retiredTransients.clear();
+
+            // Every scaled image gets a new view below
+            _device->_descriptorMegaPool->FlushCachedDescriptors();
+
             // Recreate color images
-            for (auto& image : data.images)
+            for (size_t i = 0; i < data.images.size(); i++)
             {
-                if (image.desc.dimensionType == ImageDimensionType::DIMENSION_SCALE)
+                Image& image = data.images[i];
+
+                if (image.desc.dimensionType == ImageDimensionType::DIMENSION_SCALE && !image.isTransient)
                 {
                     // Destroy old image
                     vkDestroyImageView(_device->_device, image.colorView, nullptr);
@@ -91,14 +142,14 @@ namespace Renderer
                     // Create new
                     VkFormat format;
                     CreateImage(image, format);
-                    CreateImageViews(image, format);
+                    CreateImageViews(image, format, ImageID(static_cast<ImageID::type>(i)));
                 }
             }
 
             // Recreate depth images
             for (auto& image : data.depthImages)
             {
-                if (image.desc.dimensionType == ImageDimensionType::DIMENSION_SCALE)
+                if (image.desc.dimensionType == ImageDimensionType::DIMENSION_SCALE && !image.isTransient)
                 {
                     // Destroy old image
                     vkDestroyImageView(_device->_device, image.depthView, nullptr);
@@ -129,7 +180,7 @@ namespace Renderer
 
             VkFormat format;
             CreateImage(image, format);
-            CreateImageViews(image, format);
+            CreateImageViews(image, format, ImageID(static_cast<ImageID::type>(nextHandle)));
 
             // Transition image from VK_IMAGE_LAYOUT_UNDEFINED to VK_IMAGE_LAYOUT_GENERAL
             _device->TransitionImageLayout(image.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, image.desc.depth, image.desc.mipLevels);
@@ -162,7 +213,7 @@ namespace Renderer
             vkGetSwapchainImagesKHR(_device->_device, swapChain, &imageCount, images);
             image.image = images[index];
 
-            CreateImageViews(image, format);
+            CreateImageViews(image, format, ImageID(static_cast<ImageID::type>(nextHandle)));
 
             // Transition image from VK_IMAGE_LAYOUT_UNDEFINED to VK_IMAGE_LAYOUT_GENERAL
             _device->TransitionImageLayout(image.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, image.desc.depth, image.desc.mipLevels);
@@ -191,6 +242,363 @@ namespace Renderer
             return DepthImageID(static_cast<DepthImageID::type>(nextHandle));
         }
 
+        // mipLevels gets overwritten when the image is created, so it isn't part of what makes two transient images interchangeable
+        static bool IsSameTransientDesc(const ImageDesc& a, const ImageDesc& b)
+        {
+            return a.debugName == b.debugName && a.dimensions == b.dimensions && a.dimensionType == b.dimensionType && a.depth == b.depth && a.format == b.format && a.sampleCount == b.sampleCount;
+        }
+
+        static bool IsSameTransientDesc(const DepthImageDesc& a, const DepthImageDesc& b)
+        {
+            return a.debugName == b.debugName && a.dimensions == b.dimensions && a.dimensionType == b.dimensionType && a.format == b.format && a.sampleCount == b.sampleCount;
+        }
+
+        ImageID ImageHandlerVK::CreateTransientImage(const ImageDesc& desc)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            // Hand out the same ID as last frame so the aliasing and the descriptors that point at it can stay as they are
+            for (ImageID id : data.transientImages)
+            {
+                Image& image = data.images[static_cast<ImageID::type>(id)];
+                if (!image.isAcquired && IsSameTransientDesc(image.desc, desc))
+                {
+                    image.isAcquired = true;
+                    return id;
+                }
+            }
+
+            size_t nextHandle = data.images.size();
+
+            // Make sure we haven't exceeded the limit of the ImageID type, if this hits you need to change type of ImageID to something bigger
+            assert(nextHandle < ImageID::MaxValue());
+
+            assert(desc.dimensions.x > 0); // Make sure the width is valid
+            assert(desc.dimensions.y > 0); // Make sure the height is valid
+            assert(desc.depth > 0); // Make sure the depth is valid
+            assert(desc.format != ImageFormat::UNKNOWN); // Make sure the format is valid
+
+            // The VkImage gets created once AllocateTransientImages knows which memory it goes into
+            Image image;
+            image.desc = desc;
+            image.allocation = VK_NULL_HANDLE;
+            image.image = VK_NULL_HANDLE;
+            image.colorView = VK_NULL_HANDLE;
+            image.isTransient = true;
+            image.isAcquired = true;
+
+            data.images.push_back(image);
+
+            ImageID id = ImageID(static_cast<ImageID::type>(nextHandle));
+            data.transientImages.push_back(id);
+
+            return id;
+        }
+
+        DepthImageID ImageHandlerVK::CreateTransientDepthImage(const DepthImageDesc& desc)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            for (DepthImageID id : data.transientDepthImages)
+            {
+                DepthImage& image = data.depthImages[static_cast<DepthImageID::type>(id)];
+                if (!image.isAcquired && IsSameTransientDesc(image.desc, desc))
+                {
+                    image.isAcquired = true;
+                    return id;
+                }
+            }
+
+            size_t nextHandle = data.depthImages.size();
+
+            // Make sure we haven't exceeded the limit of the DepthImageID type, if this hits you need to change type of DepthImageID to something bigger
+            assert(nextHandle < DepthImageID::MaxValue());
+
+            DepthImage image;
+            image.desc = desc;
+            image.allocation = VK_NULL_HANDLE;
+            image.image = VK_NULL_HANDLE;
+            image.depthView = VK_NULL_HANDLE;
+            image.isTransient = true;
+            image.isAcquired = true;
+
+            data.depthImages.push_back(image);
+
+            DepthImageID id = DepthImageID(static_cast<DepthImageID::type>(nextHandle));
+            data.transientDepthImages.push_back(id);
+
+            return id;
+        }
+
+        bool ImageHandlerVK::AllocateTransientImages(const TransientImageDesc* images, u32 numImages)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            // Group the requested images by alias slot, sorted so they can be compared against last frame's blocks
+            std::vector<std::vector<u32>> requestedBlocks;
+            for (u32 i = 0; i < numImages; i++)
+            {
+                const TransientImageDesc& transient = images[i];
+                if (transient.aliasSlot >= requestedBlocks.size())
+                {
+                    requestedBlocks.resize(transient.aliasSlot + 1);
+                }
+
+                u32 key = transient.depthImage != DepthImageID::Invalid() ? TRANSIENT_DEPTH_KEY_BIT | static_cast<DepthImageID::type>(transient.depthImage) : static_cast<ImageID::type>(transient.image);
+                requestedBlocks[transient.aliasSlot].push_back(key);
+            }
+
+            for (std::vector<u32>& members : requestedBlocks)
+            {
+                std::sort(members.begin(), members.end());
+            }
+
+            // Blocks with exactly the same members as last frame stay, everything else gets retired and recreated
+            std::vector<TransientMemoryBlock> blocks;
+            std::vector<bool> isRequestedBlockKept(requestedBlocks.size(), false);
+            bool viewsChanged = false;
+
+            for (TransientMemoryBlock& block : data.transientBlocks)
+            {
+                bool isKept = false;
+                for (size_t i = 0; i < requestedBlocks.size(); i++)
+                {
+                    if (!isRequestedBlockKept[i] && requestedBlocks[i] == block.members)
+                    {
+                        isRequestedBlockKept[i] = true;
+                        isKept = true;
+                        break;
+                    }
+                }
+
+                if (isKept)
+                {
+                    blocks.push_back(std::move(block));
+                }
+                else
+                {
+                    RetireTransientBlock(block);
+                    viewsChanged = true;
+                }
+            }
+
+            for (size_t i = 0; i < requestedBlocks.size(); i++)
+            {
+                if (isRequestedBlockKept[i] || requestedBlocks[i].empty())
+                    continue;
+
+                blocks.push_back(CreateTransientBlock(requestedBlocks[i]));
+                viewsChanged = true;
+            }
+
+            data.transientBlocks = std::move(blocks);
+
+            // The next render graph acquires its transient images again
+            for (ImageID id : data.transientImages)
+            {
+                data.images[static_cast<ImageID::type>(id)].isAcquired = false;
+            }
+
+            for (DepthImageID id : data.transientDepthImages)
+            {
+                data.depthImages[static_cast<DepthImageID::type>(id)].isAcquired = false;
+            }
+
+            return viewsChanged;
+        }
+
+        bool ImageHandlerVK::IsImageAvailable(const ImageID id)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            // Lets make sure this id exists
+            assert(data.images.size() > static_cast<ImageID::type>(id));
+            const Image& image = data.images[static_cast<ImageID::type>(id)];
+
+            return !image.isTransient || image.isAcquired;
+        }
+
+        bool ImageHandlerVK::IsImageAvailable(const DepthImageID id)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            // Lets make sure this id exists
+            assert(data.depthImages.size() > static_cast<DepthImageID::type>(id));
+            const DepthImage& image = data.depthImages[static_cast<DepthImageID::type>(id)];
+
+            return !image.isTransient || image.isAcquired;
+        }
+
+        void ImageHandlerVK::OnFrameStart()
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            i64 numRetired = static_cast<i64>(data.retiredTransients.size());
+
+            for (i64 i = numRetired - 1; i >= 0; i--)
+            {
+                RetiredTransient& retired = data.retiredTransients[i];
+
+                if (--retired.framesLifetimeLeft == 0)
+                {
+                    DestroyRetiredTransient(retired);
+                    data.retiredTransients.erase(data.retiredTransients.begin() + i);
+                }
+            }
+        }
+
+        TransientMemoryBlock ImageHandlerVK::CreateTransientBlock(const std::vector<u32>& members)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            TransientMemoryBlock block;
+            block.members = members;
+
+            // Create every image first, the block has to fit the biggest one and satisfy all of their memory types
+            VkMemoryRequirements blockRequirements = {};
+            blockRequirements.memoryTypeBits = ~0u;
+
+            std::vector<VkFormat> formats(members.size());
+            for (size_t i = 0; i < members.size(); i++)
+            {
+                const u32 key = members[i];
+
+                VkImageCreateInfo imageInfo = {};
+                VkImage* vkImage = nullptr;
+
+                if (key & TRANSIENT_DEPTH_KEY_BIT)
+                {
+                    DepthImage& image = data.depthImages[key & ~TRANSIENT_DEPTH_KEY_BIT];
+                    GetImageCreateInfo(image, imageInfo);
+                    vkImage = &image.image;
+                }
+                else
+                {
+                    Image& image = data.images[key];
+                    GetImageCreateInfo(image, imageInfo);
+                    vkImage = &image.image;
+                }
+
+                // Aliased images get their layout set up by the barrier before their first use every frame, see ImageBarrierDesc::discard
+                if (vkCreateImage(_device->_device, &imageInfo, nullptr, vkImage) != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("Failed to create transient image!");
+                }
+
+                formats[i] = imageInfo.format;
+
+                VkMemoryRequirements requirements;
+                vkGetImageMemoryRequirements(_device->_device, *vkImage, &requirements);
+
+                blockRequirements.size = std::max(blockRequirements.size, requirements.size);
+                blockRequirements.alignment = std::max(blockRequirements.alignment, requirements.alignment);
+                blockRequirements.memoryTypeBits &= requirements.memoryTypeBits;
+            }
+
+            if (blockRequirements.memoryTypeBits == 0)
+            {
+                DebugHandler::PrintFatal("Transient images sharing an alias slot have no memory type in common!");
+            }
+
+            VmaAllocationCreateInfo allocInfo = {};
+            allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+            if (vmaAllocateMemory(_device->_allocator, &blockRequirements, &allocInfo, &block.allocation, nullptr) != VK_SUCCESS)
+            {
+                DebugHandler::PrintFatal("Failed to allocate transient image memory!");
+            }
+
+            for (size_t i = 0; i < members.size(); i++)
+            {
+                const u32 key = members[i];
+
+                if (key & TRANSIENT_DEPTH_KEY_BIT)
+                {
+                    DepthImage& image = data.depthImages[key & ~TRANSIENT_DEPTH_KEY_BIT];
+                    vmaBindImageMemory(_device->_allocator, block.allocation, image.image);
+
+                    CreateDepthView(image, formats[i]);
+                    _device->TransitionImageLayout(image.image, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, 1, 1);
+                }
+                else
+                {
+                    Image& image = data.images[key];
+                    vmaBindImageMemory(_device->_allocator, block.allocation, image.image);
+
+                    CreateImageViews(image, formats[i], ImageID(static_cast<ImageID::type>(key)));
+                    _device->TransitionImageLayout(image.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, image.desc.depth, image.desc.mipLevels);
+                }
+            }
+
+            return block;
+        }
+
+        void ImageHandlerVK::RetireTransientBlock(TransientMemoryBlock& block)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            for (u32 key : block.members)
+            {
+                RetiredTransient& retired = data.retiredTransients.emplace_back();
+                retired.framesLifetimeLeft = TRANSIENT_RETIRE_FRAMES;
+
+                if (key & TRANSIENT_DEPTH_KEY_BIT)
+                {
+                    DepthImage& image = data.depthImages[key & ~TRANSIENT_DEPTH_KEY_BIT];
+                    retired.image = image.image;
+                    retired.views.push_back(image.depthView);
+
+                    image.image = VK_NULL_HANDLE;
+                    image.depthView = VK_NULL_HANDLE;
+                }
+                else
+                {
+                    Image& image = data.images[key];
+                    retired.image = image.image;
+                    retired.views.push_back(image.colorView);
+
+                    auto extraViews = data.extraViews.find(static_cast<ImageID::type>(key));
+                    if (extraViews != data.extraViews.end())
+                    {
+                        for (ExtraViews& extraView : extraViews->second)
+                        {
+                            retired.views.push_back(extraView.view);
+                        }
+                        data.extraViews.erase(extraViews);
+                    }
+
+                    image.image = VK_NULL_HANDLE;
+                    image.colorView = VK_NULL_HANDLE;
+                }
+            }
+
+            RetiredTransient& retiredMemory = data.retiredTransients.emplace_back();
+            retiredMemory.allocation = block.allocation;
+            retiredMemory.framesLifetimeLeft = TRANSIENT_RETIRE_FRAMES;
+
+            block.allocation = VK_NULL_HANDLE;
+            block.members.clear();
+        }
+
+        void ImageHandlerVK::DestroyRetiredTransient(RetiredTransient& retired)
+        {
+            for (VkImageView view : retired.views)
+            {
+                _device->_descriptorMegaPool->OnHandleDestroyed(DescriptorMegaPoolVK::GetHandleKey(view));
+                vkDestroyImageView(_device->_device, view, nullptr);
+            }
+
+            if (retired.image != VK_NULL_HANDLE)
+            {
+                vkDestroyImage(_device->_device, retired.image, nullptr);
+            }
+
+            if (retired.allocation != VK_NULL_HANDLE)
+            {
+                vmaFreeMemory(_device->_allocator, retired.allocation);
+            }
+        }
+
         const ImageDesc& ImageHandlerVK::GetImageDesc(const ImageID id)
         {
             ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
@@ -321,6 +729,24 @@ namespace Renderer
             return data.images[static_cast<ImageID::type>(id)].isSwapchain;
         }
 
+        bool ImageHandlerVK::IsTransientImage(const ImageID id)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            // Lets make sure this id exists
+            assert(data.images.size() > static_cast<ImageID::type>(id));
+            return data.images[static_cast<ImageID::type>(id)].isTransient;
+        }
+
+        bool ImageHandlerVK::IsTransientImage(const DepthImageID id)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            // Lets make sure this id exists
+            assert(data.depthImages.size() > static_cast<DepthImageID::type>(id));
+            return data.depthImages[static_cast<DepthImageID::type>(id)].isTransient;
+        }
+
         u32 ImageHandlerVK::GetNumImages()
         {
             ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
@@ -337,10 +763,23 @@ namespace Renderer
 
         void ImageHandlerVK::CreateImage(Image& image, VkFormat& format)
         {
-            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+            VkImageCreateInfo imageInfo = {};
+            GetImageCreateInfo(image, imageInfo);
+            format = imageInfo.format;
+
+            VmaAllocationCreateInfo allocInfo = {};
+            allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
+            if (vmaCreateImage(_device->_allocator, &imageInfo, &allocInfo, &image.image, &image.allocation, nullptr) != VK_SUCCESS)
+            {
+                DebugHandler::PrintFatal("Failed to create image!");
+            }
+        }
+
+        void ImageHandlerVK::GetImageCreateInfo(Image& image, VkImageCreateInfo& imageInfo)
+        {
             // Create image
-            VkImageCreateInfo imageInfo = {};
+            imageInfo = {};
             imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
             imageInfo.pNext = nullptr;
             imageInfo.flags = 0; // TODO: VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT and VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT? https://github.com/DiligentGraphics/DiligentCore/blob/1edcafe9bd41bdde86869d4e1c0212c78ce123b7/Graphics/GraphicsEngineVulkan/src/TextureVkImpl.cpp
@@ -391,9 +830,7 @@ namespace Renderer
                 image.desc.mipLevels = mips;
             }
 
-            format = FormatConverterVK::ToVkFormat(image.desc.format);
-
-            imageInfo.format = format;
+            imageInfo.format = FormatConverterVK::ToVkFormat(image.desc.format);
             imageInfo.extent.width = uwidth;
             imageInfo.extent.height = uheight;
             imageInfo.extent.depth = image.desc.depth;
@@ -411,6 +848,12 @@ namespace Renderer
             imageInfo.queueFamilyIndexCount = 0;
             imageInfo.pQueueFamilyIndices = nullptr;
             imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        }
+
+        void ImageHandlerVK::CreateImage(DepthImage& image)
+        {
+            VkImageCreateInfo imageInfo = {};
+            GetImageCreateInfo(image, imageInfo);
 
             VmaAllocationCreateInfo allocInfo = {};
             allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
@@ -419,12 +862,17 @@ namespace Renderer
             {
                 DebugHandler::PrintFatal("Failed to create image!");
             }
+
+            CreateDepthView(image, imageInfo.format);
+
+            // Transition image from VK_IMAGE_LAYOUT_UNDEFINED to VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+            _device->TransitionImageLayout(image.image, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, 1, 1);
         }
 
-        void ImageHandlerVK::CreateImage(DepthImage& image)
+        void ImageHandlerVK::GetImageCreateInfo(DepthImage& image, VkImageCreateInfo& imageInfo)
         {
             // Create image
-            VkImageCreateInfo imageInfo = {};
+            imageInfo = {};
             imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
             imageInfo.pNext = nullptr;
             imageInfo.flags = 0; // TODO: VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT and VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT? https://github.com/DiligentGraphics/DiligentCore/blob/1edcafe9bd41bdde86869d4e1c0212c78ce123b7/Graphics/GraphicsEngineVulkan/src/TextureVkImpl.cpp
@@ -459,22 +907,17 @@ namespace Renderer
             imageInfo.queueFamilyIndexCount = 0;
             imageInfo.pQueueFamilyIndices = nullptr;
             imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        }
 
-            VmaAllocationCreateInfo allocInfo = {};
-            allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-
-            if (vmaCreateImage(_device->_allocator, &imageInfo, &allocInfo, &image.image, &image.allocation, nullptr) != VK_SUCCESS)
-            {
-                DebugHandler::PrintFatal("Failed to create image!");
-            }
-
+        void ImageHandlerVK::CreateDepthView(DepthImage& image, VkFormat format)
+        {
             // Create Depth View
             VkImageViewCreateInfo depthViewInfo = {};
             depthViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
             depthViewInfo.image = image.image;
             depthViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
 
-            depthViewInfo.format = imageInfo.format;
+            depthViewInfo.format = format;
             depthViewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
             depthViewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
             depthViewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
@@ -491,12 +934,9 @@ namespace Renderer
             }
 
             DebugMarkerUtilVK::SetObjectName(_device->_device, (u64)image.depthView, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_VIEW_EXT, image.desc.debugName.c_str());
-
-            // Transition image from VK_IMAGE_LAYOUT_UNDEFINED to VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
-            _device->TransitionImageLayout(image.image, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, 1, 1);
         }
 
-        void ImageHandlerVK::CreateImageViews(Image& image, VkFormat format)
+        void ImageHandlerVK::CreateImageViews(Image& image, VkFormat format, ImageID id)
         {
             ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
 
@@ -543,7 +983,7 @@ namespace Renderer
                     views.push_back(v);
                 }
                 
-                data.extraViews[(static_cast<u16>(data.images.size()))] = std::move(views);
+                data.extraViews[static_cast<ImageID::type>(id)] = std::move(views);
             }
 
             if (vkCreateImageView(_device->_device, &colorViewInfo, nullptr, &image.colorView) != VK_SUCCESS)
@@ -5,6 +5,8 @@
 #include "vk_mem_alloc.h"
 #include "../../../Descriptors/ImageDesc.h"
 #include "../../../Descriptors/DepthImageDesc.h"
+#include "../../../Descriptors/TransientImageDesc.h"
+#include <vector>
 
 namespace Renderer
 {
@@ -13,6 +15,8 @@ namespace Renderer
         class RenderDeviceVK;
         struct Image;
         struct DepthImage;
+        struct TransientMemoryBlock;
+        struct RetiredTransient;
 
         struct IImageHandlerVKData {};
 
@@ -28,6 +32,14 @@ namespace Renderer
 
             DepthImageID CreateDepthImage(const DepthImageDesc& desc);
 
+            // Transient images get their memory in AllocateTransientImages, images sharing an alias slot share their memory
+            ImageID CreateTransientImage(const ImageDesc& desc);
+            DepthImageID CreateTransientDepthImage(const DepthImageDesc& desc);
+            // Returns true when a transient image got new views, anything caching those views (like framebuffers) has to be rebuilt
+            bool AllocateTransientImages(const TransientImageDesc* images, u32 numImages);
+
+            void OnFrameStart();
+
             const ImageDesc& GetImageDesc(const ImageID id);
             const DepthImageDesc& GetDepthImageDesc(const DepthImageID id);
 
@@ -41,15 +53,28 @@ namespace Renderer
             VkImageView GetDepthView(const DepthImageID id);
 
             bool IsSwapChainImage(const ImageID id);
+            bool IsTransientImage(const ImageID id);
+            bool IsTransientImage(const DepthImageID id);
 
             u32 GetNumImages();
             u32 GetNumDepthImages();
 
+            bool IsImageAvailable(const ImageID id);
+            bool IsImageAvailable(const DepthImageID id);
+
         private:
             void CreateImage(Image& image, VkFormat& format);
             void CreateImage(DepthImage& image);
 
-            void CreateImageViews(Image& image, VkFormat format);
+            void GetImageCreateInfo(Image& image, VkImageCreateInfo& imageInfo);
+            void GetImageCreateInfo(DepthImage& image, VkImageCreateInfo& imageInfo);
+
+            void CreateImageViews(Image& image, VkFormat format, ImageID id);
+            void CreateDepthView(DepthImage& image, VkFormat format);
+
+            TransientMemoryBlock CreateTransientBlock(const std::vector<u32>& members);
+            void RetireTransientBlock(TransientMemoryBlock& block);
+            void DestroyRetiredTransient(RetiredTransient& retired);
 
         private:
             RenderDeviceVK* _device;
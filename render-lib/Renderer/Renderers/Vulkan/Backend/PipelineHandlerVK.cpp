@@ -3,6 +3,11 @@
 #include <Utils/DebugHandler.h>
 #include <Utils/XXHash64.h>
 #include <vulkan/vulkan.h>
+#include <robin_hood.h>
+#include <tracy/Tracy.hpp>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
 
 #include "FormatConverterVK.h"
 #include "RenderDeviceVK.h"
@@ -36,6 +41,10 @@ namespace Renderer
             u32 numRenderTargets = 0;
             VkFramebuffer framebuffer;
 
+            // Resolved when the pipeline is created, the desc's resource lookups point into a render graph that only lives for a frame
+            ImageID renderTargetImages[MAX_RENDER_TARGETS];
+            DepthImageID depthStencilImage = DepthImageID::Invalid();
+
             std::vector<DescriptorSetLayoutData> descriptorSetLayoutDatas;
             std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
 
@@ -65,18 +74,138 @@ namespace Renderer
             DescriptorSetBuilderVK* descriptorSetBuilder;
         };
 
+        const std::filesystem::path PIPELINE_CACHE_PATH = "Data/shaders/_pipelines.cache";
+
         struct PipelineHandlerVKData : IPipelineHandlerVKData
         {
             std::vector<GraphicsPipeline> graphicsPipelines;
             std::vector<ComputePipeline> computePipelines;
+
+            robin_hood::unordered_map<u64, size_t> cacheDescHashToGraphicsPipeline;
+            robin_hood::unordered_map<u64, size_t> cacheDescHashToComputePipeline;
+
+            // Frames still in flight can reference these, they get destroyed once FRAMEBUFFER_RETIRE_FRAMES frames have started
+            struct RetiredFramebuffer
+            {
+                VkFramebuffer framebuffer;
+                u32 framesLifetimeLeft;
+            };
+            std::vector<RetiredFramebuffer> retiredFramebuffers;
+
+            VkPipelineCache pipelineCache = VK_NULL_HANDLE;
         };
 
+        constexpr u32 FRAMEBUFFER_RETIRE_FRAMES = 2;
+
         void PipelineHandlerVK::Init(RenderDeviceVK* device, ShaderHandlerVK* shaderHandler, ImageHandlerVK* imageHandler)
         {
             _device = device;
             _shaderHandler = shaderHandler;
             _imageHandler = imageHandler;
             _data = new PipelineHandlerVKData();
+
+            LoadPipelineCache();
+        }
+
+        void PipelineHandlerVK::LoadPipelineCache()
+        {
+            PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
+
+            std::vector<char> cacheData;
+            {
+                std::ifstream file(PIPELINE_CACHE_PATH, std::ios::ate | std::ios::binary);
+                if (file.is_open())
+                {
+                    cacheData.resize(static_cast<size_t>(file.tellg()));
+                    file.seekg(0);
+                    file.read(cacheData.data(), cacheData.size());
+                }
+            }
+
+            // Some drivers don't survive being handed a cache from another GPU or driver version, so check the header ourselves before passing it on
+            if (!cacheData.empty())
+            {
+                VkPhysicalDeviceProperties deviceProperties;
+                vkGetPhysicalDeviceProperties(_device->_physicalDevice, &deviceProperties);
+
+                VkPipelineCacheHeaderVersionOne header;
+                bool isValid = cacheData.size() >= sizeof(header);
+                if (isValid)
+                {
+                    memcpy(&header, cacheData.data(), sizeof(header));
+
+                    isValid = header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                              header.vendorID == deviceProperties.vendorID &&
+                              header.deviceID == deviceProperties.deviceID &&
+                              memcmp(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+                }
+
+                if (isValid)
+                {
+                    DebugHandler::PrintSuccess("Loaded pipelinecache from: %s", PIPELINE_CACHE_PATH.string().c_str());
+                }
+                else
+                {
+                    DebugHandler::Print("Discarding pipelinecache made by a different GPU or driver: %s", PIPELINE_CACHE_PATH.string().c_str());
+                    cacheData.clear();
+                }
+            }
+            else
+            {
+                DebugHandler::Print("Creating pipelinecache at: %s", PIPELINE_CACHE_PATH.string().c_str());
+            }
+
+            VkPipelineCacheCreateInfo cacheInfo = {};
+            cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+            cacheInfo.initialDataSize = cacheData.size();
+            cacheInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+            if (vkCreatePipelineCache(_device->_device, &cacheInfo, nullptr, &data.pipelineCache) != VK_SUCCESS)
+            {
+                DebugHandler::PrintFatal("Failed to create pipeline cache!");
+            }
+        }
+
+        void PipelineHandlerVK::SavePipelineCache()
+        {
+            PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
+
+            size_t cacheSize = 0;
+            if (vkGetPipelineCacheData(_device->_device, data.pipelineCache, &cacheSize, nullptr) != VK_SUCCESS || cacheSize == 0)
+            {
+                DebugHandler::PrintError("Failed to get pipeline cache data");
+                return;
+            }
+
+            std::vector<char> cacheData(cacheSize);
+            if (vkGetPipelineCacheData(_device->_device, data.pipelineCache, &cacheSize, cacheData.data()) != VK_SUCCESS)
+            {
+                DebugHandler::PrintError("Failed to get pipeline cache data");
+                return;
+            }
+
+            std::error_code errorCode;
+            std::filesystem::create_directories(PIPELINE_CACHE_PATH.parent_path(), errorCode);
+
+            std::ofstream file(PIPELINE_CACHE_PATH, std::ios::out | std::ios::binary);
+            if (!file)
+            {
+                DebugHandler::PrintError("Failed to create file (%s)", PIPELINE_CACHE_PATH.string().c_str());
+                return;
+            }
+
+            file.write(cacheData.data(), cacheSize);
+        }
+
+        void PipelineHandlerVK::Deinit()
+        {
+            PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
+
+            SavePipelineCache();
+            DiscardPipelines();
+
+            vkDestroyPipelineCache(_device->_device, data.pipelineCache, nullptr);
+            data.pipelineCache = VK_NULL_HANDLE;
         }
 
         void PipelineHandlerVK::DiscardPipelines()
@@ -102,6 +231,13 @@ namespace Renderer
                 delete pipeline.descriptorSetBuilder;
             }
             data.graphicsPipelines.clear();
+            data.cacheDescHashToGraphicsPipeline.clear();
+
+            for (PipelineHandlerVKData::RetiredFramebuffer& retired : data.retiredFramebuffers)
+            {
+                vkDestroyFramebuffer(_device->_device, retired.framebuffer, nullptr);
+            }
+            data.retiredFramebuffers.clear();
 
             for (ComputePipeline& pipeline : data.computePipelines)
             {
@@ -119,6 +255,10 @@ namespace Renderer
                 delete pipeline.descriptorSetBuilder;
             }
             data.computePipelines.clear();
+            data.cacheDescHashToComputePipeline.clear();
+
+            // Cached descriptor sets were allocated with the layouts destroyed above
+            _device->_descriptorMegaPool->FlushCachedDescriptors();
         }
 
         void PipelineHandlerVK::OnWindowResize()
@@ -131,8 +271,43 @@ namespace Renderer
             }
         }
 
+        void PipelineHandlerVK::OnTransientImagesChanged()
+        {
+            PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
+            for (auto& pipeline : data.graphicsPipelines)
+            {
+                if (!UsesTransientImages(pipeline))
+                    continue;
+
+                if (pipeline.framebuffer != VK_NULL_HANDLE)
+                {
+                    data.retiredFramebuffers.push_back({ pipeline.framebuffer, FRAMEBUFFER_RETIRE_FRAMES });
+                }
+
+                CreateFramebuffer(pipeline);
+            }
+        }
+
+        void PipelineHandlerVK::OnFrameStart()
+        {
+            PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
+
+            i64 numRetired = static_cast<i64>(data.retiredFramebuffers.size());
+            for (i64 i = numRetired - 1; i >= 0; i--)
+            {
+                PipelineHandlerVKData::RetiredFramebuffer& retired = data.retiredFramebuffers[i];
+
+                if (--retired.framesLifetimeLeft == 0)
+                {
+                    vkDestroyFramebuffer(_device->_device, retired.framebuffer, nullptr);
+                    data.retiredFramebuffers.erase(data.retiredFramebuffers.begin() + i);
+                }
+            }
+        }
+
         GraphicsPipelineID PipelineHandlerVK::CreatePipeline(const GraphicsPipelineDesc& desc)
         {
+            ZoneScopedNC("PipelineHandlerVK::CreatePipeline", tracy::Color::Red3);
             PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
 
             // -- Get number of render targets and attachments --
@@ -173,6 +348,15 @@ namespace Renderer
             pipeline.cacheDescHash = cacheDescHash;
             pipeline.numRenderTargets = numAttachments;
 
+            for (u32 i = 0; i < numAttachments; i++)
+            {
+                pipeline.renderTargetImages[i] = desc.MutableResourceToImageID(desc.renderTargets[i]);
+            }
+            if (desc.depthStencil != RenderPassMutableResource::Invalid())
+            {
+                pipeline.depthStencilImage = desc.MutableResourceToDepthImageID(desc.depthStencil);
+            }
+
             // -- Create Render Pass --
             std::vector<VkAttachmentDescription> attachments(numAttachments);
             std::vector< VkAttachmentReference> colorAttachmentRefs(numAttachments);
@@ -600,15 +784,19 @@ namespace Renderer
             pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
             pipelineInfo.basePipelineIndex = -1; // Optional
 
-            if (vkCreateGraphicsPipelines(_device->_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
             {
-                DebugHandler::PrintFatal("Failed to create graphics pipeline!");
+                ZoneScopedNC("vkCreateGraphicsPipelines", tracy::Color::Red3);
+                if (vkCreateGraphicsPipelines(_device->_device, data.pipelineCache, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("Failed to create graphics pipeline!");
+                }
             }
 
             GraphicsPipelineID pipelineID = GraphicsPipelineID(static_cast<gIDType>(nextID));
             pipeline.descriptorSetBuilder = new DescriptorSetBuilderVK(pipelineID, this, _shaderHandler, _device->_descriptorMegaPool);
 
             data.graphicsPipelines.push_back(pipeline);
+            data.cacheDescHashToGraphicsPipeline[cacheDescHash] = nextID;
 
             pipeline.descriptorSetBuilder->InitReflectData(); // Needs to happen after push_back
 
@@ -617,6 +805,7 @@ namespace Renderer
 
         ComputePipelineID PipelineHandlerVK::CreatePipeline(const ComputePipelineDesc& desc)
         {
+            ZoneScopedNC("PipelineHandlerVK::CreatePipeline", tracy::Color::Red3);
             PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
 
             // Check the cache
@@ -695,15 +884,19 @@ namespace Renderer
             pipelineInfo.stage = shaderStage;
             pipelineInfo.layout = pipeline.pipelineLayout;
 
-            if (vkCreateComputePipelines(_device->_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
             {
-                DebugHandler::PrintFatal("Failed to create compute pipeline!");
+                ZoneScopedNC("vkCreateComputePipelines", tracy::Color::Red3);
+                if (vkCreateComputePipelines(_device->_device, data.pipelineCache, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("Failed to create compute pipeline!");
+                }
             }
 
             ComputePipelineID pipelineID = ComputePipelineID(static_cast<cIDType>(nextID));
             pipeline.descriptorSetBuilder = new DescriptorSetBuilderVK(pipelineID, this, _shaderHandler, _device->_descriptorMegaPool);
 
             data.computePipelines.push_back(pipeline);
+            data.cacheDescHashToComputePipeline[cacheDescHash] = nextID;
 
             pipeline.descriptorSetBuilder->InitReflectData(); // Needs to happen after push_back
 
@@ -836,35 +1029,25 @@ namespace Renderer
         bool PipelineHandlerVK::TryFindExistingGPipeline(u64 descHash, size_t& id)
         {
             PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
-            id = 0;
 
-            for (auto& pipeline : data.graphicsPipelines)
-            {
-                if (descHash == pipeline.cacheDescHash)
-                {
-                    return true;
-                }
-                id++;
-            }
+            auto itr = data.cacheDescHashToGraphicsPipeline.find(descHash);
+            if (itr == data.cacheDescHashToGraphicsPipeline.end())
+                return false;
 
-            return false;
+            id = itr->second;
+            return true;
         }
 
         bool PipelineHandlerVK::TryFindExistingCPipeline(u64 descHash, size_t& id)
         {
             PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
-            id = 0;
 
-            for (auto& pipeline : data.computePipelines)
-            {
-                if (descHash == pipeline.cacheDescHash)
-                {
-                    return true;
-                }
-                id++;
-            }
+            auto itr = data.cacheDescHashToComputePipeline.find(descHash);
+            if (itr == data.cacheDescHashToComputePipeline.end())
+                return false;
 
-            return false;
+            id = itr->second;
+            return true;
         }
 
         DescriptorSetLayoutData& PipelineHandlerVK::GetDescriptorSet(i32 setNumber, std::vector<DescriptorSetLayoutData>& sets)
@@ -896,14 +1079,22 @@ namespace Renderer
             // Add all color rendertargets as attachments
             for (u32 i = 0; i < pipeline.numRenderTargets; i++)
             {
-                ImageID imageID = pipeline.desc.MutableResourceToImageID(pipeline.desc.renderTargets[i]);
-                attachmentViews[i] = _imageHandler->GetColorView(imageID);
+                attachmentViews[i] = _imageHandler->GetColorView(pipeline.renderTargetImages[i]);
             }
             // Add depthstencil as attachment
-            if (pipeline.desc.depthStencil != RenderPassMutableResource::Invalid())
+            if (pipeline.depthStencilImage != DepthImageID::Invalid())
             {
-                DepthImageID depthImageID = pipeline.desc.MutableResourceToDepthImageID(pipeline.desc.depthStencil);
-                attachmentViews[pipeline.numRenderTargets] = _imageHandler->GetDepthView(depthImageID);
+                attachmentViews[pipeline.numRenderTargets] = _imageHandler->GetDepthView(pipeline.depthStencilImage);
+            }
+
+            // A transient attachment without memory this frame has no view, OnTransientImagesChanged builds the framebuffer once it gets one
+            for (VkImageView view : attachmentViews)
+            {
+                if (view == VK_NULL_HANDLE)
+                {
+                    pipeline.framebuffer = VK_NULL_HANDLE;
+                    return;
+                }
             }
 
             uvec2 renderSize = _device->GetMainWindowSize();
@@ -922,5 +1113,21 @@ namespace Renderer
                 DebugHandler::PrintFatal("Failed to create framebuffer!");
             }
         }
+
+        bool PipelineHandlerVK::UsesTransientImages(const GraphicsPipeline& pipeline)
+        {
+            for (u32 i = 0; i < pipeline.numRenderTargets; i++)
+            {
+                if (_imageHandler->IsTransientImage(pipeline.renderTargetImages[i]))
+                    return true;
+            }
+
+            if (pipeline.depthStencilImage != DepthImageID::Invalid())
+            {
+                return _imageHandler->IsTransientImage(pipeline.depthStencilImage);
+            }
+
+            return false;
+        }
     }
-}
\ No newline at end of file
+}
@@ -30,9 +30,13 @@ namespace Renderer
             using cIDType = type_safe::underlying_type<ComputePipelineID>;
         public:
             void Init(RenderDeviceVK* device, ShaderHandlerVK* shaderHandler, ImageHandlerVK* imageHandler);
+            void Deinit(); // Saves the VkPipelineCache so the next run doesn't have to compile every pipeline in the driver again
             void DiscardPipelines();
 
             void OnWindowResize();
+            // Transient images got new views, framebuffers built with the old ones are retired and rebuilt
+            void OnTransientImagesChanged();
+            void OnFrameStart();
 
             GraphicsPipelineID CreatePipeline(const GraphicsPipelineDesc& desc);
             ComputePipelineID CreatePipeline(const ComputePipelineDesc& desc);
@@ -62,6 +66,9 @@ namespace Renderer
             DescriptorSetBuilderVK* GetDescriptorSetBuilder(ComputePipelineID id);
 
         private:
+            void LoadPipelineCache();
+            void SavePipelineCache();
+
             u64 CalculateCacheDescHash(const GraphicsPipelineDesc& desc);
             u64 CalculateCacheDescHash(const ComputePipelineDesc& desc);
             bool TryFindExistingGPipeline(u64 descHash, size_t& id);
@@ -69,6 +76,7 @@ namespace Renderer
             DescriptorSetLayoutData& GetDescriptorSet(i32 setNumber, std::vector<DescriptorSetLayoutData>& sets);
             
             void CreateFramebuffer(GraphicsPipeline& pipeline);
+            bool UsesTransientImages(const GraphicsPipeline& pipeline);
 
         private:
             RenderDeviceVK* _device;
@@ -1277,10 +1277,17 @@ namespace Renderer
 
         void RenderDeviceVK::CopyBufferToImage(VkBuffer srcBuffer, VkImage dstImage, VkFormat format, u32 width, u32 height, u32 numLayers, u32 numMipLevels)
         {
-            VkDeviceSize bufferOffset = 0;
-
             VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
 
+            CopyBufferToImage(commandBuffer, srcBuffer, 0, dstImage, format, width, height, numLayers, numMipLevels);
+
+            EndSingleTimeCommands(commandBuffer);
+        }
+
+        void RenderDeviceVK::CopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, u64 srcOffset, VkImage dstImage, VkFormat format, u32 width, u32 height, u32 numLayers, u32 numMipLevels)
+        {
+            VkDeviceSize bufferOffset = srcOffset;
+
             std::vector<VkBufferImageCopy> regions;
             regions.reserve(numMipLevels);
 
@@ -1338,8 +1345,6 @@ namespace Renderer
                 numMipLevels,
                 regions.data()
             );
-
-            EndSingleTimeCommands(commandBuffer);
         }
 
         void RenderDeviceVK::TransitionImageLayout(VkImage image, VkImageAspectFlags aspects, VkImageLayout oldLayout, VkImageLayout newLayout, u32 numLayers, u32 numMipLevels)
@@ -7,6 +7,7 @@
 #include <vulkan/vulkan.h>
 #include <filesystem>
 #include <fstream>
+#include <algorithm>
 
 #include "RenderDeviceVK.h"
 
@@ -53,21 +54,49 @@ namespace Renderer
             _vertexShaders.clear();
             _pixelShaders.clear();
             _computeShaders.clear();
+
+            _vertexShaderLookup.clear();
+            _pixelShaderLookup.clear();
+            _computeShaderLookup.clear();
+        }
+
+        bool ShaderHandlerVK::OnFrameStart()
+        {
+            FinishBackgroundCompiles(false);
+
+            if (!_isCompiling)
+            {
+                for (const std::string& shaderPath : _pendingCompileChecks)
+                {
+                    if (NeedsCompile(shaderPath))
+                    {
+                        QueueCompile(shaderPath);
+                    }
+                }
+                _pendingCompileChecks.clear();
+
+                StartQueuedCompiles();
+            }
+
+            bool hasRecompiledShaders = _hasRecompiledShaders;
+            _hasRecompiledShaders = false;
+
+            return hasRecompiledShaders;
         }
 
         VertexShaderID ShaderHandlerVK::LoadShader(const VertexShaderDesc& desc)
         {
-            return LoadShader<VertexShaderID>(desc.path, desc.permutationFields, _vertexShaders);
+            return LoadShader<VertexShaderID>(desc.path, desc.permutationFields, _vertexShaders, _vertexShaderLookup);
         }
 
         PixelShaderID ShaderHandlerVK::LoadShader(const PixelShaderDesc& desc)
         {
-            return LoadShader<PixelShaderID>(desc.path, desc.permutationFields, _pixelShaders);
+            return LoadShader<PixelShaderID>(desc.path, desc.permutationFields, _pixelShaders, _pixelShaderLookup);
         }
 
         ComputeShaderID ShaderHandlerVK::LoadShader(const ComputeShaderDesc& desc)
         {
-            return LoadShader<ComputeShaderID>(desc.path, desc.permutationFields, _computeShaders);
+            return LoadShader<ComputeShaderID>(desc.path, desc.permutationFields, _computeShaders, _computeShaderLookup);
         }
 
         void ShaderHandlerVK::ReadFile(const std::string& filename, ShaderBinary& binary)
@@ -104,21 +133,14 @@ namespace Renderer
             return shaderModule;
         }
 
-        bool ShaderHandlerVK::TryFindExistingShader(const std::string& shaderPath, std::vector<Shader>& shaders, size_t& id)
+        bool ShaderHandlerVK::TryFindExistingShader(u32 shaderPathHash, ShaderLookup& shaderLookup, size_t& id)
         {
-            u32 shaderPathHash = StringUtils::fnv1a_32(shaderPath.c_str(), shaderPath.length());
-
-            id = 0;
-            for (Shader& existingShader : shaders)
-            {
-                if (StringUtils::fnv1a_32(existingShader.path.c_str(), existingShader.path.length()) == shaderPathHash)
-                {
-                    return true;
-                }
-                id++;
-            }
+            auto itr = shaderLookup.find(shaderPathHash);
+            if (itr == shaderLookup.end())
+                return false;
 
-            return false;
+            id = itr->second;
+            return true;
         }
         
         std::string ShaderHandlerVK::GetPermutationPath(const std::string& shaderPathString, const std::vector<PermutationField>& permutationFields)
@@ -195,5 +217,95 @@ namespace Renderer
 
             return _shaderCompiler->GetNumCompiledShaders() > 0;
         }
+
+        void ShaderHandlerVK::CompileIfNeeded(const std::string& shaderPath)
+        {
+            // A stale shader that still has a binary keeps using it until the background compile is done, that way editing HLSL doesn't stall the frame
+            if (!_forceRecompileAll && std::filesystem::exists(GetShaderBinPath(shaderPath)))
+            {
+                if (_isCompiling)
+                {
+                    if (std::find(_pendingCompileChecks.begin(), _pendingCompileChecks.end(), shaderPath) == _pendingCompileChecks.end())
+                    {
+                        _pendingCompileChecks.push_back(shaderPath);
+                    }
+                }
+                else if (NeedsCompile(shaderPath))
+                {
+                    QueueCompile(shaderPath);
+                }
+
+                return;
+            }
+
+            // Without a binary there is nothing to load yet, so this one has to compile right away
+            FinishBackgroundCompiles(true);
+
+            if (NeedsCompile(shaderPath))
+            {
+                //DebugHandler::Print("[ShaderCooker]: Compiling %s", shaderPath.c_str());
+                if (!CompileShader(shaderPath))
+                {
+                    DebugHandler::PrintWarning("[ShaderCooker]: Compiling %s failed, using old version", shaderPath.c_str());
+                }
+            }
+        }
+
+        void ShaderHandlerVK::QueueCompile(const std::string& shaderPath)
+        {
+            if (std::find(_queuedCompiles.begin(), _queuedCompiles.end(), shaderPath) == _queuedCompiles.end())
+            {
+                _queuedCompiles.push_back(shaderPath);
+            }
+        }
+
+        void ShaderHandlerVK::StartQueuedCompiles()
+        {
+            if (_isCompiling || _queuedCompiles.empty())
+                return;
+
+            _shaderCompiler->Start();
+            for (const std::string& shaderPath : _queuedCompiles)
+            {
+                std::filesystem::path shaderAbsolutePath = std::filesystem::path(SHADER_SOURCE_DIR) / shaderPath;
+                _shaderCompiler->AddPath(std::filesystem::absolute(shaderAbsolutePath.make_preferred()));
+            }
+            _shaderCompiler->Process();
+
+            DebugHandler::Print("[ShaderCooker]: Compiling %u shaders in the background", static_cast<u32>(_queuedCompiles.size()));
+
+            _queuedCompiles.clear();
+            _isCompiling = true;
+        }
+
+        void ShaderHandlerVK::FinishBackgroundCompiles(bool wait)
+        {
+            if (!_isCompiling)
+                return;
+
+            if (wait)
+            {
+                while (_shaderCompiler->GetStage() != ShaderCooker::ShaderCompiler::Stage::STOPPED)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            else if (_shaderCompiler->GetStage() != ShaderCooker::ShaderCompiler::Stage::STOPPED)
+            {
+                return;
+            }
+
+            _isCompiling = false;
+            _shaderCache->Save(SHADER_CACHE_PATH);
+
+            if (_shaderCompiler->GetNumCompiledShaders() > 0)
+            {
+                _hasRecompiledShaders = true;
+            }
+            else
+            {
+                DebugHandler::PrintWarning("[ShaderCooker]: Compiling shaders in the background failed, using old versions");
+            }
+        }
     }
 }
\ No newline at end of file
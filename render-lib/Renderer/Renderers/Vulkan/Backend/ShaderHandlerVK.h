@@ -5,6 +5,7 @@
 #include <vector>
 #include <unordered_map>
 #include <cassert>
+#include <robin_hood.h>
 #include <Utils/DebugHandler.h>
 
 #include "../../../Descriptors/VertexShaderDesc.h"
@@ -62,6 +63,10 @@ namespace Renderer
             void Init(RenderDeviceVK* device);
             void ReloadShaders(bool forceRecompileAll);
 
+            // Stale shaders keep using their old binary while they compile in the background, returns true once new binaries are ready
+            // The caller has to reload shaders and pipelines when this returns true
+            bool OnFrameStart();
+
             VertexShaderID LoadShader(const VertexShaderDesc& desc);
             PixelShaderID LoadShader(const PixelShaderDesc& desc);
             ComputeShaderID LoadShader(const ComputeShaderDesc& desc);
@@ -98,35 +103,32 @@ namespace Renderer
             };
 
         private:
+            typedef robin_hood::unordered_map<u32, size_t> ShaderLookup; // Permutation path hash to index
+
             template <typename T>
-            T LoadShader(const std::string& shaderPath, const std::vector<PermutationField>& permutationFields, std::vector<Shader>& shaders)
+            T LoadShader(const std::string& shaderPath, const std::vector<PermutationField>& permutationFields, std::vector<Shader>& shaders, ShaderLookup& shaderLookup)
             {
                 size_t id;
                 using idType = type_safe::underlying_type<T>;
 
                 std::string permutationPath = GetPermutationPath(shaderPath, permutationFields);
+                u32 permutationPathHash = StringUtils::fnv1a_32(permutationPath.c_str(), permutationPath.length());
 
                 // If shader is already loaded, return ID of already loaded version
-                if (TryFindExistingShader(permutationPath, shaders, id))
+                if (TryFindExistingShader(permutationPathHash, shaderLookup, id))
                 {
                     return T(static_cast<idType>(id));
                 }
 
                 // Check if we need to compile it before loading
-                if (NeedsCompile(shaderPath))
-                {
-                    //DebugHandler::Print("[ShaderCooker]: Compiling %s", shaderPath.c_str());
-                    if (!CompileShader(shaderPath))
-                    {
-                        DebugHandler::PrintWarning("[ShaderCooker]: Compiling %s failed, using old version", shaderPath.c_str());
-                    }
-                }
+                CompileIfNeeded(shaderPath);
 
                 std::string shaderBinPath = GetShaderBinPathString(permutationPath);
 
                 id = shaders.size();
                 assert(id < T::MaxValue());
 
+                shaderLookup[permutationPathHash] = id;
                 shaders.emplace_back();
                 Shader& shader = shaders.back();
                 ReadFile(shaderBinPath, shader.spirv);
@@ -169,6 +171,12 @@ namespace Renderer
                             const SpvReflectDescriptorBinding* reflectionBinding = descriptorSet->bindings[binding];
                             BindInfo bindInfo;
                             bindInfo.descriptorType = static_cast<VkDescriptorType>(reflectionBinding->descriptor_type);
+
+                            // Uniform buffers are bound as dynamic so constants allocated from the per frame ring only change the offset, not the descriptor set
+                            if (bindInfo.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
+                            {
+                                bindInfo.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+                            }
                             bindInfo.set = descriptorSet->set;
                             bindInfo.binding = reflectionBinding->binding;
                             bindInfo.count = reflectionBinding->count;
@@ -210,7 +218,7 @@ namespace Renderer
             
             void ReadFile(const std::string& filename, ShaderBinary& binary);
             VkShaderModule CreateShaderModule(const ShaderBinary& binary);
-            bool TryFindExistingShader(const std::string& shaderPath, std::vector<Shader>& shaders, size_t& id);
+            bool TryFindExistingShader(u32 shaderPathHash, ShaderLookup& shaderLookup, size_t& id);
 
             std::string GetShaderBinPathString(const std::string& shaderPath);
             std::string GetPermutationPath(const std::string& shaderPathString, const std::vector<PermutationField>& permutationFields);
@@ -218,6 +226,11 @@ namespace Renderer
             bool NeedsCompile(const std::string& shaderPath);
             bool CompileShader(const std::string& shaderPath);
 
+            void CompileIfNeeded(const std::string& shaderPath);
+            void QueueCompile(const std::string& shaderPath);
+            void StartQueuedCompiles();
+            void FinishBackgroundCompiles(bool wait);
+
         private:
             RenderDeviceVK* _device;
 
@@ -225,9 +238,19 @@ namespace Renderer
             ShaderCooker::ShaderCompiler* _shaderCompiler;
             bool _forceRecompileAll = false;
 
+            // The compiler runs one batch at a time on its own threads and owns the shader cache while it does
+            bool _isCompiling = false;
+            bool _hasRecompiledShaders = false;
+            std::vector<std::string> _queuedCompiles;
+            std::vector<std::string> _pendingCompileChecks; // Loaded while the compiler was busy, they get checked for changes once it's done
+
             std::vector<Shader> _vertexShaders;
             std::vector<Shader> _pixelShaders;
             std::vector<Shader> _computeShaders;
+
+            ShaderLookup _vertexShaderLookup;
+            ShaderLookup _pixelShaderLookup;
+            ShaderLookup _computeShaderLookup;
         };
     }
 }
@@ -3,16 +3,25 @@
 #include <Utils/DebugHandler.h>
 #include <Utils/StringUtils.h>
 #include <Utils/XXHash64.h>
+#include <Utils/ConcurrentQueue.h>
+#include <robin_hood.h>
 #include <vulkan/vulkan.h>
 #include <gli/gli.hpp>
+#include <tracy/Tracy.hpp>
 #include <vector>
 #include <queue>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "vk_mem_alloc.h"
 #include "RenderDeviceVK.h"
 #include "FormatConverterVK.h"
 #include "DebugMarkerUtilVK.h"
 #include "BufferHandlerVK.h"
+#include "UploadBufferHandlerVK.h"
+#include "DescriptorSetBuilderVK.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -24,9 +33,15 @@ namespace Renderer
 {
     namespace Backend
     {
+        constexpr u32 NUM_TEXTURE_LOAD_THREADS = 2;
+
+        // Keeps a frame from stalling on uploads when a lot of textures finish decoding at once, at least one texture is uploaded every frame
+        constexpr size_t ASYNC_TEXTURE_UPLOAD_BUDGET = 16 * 1024 * 1024; // 16 MB
+
         struct Texture
         {
             bool loaded = true;
+            bool pending = false; // Waiting on an async load, imageView points at the placeholder texture until then
             u64 hash;
 
             TextureID::type textureIndex;
@@ -39,9 +54,9 @@ namespace Renderer
             VkFormat format;
             size_t fileSize;
 
-            VmaAllocation allocation;
-            VkImage image;
-            VkImageView imageView;
+            VmaAllocation allocation = VK_NULL_HANDLE;
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView imageView = VK_NULL_HANDLE;
 
             std::string debugName = "";
         };
@@ -51,6 +66,70 @@ namespace Renderer
             u32 size;
             std::vector<TextureID> textures;
             std::vector<u64> textureHashes;
+            std::vector<u32> references; // Every load or creation into an index adds one, released indices point at the debug texture until they get reused
+            std::vector<u32> freeArrayIndices;
+
+            robin_hood::unordered_map<u64, u32> hashToArrayIndex; // Only loaded textures, data textures have no hash
+        };
+
+        // Reuses a released index if there is one so arrays that keep loading and releasing textures don't grow
+        static u32 AddToTextureArray(TextureArray& textureArray, TextureID textureID, u64 hash)
+        {
+            u32 arrayIndex;
+            if (!textureArray.freeArrayIndices.empty())
+            {
+                arrayIndex = textureArray.freeArrayIndices.back();
+                textureArray.freeArrayIndices.pop_back();
+
+                textureArray.textures[arrayIndex] = textureID;
+                textureArray.textureHashes[arrayIndex] = hash;
+                textureArray.references[arrayIndex] = 1;
+            }
+            else
+            {
+                arrayIndex = static_cast<u32>(textureArray.textures.size());
+                textureArray.textures.push_back(textureID);
+                textureArray.textureHashes.push_back(hash);
+                textureArray.references.push_back(1);
+            }
+
+            return arrayIndex;
+        }
+
+        struct TextureLoadRequest
+        {
+            TextureID::type textureIndex;
+            std::string path;
+
+            f32 priority;
+            u64 sequence; // Requests with the same priority load in the order they were made
+        };
+
+        struct TextureLoadRequestCompare
+        {
+            bool operator()(const TextureLoadRequest& a, const TextureLoadRequest& b) const
+            {
+                // std::priority_queue pops the largest element, we want the lowest priority first
+                if (a.priority != b.priority)
+                    return a.priority > b.priority;
+
+                return a.sequence > b.sequence;
+            }
+        };
+
+        struct DecodedTexture
+        {
+            TextureID::type textureIndex;
+
+            i32 width;
+            i32 height;
+            i32 layers;
+            i32 mipLevels;
+
+            VkFormat format;
+            size_t fileSize;
+
+            u8* pixels = nullptr; // nullptr if the file could not be read
         };
 
         struct TextureHandlerVKData : ITextureHandlerVKData
@@ -58,14 +137,38 @@ namespace Renderer
             std::vector<Texture> textures;
             std::queue<Texture*> freeTextureQueue;
 
+            robin_hood::unordered_map<u64, TextureID::type> hashToTextureIndex; // Only loaded textures, unloading one removes it again
+
             std::vector<TextureArray> textureArrays;
+
+            // Async loading, requests are handed to the load threads through loadRequests and come back through decodedTextures
+            std::mutex loadRequestMutex;
+            std::condition_variable loadRequestCondition;
+            std::priority_queue<TextureLoadRequest, std::vector<TextureLoadRequest>, TextureLoadRequestCompare> loadRequests;
+            u64 nextLoadRequestSequence = 0;
+            bool stopLoadThreads = false;
+
+            std::vector<std::thread> loadThreads;
+            moodycamel::ConcurrentQueue<DecodedTexture> decodedTextures;
+
+            u32 numPendingTextures = 0;
+            u32 textureArrayGeneration = 0;
         };
 
-        void TextureHandlerVK::Init(RenderDeviceVK* device, BufferHandlerVK* bufferHandler)
+        TextureHandlerVK::~TextureHandlerVK()
+        {
+            if (_data != nullptr)
+            {
+                StopLoadThreads();
+            }
+        }
+
+        void TextureHandlerVK::Init(RenderDeviceVK* device, BufferHandlerVK* bufferHandler, UploadBufferHandlerVK* uploadBufferHandler)
         {
             _data = new TextureHandlerVKData();
             _device = device;
             _bufferHandler = bufferHandler;
+            _uploadBufferHandler = uploadBufferHandler;
 
             DataTextureDesc dataTextureDesc;
             dataTextureDesc.width = 1;
@@ -77,6 +180,19 @@ namespace Renderer
             _debugOnionTexture = CreateDataTexture(dataTextureDesc);
 
             delete[] dataTextureDesc.data;
+
+            u8 placeholderPixel[4] = { 127, 127, 127, 255 };
+
+            DataTextureDesc placeholderTextureDesc;
+            placeholderTextureDesc.width = 1;
+            placeholderTextureDesc.height = 1;
+            placeholderTextureDesc.format = ImageFormat::R8G8B8A8_UNORM;
+            placeholderTextureDesc.data = placeholderPixel;
+            placeholderTextureDesc.debugName = "PlaceholderTexture";
+
+            _placeholderTexture = CreateDataTexture(placeholderTextureDesc);
+
+            StartLoadThreads();
         }
 
         void TextureHandlerVK::LoadDebugTexture(const TextureDesc& desc)
@@ -127,10 +243,139 @@ namespace Renderer
             CreateTexture(texture, pixels);
 
             data.textures.push_back(texture);
+            data.hashToTextureIndex[cacheDescHash] = texture.textureIndex;
+
             return TextureID(static_cast<TextureID::type>(nextHandle));
         }
 
         TextureID TextureHandlerVK::LoadTextureIntoArray(const TextureDesc& desc, TextureArrayID textureArrayID, u32& arrayIndex)
+        {
+            return LoadIntoArray(desc, textureArrayID, arrayIndex, false, 0.0f);
+        }
+
+        TextureID TextureHandlerVK::LoadTextureAsync(const TextureDesc& desc, f32 priority)
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+
+            // Same cache as LoadTexture, a texture that is still pending is handed out as well
+            size_t nextID;
+            u64 cacheDescHash = CalculateDescHash(desc);
+            if (TryFindExistingTexture(cacheDescHash, nextID))
+            {
+                TextureID::type id = static_cast<TextureID::type>(nextID);
+                Texture& texture = data.textures[id];
+                if (texture.loaded)
+                {
+                    return TextureID(id);
+                }
+            }
+
+            size_t nextHandle = data.textures.size();
+
+            // Make sure we haven't exceeded the limit of the ImageID type, if this hits you need to change type of ImageID to something bigger
+            if (nextHandle >= TextureID::MaxValue())
+            {
+                DebugHandler::PrintFatal("We exceeded the limit of the TextureID type!");
+            }
+
+            const Texture& placeholderTexture = data.textures[static_cast<TextureID::type>(_placeholderTexture)];
+
+            // Describe the placeholder until the real texture is decoded, the image itself stays owned by the placeholder
+            Texture texture;
+            texture.pending = true;
+            texture.hash = cacheDescHash;
+            texture.debugName = desc.path;
+            texture.textureIndex = static_cast<TextureID::type>(nextHandle);
+            texture.width = placeholderTexture.width;
+            texture.height = placeholderTexture.height;
+            texture.layers = placeholderTexture.layers;
+            texture.mipLevels = placeholderTexture.mipLevels;
+            texture.format = placeholderTexture.format;
+            texture.fileSize = 0;
+            texture.imageView = placeholderTexture.imageView;
+
+            data.textures.push_back(texture);
+            data.hashToTextureIndex[cacheDescHash] = texture.textureIndex;
+            data.numPendingTextures++;
+
+            {
+                std::lock_guard<std::mutex> lock(data.loadRequestMutex);
+
+                TextureLoadRequest request;
+                request.textureIndex = texture.textureIndex;
+                request.path = desc.path;
+                request.priority = priority;
+                request.sequence = data.nextLoadRequestSequence++;
+
+                data.loadRequests.push(std::move(request));
+            }
+            data.loadRequestCondition.notify_one();
+
+            return TextureID(static_cast<TextureID::type>(nextHandle));
+        }
+
+        TextureID TextureHandlerVK::LoadTextureIntoArrayAsync(const TextureDesc& desc, TextureArrayID textureArrayID, u32& arrayIndex, f32 priority)
+        {
+            return LoadIntoArray(desc, textureArrayID, arrayIndex, true, priority);
+        }
+
+        void TextureHandlerVK::FinishAsyncLoads()
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+
+            if (data.decodedTextures.size_approx() == 0)
+                return;
+
+            ZoneScopedNC("TextureHandlerVK::FinishAsyncLoads", tracy::Color::Red3);
+
+            size_t uploadedSize = 0;
+
+            DecodedTexture decodedTexture;
+            while (uploadedSize < ASYNC_TEXTURE_UPLOAD_BUDGET && data.decodedTextures.try_dequeue(decodedTexture))
+            {
+                Texture& texture = data.textures[decodedTexture.textureIndex];
+
+                // The texture got unloaded while it was being decoded
+                if (!texture.pending)
+                {
+                    delete[] decodedTexture.pixels;
+                    continue;
+                }
+
+                texture.pending = false;
+                data.numPendingTextures--;
+
+                if (decodedTexture.pixels == nullptr)
+                {
+                    DebugHandler::PrintError("Failed to load texture, it keeps using the placeholder (%s)", texture.debugName.c_str());
+                    continue;
+                }
+
+                texture.width = decodedTexture.width;
+                texture.height = decodedTexture.height;
+                texture.layers = decodedTexture.layers;
+                texture.mipLevels = decodedTexture.mipLevels;
+                texture.format = decodedTexture.format;
+                texture.fileSize = decodedTexture.fileSize;
+
+                CreateImage(texture);
+                data.textureArrayGeneration++;
+
+                // The upload is submitted before the next command list, which is also the first one that can bind the new image view
+                void* stagingMemory = _uploadBufferHandler->StageImageUpload(texture.image, texture.format, static_cast<u32>(texture.width), static_cast<u32>(texture.height), texture.layers, texture.mipLevels, texture.fileSize);
+                if (stagingMemory == nullptr)
+                {
+                    DebugHandler::PrintFatal("Failed to stage texture upload! (%s)", texture.debugName.c_str());
+                }
+
+                memcpy(stagingMemory, decodedTexture.pixels, texture.fileSize);
+                delete[] decodedTexture.pixels;
+
+                uploadedSize += texture.fileSize;
+            }
+        }
+
+        TextureID TextureHandlerVK::LoadIntoArray(const TextureDesc& desc, TextureArrayID textureArrayID, u32& arrayIndex, bool async, f32 priority)
         {
             TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
             TextureID textureID;
@@ -147,6 +392,7 @@ namespace Renderer
             if (TryFindExistingTextureInArray(textureArrayID, descHash, nextID, textureID))
             {
                 arrayIndex = static_cast<u32>(nextID);
+                data.textureArrays[static_cast<TextureArrayID::type>(textureArrayID)].references[arrayIndex]++;
                 return textureID; // This texture already exists in this array
             }
 
@@ -158,14 +404,12 @@ namespace Renderer
                 DebugHandler::PrintFatal("Tried to load into a TextureArrayID which doesn't exist! (%u)", id);
             }
 
-            textureID = LoadTexture(desc);
-
-            Texture& texture = data.textures[static_cast<TextureID::type>(textureID)];
+            textureID = async ? LoadTextureAsync(desc, priority) : LoadTexture(desc);
 
             TextureArray& textureArray = data.textureArrays[static_cast<TextureArrayID::type>(textureArrayID)];
-            arrayIndex = static_cast<u32>(textureArray.textures.size());
-            textureArray.textures.push_back(textureID);
-            textureArray.textureHashes.push_back(descHash);
+            arrayIndex = AddToTextureArray(textureArray, textureID, descHash);
+            textureArray.hashToArrayIndex[descHash] = arrayIndex;
+            data.textureArrayGeneration++;
 
             return textureID;
         }
@@ -180,12 +424,40 @@ namespace Renderer
                 return;
             }
 
+            auto itr = data.hashToTextureIndex.find(texture.hash);
+            if (itr != data.hashToTextureIndex.end() && itr->second == static_cast<TextureID::type>(textureID))
+            {
+                data.hashToTextureIndex.erase(itr);
+            }
+
             texture.loaded = false;
             texture.hash = 0;
 
-            vmaFreeMemory(_device->_allocator, texture.allocation);
-            vkDestroyImage(_device->_device, texture.image, nullptr);
-            vkDestroyImageView(_device->_device, texture.imageView, nullptr);
+            if (texture.pending)
+            {
+                texture.pending = false;
+                data.numPendingTextures--;
+
+                // Every request still in the queue is for a texture that got unloaded, no need to decode them
+                if (data.numPendingTextures == 0)
+                {
+                    std::lock_guard<std::mutex> lock(data.loadRequestMutex);
+                    data.loadRequests = decltype(data.loadRequests)();
+                }
+            }
+
+            // Textures that never finished loading point at the placeholder and have no image of their own
+            if (texture.image != VK_NULL_HANDLE)
+            {
+                _device->_descriptorMegaPool->OnHandleDestroyed(DescriptorMegaPoolVK::GetHandleKey(texture.imageView));
+
+                vmaFreeMemory(_device->_allocator, texture.allocation);
+                vkDestroyImage(_device->_device, texture.image, nullptr);
+                vkDestroyImageView(_device->_device, texture.imageView, nullptr);
+            }
+            data.textureArrayGeneration++;
+            texture.image = VK_NULL_HANDLE;
+            texture.imageView = VK_NULL_HANDLE;
 
             data.freeTextureQueue.push(&texture);
         }
@@ -197,11 +469,68 @@ namespace Renderer
 
             for (u32 i = unloadStartIndex; i < textureArray.textures.size(); i++)
             {
+                // Released indices point at the debug texture, which isn't ours to unload
+                if (textureArray.references[i] == 0)
+                    continue;
+
                 UnloadTexture(textureArray.textures[i]);
+                textureArray.hashToArrayIndex.erase(textureArray.textureHashes[i]);
+            }
+
+            if (unloadStartIndex < textureArray.textures.size())
+            {
+                textureArray.textureHashes.resize(unloadStartIndex);
+                textureArray.textures.resize(unloadStartIndex);
+                textureArray.references.resize(unloadStartIndex);
             }
 
-            textureArray.textureHashes.resize(unloadStartIndex);
-            textureArray.textures.resize(unloadStartIndex);
+            auto removedIndices = std::remove_if(textureArray.freeArrayIndices.begin(), textureArray.freeArrayIndices.end(), [unloadStartIndex](u32 arrayIndex) { return arrayIndex >= unloadStartIndex; });
+            textureArray.freeArrayIndices.erase(removedIndices, textureArray.freeArrayIndices.end());
+        }
+
+        void TextureHandlerVK::ReleaseTexturesInArray(const TextureArrayID textureArrayID, const u32* arrayIndices, u32 numArrayIndices, std::vector<u32>& outUnreferencedArrayIndices)
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+            TextureArray& textureArray = data.textureArrays[static_cast<TextureArrayID::type>(textureArrayID)];
+
+            for (u32 i = 0; i < numArrayIndices; i++)
+            {
+                u32 arrayIndex = arrayIndices[i];
+                if (arrayIndex >= textureArray.textures.size() || textureArray.references[arrayIndex] == 0)
+                {
+                    DebugHandler::PrintFatal("Tried to release index %u in a texture array which isn't in use", arrayIndex);
+                }
+
+                if (--textureArray.references[arrayIndex] == 0)
+                {
+                    outUnreferencedArrayIndices.push_back(arrayIndex);
+                }
+            }
+        }
+
+        void TextureHandlerVK::UnloadUnreferencedTexturesInArray(const TextureArrayID textureArrayID, const std::vector<u32>& unreferencedArrayIndices)
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+            TextureArray& textureArray = data.textureArrays[static_cast<TextureArrayID::type>(textureArrayID)];
+
+            for (u32 arrayIndex : unreferencedArrayIndices)
+            {
+                TextureID textureID = textureArray.textures[arrayIndex];
+                const bool isOnionTexture = IsOnionTexture(textureID);
+
+                UnloadTexture(textureID);
+
+                u64 hash = textureArray.textureHashes[arrayIndex];
+                if (hash != 0)
+                {
+                    textureArray.hashToArrayIndex.erase(hash);
+                }
+
+                // The descriptor still has to point at something valid until the index gets reused
+                textureArray.textures[arrayIndex] = isOnionTexture ? _debugOnionTexture : _debugTexture;
+                textureArray.textureHashes[arrayIndex] = 0;
+                textureArray.freeArrayIndices.push_back(arrayIndex);
+            }
         }
 
         TextureArrayID TextureHandlerVK::CreateTextureArray(const TextureArrayDesc& desc)
@@ -277,13 +606,39 @@ namespace Renderer
             Texture& texture = data.textures[static_cast<TextureID::type>(textureID)];
 
             TextureArray& textureArray = data.textureArrays[static_cast<TextureArrayID::type>(textureArrayID)];
-            arrayIndex = static_cast<u32>(textureArray.textures.size());
-            textureArray.textures.push_back(textureID);
-            textureArray.textureHashes.push_back(0);
+            arrayIndex = AddToTextureArray(textureArray, textureID, 0);
+            data.textureArrayGeneration++;
 
             return textureID;
         }
 
+        void TextureHandlerVK::UpdateDataTexture(const TextureID textureID, u32 x, u32 y, u32 width, u32 height, const void* pixels)
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+            Texture& texture = data.textures[static_cast<TextureID::type>(textureID)];
+
+            if (texture.image == VK_NULL_HANDLE || texture.pending || texture.layers != 1 || FormatIsCompressed(texture.format))
+            {
+                DebugHandler::PrintFatal("Tried to update a texture that isn't an uncompressed single layer data texture (%s)", texture.debugName.c_str());
+            }
+
+            if (width == 0 || height == 0 || x + width > static_cast<u32>(texture.width) || y + height > static_cast<u32>(texture.height))
+            {
+                DebugHandler::PrintFatal("Tried to update DataTexture outside of its bounds (x %u, y %u, width %u, height %u) (%s)", x, y, width, height, texture.debugName.c_str());
+            }
+
+            size_t size = Math::RoofToInt(static_cast<f64>(width) * static_cast<f64>(height) * FormatTexelSize(texture.format));
+
+            // Staged like the async texture uploads, the batch gets submitted before the next command list
+            void* stagingMemory = _uploadBufferHandler->StageImageRegionUpload(texture.image, x, y, width, height, size);
+            if (stagingMemory == nullptr)
+            {
+                DebugHandler::PrintFatal("Failed to stage texture upload! (%s)", texture.debugName.c_str());
+            }
+
+            memcpy(stagingMemory, pixels, size);
+        }
+
         const std::vector<TextureID>& TextureHandlerVK::GetTextureIDsInArray(const TextureArrayID textureArrayID)
         {
             TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
@@ -350,6 +705,12 @@ namespace Renderer
             return data.textureArrays[static_cast<TextureArrayID::type>(textureArrayID)].size;
         }
 
+        u32 TextureHandlerVK::GetTextureArrayGeneration()
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+            return data.textureArrayGeneration;
+        }
+
         u64 TextureHandlerVK::CalculateDescHash(const TextureDesc& desc)
         {
             u64 hash = XXHash64::hash(desc.path.c_str(), desc.path.size(), 0);
@@ -359,18 +720,13 @@ namespace Renderer
         bool TextureHandlerVK::TryFindExistingTexture(u64 descHash, size_t& id)
         {
             TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
-            id = 0;
 
-            for (auto& texture : data.textures)
-            {
-                if (descHash == texture.hash)
-                {
-                    return true;
-                }
-                id++;
-            }
+            auto itr = data.hashToTextureIndex.find(descHash);
+            if (itr == data.hashToTextureIndex.end())
+                return false;
 
-            return false;
+            id = itr->second;
+            return true;
         }
 
         bool TextureHandlerVK::TryFindExistingTextureInArray(TextureArrayID textureArrayID, u64 descHash, size_t& arrayIndex, TextureID& textureID)
@@ -384,16 +740,13 @@ namespace Renderer
 
             TextureArray& array = data.textureArrays[id];
 
-            for (arrayIndex = 0; arrayIndex < array.textureHashes.size(); arrayIndex++)
-            {
-                if (descHash == array.textureHashes[arrayIndex])
-                {
-                    textureID = array.textures[arrayIndex];
-                    return true;
-                }
-            }
+            auto itr = array.hashToArrayIndex.find(descHash);
+            if (itr == array.hashToArrayIndex.end())
+                return false;
 
-            return false;
+            arrayIndex = itr->second;
+            textureID = array.textures[arrayIndex];
+            return true;
         }
 
         u8* TextureHandlerVK::ReadFile(const std::string& filename, i32& width, i32& height, i32& layers, i32& mipLevels, VkFormat& format, size_t& fileSize)
@@ -410,7 +763,8 @@ namespace Renderer
                 gli::texture texture = gli::load(filename);
                 if (texture.empty())
                 {
-                    DebugHandler::PrintFatal("Failed to load texture (%s)", filename.c_str());
+                    DebugHandler::PrintError("Failed to load texture (%s)", filename.c_str());
+                    return nullptr;
                 }
 
                 gli::gl gl(gli::gl::PROFILE_GL33);
@@ -433,26 +787,15 @@ namespace Renderer
 
                 textureMemory = new u8[fileSize];
                 memcpy(textureMemory, pixels, fileSize);
+
+                stbi_image_free(pixels);
             }
 
             return textureMemory;
         }
 
-        void TextureHandlerVK::CreateTexture(Texture& texture, u8* pixels)
+        void TextureHandlerVK::CreateImage(Texture& texture)
         {
-            // Create staging buffer
-            BufferDesc bufferDesc;
-            bufferDesc.name = texture.debugName + "_StagingBuffer";
-            bufferDesc.size = texture.fileSize;
-            bufferDesc.usage = BufferUsage::TRANSFER_SOURCE;
-            bufferDesc.cpuAccess = BufferCPUAccess::WriteOnly;
-            BufferID stagingBuffer = _bufferHandler->CreateBuffer(bufferDesc);
-
-            void* data;
-            vmaMapMemory(_device->_allocator, _bufferHandler->GetBufferAllocation(stagingBuffer), &data);
-            memcpy(data, pixels, texture.fileSize);
-            vmaUnmapMemory(_device->_allocator, _bufferHandler->GetBufferAllocation(stagingBuffer));
-
             // Create image
             VkImageCreateInfo imageInfo = {};
             imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -480,13 +823,6 @@ namespace Renderer
 
             DebugMarkerUtilVK::SetObjectName(_device->_device, (u64)texture.image, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_EXT, texture.debugName.c_str());
 
-            // Copy data from stagingBuffer into image
-            _device->TransitionImageLayout(texture.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, texture.layers, texture.mipLevels);
-            _device->CopyBufferToImage(_bufferHandler->GetBuffer(stagingBuffer), texture.image, texture.format, static_cast<u32>(texture.width), static_cast<u32>(texture.height), texture.layers, texture.mipLevels);
-            _device->TransitionImageLayout(texture.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, texture.layers, texture.mipLevels);
-
-            _bufferHandler->DestroyBuffer(stagingBuffer);
-
             // Create color view
             VkImageViewCreateInfo viewInfo = {};
             viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -506,5 +842,91 @@ namespace Renderer
 
             DebugMarkerUtilVK::SetObjectName(_device->_device, (u64)texture.imageView, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_VIEW_EXT, texture.debugName.c_str());
         }
+
+        void TextureHandlerVK::CreateTexture(Texture& texture, u8* pixels)
+        {
+            // Create staging buffer
+            BufferDesc bufferDesc;
+            bufferDesc.name = texture.debugName + "_StagingBuffer";
+            bufferDesc.size = texture.fileSize;
+            bufferDesc.usage = BufferUsage::TRANSFER_SOURCE;
+            bufferDesc.cpuAccess = BufferCPUAccess::WriteOnly;
+            BufferID stagingBuffer = _bufferHandler->CreateBuffer(bufferDesc);
+
+            void* data;
+            vmaMapMemory(_device->_allocator, _bufferHandler->GetBufferAllocation(stagingBuffer), &data);
+            memcpy(data, pixels, texture.fileSize);
+            vmaUnmapMemory(_device->_allocator, _bufferHandler->GetBufferAllocation(stagingBuffer));
+
+            CreateImage(texture);
+
+            // Copy data from stagingBuffer into image
+            _device->TransitionImageLayout(texture.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, texture.layers, texture.mipLevels);
+            _device->CopyBufferToImage(_bufferHandler->GetBuffer(stagingBuffer), texture.image, texture.format, static_cast<u32>(texture.width), static_cast<u32>(texture.height), texture.layers, texture.mipLevels);
+            _device->TransitionImageLayout(texture.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, texture.layers, texture.mipLevels);
+
+            _bufferHandler->DestroyBuffer(stagingBuffer);
+        }
+
+        void TextureHandlerVK::StartLoadThreads()
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+
+            for (u32 i = 0; i < NUM_TEXTURE_LOAD_THREADS; i++)
+            {
+                data.loadThreads.emplace_back(&TextureHandlerVK::LoadThreadMain, this);
+            }
+        }
+
+        void TextureHandlerVK::StopLoadThreads()
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+
+            {
+                std::lock_guard<std::mutex> lock(data.loadRequestMutex);
+                data.stopLoadThreads = true;
+            }
+            data.loadRequestCondition.notify_all();
+
+            for (std::thread& thread : data.loadThreads)
+            {
+                thread.join();
+            }
+            data.loadThreads.clear();
+
+            DecodedTexture decodedTexture;
+            while (data.decodedTextures.try_dequeue(decodedTexture))
+            {
+                delete[] decodedTexture.pixels;
+            }
+        }
+
+        void TextureHandlerVK::LoadThreadMain()
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+
+            while (true)
+            {
+                TextureLoadRequest request;
+                {
+                    std::unique_lock<std::mutex> lock(data.loadRequestMutex);
+                    data.loadRequestCondition.wait(lock, [&data]() { return data.stopLoadThreads || !data.loadRequests.empty(); });
+
+                    if (data.stopLoadThreads)
+                        return;
+
+                    request = data.loadRequests.top();
+                    data.loadRequests.pop();
+                }
+
+                ZoneScopedNC("TextureHandlerVK::DecodeTexture", tracy::Color::Red3);
+
+                DecodedTexture decodedTexture;
+                decodedTexture.textureIndex = request.textureIndex;
+                decodedTexture.pixels = ReadFile(request.path, decodedTexture.width, decodedTexture.height, decodedTexture.layers, decodedTexture.mipLevels, decodedTexture.format, decodedTexture.fileSize);
+
+                data.decodedTextures.enqueue(decodedTexture);
+            }
+        }
     }
-}
\ No newline at end of file
+}
@@ -11,6 +11,7 @@ namespace Renderer
     {
         class RenderDeviceVK;
         class BufferHandlerVK;
+        class UploadBufferHandlerVK;
         struct Texture;
 
         struct ITextureHandlerVKData {};
@@ -18,20 +19,34 @@ namespace Renderer
         class TextureHandlerVK
         {
         public:
-            void Init(RenderDeviceVK* device, BufferHandlerVK* bufferHandler);
+            ~TextureHandlerVK();
+
+            void Init(RenderDeviceVK* device, BufferHandlerVK* bufferHandler, UploadBufferHandlerVK* uploadBufferHandler);
 
             void LoadDebugTexture(const TextureDesc& desc);
 
             TextureID LoadTexture(const TextureDesc& desc);
             TextureID LoadTextureIntoArray(const TextureDesc& desc, TextureArrayID textureArrayID, u32& arrayIndex);
 
+            // Returns right away, the texture is bound to the placeholder texture until a load thread has decoded it and FinishAsyncLoads has uploaded it
+            TextureID LoadTextureAsync(const TextureDesc& desc, f32 priority);
+            TextureID LoadTextureIntoArrayAsync(const TextureDesc& desc, TextureArrayID textureArrayID, u32& arrayIndex, f32 priority);
+
+            // Stages uploads for textures the load threads have finished decoding, called once per frame
+            void FinishAsyncLoads();
+
             void UnloadTexture(const TextureID textureID);
             void UnloadTexturesInArray(const TextureArrayID textureArrayID, u32 unloadStartIndex);
+            // Drops a reference from every index, the ones nothing references anymore are added to outUnreferencedArrayIndices
+            void ReleaseTexturesInArray(const TextureArrayID textureArrayID, const u32* arrayIndices, u32 numArrayIndices, std::vector<u32>& outUnreferencedArrayIndices);
+            // The GPU has to be done with the textures before they get unloaded
+            void UnloadUnreferencedTexturesInArray(const TextureArrayID textureArrayID, const std::vector<u32>& unreferencedArrayIndices);
 
             TextureArrayID CreateTextureArray(const TextureArrayDesc& desc);
 
             TextureID CreateDataTexture(const DataTextureDesc& desc);
             TextureID CreateDataTextureIntoArray(const DataTextureDesc& desc, TextureArrayID textureArrayID, u32& arrayIndex);
+            void UpdateDataTexture(const TextureID textureID, u32 x, u32 y, u32 width, u32 height, const void* pixels);
 
             const std::vector<TextureID>& GetTextureIDsInArray(const TextureArrayID textureID);
 
@@ -43,21 +58,34 @@ namespace Renderer
 
             u32 GetTextureArraySize(const TextureArrayID textureArrayID);
 
+            // Changes whenever an image view in any texture array might have changed, descriptor sets with texture arrays are cached by it
+            u32 GetTextureArrayGeneration();
+
         private:
             u64 CalculateDescHash(const TextureDesc& desc);
             bool TryFindExistingTexture(u64 descHash, size_t& id);
             bool TryFindExistingTextureInArray(TextureArrayID textureArrayID, u64 descHash, size_t& arrayIndex, TextureID& textureID);
 
-            u8* ReadFile(const std::string& filename, i32& width, i32& height, i32& layers, i32& mipLevels, VkFormat& format, size_t& fileSize);
+            TextureID LoadIntoArray(const TextureDesc& desc, TextureArrayID textureArrayID, u32& arrayIndex, bool async, f32 priority);
+
+            // Only touches its arguments so the load threads can call it
+            static u8* ReadFile(const std::string& filename, i32& width, i32& height, i32& layers, i32& mipLevels, VkFormat& format, size_t& fileSize);
+            void CreateImage(Texture& texture);
             void CreateTexture(Texture& texture, u8* pixels);
 
+            void StartLoadThreads();
+            void StopLoadThreads();
+            void LoadThreadMain();
+
         private:
-            ITextureHandlerVKData* _data;
+            ITextureHandlerVKData* _data = nullptr;
 
             RenderDeviceVK* _device;
             BufferHandlerVK* _bufferHandler;
+            UploadBufferHandlerVK* _uploadBufferHandler;
 
             TextureID _debugTexture;
+            TextureID _placeholderTexture; // 1x1 texture that async loaded textures point to until they are uploaded
             TextureID _debugOnionTexture; // "TextureArrays" using texture layers rather than arrays of descriptors are now called Onion Textures to make it possible to differentiate between them...
         };
     }
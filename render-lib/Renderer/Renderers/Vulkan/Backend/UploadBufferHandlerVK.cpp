@@ -0,0 +1,471 @@
+#include "UploadBufferHandlerVK.h"
+#include "RenderDeviceVK.h"
+#include "DebugMarkerUtilVK.h"
+
+#include <deque>
+#include <vector>
+#include <cassert>
+#include <vulkan/vulkan.h>
+#include <Utils/DebugHandler.h>
+#include <tracy/Tracy.hpp>
+#include "vk_mem_alloc.h"
+
+namespace Renderer
+{
+    namespace Backend
+    {
+        constexpr u64 STAGING_RING_SIZE = 64 * 1024 * 1024; // 64 MB
+        constexpr u64 STAGING_ALIGNMENT = 16;
+
+        // Uploads bigger than this get their own staging buffer so a single big upload doesn't stall the ring
+        constexpr u64 MAX_RING_UPLOAD_SIZE = STAGING_RING_SIZE / 4;
+
+        struct DedicatedStagingBuffer
+        {
+            VkBuffer buffer;
+            VmaAllocation allocation;
+        };
+
+        struct UploadBatch
+        {
+            UploadBatchID::type id = 0;
+
+            VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+            VkFence fence = VK_NULL_HANDLE;
+
+            u64 ringEnd = 0; // The ring head when this batch was submitted, the tail moves here once the GPU is done with it
+
+            std::vector<DedicatedStagingBuffer> dedicatedBuffers;
+        };
+
+        struct UploadBufferHandlerVKData : IUploadBufferHandlerVKData
+        {
+            VkBuffer ringBuffer;
+            VmaAllocation ringAllocation;
+            u8* ringMemory = nullptr;
+
+            // Head and tail only ever grow, the position in the ring is offset % STAGING_RING_SIZE
+            u64 head = 0;
+            u64 tail = 0;
+
+            VkCommandPool commandPool;
+            std::vector<VkCommandBuffer> availableCommandBuffers;
+            std::vector<VkFence> availableFences;
+
+            bool hasOpenBatch = false;
+            UploadBatch openBatch;
+            std::deque<UploadBatch> inFlightBatches;
+
+            UploadBatchID::type nextBatchID = 0;
+            UploadBatchID::type numFinishedBatches = 0;
+        };
+
+        void UploadBufferHandlerVK::Init(RenderDeviceVK* device)
+        {
+            _device = device;
+
+            UploadBufferHandlerVKData* data = new UploadBufferHandlerVKData();
+            _data = data;
+
+            // Create the staging ring, it stays mapped for the lifetime of the handler
+            VkBufferCreateInfo bufferInfo = {};
+            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = STAGING_RING_SIZE;
+            bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            VmaAllocationCreateInfo allocInfo = {};
+            allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+            VmaAllocationInfo allocationInfo;
+            if (vmaCreateBuffer(_device->_allocator, &bufferInfo, &allocInfo, &data->ringBuffer, &data->ringAllocation, &allocationInfo) != VK_SUCCESS)
+            {
+                DebugHandler::PrintFatal("Failed to create staging ring buffer!");
+            }
+            data->ringMemory = static_cast<u8*>(allocationInfo.pMappedData);
+
+            DebugMarkerUtilVK::SetObjectName(_device->_device, (u64)data->ringBuffer, VK_DEBUG_REPORT_OBJECT_TYPE_BUFFER_EXT, "StagingRingBuffer");
+
+            QueueFamilyIndices queueFamilyIndices = _device->FindQueueFamilies(_device->_physicalDevice);
+
+            VkCommandPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+            if (vkCreateCommandPool(_device->_device, &poolInfo, nullptr, &data->commandPool) != VK_SUCCESS)
+            {
+                DebugHandler::PrintFatal("Failed to create upload command pool!");
+            }
+        }
+
+        void* UploadBufferHandlerVK::StageUpload(VkBuffer dstBuffer, u64 dstOffset, u64 size)
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            VkBuffer srcBuffer;
+            u64 srcOffset;
+            void* mappedMemory = AllocateStaging(size, srcBuffer, srcOffset);
+            if (mappedMemory == nullptr)
+                return nullptr;
+
+            VkBufferCopy copyRegion = {};
+            copyRegion.srcOffset = srcOffset;
+            copyRegion.dstOffset = dstOffset;
+            copyRegion.size = size;
+            vkCmdCopyBuffer(data.openBatch.commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+
+            return mappedMemory;
+        }
+
+        void* UploadBufferHandlerVK::StageImageUpload(VkImage dstImage, VkFormat format, u32 width, u32 height, u32 numLayers, u32 numMipLevels, u64 size)
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            VkBuffer srcBuffer;
+            u64 srcOffset;
+            void* mappedMemory = AllocateStaging(size, srcBuffer, srcOffset);
+            if (mappedMemory == nullptr)
+                return nullptr;
+
+            VkCommandBuffer commandBuffer = data.openBatch.commandBuffer;
+            _device->TransitionImageLayout(commandBuffer, dstImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, numLayers, numMipLevels);
+            _device->CopyBufferToImage(commandBuffer, srcBuffer, srcOffset, dstImage, format, width, height, numLayers, numMipLevels);
+            _device->TransitionImageLayout(commandBuffer, dstImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, numLayers, numMipLevels);
+
+            return mappedMemory;
+        }
+
+        void* UploadBufferHandlerVK::StageImageRegionUpload(VkImage dstImage, u32 x, u32 y, u32 width, u32 height, u64 size)
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            VkBuffer srcBuffer;
+            u64 srcOffset;
+            void* mappedMemory = AllocateStaging(size, srcBuffer, srcOffset);
+            if (mappedMemory == nullptr)
+                return nullptr;
+
+            // Transitioning from the sampled layout instead of UNDEFINED keeps the contents outside of the region
+            VkCommandBuffer commandBuffer = data.openBatch.commandBuffer;
+            _device->TransitionImageLayout(commandBuffer, dstImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, 1);
+
+            VkBufferImageCopy region = {};
+            region.bufferOffset = srcOffset;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = 0;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = { static_cast<i32>(x), static_cast<i32>(y), 0 };
+            region.imageExtent = { width, height, 1 };
+            vkCmdCopyBufferToImage(commandBuffer, srcBuffer, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+            _device->TransitionImageLayout(commandBuffer, dstImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 1, 1);
+
+            return mappedMemory;
+        }
+
+        UploadBatchID UploadBufferHandlerVK::SubmitUploads()
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            if (!data.hasOpenBatch)
+            {
+                // Nothing staged since the last submit, hand out the last submitted batch instead
+                if (data.nextBatchID == 0)
+                    return UploadBatchID::Invalid();
+
+                return UploadBatchID(data.nextBatchID - 1);
+            }
+
+            ZoneScopedNC("UploadBufferHandlerVK::SubmitUploads", tracy::Color::Red3);
+
+            UploadBatch& batch = data.openBatch;
+
+            // Make the copies visible to everything submitted after this batch
+            VkMemoryBarrier memoryBarrier = {};
+            memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+            vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+            if (vkEndCommandBuffer(batch.commandBuffer) != VK_SUCCESS)
+            {
+                DebugHandler::PrintFatal("Failed to record upload command buffer!");
+            }
+
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &batch.commandBuffer;
+
+            if (vkQueueSubmit(_device->_graphicsQueue, 1, &submitInfo, batch.fence) != VK_SUCCESS)
+            {
+                DebugHandler::PrintFatal("Failed to submit upload batch!");
+            }
+
+            batch.ringEnd = data.head;
+
+            UploadBatchID batchID = UploadBatchID(batch.id);
+            data.inFlightBatches.push_back(std::move(batch));
+
+            data.openBatch = UploadBatch();
+            data.hasOpenBatch = false;
+
+            return batchID;
+        }
+
+        bool UploadBufferHandlerVK::HasPendingUploads()
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+            return data.hasOpenBatch;
+        }
+
+        bool UploadBufferHandlerVK::IsUploadFinished(UploadBatchID batchID)
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            if (batchID == UploadBatchID::Invalid())
+                return true;
+
+            RetireFinishedBatches();
+
+            // Batches finish in submission order since they all go through the graphics queue
+            return static_cast<UploadBatchID::type>(batchID) < data.numFinishedBatches;
+        }
+
+        void UploadBufferHandlerVK::WaitForUpload(UploadBatchID batchID)
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            if (batchID == UploadBatchID::Invalid())
+                return;
+
+            // Waiting on the open batch means it has to be submitted first
+            if (data.hasOpenBatch && static_cast<UploadBatchID::type>(batchID) >= data.openBatch.id)
+            {
+                SubmitUploads();
+            }
+
+            while (static_cast<UploadBatchID::type>(batchID) >= data.numFinishedBatches && !data.inFlightBatches.empty())
+            {
+                RetireOldestBatch(true);
+            }
+        }
+
+        void UploadBufferHandlerVK::RetireFinishedBatches()
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            while (!data.inFlightBatches.empty())
+            {
+                UploadBatch& batch = data.inFlightBatches.front();
+                if (vkGetFenceStatus(_device->_device, batch.fence) != VK_SUCCESS)
+                    break;
+
+                RetireOldestBatch(false);
+            }
+        }
+
+        void* UploadBufferHandlerVK::AllocateStaging(u64 size, VkBuffer& outBuffer, u64& outOffset)
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            assert(size > 0);
+
+            void* mappedMemory = nullptr;
+            outOffset = 0;
+
+            if (size > MAX_RING_UPLOAD_SIZE)
+            {
+                mappedMemory = AllocateDedicated(size, outBuffer);
+                if (mappedMemory == nullptr)
+                    return nullptr;
+            }
+            else
+            {
+                u64 ringPosition;
+                if (!AllocateFromRing(size, ringPosition))
+                    return nullptr;
+
+                outBuffer = data.ringBuffer;
+                outOffset = ringPosition % STAGING_RING_SIZE;
+                mappedMemory = data.ringMemory + outOffset;
+            }
+
+            // Allocating might have submitted the open batch to make room, so the batch is opened afterwards
+            if (!data.hasOpenBatch)
+            {
+                OpenBatch();
+            }
+
+            return mappedMemory;
+        }
+
+        void UploadBufferHandlerVK::OpenBatch()
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            UploadBatch& batch = data.openBatch;
+            batch.id = data.nextBatchID++;
+
+            if (!data.availableCommandBuffers.empty())
+            {
+                batch.commandBuffer = data.availableCommandBuffers.back();
+                data.availableCommandBuffers.pop_back();
+            }
+            else
+            {
+                VkCommandBufferAllocateInfo allocInfo = {};
+                allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+                allocInfo.commandPool = data.commandPool;
+                allocInfo.commandBufferCount = 1;
+
+                if (vkAllocateCommandBuffers(_device->_device, &allocInfo, &batch.commandBuffer) != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("Failed to allocate upload command buffer!");
+                }
+            }
+
+            if (!data.availableFences.empty())
+            {
+                batch.fence = data.availableFences.back();
+                data.availableFences.pop_back();
+            }
+            else
+            {
+                VkFenceCreateInfo fenceInfo = {};
+                fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+                if (vkCreateFence(_device->_device, &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("Failed to create upload fence!");
+                }
+            }
+
+            VkCommandBufferBeginInfo beginInfo = {};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+            if (vkBeginCommandBuffer(batch.commandBuffer, &beginInfo) != VK_SUCCESS)
+            {
+                DebugHandler::PrintFatal("Failed to begin recording upload command buffer!");
+            }
+
+            data.hasOpenBatch = true;
+        }
+
+        bool UploadBufferHandlerVK::AllocateFromRing(u64 size, u64& outOffset)
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            while (true)
+            {
+                // Nothing is using the ring, start over from the beginning to avoid wrapping
+                if (!data.hasOpenBatch && data.inFlightBatches.empty())
+                {
+                    data.head = 0;
+                    data.tail = 0;
+                }
+
+                u64 offset = (data.head + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+
+                // Allocations never straddle the end of the ring, skip ahead to the start instead
+                u64 ringOffset = offset % STAGING_RING_SIZE;
+                if (ringOffset + size > STAGING_RING_SIZE)
+                {
+                    offset += STAGING_RING_SIZE - ringOffset;
+                }
+
+                if (offset + size - data.tail <= STAGING_RING_SIZE)
+                {
+                    data.head = offset + size;
+                    outOffset = offset;
+                    return true;
+                }
+
+                // The ring is full, submit what we have and wait for the oldest batch to free up space
+                ZoneScopedNC("UploadBufferHandlerVK::WaitForRingSpace", tracy::Color::Red3);
+
+                SubmitUploads();
+
+                if (data.inFlightBatches.empty())
+                {
+                    DebugHandler::PrintError("Staging ring could not fit an upload of %llu bytes", size);
+                    return false;
+                }
+
+                RetireOldestBatch(true);
+            }
+        }
+
+        void* UploadBufferHandlerVK::AllocateDedicated(u64 size, VkBuffer& outBuffer)
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            VkBufferCreateInfo bufferInfo = {};
+            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = size;
+            bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            VmaAllocationCreateInfo allocInfo = {};
+            allocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+            DedicatedStagingBuffer dedicatedBuffer;
+            VmaAllocationInfo allocationInfo;
+            if (vmaCreateBuffer(_device->_allocator, &bufferInfo, &allocInfo, &dedicatedBuffer.buffer, &dedicatedBuffer.allocation, &allocationInfo) != VK_SUCCESS)
+            {
+                DebugHandler::PrintError("Failed to create dedicated staging buffer of %llu bytes", size);
+                return nullptr;
+            }
+
+            DebugMarkerUtilVK::SetObjectName(_device->_device, (u64)dedicatedBuffer.buffer, VK_DEBUG_REPORT_OBJECT_TYPE_BUFFER_EXT, "DedicatedStagingBuffer");
+
+            if (!data.hasOpenBatch)
+            {
+                OpenBatch();
+            }
+            data.openBatch.dedicatedBuffers.push_back(dedicatedBuffer);
+
+            outBuffer = dedicatedBuffer.buffer;
+            return allocationInfo.pMappedData;
+        }
+
+        void UploadBufferHandlerVK::RetireOldestBatch(bool wait)
+        {
+            UploadBufferHandlerVKData& data = static_cast<UploadBufferHandlerVKData&>(*_data);
+
+            UploadBatch& batch = data.inFlightBatches.front();
+
+            if (wait)
+            {
+                u64 timeout = 5000000000; // 5 seconds in nanoseconds
+                if (vkWaitForFences(_device->_device, 1, &batch.fence, true, timeout) == VK_TIMEOUT)
+                {
+                    DebugHandler::PrintFatal("Waiting for upload fence took longer than 5 seconds, something is wrong!");
+                }
+            }
+
+            for (DedicatedStagingBuffer& dedicatedBuffer : batch.dedicatedBuffers)
+            {
+                vmaDestroyBuffer(_device->_allocator, dedicatedBuffer.buffer, dedicatedBuffer.allocation);
+            }
+
+            vkResetCommandBuffer(batch.commandBuffer, 0);
+            vkResetFences(_device->_device, 1, &batch.fence);
+
+            data.availableCommandBuffers.push_back(batch.commandBuffer);
+            data.availableFences.push_back(batch.fence);
+
+            data.tail = batch.ringEnd;
+            data.numFinishedBatches = batch.id + 1;
+
+            data.inFlightBatches.pop_front();
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <NovusTypes.h>
+#include <vulkan/vulkan_core.h>
+
+#include "../../../Descriptors/UploadBufferDesc.h"
+
+namespace Renderer
+{
+    namespace Backend
+    {
+        class RenderDeviceVK;
+
+        struct IUploadBufferHandlerVKData {};
+
+        // Gathers buffer uploads into a persistently mapped staging ring and records the copies into a shared command buffer,
+        // the copies get submitted as one batch instead of one blocking submit per upload
+        class UploadBufferHandlerVK
+        {
+        public:
+            void Init(RenderDeviceVK* device);
+
+            // Returns staging memory which gets copied into dstBuffer when the current batch is submitted,
+            // the memory has to be written before the next call into this handler since that call might submit the batch
+            void* StageUpload(VkBuffer dstBuffer, u64 dstOffset, u64 size);
+            // Same as StageUpload but copies into every mip and layer of dstImage, the image ends up in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            void* StageImageUpload(VkImage dstImage, VkFormat format, u32 width, u32 height, u32 numLayers, u32 numMipLevels, u64 size);
+            // Copies into a region of the first layer and mip of dstImage and keeps the rest of it, the image has to be in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            void* StageImageRegionUpload(VkImage dstImage, u32 x, u32 y, u32 width, u32 height, u64 size);
+
+            UploadBatchID SubmitUploads();
+            bool HasPendingUploads();
+
+            bool IsUploadFinished(UploadBatchID batchID);
+            void WaitForUpload(UploadBatchID batchID);
+
+            // Polls in flight batches and reclaims the staging memory of the ones the GPU has finished
+            void RetireFinishedBatches();
+
+        private:
+            void* AllocateStaging(u64 size, VkBuffer& outBuffer, u64& outOffset);
+            void OpenBatch();
+            bool AllocateFromRing(u64 size, u64& outOffset);
+            void* AllocateDedicated(u64 size, VkBuffer& outBuffer);
+            void RetireOldestBatch(bool wait);
+
+        private:
+            RenderDeviceVK* _device;
+
+            IUploadBufferHandlerVKData* _data;
+        };
+    }
+}
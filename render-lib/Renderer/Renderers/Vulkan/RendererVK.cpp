@@ -2,8 +2,10 @@
 #include "../../../Window/Window.h"
 #include <Utils/StringUtils.h>
 #include <Utils/DebugHandler.h>
+#include <Utils/XXHash64.h>
 #include <tracy/Tracy.hpp>
 #include <tracy/TracyVulkan.hpp>
+#include <algorithm>
 
 #include "Backend/RenderDeviceVK.h"
 #include "Backend/BufferHandlerVK.h"
@@ -14,6 +16,7 @@
 #include "Backend/CommandListHandlerVK.h"
 #include "Backend/SamplerHandlerVK.h"
 #include "Backend/SemaphoreHandlerVK.h"
+#include "Backend/UploadBufferHandlerVK.h"
 #include "Backend/SwapChainVK.h"
 #include "Backend/DebugMarkerUtilVK.h"
 #include "Backend/DescriptorSetBuilderVK.h"
@@ -23,6 +26,9 @@
 
 namespace Renderer
 {
+    static const u32 FRAME_CONSTANTS_RING_SIZE = 1024 * 1024; // Initial size, a ring doubles whenever a frame doesn't fit
+    static const u32 MAX_DYNAMIC_OFFSETS = 8; // The lowest maxDescriptorSetUniformBuffersDynamic the spec allows
+
     RendererVK::RendererVK(TextureDesc& debugTexture)
         : _device(new Backend::RenderDeviceVK())
     {
@@ -35,20 +41,26 @@ namespace Renderer
         _commandListHandler = new Backend::CommandListHandlerVK();
         _samplerHandler = new Backend::SamplerHandlerVK();
         _semaphoreHandler = new Backend::SemaphoreHandlerVK();
+        _uploadBufferHandler = new Backend::UploadBufferHandlerVK();
 
         // Init
         _device->Init();
         _bufferHandler->Init(_device);
         _imageHandler->Init(_device);
-        _textureHandler->Init(_device, _bufferHandler);
+        _textureHandler->Init(_device, _bufferHandler, _uploadBufferHandler);
         _shaderHandler->Init(_device);
         _pipelineHandler->Init(_device, _shaderHandler, _imageHandler);
         _commandListHandler->Init(_device);
         _samplerHandler->Init(_device);
         _semaphoreHandler->Init(_device);
+        _uploadBufferHandler->Init(_device);
 
         _textureHandler->LoadDebugTexture(debugTexture);
 
+        VkPhysicalDeviceProperties deviceProperties;
+        vkGetPhysicalDeviceProperties(_device->_physicalDevice, &deviceProperties);
+        _frameConstantsAlignment = std::max(static_cast<u32>(deviceProperties.limits.minUniformBufferOffsetAlignment), 16u);
+
         CreateDummyPipeline();
     }
 
@@ -61,6 +73,8 @@ namespace Renderer
     {
         _device->FlushGPU(); // Make sure it has finished rendering
 
+        _pipelineHandler->Deinit();
+
         delete(_device);
         delete(_bufferHandler);
         delete(_imageHandler);
@@ -70,6 +84,7 @@ namespace Renderer
         delete(_commandListHandler);
         delete(_samplerHandler);
         delete(_semaphoreHandler);
+        delete(_uploadBufferHandler);
     }
 
     void RendererVK::ReloadShaders(bool forceRecompileAll)
@@ -108,6 +123,24 @@ namespace Renderer
         return _imageHandler->CreateDepthImage(desc);
     }
 
+    ImageID RendererVK::CreateTransientImage(ImageDesc& desc)
+    {
+        return _imageHandler->CreateTransientImage(desc);
+    }
+
+    DepthImageID RendererVK::CreateTransientDepthImage(DepthImageDesc& desc)
+    {
+        return _imageHandler->CreateTransientDepthImage(desc);
+    }
+
+    void RendererVK::AllocateTransientImages(const TransientImageDesc* images, u32 numImages)
+    {
+        if (_imageHandler->AllocateTransientImages(images, numImages))
+        {
+            _pipelineHandler->OnTransientImagesChanged();
+        }
+    }
+
     SamplerID RendererVK::CreateSampler(SamplerDesc& desc)
     {
         return _samplerHandler->CreateSampler(desc);
@@ -143,6 +176,11 @@ namespace Renderer
         return _textureHandler->CreateDataTextureIntoArray(desc, textureArray, arrayIndex);
     }
 
+    void RendererVK::UpdateDataTexture(TextureID textureID, u32 x, u32 y, u32 width, u32 height, const void* data)
+    {
+        _textureHandler->UpdateDataTexture(textureID, x, y, width, height, data);
+    }
+
     TextureID RendererVK::LoadTexture(TextureDesc& desc)
     {
         return _textureHandler->LoadTexture(desc);
@@ -153,6 +191,16 @@ namespace Renderer
         return _textureHandler->LoadTextureIntoArray(desc, textureArray, arrayIndex);
     }
 
+    TextureID RendererVK::LoadTextureAsync(TextureDesc& desc, f32 priority)
+    {
+        return _textureHandler->LoadTextureAsync(desc, priority);
+    }
+
+    TextureID RendererVK::LoadTextureIntoArrayAsync(TextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex, f32 priority)
+    {
+        return _textureHandler->LoadTextureIntoArrayAsync(desc, textureArray, arrayIndex, priority);
+    }
+
     VertexShaderID RendererVK::LoadShader(VertexShaderDesc& desc)
     {
         return _shaderHandler->LoadShader(desc);
@@ -182,6 +230,23 @@ namespace Renderer
         _textureHandler->UnloadTexturesInArray(textureArrayID, unloadStartIndex);
     }
 
+    void RendererVK::ReleaseTexturesInArray(TextureArrayID textureArrayID, const u32* arrayIndices, u32 numArrayIndices)
+    {
+        if (numArrayIndices == 0)
+            return;
+
+        std::vector<u32> unreferencedArrayIndices;
+        _textureHandler->ReleaseTexturesInArray(textureArrayID, arrayIndices, numArrayIndices, unreferencedArrayIndices);
+
+        // Textures that are still referenced stay loaded, only wait on the GPU when something actually gets unloaded
+        if (unreferencedArrayIndices.empty())
+            return;
+
+        _device->FlushGPU(); // Make sure we have finished rendering
+
+        _textureHandler->UnloadUnreferencedTexturesInArray(textureArrayID, unreferencedArrayIndices);
+    }
+
     static VmaBudget sBudgets[16] = { 0 };
 
     void RendererVK::FlipFrame(u32 frameIndex)
@@ -209,7 +274,25 @@ namespace Renderer
         }
 
         _commandListHandler->ResetCommandBuffers();
+
+        // The GPU is done with the frame that last used this ring
+        _frameConstantsRingIndex = (_frameConstantsRingIndex + 1) % _frameConstantsRings.size();
+        _frameConstantsRings[_frameConstantsRingIndex].offset = 0;
+
         _bufferHandler->OnFrameStart();
+        _imageHandler->OnFrameStart();
+        _pipelineHandler->OnFrameStart();
+
+        // Shaders that finished compiling in the background get swapped in here, nothing of the new frame has been recorded yet
+        if (_shaderHandler->OnFrameStart())
+        {
+            ReloadShaders(false);
+        }
+        _uploadBufferHandler->RetireFinishedBatches();
+        _textureHandler->FinishAsyncLoads();
+
+        // Free up any old descriptors, this can't wait for MarkFrameStart since deferred command lists might build descriptors before that one gets recorded
+        _device->_descriptorMegaPool->SetFrame(frameIndex);
 
         vmaSetCurrentFrameIndex(_device->_allocator, frameIndex);
         vmaGetBudget(_device->_allocator, sBudgets);
@@ -234,19 +317,67 @@ namespace Renderer
 
     CommandListID RendererVK::BeginCommandList()
     {
+        // Staged uploads have to land before any command list that might read them
+        if (_uploadBufferHandler->HasPendingUploads())
+        {
+            _uploadBufferHandler->SubmitUploads();
+        }
+
         return _commandListHandler->BeginCommandList();
     }
 
     void RendererVK::EndCommandList(CommandListID commandListID)
     {
-        if (_renderPassOpenCount != 0)
+        if (_commandListHandler->GetRenderPassOpenCount(commandListID) != 0)
         {
             DebugHandler::PrintFatal("We found unmatched calls to BeginPipeline in your commandlist, for every BeginPipeline you need to also EndPipeline!");
         }
 
+        // Deferred command lists can be ended from a worker thread, they get submitted by SubmitCommandLists
+        if (_commandListHandler->IsDeferred(commandListID))
+        {
+            _commandListHandler->EndDeferredCommandList(commandListID);
+            return;
+        }
+
+        _commandListHandler->GetViewport(commandListID, _lastViewport);
+        _commandListHandler->GetScissorRect(commandListID, _lastScissorRect);
+
         _commandListHandler->EndCommandList(commandListID, VK_NULL_HANDLE);
     }
 
+    CommandListID RendererVK::BeginDeferredCommandList()
+    {
+        // Staged uploads have to land before any command list that might read them
+        if (_uploadBufferHandler->HasPendingUploads())
+        {
+            _uploadBufferHandler->SubmitUploads();
+        }
+
+        return _commandListHandler->BeginDeferredCommandList();
+    }
+
+    void RendererVK::SubmitCommandLists(const CommandListID* commandListIDs, u32 numCommandLists)
+    {
+        // Present restores the viewport and scissor rect of the last command list that set them
+        for (u32 i = 0; i < numCommandLists; i++)
+        {
+            Viewport viewport;
+            if (_commandListHandler->GetViewport(commandListIDs[i], viewport))
+            {
+                _lastViewport = viewport;
+            }
+
+            ScissorRect scissorRect;
+            if (_commandListHandler->GetScissorRect(commandListIDs[i], scissorRect))
+            {
+                _lastScissorRect = scissorRect;
+            }
+        }
+
+        _commandListHandler->SubmitCommandLists(commandListIDs, numCommandLists, VK_NULL_HANDLE);
+    }
+
     void RendererVK::Clear(CommandListID commandListID, ImageID imageID, Color color)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
@@ -313,8 +444,9 @@ namespace Renderer
     void RendererVK::Draw(CommandListID commandListID, u32 numVertices, u32 numInstances, u32 vertexOffset, u32 instanceOffset)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        i8& renderPassOpenCount = _commandListHandler->GetRenderPassOpenCount(commandListID);
 
-        if (_renderPassOpenCount <= 0)
+        if (renderPassOpenCount <= 0)
         {
             DebugHandler::PrintFatal("You tried to draw without first calling BeginPipeline!");
         }
@@ -325,8 +457,9 @@ namespace Renderer
     void RendererVK::DrawIndirect(CommandListID commandListID, BufferID argumentBuffer, u32 argumentBufferOffset, u32 drawCount)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        i8& renderPassOpenCount = _commandListHandler->GetRenderPassOpenCount(commandListID);
 
-        if (_renderPassOpenCount <= 0)
+        if (renderPassOpenCount <= 0)
         {
             DebugHandler::PrintFatal("You tried to draw without first calling BeginPipeline!");
         }
@@ -339,8 +472,9 @@ namespace Renderer
     void RendererVK::DrawIndexed(CommandListID commandListID, u32 numIndices, u32 numInstances, u32 indexOffset, u32 vertexOffset, u32 instanceOffset)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        i8& renderPassOpenCount = _commandListHandler->GetRenderPassOpenCount(commandListID);
 
-        if (_renderPassOpenCount <= 0)
+        if (renderPassOpenCount <= 0)
         {
             DebugHandler::PrintFatal("You tried to draw without first calling BeginPipeline!");
         }
@@ -351,8 +485,9 @@ namespace Renderer
     void RendererVK::DrawIndexedIndirect(CommandListID commandListID, BufferID argumentBuffer, u32 argumentBufferOffset, u32 drawCount)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        i8& renderPassOpenCount = _commandListHandler->GetRenderPassOpenCount(commandListID);
 
-        if (_renderPassOpenCount <= 0)
+        if (renderPassOpenCount <= 0)
         {
             DebugHandler::PrintFatal("You tried to draw without first calling BeginPipeline!");
         }
@@ -365,8 +500,9 @@ namespace Renderer
     void RendererVK::DrawIndexedIndirectCount(CommandListID commandListID, BufferID argumentBuffer, u32 argumentBufferOffset, BufferID drawCountBuffer, u32 drawCountBufferOffset, u32 maxDrawCount)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        i8& renderPassOpenCount = _commandListHandler->GetRenderPassOpenCount(commandListID);
 
-        if (_renderPassOpenCount <= 0)
+        if (renderPassOpenCount <= 0)
         {
             DebugHandler::PrintFatal("You tried to draw without first calling BeginPipeline!");
         }
@@ -407,17 +543,18 @@ namespace Renderer
     void RendererVK::BeginPipeline(CommandListID commandListID, GraphicsPipelineID pipelineID)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        i8& renderPassOpenCount = _commandListHandler->GetRenderPassOpenCount(commandListID);
 
         const GraphicsPipelineDesc& pipelineDesc = _pipelineHandler->GetDescriptor(pipelineID);
         VkPipeline pipeline = _pipelineHandler->GetPipeline(pipelineID);
         VkRenderPass renderPass = _pipelineHandler->GetRenderPass(pipelineID);
         VkFramebuffer frameBuffer = _pipelineHandler->GetFramebuffer(pipelineID);
 
-        if (_renderPassOpenCount != 0)
+        if (renderPassOpenCount != 0)
         {
             DebugHandler::PrintFatal("You need to match your BeginPipeline calls with a EndPipeline call before beginning another pipeline!");
         }
-        _renderPassOpenCount++;
+        renderPassOpenCount++;
 
         uvec2 renderSize = _device->GetMainWindowSize();
 
@@ -454,12 +591,13 @@ namespace Renderer
     void RendererVK::EndPipeline(CommandListID commandListID, GraphicsPipelineID pipelineID)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        i8& renderPassOpenCount = _commandListHandler->GetRenderPassOpenCount(commandListID);
 
-        if (_renderPassOpenCount <= 0)
+        if (renderPassOpenCount <= 0)
         {
             DebugHandler::PrintFatal("You tried to call EndPipeline without first calling BeginPipeline!");
         }
-        _renderPassOpenCount--;
+        renderPassOpenCount--;
 
         vkCmdEndRenderPass(commandBuffer);
         _commandListHandler->SetBoundGraphicsPipeline(commandListID, GraphicsPipelineID::Invalid());
@@ -482,14 +620,15 @@ namespace Renderer
     void RendererVK::BeginPipeline(CommandListID commandListID, ComputePipelineID pipelineID)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        i8& renderPassOpenCount = _commandListHandler->GetRenderPassOpenCount(commandListID);
 
         VkPipeline pipeline = _pipelineHandler->GetPipeline(pipelineID);
 
-        if (_renderPassOpenCount != 0)
+        if (renderPassOpenCount != 0)
         {
             DebugHandler::PrintFatal("You need to match your BeginPipeline calls with a EndPipeline call before beginning another pipeline!");
         }
-        _renderPassOpenCount++;
+        renderPassOpenCount++;
 
         vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
 
@@ -499,12 +638,13 @@ namespace Renderer
     void RendererVK::EndPipeline(CommandListID commandListID, ComputePipelineID pipelineID)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        i8& renderPassOpenCount = _commandListHandler->GetRenderPassOpenCount(commandListID);
 
-        if (_renderPassOpenCount <= 0)
+        if (renderPassOpenCount <= 0)
         {
             DebugHandler::PrintFatal("You tried to call EndPipeline without first calling BeginPipeline!");
         }
-        _renderPassOpenCount--;
+        renderPassOpenCount--;
 
         VkPipeline pipeline = _pipelineHandler->GetPipeline(pipelineID);
 
@@ -515,7 +655,7 @@ namespace Renderer
 
     void RendererVK::SetScissorRect(CommandListID commandListID, ScissorRect scissorRect)
     {
-        _lastScissorRect = scissorRect;
+        _commandListHandler->SetScissorRect(commandListID, scissorRect);
 
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
 
@@ -528,7 +668,7 @@ namespace Renderer
 
     void RendererVK::SetViewport(CommandListID commandListID, Viewport viewport)
     {
-        _lastViewport = viewport;
+        _commandListHandler->SetViewport(commandListID, viewport);
 
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
 
@@ -703,7 +843,7 @@ namespace Renderer
         {
             VkDescriptorBufferInfo bufferInfo = {};
             bufferInfo.buffer = _bufferHandler->GetBuffer(descriptor.bufferID);
-            bufferInfo.range = _bufferHandler->GetBufferSize(descriptor.bufferID);
+            bufferInfo.range = GetDescriptorBufferRange(descriptor);
 
             builder->BindBuffer(descriptor.nameHash, bufferInfo);
         }
@@ -746,47 +886,146 @@ namespace Renderer
         GraphicsPipelineID graphicsPipelineID = _commandListHandler->GetBoundGraphicsPipeline(commandListID);
         ComputePipelineID computePipelineID = _commandListHandler->GetBoundComputePipeline(commandListID);
 
-        if (graphicsPipelineID != GraphicsPipelineID::Invalid())
+        // The key is built from what would get written into the set, so a new image view or buffer behind the same ID gives a new key
+        struct DescriptorKey
         {
-            std::vector<std::vector<VkDescriptorImageInfo>> imageInfosArrays; // These need to live until builder->BuildDescriptor()
-            imageInfosArrays.reserve(8);
+            u64 handle;
+            u64 extra;
+            u32 nameHash;
+            u32 descriptorType;
+        };
+
+        u64 descriptorsKey = static_cast<u64>(slot);
+        for (u32 i = 0; i < numDescriptors; i++)
+        {
+            DescriptorKey descriptorKey;
+            descriptorKey.nameHash = descriptors[i].nameHash;
+            descriptorKey.descriptorType = static_cast<u32>(descriptors[i].descriptorType);
+            GetDescriptorHandle(descriptors[i], descriptorKey.handle, descriptorKey.extra);
 
-            Backend::DescriptorSetBuilderVK* builder = _pipelineHandler->GetDescriptorSetBuilder(graphicsPipelineID);
+            descriptorsKey = XXHash64::hash(&descriptorKey, sizeof(DescriptorKey), descriptorsKey);
+        }
+
+        Backend::DescriptorMegaPoolVK* descriptorPool = _device->_descriptorMegaPool;
+
+        // Sets are cached across frames, only a combination of layout and descriptors that hasn't been bound lately gets built and written
+        auto getDescriptorSet = [&](Backend::DescriptorSetBuilderVK* builder, VkDescriptorSetLayout descriptorSetLayout)
+        {
+            u64 key = XXHash64::hash(&descriptorSetLayout, sizeof(VkDescriptorSetLayout), descriptorsKey);
+
+            VkDescriptorSet descriptorSet;
+            if (descriptorPool->TryGetCachedDescriptor(key, descriptorSet))
+                return descriptorSet;
+
+            std::vector<std::vector<VkDescriptorImageInfo>> imageInfosArrays; // These need to live until builder->BuildCachedDescriptor()
+            imageInfosArrays.reserve(8);
 
             for (u32 i = 0; i < numDescriptors; i++)
             {
                 ZoneScopedNC("BindDescriptor", tracy::Color::Red3);
                 Descriptor& descriptor = descriptors[i];
                 BindDescriptor(builder, &imageInfosArrays, descriptor);
+
+                // Texture arrays are keyed by their generation instead of the image views in them
+                if (descriptor.descriptorType != DescriptorType::DESCRIPTOR_TYPE_TEXTURE_ARRAY)
+                {
+                    u64 handle;
+                    u64 extra;
+                    GetDescriptorHandle(descriptor, handle, extra);
+
+                    descriptorPool->AddCachedHandle(handle);
+                }
+            }
+
+            return builder->BuildCachedDescriptor(static_cast<i32>(slot), key);
+        };
+
+        // Uniform buffers are dynamic, their offsets get passed along every bind whether the set came from the cache or not
+        std::array<u32, MAX_DYNAMIC_OFFSETS> dynamicOffsets;
+        auto getDynamicOffsets = [&](Backend::DescriptorSetBuilderVK* builder)
+        {
+            u32 numDynamicOffsets = builder->GetNumDynamicOffsets(static_cast<i32>(slot));
+            assert(numDynamicOffsets <= MAX_DYNAMIC_OFFSETS);
+
+            dynamicOffsets.fill(0);
+            for (u32 i = 0; i < numDescriptors; i++)
+            {
+                u32 dynamicOffsetIndex;
+                if (descriptors[i].descriptorType == DescriptorType::DESCRIPTOR_TYPE_BUFFER &&
+                    builder->GetDynamicOffsetIndex(descriptors[i].nameHash, static_cast<i32>(slot), dynamicOffsetIndex))
+                {
+                    dynamicOffsets[dynamicOffsetIndex] = descriptors[i].bufferOffset;
+                }
             }
 
-            VkDescriptorSet descriptorSet = builder->BuildDescriptor(static_cast<i32>(slot), Backend::DescriptorLifetime::PerFrame);
+            return numDynamicOffsets;
+        };
+
+        // The builders belong to the pipelines, not the command list, so deferred command lists take turns building their sets
+        std::lock_guard<std::mutex> lock(_descriptorMutex);
+
+        if (graphicsPipelineID != GraphicsPipelineID::Invalid())
+        {
+            Backend::DescriptorSetBuilderVK* builder = _pipelineHandler->GetDescriptorSetBuilder(graphicsPipelineID);
+            VkDescriptorSet descriptorSet = getDescriptorSet(builder, _pipelineHandler->GetDescriptorSetLayout(graphicsPipelineID, slot));
 
             VkPipelineLayout pipelineLayout = _pipelineHandler->GetPipelineLayout(graphicsPipelineID);
+            u32 numDynamicOffsets = getDynamicOffsets(builder);
 
             // Bind descriptor set
-            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, slot, 1, &descriptorSet, 0, nullptr);
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, slot, 1, &descriptorSet, numDynamicOffsets, dynamicOffsets.data());
         } 
         else if (computePipelineID != ComputePipelineID::Invalid())
         {
-            std::vector<std::vector<VkDescriptorImageInfo>> imageInfosArrays; // These need to live until builder->BuildDescriptor()
-            imageInfosArrays.reserve(8);
-
             Backend::DescriptorSetBuilderVK* builder = _pipelineHandler->GetDescriptorSetBuilder(computePipelineID);
-
-            for (u32 i = 0; i < numDescriptors; i++)
-            {
-                ZoneScopedNC("BindDescriptor", tracy::Color::Red3);
-                Descriptor& descriptor = descriptors[i];
-                BindDescriptor(builder, &imageInfosArrays, descriptor);
-            }
-
-            VkDescriptorSet descriptorSet = builder->BuildDescriptor(static_cast<i32>(slot), Backend::DescriptorLifetime::PerFrame);
+            VkDescriptorSet descriptorSet = getDescriptorSet(builder, _pipelineHandler->GetDescriptorSetLayout(computePipelineID, slot));
 
             VkPipelineLayout pipelineLayout = _pipelineHandler->GetPipelineLayout(computePipelineID);
+            u32 numDynamicOffsets = getDynamicOffsets(builder);
 
             // Bind descriptor set
-            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, slot, 1, &descriptorSet, 0, nullptr);
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, slot, 1, &descriptorSet, numDynamicOffsets, dynamicOffsets.data());
+        }
+    }
+
+    u64 RendererVK::GetDescriptorBufferRange(const Descriptor& descriptor)
+    {
+        if (descriptor.bufferRange != 0)
+            return descriptor.bufferRange;
+
+        return _bufferHandler->GetBufferSize(descriptor.bufferID);
+    }
+
+    void RendererVK::GetDescriptorHandle(const Descriptor& descriptor, u64& outHandle, u64& outExtra)
+    {
+        outExtra = 0;
+
+        switch (descriptor.descriptorType)
+        {
+            case DescriptorType::DESCRIPTOR_TYPE_SAMPLER:
+                outHandle = Backend::DescriptorMegaPoolVK::GetHandleKey(_samplerHandler->GetSampler(descriptor.samplerID));
+                break;
+            case DescriptorType::DESCRIPTOR_TYPE_TEXTURE:
+                outHandle = Backend::DescriptorMegaPoolVK::GetHandleKey(_textureHandler->GetImageView(descriptor.textureID));
+                break;
+            case DescriptorType::DESCRIPTOR_TYPE_TEXTURE_ARRAY:
+                outHandle = static_cast<u64>(static_cast<TextureArrayID::type>(descriptor.textureArrayID));
+                outExtra = _textureHandler->GetTextureArrayGeneration();
+                break;
+            case DescriptorType::DESCRIPTOR_TYPE_IMAGE:
+            case DescriptorType::DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                outHandle = Backend::DescriptorMegaPoolVK::GetHandleKey(_imageHandler->GetColorView(descriptor.imageID, descriptor.imageMipLevel));
+                break;
+            case DescriptorType::DESCRIPTOR_TYPE_DEPTH_IMAGE:
+                outHandle = Backend::DescriptorMegaPoolVK::GetHandleKey(_imageHandler->GetDepthView(descriptor.depthImageID));
+                break;
+            case DescriptorType::DESCRIPTOR_TYPE_BUFFER:
+                outHandle = Backend::DescriptorMegaPoolVK::GetHandleKey(_bufferHandler->GetBuffer(descriptor.bufferID));
+                outExtra = GetDescriptorBufferRange(descriptor); // The offset is dynamic, it doesn't need a set of its own
+                break;
+            default:
+                outHandle = 0;
+                break;
         }
     }
 
@@ -795,14 +1034,14 @@ namespace Renderer
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
 
         // Collect tracy timings
-        TracyVkCollect(_device->_tracyContext, commandBuffer);
+        {
+            std::lock_guard<std::mutex> lock(_tracyMutex);
+            TracyVkCollect(_device->_tracyContext, commandBuffer);
+        }
 
         // Add a marker specifying the frameIndex
         Backend::DebugMarkerUtilVK::PushMarker(commandBuffer, Color(1,1,1,1), std::to_string(frameIndex));
         Backend::DebugMarkerUtilVK::PopMarker(commandBuffer);
-
-        // Free up any old descriptors
-        _device->_descriptorMegaPool->SetFrame(frameIndex);
     }
 
 #if !TRACY_ENABLE
@@ -820,6 +1059,7 @@ namespace Renderer
             DebugHandler::PrintFatal("Tried to begin GPU trace on a commandlist that already had a begun GPU trace");
         }
 
+        std::lock_guard<std::mutex> lock(_tracyMutex);
         tracyScope = new tracy::VkCtxManualScope(_device->_tracyContext, sourceLocation, true);
         tracyScope->Start(commandBuffer);
 #endif
@@ -839,6 +1079,7 @@ namespace Renderer
             DebugHandler::PrintFatal("Tried to end GPU trace on a commandlist that didn't have a running trace");
         }
 
+        std::lock_guard<std::mutex> lock(_tracyMutex);
         tracyScope->End();
         delete tracyScope;
         tracyScope = nullptr;
@@ -1013,6 +1254,96 @@ namespace Renderer
         _device->TransitionImageLayout(commandBuffer, vkImage, imageAspect, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, 1, 1);
     }
 
+    static void GetImageAccessMasks(u8 access, bool isDepth, VkPipelineStageFlags& stageMask, VkAccessFlags& accessMask)
+    {
+        if (access & IMAGE_ACCESS_RENDERTARGET)
+        {
+            if (isDepth)
+            {
+                stageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+                accessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            }
+            else
+            {
+                stageMask |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                accessMask |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            }
+        }
+        if (access & IMAGE_ACCESS_UAV)
+        {
+            stageMask |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            accessMask |= VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        }
+        if (access & IMAGE_ACCESS_VERTEX_READ)
+        {
+            stageMask |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+            accessMask |= VK_ACCESS_SHADER_READ_BIT;
+        }
+        if (access & IMAGE_ACCESS_PIXEL_READ)
+        {
+            stageMask |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            accessMask |= VK_ACCESS_SHADER_READ_BIT;
+        }
+        if (access & IMAGE_ACCESS_COMPUTE_READ)
+        {
+            stageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            accessMask |= VK_ACCESS_SHADER_READ_BIT;
+        }
+    }
+
+    void RendererVK::ImageBarriers(CommandListID commandListID, const ImageBarrierDesc* barriers, u32 numBarriers)
+    {
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+
+        // Every barrier of a render pass goes into a single vkCmdPipelineBarrier, color images stay in GENERAL and depth images rest in READ_ONLY between pipelines
+        std::vector<VkImageMemoryBarrier> imageBarriers(numBarriers);
+        VkPipelineStageFlags srcStageMask = 0;
+        VkPipelineStageFlags dstStageMask = 0;
+
+        for (u32 i = 0; i < numBarriers; i++)
+        {
+            const ImageBarrierDesc& barrier = barriers[i];
+            const bool isDepth = barrier.depthImage != DepthImageID::Invalid();
+
+            VkImageMemoryBarrier& imageBarrier = imageBarriers[i];
+            imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+            if (isDepth)
+            {
+                imageBarrier.image = _imageHandler->GetImage(barrier.depthImage);
+                imageBarrier.oldLayout = barrier.discard ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+                imageBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+                imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+                imageBarrier.subresourceRange.levelCount = 1;
+                imageBarrier.subresourceRange.layerCount = 1;
+            }
+            else
+            {
+                const ImageDesc& imageDesc = _imageHandler->GetImageDesc(barrier.image);
+
+                imageBarrier.image = _imageHandler->GetImage(barrier.image);
+                imageBarrier.oldLayout = barrier.discard ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_GENERAL;
+                imageBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+                imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                imageBarrier.subresourceRange.levelCount = imageDesc.mipLevels;
+                imageBarrier.subresourceRange.layerCount = imageDesc.depth;
+            }
+
+            GetImageAccessMasks(barrier.srcAccess, isDepth, srcStageMask, imageBarrier.srcAccessMask);
+            GetImageAccessMasks(barrier.dstAccess, isDepth, dstStageMask, imageBarrier.dstAccessMask);
+        }
+
+        // The first transient image in an alias slot has nothing to wait on
+        if (srcStageMask == 0)
+        {
+            srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        }
+
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, numBarriers, imageBarriers.data());
+    }
+
     void RendererVK::PushConstant(CommandListID commandListID, void* data, u32 offset, u32 size)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
@@ -1280,6 +1611,9 @@ namespace Renderer
 
     void RendererVK::CopyBuffer(BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range)
     {
+        // The source might still have staged uploads pending, submitting them first keeps the copies in order
+        _uploadBufferHandler->SubmitUploads();
+
         VkBuffer vkDstBuffer = _bufferHandler->GetBuffer(dstBuffer);
         VkBuffer vkSrcBuffer = _bufferHandler->GetBuffer(srcBuffer);
         _device->CopyBuffer(vkDstBuffer, dstOffset, vkSrcBuffer, srcOffset, range);
@@ -1287,6 +1621,27 @@ namespace Renderer
         DestroyObjects(_destroyLists[_destroyListIndex]);
     }
 
+    void* RendererVK::StageUpload(BufferID dstBuffer, u64 dstOffset, u64 size)
+    {
+        VkBuffer vkDstBuffer = _bufferHandler->GetBuffer(dstBuffer);
+        return _uploadBufferHandler->StageUpload(vkDstBuffer, dstOffset, size);
+    }
+
+    UploadBatchID RendererVK::SubmitUploads()
+    {
+        return _uploadBufferHandler->SubmitUploads();
+    }
+
+    bool RendererVK::IsUploadFinished(UploadBatchID batchID)
+    {
+        return _uploadBufferHandler->IsUploadFinished(batchID);
+    }
+
+    void RendererVK::WaitForUpload(UploadBatchID batchID)
+    {
+        _uploadBufferHandler->WaitForUpload(batchID);
+    }
+
     void RendererVK::FillBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, u32 data)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
@@ -1305,7 +1660,9 @@ namespace Renderer
 
     void* RendererVK::MapBuffer(BufferID buffer)
     {
-        void* mappedMemory;
+        void* mappedMemory = _bufferHandler->GetMappedMemory(buffer);
+        if (mappedMemory != nullptr)
+            return mappedMemory;
 
         VkResult result = vmaMapMemory(_device->_allocator, _bufferHandler->GetBufferAllocation(buffer), &mappedMemory);
         if (result != VK_SUCCESS)
@@ -1318,9 +1675,63 @@ namespace Renderer
     
     void RendererVK::UnmapBuffer(BufferID buffer)
     {
+        // Persistently mapped buffers stay mapped until they get destroyed
+        if (_bufferHandler->GetMappedMemory(buffer) != nullptr)
+            return;
+
         vmaUnmapMemory(_device->_allocator, _bufferHandler->GetBufferAllocation(buffer));
     }
 
+    FrameConstantsAllocation RendererVK::AllocateFrameConstants(u32 size)
+    {
+        std::lock_guard<std::mutex> lock(_frameConstantsMutex);
+
+        FrameConstantsRing& ring = _frameConstantsRings[_frameConstantsRingIndex];
+
+        // minUniformBufferOffsetAlignment is a power of two
+        const u32 alignedSize = (size + _frameConstantsAlignment - 1) & ~(_frameConstantsAlignment - 1);
+        if (ring.offset + alignedSize > ring.size)
+        {
+            u32 newSize = std::max(ring.size * 2, FRAME_CONSTANTS_RING_SIZE);
+            while (newSize < alignedSize)
+            {
+                newSize *= 2;
+            }
+
+            // Allocations made earlier this frame still point into the old buffer, so it can't be destroyed right away
+            if (ring.buffer != BufferID::Invalid())
+            {
+                QueueDestroyBuffer(ring.buffer);
+            }
+
+            CreateFrameConstantsRing(ring, newSize);
+        }
+
+        FrameConstantsAllocation allocation;
+        allocation.buffer = ring.buffer;
+        allocation.offset = ring.offset;
+        allocation.size = size;
+        allocation.mappedMemory = ring.mappedMemory + ring.offset;
+
+        ring.offset += alignedSize;
+
+        return allocation;
+    }
+
+    void RendererVK::CreateFrameConstantsRing(FrameConstantsRing& ring, u32 size)
+    {
+        BufferDesc desc;
+        desc.name = "FrameConstantsRing";
+        desc.size = size;
+        desc.usage = BufferUsage::UNIFORM_BUFFER;
+        desc.cpuAccess = BufferCPUAccess::WriteOnly;
+
+        ring.buffer = _bufferHandler->CreateBuffer(desc);
+        ring.size = size;
+        ring.offset = 0;
+        ring.mappedMemory = static_cast<u8*>(_bufferHandler->GetMappedMemory(ring.buffer));
+    }
+
     const std::string& RendererVK::GetGPUName()
     {
         return _device->GetGPUName();
@@ -1361,4 +1772,14 @@ namespace Renderer
     {
         return _imageHandler->GetNumDepthImages();
     }
+
+    bool RendererVK::IsImageAvailable(ImageID imageID)
+    {
+        return _imageHandler->IsImageAvailable(imageID);
+    }
+
+    bool RendererVK::IsImageAvailable(DepthImageID imageID)
+    {
+        return _imageHandler->IsImageAvailable(imageID);
+    }
 }
\ No newline at end of file
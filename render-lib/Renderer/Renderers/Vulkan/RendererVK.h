@@ -1,6 +1,7 @@
 #pragma once
 #include "../../Renderer.h"
 #include <array>
+#include <mutex>
 
 struct VkDescriptorSetLayoutBinding;
 
@@ -17,6 +18,7 @@ namespace Renderer
         class CommandListHandlerVK;
         class SamplerHandlerVK;
         class SemaphoreHandlerVK;
+        class UploadBufferHandlerVK;
         struct BindInfo;
         class DescriptorSetBuilderVK;
         struct SwapChainVK;
@@ -41,6 +43,10 @@ namespace Renderer
         ImageID CreateImage(ImageDesc& desc) override;
         DepthImageID CreateDepthImage(DepthImageDesc& desc) override;
 
+        ImageID CreateTransientImage(ImageDesc& desc) override;
+        DepthImageID CreateTransientDepthImage(DepthImageDesc& desc) override;
+        void AllocateTransientImages(const TransientImageDesc* images, u32 numImages) override;
+
         SamplerID CreateSampler(SamplerDesc& desc) override;
         GPUSemaphoreID CreateGPUSemaphore() override;
 
@@ -51,10 +57,13 @@ namespace Renderer
 
         TextureID CreateDataTexture(DataTextureDesc& desc) override;
         TextureID CreateDataTextureIntoArray(DataTextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex) override;
+        void UpdateDataTexture(TextureID textureID, u32 x, u32 y, u32 width, u32 height, const void* data) override;
 
         // Loading
         TextureID LoadTexture(TextureDesc& desc) override;
         TextureID LoadTextureIntoArray(TextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex) override;
+        TextureID LoadTextureAsync(TextureDesc& desc, f32 priority) override;
+        TextureID LoadTextureIntoArrayAsync(TextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex, f32 priority) override;
 
         VertexShaderID LoadShader(VertexShaderDesc& desc) override;
         PixelShaderID LoadShader(PixelShaderDesc& desc) override;
@@ -63,10 +72,13 @@ namespace Renderer
         // Unloading
         void UnloadTexture(TextureID textureID) override;
         void UnloadTexturesInArray(TextureArrayID textureArrayID, u32 unloadStartIndex) override;
+        void ReleaseTexturesInArray(TextureArrayID textureArrayID, const u32* arrayIndices, u32 numArrayIndices) override;
 
         // Command List Functions
         CommandListID BeginCommandList() override;
         void EndCommandList(CommandListID commandListID) override;
+        CommandListID BeginDeferredCommandList() override;
+        void SubmitCommandLists(const CommandListID* commandListIDs, u32 numCommandLists) override;
         void Clear(CommandListID commandListID, ImageID image, Color color) override;
         void Clear(CommandListID commandListID, DepthImageID image, DepthClearFlags clearFlags, f32 depth, u8 stencil) override;
         void Draw(CommandListID commandListID, u32 numVertices, u32 numInstances, u32 vertexOffset, u32 instanceOffset) override;
@@ -98,6 +110,7 @@ namespace Renderer
         void PipelineBarrier(CommandListID commandListID, PipelineBarrierType type, BufferID buffer) override;
         void ImageBarrier(CommandListID commandListID, ImageID image) override;
         void DepthImageBarrier(CommandListID commandListID, DepthImageID image) override;
+        void ImageBarriers(CommandListID commandListID, const ImageBarrierDesc* barriers, u32 numBarriers) override;
         void PushConstant(CommandListID commandListID, void* data, u32 offset, u32 size) override;
         void FillBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, u32 data) override;
         void UpdateBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, void* data) override;
@@ -116,9 +129,16 @@ namespace Renderer
 
         void CopyBuffer(BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range) override;
 
+        void* StageUpload(BufferID dstBuffer, u64 dstOffset, u64 size) override;
+        UploadBatchID SubmitUploads() override;
+        bool IsUploadFinished(UploadBatchID batchID) override;
+        void WaitForUpload(UploadBatchID batchID) override;
+
         void* MapBuffer(BufferID buffer) override;
         void UnmapBuffer(BufferID buffer) override;
 
+        FrameConstantsAllocation AllocateFrameConstants(u32 size) override;
+
         const std::string& GetGPUName() override;
 
         size_t GetVRAMUsage() override;
@@ -130,9 +150,24 @@ namespace Renderer
         u32 GetNumImages() override;
         u32 GetNumDepthImages() override;
 
+        bool IsImageAvailable(ImageID imageID) override;
+        bool IsImageAvailable(DepthImageID imageID) override;
+
     private:
         bool ReflectDescriptorSet(const std::string& name, u32 nameHash, u32 type, i32& set, const std::vector<Backend::BindInfo>& bindInfos, u32& outBindInfoIndex, VkDescriptorSetLayoutBinding* outDescriptorLayoutBinding);
         void BindDescriptor(Backend::DescriptorSetBuilderVK* builder, void* imageInfosArraysVoid, Descriptor& descriptor);
+        void GetDescriptorHandle(const Descriptor& descriptor, u64& outHandle, u64& outExtra);
+        u64 GetDescriptorBufferRange(const Descriptor& descriptor);
+
+        struct FrameConstantsRing
+        {
+            BufferID buffer = BufferID::Invalid();
+            u32 size = 0;
+            u32 offset = 0;
+            u8* mappedMemory = nullptr;
+        };
+
+        void CreateFrameConstantsRing(FrameConstantsRing& ring, u32 size);
 
         void RecreateSwapChain(Backend::SwapChainVK* swapChain);
         void CreateDummyPipeline();
@@ -147,6 +182,7 @@ namespace Renderer
         Backend::CommandListHandlerVK* _commandListHandler = nullptr;
         Backend::SamplerHandlerVK* _samplerHandler = nullptr;
         Backend::SemaphoreHandlerVK* _semaphoreHandler = nullptr;
+        Backend::UploadBufferHandlerVK* _uploadBufferHandler = nullptr;
 
         GraphicsPipelineID _globalDummyPipeline = GraphicsPipelineID::Invalid();
         Backend::DescriptorSetBuilderVK* _descriptorSetBuilder = nullptr;
@@ -154,7 +190,15 @@ namespace Renderer
         Viewport _lastViewport;
         ScissorRect _lastScissorRect;
 
-        i8 _renderPassOpenCount = 0; // TODO: Move these into CommandListHandler I guess?
+        // Deferred command lists get recorded on several threads at once, these guard the state they share
+        std::mutex _descriptorMutex; // Descriptor set builders and the descriptor pools
+        std::mutex _tracyMutex; // Query ids of the tracy GPU context
+        std::mutex _frameConstantsMutex; // Offset of the current frame constants ring
+
+        // One ring per frame in flight, a ring only gets reused once the fence of the frame that wrote it has been waited on
+        std::array<FrameConstantsRing, 2> _frameConstantsRings;
+        u32 _frameConstantsRingIndex = 0;
+        u32 _frameConstantsAlignment = 256;
 
         struct ObjectDestroyList
         {
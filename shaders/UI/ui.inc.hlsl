@@ -0,0 +1,44 @@
+// Every UI element is drawn as instanced quads out of one frame wide buffer, the instance index is the index of the quad
+struct Quad
+{
+    float2 minPosition; // Upper left corner in 0 - 1 screen space
+    float2 maxPosition; // Lower right corner
+    float2 minUV;
+    float2 maxUV;
+    uint textureIndex;
+    uint dataIndex; // Into _panelData or _textData depending on the pipeline drawing the quad
+};
+
+[[vk::binding(0, PER_PASS)]] SamplerState _sampler;
+[[vk::binding(1, PER_PASS)]] StructuredBuffer<Quad> _quads;
+
+struct VertexInput
+{
+    uint vertexID : SV_VertexID;
+    uint instanceID : SV_InstanceID;
+};
+
+struct VertexOutput
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD0;
+    nointerpolation uint textureIndex : TEXCOORD1;
+    nointerpolation uint dataIndex : TEXCOORD2;
+};
+
+VertexOutput LoadQuadVertex(VertexInput input)
+{
+    Quad quad = _quads[input.instanceID];
+
+    // Vertices 0 - 3 are upper left, upper right, lower left and lower right, which is what the shared index buffer expects
+    float2 corner = float2(input.vertexID & 1, input.vertexID >> 1);
+    float2 position = lerp(quad.minPosition, quad.maxPosition, corner);
+
+    VertexOutput output;
+    output.position = float4((position * 2.0f) - 1.0f, 0.0f, 1.0f);
+    output.uv = lerp(quad.minUV, quad.maxUV, corner);
+    output.textureIndex = quad.textureIndex;
+    output.dataIndex = quad.dataIndex;
+
+    return output;
+}
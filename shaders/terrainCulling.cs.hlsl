@@ -92,7 +92,7 @@ void main(uint3 dispatchThreadId : SV_DispatchThreadID)
     const uint cellID = instance.packedChunkCellID & 0xffff;
     const uint chunkID = instance.packedChunkCellID >> 16;
 
-    const float2 heightRange = ReadHeightRange(instanceIndex);
+    const float2 heightRange = ReadHeightRange(instance.instanceID);
     AABB aabb = GetCellAABB(chunkID, cellID, heightRange);
     
     if (!IsAABBInsideFrustum(_constants.frustumPlanes, aabb))
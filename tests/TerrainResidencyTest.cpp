@@ -0,0 +1,224 @@
+#include <NovusTypes.h>
+#include <Utils/DebugHandler.h>
+#include <Renderer/Renderers/Null/RendererNull.h>
+#include <Renderer/Descriptors/TextureDesc.h>
+#include <Renderer/Descriptors/TextureArrayDesc.h>
+
+#include "../client/Gameplay/Map/Chunk.h"
+#include "../client/Rendering/TerrainChunkResidency.h"
+
+#include <deque>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Flies a camera across the map the way TerrainRenderer::UpdateStreaming streams chunks, on the null renderer so it runs without a GPU or extracted data
+// Chunks arrive a few frames after being requested so some of them are already out of range, or find every slot taken, when they get loaded
+
+namespace
+{
+    constexpr u16 STREAMING_RADIUS = 4;
+    constexpr u32 LOAD_LATENCY_FRAMES = 6;
+    constexpr u32 MAX_LOADS_PER_FRAME = 8;
+    constexpr u32 NUM_SHARED_COLOR_TEXTURES = 16;
+    constexpr u32 SETTLE_FRAMES = 64;
+
+    struct PendingChunk
+    {
+        u16 chunkID;
+        u32 arrivalFrame;
+    };
+
+    struct SlotTextures
+    {
+        std::vector<u32> colorTextureIDs;
+        u32 alphaTextureID = std::numeric_limits<u32>().max();
+    };
+
+    u32 numFailures = 0;
+
+    void Check(bool condition, const char* message, u32 frame)
+    {
+        if (!condition)
+        {
+            DebugHandler::PrintError("Frame %u: %s", frame, message);
+            numFailures++;
+        }
+    }
+
+    ivec2 GetChunkPosition(u16 chunkID)
+    {
+        return ivec2(chunkID % Terrain::MAP_CHUNKS_PER_MAP_STRIDE, chunkID / Terrain::MAP_CHUNKS_PER_MAP_STRIDE);
+    }
+}
+
+int main()
+{
+    Renderer::RendererNull renderer;
+
+    Renderer::TextureArrayDesc colorArrayDesc;
+    colorArrayDesc.size = 4096;
+    Renderer::TextureArrayID colorTextureArray = renderer.CreateTextureArray(colorArrayDesc);
+
+    Renderer::TextureArrayDesc alphaArrayDesc;
+    alphaArrayDesc.size = Terrain::MAP_CHUNKS_PER_MAP;
+    Renderer::TextureArrayID alphaTextureArray = renderer.CreateTextureArray(alphaArrayDesc);
+
+    const u32 numSlots = TerrainChunkResidency::GetNumSlotsForRadius(STREAMING_RADIUS);
+
+    TerrainChunkResidency residency;
+    residency.Reset(numSlots);
+
+    std::vector<SlotTextures> slotTextures(numSlots);
+    std::deque<PendingChunk> pendingChunks;
+    std::vector<bool> isPending(Terrain::MAP_CHUNKS_PER_MAP, false);
+
+    // Corner to corner, a teleport to the other side of the map and back to the middle
+    const std::vector<vec2> waypoints = { vec2(0, 0), vec2(63, 0), vec2(63, 63), vec2(0, 63), vec2(32, 32) };
+    const f32 chunksPerFrame = 0.75f;
+
+    u32 frame = 0;
+    u32 numDroppedChunks = 0;
+    u32 maxColorArrayIndex = 0;
+    u32 maxAlphaArrayIndex = 0;
+
+    auto RunFrame = [&](const ivec2& centerChunk)
+    {
+        // Poll whatever finished loading, same order as UpdateStreaming so arrivals are placed before the eviction below
+        while (!pendingChunks.empty() && pendingChunks.front().arrivalFrame <= frame)
+        {
+            const u16 chunkID = pendingChunks.front().chunkID;
+            pendingChunks.pop_front();
+            isPending[chunkID] = false;
+
+            u16 chunkSlot = 0;
+            if (!residency.Acquire(chunkID, chunkSlot))
+            {
+                // TerrainRenderer::LoadChunk drops the chunk, it gets requested again once it is in range
+                numDroppedChunks++;
+                continue;
+            }
+
+            SlotTextures& textures = slotTextures[chunkSlot];
+            for (u32 i = 0; i < 2; i++)
+            {
+                Renderer::TextureDesc colorDesc;
+                colorDesc.path = "Tileset/Color_" + std::to_string((chunkID + i) % NUM_SHARED_COLOR_TEXTURES) + ".dds";
+
+                u32 colorID = 0;
+                renderer.LoadTextureIntoArray(colorDesc, colorTextureArray, colorID);
+                textures.colorTextureIDs.push_back(colorID);
+                maxColorArrayIndex = glm::max(maxColorArrayIndex, colorID);
+            }
+
+            Renderer::TextureDesc alphaDesc;
+            alphaDesc.path = "Maps/Alpha_" + std::to_string(chunkID) + ".dds";
+
+            u32 alphaID = 0;
+            renderer.LoadTextureIntoArray(alphaDesc, alphaTextureArray, alphaID);
+            textures.alphaTextureID = alphaID;
+            maxAlphaArrayIndex = glm::max(maxAlphaArrayIndex, alphaID);
+        }
+
+        Check(residency.GetNumResidentChunks() <= numSlots, "More chunks resident than there are slots", frame);
+
+        // Evict everything outside of the unload radius
+        const i32 unloadRadius = STREAMING_RADIUS + 1;
+        std::vector<u16> chunkIDsToUnload;
+        residency.GatherOutsideRadius(centerChunk, unloadRadius, chunkIDsToUnload);
+
+        std::vector<u32> colorTexturesToRelease;
+        std::vector<u32> alphaTexturesToRelease;
+        for (const u16 chunkID : chunkIDsToUnload)
+        {
+            u16 chunkSlot = 0;
+            Check(residency.Release(chunkID, chunkSlot), "Failed to release a resident chunk", frame);
+
+            SlotTextures& textures = slotTextures[chunkSlot];
+            colorTexturesToRelease.insert(colorTexturesToRelease.end(), textures.colorTextureIDs.begin(), textures.colorTextureIDs.end());
+            textures.colorTextureIDs.clear();
+
+            alphaTexturesToRelease.push_back(textures.alphaTextureID);
+            textures.alphaTextureID = std::numeric_limits<u32>().max();
+        }
+
+        renderer.ReleaseTexturesInArray(colorTextureArray, colorTexturesToRelease.data(), static_cast<u32>(colorTexturesToRelease.size()));
+        renderer.ReleaseTexturesInArray(alphaTextureArray, alphaTexturesToRelease.data(), static_cast<u32>(alphaTexturesToRelease.size()));
+
+        for (const u16 chunkID : residency.GetResidentChunks())
+        {
+            const ivec2 distance = glm::abs(GetChunkPosition(chunkID) - centerChunk);
+            Check(glm::max(distance.x, distance.y) <= unloadRadius, "A chunk outside of the unload radius stayed resident", frame);
+        }
+
+        // Request the missing chunks inside the radius, a few per frame
+        const i32 maxChunkPos = Terrain::MAP_CHUNKS_PER_MAP_STRIDE - 1;
+        const ivec2 startPos = glm::max(centerChunk - ivec2(STREAMING_RADIUS), ivec2(0, 0));
+        const ivec2 endPos = glm::min(centerChunk + ivec2(STREAMING_RADIUS), ivec2(maxChunkPos, maxChunkPos));
+
+        u32 numRequested = 0;
+        for (i32 y = startPos.y; y <= endPos.y && numRequested < MAX_LOADS_PER_FRAME; y++)
+        {
+            for (i32 x = startPos.x; x <= endPos.x && numRequested < MAX_LOADS_PER_FRAME; x++)
+            {
+                const u16 chunkID = static_cast<u16>(x + (y * Terrain::MAP_CHUNKS_PER_MAP_STRIDE));
+                if (residency.IsResident(chunkID) || isPending[chunkID])
+                    continue;
+
+                pendingChunks.push_back({ chunkID, frame + LOAD_LATENCY_FRAMES });
+                isPending[chunkID] = true;
+                numRequested++;
+            }
+        }
+
+        frame++;
+    };
+
+    vec2 position = waypoints[0];
+    for (size_t i = 1; i < waypoints.size(); i++)
+    {
+        const vec2 target = waypoints[i];
+
+        // The third leg is a teleport, everything that is resident or in flight ends up out of range at once
+        if (i == 3)
+        {
+            position = target;
+        }
+
+        while (glm::distance(position, target) > chunksPerFrame)
+        {
+            position += glm::normalize(target - position) * chunksPerFrame;
+            RunFrame(ivec2(glm::floor(position)));
+        }
+        position = target;
+    }
+
+    // Stand still until streaming catches up, every chunk in the radius has to end up resident even if it was dropped on the way
+    const ivec2 finalChunk = ivec2(glm::floor(position));
+    for (u32 i = 0; i < SETTLE_FRAMES; i++)
+    {
+        RunFrame(finalChunk);
+    }
+
+    for (i32 y = finalChunk.y - STREAMING_RADIUS; y <= finalChunk.y + STREAMING_RADIUS; y++)
+    {
+        for (i32 x = finalChunk.x - STREAMING_RADIUS; x <= finalChunk.x + STREAMING_RADIUS; x++)
+        {
+            const u16 chunkID = static_cast<u16>(x + (y * Terrain::MAP_CHUNKS_PER_MAP_STRIDE));
+            Check(residency.IsResident(chunkID), "A chunk inside of the streaming radius never became resident", frame);
+        }
+    }
+
+    // Released array indices get reused, so the arrays never grow past what can be resident at once
+    Check(maxAlphaArrayIndex < numSlots, "Alpha texture array grew past the number of slots", frame);
+    Check(maxColorArrayIndex < NUM_SHARED_COLOR_TEXTURES, "Shared color textures got loaded more than once", frame);
+
+    if (numFailures > 0)
+    {
+        DebugHandler::PrintError("Terrain residency test failed with %u errors over %u frames", numFailures, frame);
+        return 1;
+    }
+
+    DebugHandler::PrintSuccess("Terrain residency stayed within %u slots over %u frames, %u late chunks were dropped", numSlots, frame, numDroppedChunks);
+    return 0;
+}